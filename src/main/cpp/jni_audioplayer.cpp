@@ -41,6 +41,7 @@ public:
         jmid_onComplete = env->GetMethodID(clazz, "onComplete", "()V");
         jmid_onAudioData = env->GetMethodID(clazz, "onAudioData", "([BI)V");
         jmid_onBuffering = env->GetMethodID(clazz, "onBuffering", "(Z)V");
+        jmid_onStartupProfile = env->GetMethodID(clazz, "onStartupProfile", "([J)V");
 
         // 记得删除局部引用
         env->DeleteLocalRef(clazz);
@@ -106,6 +107,17 @@ public:
         }
     }
 
+    void onStartupProfile(const int64_t *profile, int size) override {
+        JNIEnv *env = getEnv();
+        if (env && isValid()) {
+            jlongArray jProfile = env->NewLongArray(size);
+            env->SetLongArrayRegion(jProfile, 0, size, (const jlong *) profile);
+            env->CallVoidMethod(javaCallbackObj, jmid_onStartupProfile, jProfile);
+            checkException(env);
+            env->DeleteLocalRef(jProfile);
+        }
+    }
+
 private:
     jobject javaCallbackObj;
     jmethodID jmid_onPrepared;
@@ -114,6 +126,7 @@ private:
     jmethodID jmid_onComplete;
     jmethodID jmid_onAudioData;
     jmethodID jmid_onBuffering;
+    jmethodID jmid_onStartupProfile;
 
 
     static JNIEnv *getEnv() {
@@ -297,7 +310,37 @@ native_setDsdConfig(JNIEnv *env, jobject thiz, jlong handle, jint mode, jint sam
     }
 }
 
-// 10. Getters (GetSampleRate etc)
+// 10. Config PCM 输出编码
+static void native_setOutputEncoding(JNIEnv *env, jobject thiz, jlong handle, jint encoding) {
+    auto *ctx = getContext(handle);
+    LOCK_CONTEXT(ctx);
+    if (ctx->type == TYPE_FFMPEG) {
+        ((FFPlayer *) ctx->playerInstance)->setOutputEncoding((PcmEncoding) encoding);
+    } else {
+        ((SacdPlayer *) ctx->playerInstance)->setOutputEncoding((PcmEncoding) encoding);
+    }
+}
+
+static void native_setMaxOutputChannels(JNIEnv *env, jobject thiz, jlong handle, jint channels) {
+    auto *ctx = getContext(handle);
+    LOCK_CONTEXT(ctx);
+    if (ctx->type == TYPE_FFMPEG) {
+        ((FFPlayer *) ctx->playerInstance)->setMaxOutputChannels(channels);
+    } else {
+        ((SacdPlayer *) ctx->playerInstance)->setMaxOutputChannels(channels);
+    }
+}
+
+static void native_setPcmCacheSeconds(JNIEnv *env, jobject thiz, jlong handle, jint seconds) {
+    auto *ctx = getContext(handle);
+    LOCK_CONTEXT(ctx);
+    // 仅 FFmpeg 播放器支持 PCM 回放缓存
+    if (ctx->type == TYPE_FFMPEG) {
+        ((FFPlayer *) ctx->playerInstance)->setPcmCacheSeconds(seconds);
+    }
+}
+
+// 11. Getters (GetSampleRate etc)
 static jint native_getSampleRate(JNIEnv *env, jobject thiz, jlong handle) {
     auto *ctx = getContext(handle);
     if (ctx->type == TYPE_FFMPEG) return ((FFPlayer *) ctx->playerInstance)->getSampleRate();
@@ -340,6 +383,45 @@ static jboolean native_isDsd(JNIEnv *env, jobject thiz, jlong handle) {
     else return ((SacdPlayer *) ctx->playerInstance)->isDsd();
 }
 
+static jint native_getOutputEncoding(JNIEnv *env, jobject thiz, jlong handle) {
+    auto *ctx = getContext(handle);
+    if (ctx->type == TYPE_FFMPEG) return ((FFPlayer *) ctx->playerInstance)->getOutputEncoding();
+    else return ((SacdPlayer *) ctx->playerInstance)->getOutputEncoding();
+}
+
+// 12. Stats：不加 ctxMutex、不分配内存，供 UI 高频轮询
+static jboolean native_getStats(JNIEnv *env, jobject thiz, jlong handle, jlongArray out) {
+    auto *ctx = getContext(handle);
+    if (!ctx || !out || env->GetArrayLength(out) < PlayerStats::SNAPSHOT_SIZE) return JNI_FALSE;
+    const PlayerStats &stats = ctx->type == TYPE_FFMPEG
+                               ? ((FFPlayer *) ctx->playerInstance)->getStats()
+                               : ((SacdPlayer *) ctx->playerInstance)->getStats();
+    int64_t buf[PlayerStats::SNAPSHOT_SIZE];
+    int count = stats.snapshot(buf, PlayerStats::SNAPSHOT_SIZE);
+    if (count < 0) return JNI_FALSE;
+    env->SetLongArrayRegion(out, 0, count, reinterpret_cast<const jlong *>(buf));
+    return JNI_TRUE;
+}
+
+// 13. 内存记账：会话分项 + 全局总量，同样无锁
+static jboolean native_getMemoryUsage(JNIEnv *env, jobject thiz, jlong handle, jlongArray out) {
+    auto *ctx = getContext(handle);
+    if (!ctx || !out || env->GetArrayLength(out) < MemoryAccount::SNAPSHOT_SIZE) return JNI_FALSE;
+    const MemoryAccount &memory = ctx->type == TYPE_FFMPEG
+                                  ? ((FFPlayer *) ctx->playerInstance)->getMemory()
+                                  : ((SacdPlayer *) ctx->playerInstance)->getMemory();
+    int64_t buf[MemoryAccount::SNAPSHOT_SIZE];
+    int count = memory.snapshot(buf, MemoryAccount::SNAPSHOT_SIZE);
+    if (count < 0) return JNI_FALSE;
+    env->SetLongArrayRegion(out, 0, count, reinterpret_cast<const jlong *>(buf));
+    return JNI_TRUE;
+}
+
+// 14. 全局内存上限 (所有播放器实例共享)，静态方法
+static void native_setMemoryLimits(JNIEnv *env, jclass clazz, jlong totalBytes, jlong packetQueueBytes) {
+    MemoryBudget::setLimits(totalBytes, packetQueueBytes);
+}
+
 
 // ============================================================================
 // 动态注册表
@@ -363,6 +445,13 @@ static const JNINativeMethod gMethods[] = {
         {"native_getCurrentPosition", "(J)J",                                               (void *) native_getCurrentPosition},
         {"native_getPlayerState",     "(J)I",                                               (void *) native_getPlayerState},
         {"native_isDsd",              "(J)Z",                                               (void *) native_isDsd},
+        {"native_setOutputEncoding",  "(JI)V",                                              (void *) native_setOutputEncoding},
+        {"native_getOutputEncoding",  "(J)I",                                               (void *) native_getOutputEncoding},
+        {"native_setMaxOutputChannels", "(JI)V",                                            (void *) native_setMaxOutputChannels},
+        {"native_setPcmCacheSeconds", "(JI)V",                                              (void *) native_setPcmCacheSeconds},
+        {"native_getStats",           "(J[J)Z",                                             (void *) native_getStats},
+        {"native_getMemoryUsage",     "(J[J)Z",                                             (void *) native_getMemoryUsage},
+        {"native_setMemoryLimits",    "(JJ)V",                                              (void *) native_setMemoryLimits},
 };
 
 int register_audioplayer_methods(JavaVM *vm, JNIEnv *env) {
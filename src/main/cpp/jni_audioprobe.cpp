@@ -1,15 +1,101 @@
 #include "jni_audioprobe.h"
 #include "parser/AudioProbe.h"
 #include "parser/ProbeUtils.h"
+#include "parser/BatchProbe.h"
+#include "parser/ProbeCache.h"
+#include "parser/CoverStore.h"
+#include "parser/Fingerprinter.h"
+#include "parser/LoudnessAnalyzer.h"
+#include "parser/TagReader.h"
+#include "parser/ScanStats.h"
 #include "MapUtils.h"
 #include <jni.h>
 #include <string>
 #include <map>
+#include <unistd.h>
 
 
+// 工作线程中 FindClass 找不到应用类，类引用与方法 ID 在注册时缓存
+static JavaVM *gVm = nullptr;
+static jclass gClsMeta = nullptr;
+static jclass gClsTrack = nullptr;
+static jclass gClsList = nullptr;
+static jmethodID gCtorMeta = nullptr;
+static jmethodID gCtorTrack = nullptr;
+static jmethodID gCtorList = nullptr;
+static jmethodID gListAdd = nullptr;
+static jclass gClsFingerprint = nullptr;
+static jmethodID gCtorFingerprint = nullptr;
+static jclass gClsLoudness = nullptr;
+static jmethodID gCtorLoudness = nullptr;
+
+// InternalMetadata -> AudioMetadata，失败返回 nullptr
+static jobject toJavaMetadata(JNIEnv *env, const InternalMetadata &meta) {
+    // 解析结果处理
+    jstring jCoverPath = nullptr;
+    // 命中缓存时封面文件可能已被清理
+    if (!meta.coverPath.empty() && access(meta.coverPath.c_str(), F_OK) == 0) {
+        jCoverPath = safeNewStringUTF(env, meta.coverPath.c_str());
+    }
+
+    if (!meta.success) {
+        if (jCoverPath) env->DeleteLocalRef(jCoverPath);
+        return nullptr;
+    }
+
+    jobject jTracks = env->NewObject(gClsList, gCtorList);
+
+    for (const auto &t: meta.tracks) {
+        env->PushLocalFrame(32);
+
+        jstring ti = safeNewStringUTF(env, t.title.c_str());
+        jstring ar = safeNewStringUTF(env, t.artist.c_str());
+        jstring al = safeNewStringUTF(env, t.album.c_str());
+        jstring ge = t.genre.empty() ? nullptr : safeNewStringUTF(env, t.genre.c_str());
+        jstring pa = safeNewStringUTF(env, t.path.c_str());
+        jstring fmt = t.format.empty() ? nullptr : safeNewStringUTF(env, t.format.c_str());
+
+        jobject item = env->NewObject(gClsTrack, gCtorTrack,
+                                      t.trackId, ti, ar, al, ge, pa,
+                                      (long) t.startMs, (long) t.endMs, (long) t.durationMs,
+                                      fmt, t.sampleRate, t.channels, t.bitDepth, (long) t.bitRate, t.sacdArea,
+                                      t.trackGainDb, t.trackPeak, t.albumGainDb, t.albumPeak
+        );
+
+        env->CallBooleanMethod(jTracks, gListAdd, item);
+        env->PopLocalFrame(nullptr);
+    }
+
+    jstring jUri = safeNewStringUTF(env, meta.uri.c_str());
+    jstring jAlb = safeNewStringUTF(env, meta.albumTitle.c_str());
+    jstring jArt = safeNewStringUTF(env, meta.albumArtist.c_str());
+    jstring jGen = meta.genre.empty() ? nullptr : safeNewStringUTF(env, meta.genre.c_str());
+    jstring jDat = meta.date.empty() ? nullptr : safeNewStringUTF(env, meta.date.c_str());
+    jstring jLyr = meta.lyrics.empty() ? nullptr : safeNewStringUTF(env, meta.lyrics.c_str());
+
+    jobject result = env->NewObject(gClsMeta, gCtorMeta,
+                                    jUri, jAlb, jArt, jGen, jDat, jCoverPath, jTracks, jLyr
+    );
+
+    if (jCoverPath) env->DeleteLocalRef(jCoverPath);
+
+    return result;
+}
+
+static std::string toStdString(JNIEnv *env, jstring jStr) {
+    std::string result;
+    if (!jStr) return result;
+    const char *chars = env->GetStringUTFChars(jStr, nullptr);
+    if (chars) {
+        result = chars;
+        env->ReleaseStringUTFChars(jStr, chars);
+    }
+    return result;
+}
+
 static jobject
 nativeProbe(JNIEnv *env, jobject thiz, jstring jPath, jobject jHeaders, jstring jFilename,
-            jstring jAudioSourceUrl) {
+            jstring jAudioSourceUrl, jstring jValidator) {
     const char *path = nullptr;
     if (jPath) {
         path = env->GetStringUTFChars(jPath, nullptr);
@@ -39,7 +125,8 @@ nativeProbe(JNIEnv *env, jobject thiz, jstring jPath, jobject jHeaders, jstring
     }
 
     // 解析并返回元数据
-    InternalMetadata meta = AudioProbe::probe(env, path, headers, strFilename, strAudioUrl);
+    InternalMetadata meta = AudioProbe::probe(path, headers, strFilename, strAudioUrl,
+                                              toStdString(env, jValidator));
 
     // === 释放字符串资源 (修复部分) ===
 
@@ -60,77 +147,449 @@ nativeProbe(JNIEnv *env, jobject thiz, jstring jPath, jobject jHeaders, jstring
 
     // === 结束释放 ===
 
-    // 解析结果处理
-    jstring jCoverPath = nullptr;
-    if (!meta.coverData.empty()) {
-        std::string savedPath = ProbeUtils::saveCoverAuto(meta.uri, meta.coverData);
-        if (!savedPath.empty()) {
-            jCoverPath = safeNewStringUTF(env, savedPath.c_str());
+    return toJavaMetadata(env, meta);
+}
+
+static jint
+nativeProbeBatch(JNIEnv *env, jobject thiz, jobjectArray jSources, jobjectArray jFilenames,
+                 jobjectArray jValidators, jobject jHeaders, jint localThreads,
+                 jint networkThreads, jobject jCallback, jlongArray jStats) {
+    if (!jSources || !jCallback || !gVm) return 0;
+
+    std::vector<BatchProbe::Request> requests;
+    jsize count = env->GetArrayLength(jSources);
+    jsize nameCount = jFilenames ? env->GetArrayLength(jFilenames) : 0;
+    jsize validatorCount = jValidators ? env->GetArrayLength(jValidators) : 0;
+    requests.resize(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto jSrc = (jstring) env->GetObjectArrayElement(jSources, i);
+        if (jSrc) {
+            const char *src = env->GetStringUTFChars(jSrc, nullptr);
+            if (src) {
+                requests[i].source = src;
+                env->ReleaseStringUTFChars(jSrc, src);
+            }
+            env->DeleteLocalRef(jSrc);
+        }
+        if (i < nameCount) {
+            auto jName = (jstring) env->GetObjectArrayElement(jFilenames, i);
+            if (jName) {
+                const char *name = env->GetStringUTFChars(jName, nullptr);
+                if (name) {
+                    requests[i].filename = name;
+                    env->ReleaseStringUTFChars(jName, name);
+                }
+                env->DeleteLocalRef(jName);
+            }
+        }
+        if (i < validatorCount) {
+            auto jValidator = (jstring) env->GetObjectArrayElement(jValidators, i);
+            requests[i].validator = toStdString(env, jValidator);
+            if (jValidator) env->DeleteLocalRef(jValidator);
         }
     }
+    auto headers = jmapToStdMap(env, jHeaders);
 
-    if (!meta.success) return nullptr;
+    // 回调在工作线程中执行，需要全局引用
+    jobject callback = env->NewGlobalRef(jCallback);
+    jclass cbClass = env->GetObjectClass(jCallback);
+    jmethodID onResult = env->GetMethodID(cbClass, "onResult",
+                                          "(ILjava/lang/String;Lcom/qytech/audioplayer/parser/model/AudioMetadata;)Z");
+    env->DeleteLocalRef(cbClass);
+    if (!onResult) {
+        env->DeleteGlobalRef(callback);
+        return 0;
+    }
 
-    jclass clsMeta = env->FindClass("com/qytech/audioplayer/parser/model/AudioMetadata");
-    jclass clsTrack = env->FindClass("com/qytech/audioplayer/parser/model/AudioTrackItem");
-    jclass clsList = env->FindClass("java/util/ArrayList");
+    BatchProbe::Stats stats;
+    int completed = BatchProbe::run(
+            gVm, requests, headers, localThreads, networkThreads,
+            [&](JNIEnv *workerEnv, int index, InternalMetadata &meta) -> bool {
+                workerEnv->PushLocalFrame(64);
+                jobject result = toJavaMetadata(workerEnv, meta);
+                jstring jSource = safeNewStringUTF(workerEnv, requests[index].source.c_str());
+                jboolean keepGoing = workerEnv->CallBooleanMethod(callback, onResult, index,
+                                                                  jSource, result);
+                if (workerEnv->ExceptionCheck()) {
+                    workerEnv->ExceptionDescribe();
+                    workerEnv->ExceptionClear();
+                    keepGoing = JNI_FALSE;
+                }
+                workerEnv->PopLocalFrame(nullptr);
+                return keepGoing == JNI_TRUE;
+            }, &stats);
 
-    jmethodID ctorMeta = env->GetMethodID(clsMeta, "<init>",
-                                          "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/util/List;Ljava/lang/String;)V");
-    jmethodID ctorTrack = env->GetMethodID(clsTrack, "<init>",
-                                           "(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JJJLjava/lang/String;IIIJ)V");
-    jmethodID ctorList = env->GetMethodID(clsList, "<init>", "()V");
-    jmethodID listAdd = env->GetMethodID(clsList, "add", "(Ljava/lang/Object;)Z");
+    env->DeleteGlobalRef(callback);
+    if (jStats && env->GetArrayLength(jStats) >= BatchProbe::STATS_SIZE) {
+        jlong values[BatchProbe::STATS_SIZE] = {stats.total, stats.delivered, stats.elapsedMs,
+                                                stats.workMs, stats.cancelled};
+        env->SetLongArrayRegion(jStats, 0, BatchProbe::STATS_SIZE, values);
+    }
+    return completed;
+}
 
-    jobject jTracks = env->NewObject(clsList, ctorList);
+static void nativeCancelBatch(JNIEnv *env, jobject thiz) {
+    BatchProbe::cancelAll();
+}
 
-    for (const auto &t: meta.tracks) {
-        env->PushLocalFrame(32);
+// 扫描统计快照，布局见 ScanStats.h
+static jboolean nativeGetScanStats(JNIEnv *env, jobject thiz, jlongArray out) {
+    if (!out || env->GetArrayLength(out) < ScanStats::SNAPSHOT_SIZE) return JNI_FALSE;
+    int64_t buf[ScanStats::SNAPSHOT_SIZE];
+    ScanStats::snapshot(buf);
+    env->SetLongArrayRegion(out, 0, ScanStats::SNAPSHOT_SIZE, reinterpret_cast<const jlong *>(buf));
+    return JNI_TRUE;
+}
 
-        jstring ti = safeNewStringUTF(env, t.title.c_str());
-        jstring ar = safeNewStringUTF(env, t.artist.c_str());
-        jstring al = safeNewStringUTF(env, t.album.c_str());
-        jstring ge = t.genre.empty() ? nullptr : safeNewStringUTF(env, t.genre.c_str());
-        jstring pa = safeNewStringUTF(env, t.path.c_str());
-        jstring fmt = t.format.empty() ? nullptr : safeNewStringUTF(env, t.format.c_str());
+static void nativeResetScanStats(JNIEnv *env, jobject thiz) {
+    ScanStats::reset();
+}
 
-        jobject item = env->NewObject(clsTrack, ctorTrack,
-                                      t.trackId, ti, ar, al, ge, pa,
-                                      (long) t.startMs, (long) t.endMs, (long) t.durationMs,
-                                      fmt, t.sampleRate, t.channels, t.bitDepth, (long) t.bitRate
-        );
+// 本地文件只读标签；网络地址或 TagReader 不支持的格式回退到完整探测
+static InternalMetadata readTags(JNIEnv *env, const std::string &source,
+                                 const std::map<std::string, std::string> &headers) {
+    if (!BatchProbe::isNetworkSource(source)) {
+        std::string path = source.compare(0, 7, "file://") == 0 ? source.substr(7) : source;
+        InternalMetadata meta = TagReader::read(path);
+        if (meta.success) {
+            meta.uri = source;
+            return meta;
+        }
+    }
+    return AudioProbe::probe(source, headers, "", "");
+}
 
-        env->CallBooleanMethod(jTracks, listAdd, item);
-        env->PopLocalFrame(nullptr);
+static jobject nativeReadTags(JNIEnv *env, jobject thiz, jstring jSource, jobject jHeaders) {
+    std::string source = toStdString(env, jSource);
+    if (source.empty()) return nullptr;
+    return toJavaMetadata(env, readTags(env, source, jmapToStdMap(env, jHeaders)));
+}
+
+static jint
+nativeReadTagsBatch(JNIEnv *env, jobject thiz, jobjectArray jSources, jobject jHeaders,
+                    jint localThreads, jint networkThreads, jobject jCallback) {
+    if (!jSources || !jCallback || !gVm) return 0;
+
+    jsize count = env->GetArrayLength(jSources);
+    std::vector<std::string> sources(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto jSrc = (jstring) env->GetObjectArrayElement(jSources, i);
+        sources[i] = toStdString(env, jSrc);
+        if (jSrc) env->DeleteLocalRef(jSrc);
     }
+    auto headers = jmapToStdMap(env, jHeaders);
 
-    jstring jUri = safeNewStringUTF(env, meta.uri.c_str());
-    jstring jAlb = safeNewStringUTF(env, meta.albumTitle.c_str());
-    jstring jArt = safeNewStringUTF(env, meta.albumArtist.c_str());
-    jstring jGen = meta.genre.empty() ? nullptr : safeNewStringUTF(env, meta.genre.c_str());
-    jstring jDat = meta.date.empty() ? nullptr : safeNewStringUTF(env, meta.date.c_str());
-    jstring jLyr = meta.lyrics.empty() ? nullptr : safeNewStringUTF(env, meta.lyrics.c_str());
+    jobject callback = env->NewGlobalRef(jCallback);
+    jclass cbClass = env->GetObjectClass(jCallback);
+    jmethodID onResult = env->GetMethodID(cbClass, "onResult",
+                                          "(ILjava/lang/String;Lcom/qytech/audioplayer/parser/model/AudioMetadata;)Z");
+    env->DeleteLocalRef(cbClass);
+    if (!onResult) {
+        env->DeleteGlobalRef(callback);
+        return 0;
+    }
 
-    jobject result = env->NewObject(clsMeta, ctorMeta,
-                                    jUri, jAlb, jArt, jGen, jDat, jCoverPath, jTracks, jLyr
-    );
+    std::vector<InternalMetadata> results(count);
+    int completed = BatchProbe::forEach(
+            gVm, sources, localThreads, networkThreads, "Tags",
+            [&](JNIEnv *workerEnv, int index) {
+                results[index] = readTags(workerEnv, sources[index], headers);
+            },
+            [&](JNIEnv *workerEnv, int index) -> bool {
+                workerEnv->PushLocalFrame(64);
+                jobject result = toJavaMetadata(workerEnv, results[index]);
+                jstring jSource = safeNewStringUTF(workerEnv, sources[index].c_str());
+                jboolean keepGoing = workerEnv->CallBooleanMethod(callback, onResult, index,
+                                                                  jSource, result);
+                if (workerEnv->ExceptionCheck()) {
+                    workerEnv->ExceptionDescribe();
+                    workerEnv->ExceptionClear();
+                    keepGoing = JNI_FALSE;
+                }
+                workerEnv->PopLocalFrame(nullptr);
+                results[index] = InternalMetadata();
+                return keepGoing == JNI_TRUE;
+            });
 
-    if (jCoverPath) env->DeleteLocalRef(jCoverPath);
+    env->DeleteGlobalRef(callback);
+    return completed;
+}
 
-    return result;
+static jboolean nativeSetCacheDir(JNIEnv *env, jobject thiz, jstring jDir, jint maxEntries) {
+    std::string dir = toStdString(env, jDir);
+    if (dir.empty()) {
+        ProbeCache::close();
+        return JNI_FALSE;
+    }
+    return ProbeCache::open(dir, maxEntries) ? JNI_TRUE : JNI_FALSE;
+}
+
+static void nativeClearCache(JNIEnv *env, jobject thiz) {
+    ProbeCache::clear();
+}
+
+static void nativeSetCoverOptions(JNIEnv *env, jobject thiz, jstring jDir, jint thumbnailSize) {
+    CoverStore::configure(toStdString(env, jDir), thumbnailSize);
+}
+
+static jstring nativeGetThumbnailPath(JNIEnv *env, jobject thiz, jstring jCoverPath) {
+    std::string path = CoverStore::thumbnailPath(toStdString(env, jCoverPath));
+    return path.empty() ? nullptr : safeNewStringUTF(env, path.c_str());
+}
+
+static jobject toJavaFingerprint(JNIEnv *env, const FingerprintResult &fp) {
+    if (!fp.success) return nullptr;
+    jstring jFp = safeNewStringUTF(env, fp.fingerprint.c_str());
+    jobject obj = env->NewObject(gClsFingerprint, gCtorFingerprint, jFp, (jlong) fp.durationMs);
+    env->DeleteLocalRef(jFp);
+    return obj;
+}
+
+static jobject
+nativeFingerprint(JNIEnv *env, jobject thiz, jstring jSource, jobject jHeaders, jint maxSeconds,
+                  jstring jValidator) {
+    std::string source = toStdString(env, jSource);
+    if (source.empty()) return nullptr;
+    FingerprintResult fp = Fingerprinter::compute(source, jmapToStdMap(env, jHeaders), maxSeconds,
+                                                  toStdString(env, jValidator));
+    return toJavaFingerprint(env, fp);
+}
+
+static jint
+nativeFingerprintBatch(JNIEnv *env, jobject thiz, jobjectArray jSources, jobjectArray jValidators,
+                       jobject jHeaders, jint maxSeconds, jint localThreads, jint networkThreads,
+                       jobject jCallback) {
+    if (!jSources || !jCallback || !gVm) return 0;
+
+    jsize count = env->GetArrayLength(jSources);
+    jsize validatorCount = jValidators ? env->GetArrayLength(jValidators) : 0;
+    std::vector<std::string> sources(count);
+    std::vector<std::string> validators(count);
+    for (jsize i = 0; i < count; ++i) {
+        auto jSrc = (jstring) env->GetObjectArrayElement(jSources, i);
+        sources[i] = toStdString(env, jSrc);
+        if (jSrc) env->DeleteLocalRef(jSrc);
+        if (i < validatorCount) {
+            auto jValidator = (jstring) env->GetObjectArrayElement(jValidators, i);
+            validators[i] = toStdString(env, jValidator);
+            if (jValidator) env->DeleteLocalRef(jValidator);
+        }
+    }
+    auto headers = jmapToStdMap(env, jHeaders);
+    static const std::map<std::string, std::string> kNoHeaders;
+
+    jobject callback = env->NewGlobalRef(jCallback);
+    jclass cbClass = env->GetObjectClass(jCallback);
+    jmethodID onResult = env->GetMethodID(cbClass, "onResult",
+                                          "(ILjava/lang/String;Lcom/qytech/audioplayer/parser/model/AudioFingerprint;)Z");
+    env->DeleteLocalRef(cbClass);
+    if (!onResult) {
+        env->DeleteGlobalRef(callback);
+        return 0;
+    }
+
+    std::vector<FingerprintResult> results(count);
+    int completed = BatchProbe::forEach(
+            gVm, sources, localThreads, networkThreads, "Fp",
+            [&](JNIEnv *workerEnv, int index) {
+                bool network = BatchProbe::isNetworkSource(sources[index]);
+                results[index] = Fingerprinter::compute(sources[index],
+                                                        network ? headers : kNoHeaders,
+                                                        maxSeconds, validators[index]);
+            },
+            [&](JNIEnv *workerEnv, int index) -> bool {
+                workerEnv->PushLocalFrame(16);
+                jobject result = toJavaFingerprint(workerEnv, results[index]);
+                jstring jSource = safeNewStringUTF(workerEnv, sources[index].c_str());
+                jboolean keepGoing = workerEnv->CallBooleanMethod(callback, onResult, index,
+                                                                  jSource, result);
+                if (workerEnv->ExceptionCheck()) {
+                    workerEnv->ExceptionDescribe();
+                    workerEnv->ExceptionClear();
+                    keepGoing = JNI_FALSE;
+                }
+                workerEnv->PopLocalFrame(nullptr);
+                results[index] = FingerprintResult();
+                return keepGoing == JNI_TRUE;
+            }, true);
+
+    env->DeleteGlobalRef(callback);
+    return completed;
+}
+
+static jobject toJavaLoudness(JNIEnv *env, const LoudnessResult &r) {
+    if (!r.success) return nullptr;
+    return env->NewObject(gClsLoudness, gCtorLoudness,
+                          (jfloat) r.integratedLufs, (jfloat) r.truePeak,
+                          (jfloat) LoudnessAnalyzer::gainDb(r.integratedLufs),
+                          (jfloat) (r.hasAlbum ? LoudnessAnalyzer::gainDb(r.albumLufs) : NAN),
+                          (jfloat) (r.hasAlbum ? r.albumPeak : NAN));
+}
+
+static jobject
+nativeAnalyzeLoudness(JNIEnv *env, jobject thiz, jstring jSource, jobject jHeaders, jlong startMs,
+                      jlong endMs, jstring jValidator) {
+    std::string source = toStdString(env, jSource);
+    if (source.empty()) return nullptr;
+    LoudnessResult r = LoudnessAnalyzer::analyze(source, jmapToStdMap(env, jHeaders), startMs, endMs,
+                                                 toStdString(env, jValidator));
+    return toJavaLoudness(env, r);
+}
+
+static jint
+nativeAnalyzeLoudnessBatch(JNIEnv *env, jobject thiz, jobjectArray jSources, jlongArray jStartMs,
+                           jlongArray jEndMs, jobjectArray jAlbumKeys, jobjectArray jValidators,
+                           jobject jHeaders, jint localThreads, jint networkThreads,
+                           jobject jCallback) {
+    if (!jSources || !jCallback || !gVm) return 0;
+
+    jsize count = env->GetArrayLength(jSources);
+    std::vector<std::string> sources(count), albumKeys(count), validators(count);
+    std::vector<int64_t> startMs(count, 0), endMs(count, 0);
+    jsize albumCount = jAlbumKeys ? env->GetArrayLength(jAlbumKeys) : 0;
+    jsize validatorCount = jValidators ? env->GetArrayLength(jValidators) : 0;
+    for (jsize i = 0; i < count; ++i) {
+        auto jSrc = (jstring) env->GetObjectArrayElement(jSources, i);
+        sources[i] = toStdString(env, jSrc);
+        if (jSrc) env->DeleteLocalRef(jSrc);
+        if (i < albumCount) {
+            auto jKey = (jstring) env->GetObjectArrayElement(jAlbumKeys, i);
+            albumKeys[i] = toStdString(env, jKey);
+            if (jKey) env->DeleteLocalRef(jKey);
+        }
+        if (i < validatorCount) {
+            auto jValidator = (jstring) env->GetObjectArrayElement(jValidators, i);
+            validators[i] = toStdString(env, jValidator);
+            if (jValidator) env->DeleteLocalRef(jValidator);
+        }
+    }
+    if (jStartMs && env->GetArrayLength(jStartMs) >= count) {
+        env->GetLongArrayRegion(jStartMs, 0, count, (jlong *) startMs.data());
+    }
+    if (jEndMs && env->GetArrayLength(jEndMs) >= count) {
+        env->GetLongArrayRegion(jEndMs, 0, count, (jlong *) endMs.data());
+    }
+    auto headers = jmapToStdMap(env, jHeaders);
+    static const std::map<std::string, std::string> kNoHeaders;
+
+    jclass cbClass = env->GetObjectClass(jCallback);
+    jmethodID onResult = env->GetMethodID(cbClass, "onResult",
+                                          "(ILjava/lang/String;Lcom/qytech/audioplayer/parser/model/LoudnessInfo;)Z");
+    env->DeleteLocalRef(cbClass);
+    if (!onResult) return 0;
+
+    // 专辑增益需要整张专辑的结果，全部分析完成后再在调用线程中依次回调
+    std::vector<LoudnessResult> results(count);
+    int completed = BatchProbe::forEach(
+            gVm, sources, localThreads, networkThreads, "Lufs",
+            [&](JNIEnv *workerEnv, int index) {
+                bool network = BatchProbe::isNetworkSource(sources[index]);
+                results[index] = LoudnessAnalyzer::analyze(sources[index],
+                                                           network ? headers : kNoHeaders,
+                                                           startMs[index], endMs[index],
+                                                           validators[index]);
+            },
+            [](JNIEnv *workerEnv, int index) { return true; },
+            true);
+
+    std::map<std::string, std::vector<int>> albums;
+    for (int i = 0; i < count; ++i) {
+        if (!albumKeys[i].empty()) albums[albumKeys[i]].push_back(i);
+    }
+    for (const auto &album: albums) {
+        std::vector<LoudnessResult *> tracks;
+        std::vector<std::string> albumSources, albumValidators;
+        std::vector<int64_t> albumStart, albumEnd;
+        for (int i: album.second) {
+            tracks.push_back(&results[i]);
+            albumSources.push_back(sources[i]);
+            albumValidators.push_back(validators[i]);
+            albumStart.push_back(startMs[i]);
+            albumEnd.push_back(endMs[i]);
+        }
+        LoudnessAnalyzer::applyAlbum(tracks, albumSources, albumStart, albumEnd, albumValidators);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        env->PushLocalFrame(16);
+        jobject result = toJavaLoudness(env, results[i]);
+        jstring jSource = safeNewStringUTF(env, sources[i].c_str());
+        jboolean keepGoing = env->CallBooleanMethod(jCallback, onResult, i, jSource, result);
+        if (env->ExceptionCheck()) {
+            env->ExceptionDescribe();
+            env->ExceptionClear();
+            keepGoing = JNI_FALSE;
+        }
+        env->PopLocalFrame(nullptr);
+        if (keepGoing != JNI_TRUE) break;
+    }
+    return completed;
 }
 
 static const JNINativeMethod gMethods[] = {
         {"nativeProbe",
-         "(Ljava/lang/String;Ljava/util/Map;Ljava/lang/String;Ljava/lang/String;)Lcom/qytech/audioplayer/parser/model/AudioMetadata;",
-         (void *) nativeProbe}
+         "(Ljava/lang/String;Ljava/util/Map;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;)Lcom/qytech/audioplayer/parser/model/AudioMetadata;",
+         (void *) nativeProbe},
+        {"nativeProbeBatch",
+         "([Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;Ljava/util/Map;IILcom/qytech/audioplayer/parser/ProbeBatchCallback;[J)I",
+         (void *) nativeProbeBatch},
+        {"nativeCancelBatch", "()V", (void *) nativeCancelBatch},
+        {"nativeGetScanStats", "([J)Z", (void *) nativeGetScanStats},
+        {"nativeResetScanStats", "()V", (void *) nativeResetScanStats},
+        {"nativeReadTags",
+         "(Ljava/lang/String;Ljava/util/Map;)Lcom/qytech/audioplayer/parser/model/AudioMetadata;",
+         (void *) nativeReadTags},
+        {"nativeReadTagsBatch",
+         "([Ljava/lang/String;Ljava/util/Map;IILcom/qytech/audioplayer/parser/ProbeBatchCallback;)I",
+         (void *) nativeReadTagsBatch},
+        {"nativeSetCacheDir", "(Ljava/lang/String;I)Z", (void *) nativeSetCacheDir},
+        {"nativeClearCache",  "()V",                    (void *) nativeClearCache},
+        {"nativeSetCoverOptions", "(Ljava/lang/String;I)V", (void *) nativeSetCoverOptions},
+        {"nativeGetThumbnailPath", "(Ljava/lang/String;)Ljava/lang/String;",
+         (void *) nativeGetThumbnailPath},
+        {"nativeFingerprint",
+         "(Ljava/lang/String;Ljava/util/Map;ILjava/lang/String;)Lcom/qytech/audioplayer/parser/model/AudioFingerprint;",
+         (void *) nativeFingerprint},
+        {"nativeFingerprintBatch",
+         "([Ljava/lang/String;[Ljava/lang/String;Ljava/util/Map;IIILcom/qytech/audioplayer/parser/FingerprintBatchCallback;)I",
+         (void *) nativeFingerprintBatch},
+        {"nativeAnalyzeLoudness",
+         "(Ljava/lang/String;Ljava/util/Map;JJLjava/lang/String;)Lcom/qytech/audioplayer/parser/model/LoudnessInfo;",
+         (void *) nativeAnalyzeLoudness},
+        {"nativeAnalyzeLoudnessBatch",
+         "([Ljava/lang/String;[J[J[Ljava/lang/String;[Ljava/lang/String;Ljava/util/Map;IILcom/qytech/audioplayer/parser/LoudnessBatchCallback;)I",
+         (void *) nativeAnalyzeLoudnessBatch}
 };
 
+static jclass newGlobalClass(JNIEnv *env, const char *name) {
+    jclass local = env->FindClass(name);
+    if (!local) return nullptr;
+    auto global = (jclass) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
 int register_audioprobe_methods(JavaVM *vm, JNIEnv *env) {
     jclass clazz = env->FindClass("com/qytech/audioplayer/parser/AudioProbe");
     if (!clazz) return JNI_ERR;
     if (env->RegisterNatives(clazz, gMethods, sizeof(gMethods) / sizeof(gMethods[0])) < 0) {
         return JNI_ERR;
     }
+
+    gVm = vm;
+    gClsMeta = newGlobalClass(env, "com/qytech/audioplayer/parser/model/AudioMetadata");
+    gClsTrack = newGlobalClass(env, "com/qytech/audioplayer/parser/model/AudioTrackItem");
+    gClsList = newGlobalClass(env, "java/util/ArrayList");
+    gClsFingerprint = newGlobalClass(env, "com/qytech/audioplayer/parser/model/AudioFingerprint");
+    gClsLoudness = newGlobalClass(env, "com/qytech/audioplayer/parser/model/LoudnessInfo");
+    if (!gClsMeta || !gClsTrack || !gClsList || !gClsFingerprint || !gClsLoudness) return JNI_ERR;
+    gCtorMeta = env->GetMethodID(gClsMeta, "<init>",
+                                 "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/util/List;Ljava/lang/String;)V");
+    gCtorTrack = env->GetMethodID(gClsTrack, "<init>",
+                                  "(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JJJLjava/lang/String;IIIJIFFFF)V");
+    gCtorList = env->GetMethodID(gClsList, "<init>", "()V");
+    gListAdd = env->GetMethodID(gClsList, "add", "(Ljava/lang/Object;)Z");
+    gCtorFingerprint = env->GetMethodID(gClsFingerprint, "<init>", "(Ljava/lang/String;J)V");
+    gCtorLoudness = env->GetMethodID(gClsLoudness, "<init>", "(FFFFF)V");
     return JNI_OK;
 }
\ No newline at end of file
@@ -50,7 +50,7 @@ char* charset_convert(const char *string, size_t insize, const char *from, const
 	if ((cd = iconv_open(to, from)) == (iconv_t)-1)
 	{
 		//LOGD("convert_string(): Conversion not supported. " "Charsets: %s -> %s", from, to);
-		return strdup(string);
+		return strndup(string, insize);
 	}
 
 	/* Due to a GLIBC bug, round outbuf_size up to a multiple of 4 */
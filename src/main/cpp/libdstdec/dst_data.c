@@ -153,7 +153,8 @@ int DeleteBuffer(StrData* SD)
 
   if (SD->pDSTdata != NULL)
   {
-    hr = -1;
+    free( SD->pDSTdata );
+    SD->pDSTdata = NULL;
   }
 
   ResetReadingIndex(SD);
@@ -377,11 +378,12 @@ int getbits(StrData* SD, long *outword, int out_bitptr)
     {
         if (SD->BitPosition == 0)
         {
-            SD->DataByte = SD->pDSTdata[SD->ByteCounter++];
-            if (SD->ByteCounter > SD->TotalBytes)
+            /* check before reading: the buffer holds exactly TotalBytes */
+            if (SD->ByteCounter >= SD->TotalBytes)
             {
                 return (-1); /* EOF */
             }
+            SD->DataByte = SD->pDSTdata[SD->ByteCounter++];
             SD->BitPosition = 8;
         }
 
@@ -398,11 +400,11 @@ int getbits(StrData* SD, long *outword, int out_bitptr)
 
         if (!SD->BitPosition)
         {
-            SD->DataByte = SD->pDSTdata[SD->ByteCounter++];
-            if (SD->ByteCounter > SD->TotalBytes)
+            if (SD->ByteCounter >= SD->TotalBytes)
             {
                 return (-1); /* EOF */
             }
+            SD->DataByte = SD->pDSTdata[SD->ByteCounter++];
             SD->BitPosition = 8;
         }
 
@@ -414,7 +416,7 @@ int getbits(StrData* SD, long *outword, int out_bitptr)
         if (shift <= 0)
             *outword |= ((SD->DataByte & mask) >> -shift);
         else
-            *outword |= ((SD->DataByte & mask) << shift);
+            *outword |= ((unsigned long) (SD->DataByte & mask) << shift);
 
         out_bitptr -= thisbits;
         SD->BitPosition -= thisbits;
@@ -61,6 +61,7 @@
 
 #include "dst_decoder.h"
 #include "yarn.h"
+#include "Trace.h"
 #include "buffer_pool.h"
 #include "dst_fram.h"
 #include "dst_init.h"
@@ -68,6 +69,14 @@
 
 /* -- parallel decoding -- */
 
+#define DST_BUFFER_SIZE (64 * 1024)
+#define DST_DEFAULT_PROCS 1
+#define DST_MAX_PROCS 8
+
+/* spaces per pool: two jobs per decode thread plus the one being filled and
+   the one being written */
+#define DST_POOL_LIMIT(procs) (((procs) << 1) + 2)
+
 /* decode or write job (passed from decode list to write list) -- if seq is
    equal to -1, decode_thread is instructed to return; if more is false then
    this is the last chunk, which after writing tells write_thread to return */
@@ -139,9 +148,11 @@ static void setup_decoding_jobs(dst_decoder_t *dst_decoder)
     dst_decoder->write_first = new_lock(-1);
     dst_decoder->write_head = NULL;
 
-    /* initialize buffer pools */
-    buffer_pool_create(&dst_decoder->in_pool, 64 * 1024, (dst_decoder->procs << 1) + 2);
-    buffer_pool_create(&dst_decoder->out_pool, 64 * 1024, -1);
+    /* initialize buffer pools -- both are bounded, output spaces are taken in
+       sequence order by dst_decoder_decode() so the write thread can always
+       drain them */
+    buffer_pool_create(&dst_decoder->in_pool, DST_BUFFER_SIZE, DST_POOL_LIMIT(dst_decoder->procs));
+    buffer_pool_create(&dst_decoder->out_pool, DST_BUFFER_SIZE, DST_POOL_LIMIT(dst_decoder->procs));
 }
 
 /* command the decode threads to all return, then join them all (call from
@@ -192,6 +203,7 @@ static void decode_thread(void *userdata)
     ebunch      D;
     dst_decoder_t *dst_decoder = (dst_decoder_t *) userdata;
 
+    qy_set_thread_name("dstDecode");
     if (DST_InitDecoder(&D, dst_decoder->channel_count, 64) != 0)
     {
         pthread_exit(0);
@@ -216,15 +228,14 @@ static void decode_thread(void *userdata)
 
         if (job->more)
         {
-            job->out = buffer_pool_get_space(&dst_decoder->out_pool);
-
             /* Save the error for later, so that the write_thread can output them in DST frame order */
+            QY_TRACE_BEGIN("dstFrame");
             job->error = DST_FramDSTDecode(job->in->buf, job->out->buf, job->in->len, job->seq, &D); 
+            QY_TRACE_END();
             if (job->error != DSTErr_NoError)
                 LOGD("ERROR: %s on frame: %d", DST_GetErrorMessage(job->error), D.FrameHdr.FrameNr);
 
             job->out->len = (size_t)(MAX_DSDBITS_INFRAME / 8 * dst_decoder->channel_count);
-            dst_decoder->frame_decoded_callback(job->out->buf, job->out->len, dst_decoder->userdata);
             buffer_pool_drop_space(job->in);
 
         }
@@ -264,6 +275,8 @@ static void write_thread(void *userdata)
     int more;                       /* true if more chunks to write */
     dst_decoder_t *dst_decoder = (dst_decoder_t *) userdata;
 
+    qy_set_thread_name("dstWrite");
+
     /* build and write header */
     //LOGD("-- write thread running\n");
 
@@ -286,8 +299,9 @@ static void write_thread(void *userdata)
 
         if (more)
         {
-            /* write the decoded data and drop the output buffer */
-            //dst_decoder->frame_decoded_callback(job->out->buf, job->out->len, dst_decoder->userdata);
+            /* deliver the decoded data in sequence order (decode threads may
+               finish out of order) and drop the output buffer */
+            dst_decoder->frame_decoded_callback(job->out->buf, job->out->len, dst_decoder->userdata);
             buffer_pool_drop_space(job->out);
         }
 
@@ -341,7 +355,14 @@ static void finish_write_job(dst_decoder_t *dst_decoder)
     dst_decoder->writeth = NULL;
 }
 
-dst_decoder_t* dst_decoder_create(int channel_count, frame_decoded_callback_t frame_decoded_callback, frame_error_callback_t frame_error_callback, void *userdata)
+static int clamp_procs(int procs)
+{
+    if (procs <= 0)
+        return DST_DEFAULT_PROCS;
+    return procs > DST_MAX_PROCS ? DST_MAX_PROCS : procs;
+}
+
+dst_decoder_t* dst_decoder_create(int channel_count, int procs, frame_decoded_callback_t frame_decoded_callback, frame_error_callback_t frame_error_callback, void *userdata)
 {
     dst_decoder_t *dst_decoder = (dst_decoder_t*) calloc(sizeof(dst_decoder_t), 1);
 
@@ -354,8 +375,7 @@ dst_decoder_t* dst_decoder_create(int channel_count, frame_decoded_callback_t fr
     dst_decoder->userdata = userdata;
     dst_decoder->frame_decoded_callback = frame_decoded_callback;
     dst_decoder->frame_error_callback = frame_error_callback;
-    //dst_decoder->procs = processor_count();
-    dst_decoder->procs = 1;
+    dst_decoder->procs = clamp_procs(procs);
     LOGD("channel_count %d, procs %d", dst_decoder->channel_count, dst_decoder->procs);
 
     /* if first time or after an option change, setup the job lists */
@@ -388,7 +408,10 @@ void dst_decoder_decode(dst_decoder_t *dst_decoder, uint8_t* frame_data, size_t
     job->in = buffer_pool_get_space(&dst_decoder->in_pool);
     memcpy(job->in->buf, frame_data, frame_size);
     job->in->len = frame_size;
-    job->out = NULL;
+    /* take the output space here rather than in decode_thread: a decoder
+       blocked on a full output pool while holding an earlier sequence number
+       would stall the write thread that frees the pool */
+    job->out = buffer_pool_get_space(&dst_decoder->out_pool);
     job->more = 1;
 
     ++dst_decoder->sequence;
@@ -408,3 +431,11 @@ void dst_decoder_decode(dst_decoder_t *dst_decoder, uint8_t* frame_data, size_t
     dst_decoder->decode_tail = &(job->next);
     twist(dst_decoder->decode_have, BY, +1);
 }
+
+size_t dst_decoder_max_memory(int procs)
+{
+    /* per decode thread state, and the input and output pools at their limit */
+    procs = clamp_procs(procs);
+    return procs * sizeof(ebunch)
+           + 2 * (size_t) DST_POOL_LIMIT(procs) * DST_BUFFER_SIZE;
+}
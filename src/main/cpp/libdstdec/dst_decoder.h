@@ -28,9 +28,14 @@ typedef struct dst_decoder_s dst_decoder_t;
 typedef void (*frame_decoded_callback_t)(uint8_t* frame_data, size_t frame_size, void *userdata);
 typedef void (*frame_error_callback_t)(int frame_count, int frame_error_code, const char *frame_error_message, void *userdata);
 
-dst_decoder_t* dst_decoder_create(int channel_count, frame_decoded_callback_t frame_decoded_callback, frame_error_callback_t frame_error_callback, void *userdata);
+/* procs is the number of decode threads, <= 0 selects DST_DEFAULT_PROCS */
+dst_decoder_t* dst_decoder_create(int channel_count, int procs, frame_decoded_callback_t frame_decoded_callback, frame_error_callback_t frame_error_callback, void *userdata);
 void dst_decoder_destroy(dst_decoder_t *dst_decoder);
 void dst_decoder_decode(dst_decoder_t *dst_decoder, uint8_t* frame_data, size_t frame_size);
 
+/* upper bound of the memory a decoder with procs decode threads holds (buffer
+   pools and decode thread state), for memory accounting by the caller */
+size_t dst_decoder_max_memory(int procs);
+
 
 #endif /* DST_DECODER_H */
@@ -69,6 +69,7 @@ Changes:
 #endif
 #include "dst_init.h"
 #include "ccp_calc.h"
+#include "dst_data.h"
 #include "conststr.h"
 #include "types.h"
 
@@ -359,6 +360,8 @@ int DST_CloseDecoder(ebunch * D)
   int retval = 0;
   /* Free the memory that was used for the arrays */
   FreeDecMemory(D);
+  /* Free the copy of the last frame made by FillBuffer() */
+  DeleteBuffer(&D->S);
 
   return(retval);
 }
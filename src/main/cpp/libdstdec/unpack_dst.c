@@ -138,6 +138,10 @@ void ReadDSDframe(StrData      *S,
 /*                                                                         */
 /***************************************************************************/
 
+/* Returned at the end of the frame data: out of range for any filter
+   coefficient or Ptable entry, so the callers reject the frame */
+#define RICE_EOF (1 << 16)
+
 int RiceDecode(StrData* S, int m)
 {
   int LSBs;
@@ -146,11 +150,13 @@ int RiceDecode(StrData* S, int m)
   int RunLength;
   int Sign;
 
-  /* Retrieve run length code */
+  /* Retrieve run length code. Past the end of the frame getbits() yields
+     0 bits, so the run must stop there or it would only end on overflow */
   RunLength = 0;
   do
   {
-    FIO_BitGetIntUnsigned(S,1, &RLBit);
+    if (FIO_BitGetIntUnsigned(S,1, &RLBit))
+      return RICE_EOF;
     RunLength += (1-RLBit);
   } while (RLBit == 0);
 
@@ -673,6 +679,9 @@ int ReadFilterCoefSets(StrData     *SD,
         return DSTErr_NegativeBitAllocation;
 
       bestmethod = CF->BestMethod[FilterNr];
+      /* 2 bits in the stream, but only NROFFRICEMETHODS methods exist */
+      if (bestmethod >= NROFFRICEMETHODS)
+        return DSTErr_InvalidCoefficientCoding;
       if (CF->CPredOrder[bestmethod] >= FH->PredOrder[FilterNr])
         return DSTErr_InvalidCoefficientCoding;
 
@@ -772,6 +781,9 @@ int ReadProbabilityTables(StrData      *SD,
           return DSTErr_NegativeBitAllocation;
 
         bestmethod = CP->BestMethod[PtableNr];
+        /* 2 bits in the stream, but only NROFPRICEMETHODS methods exist */
+        if (bestmethod >= NROFPRICEMETHODS)
+          return DSTErr_InvalidPtableCoding;
         if (CP->CPredOrder[bestmethod] >= FH->PtableLen[PtableNr])
           return DSTErr_InvalidPtableCoding;
 
@@ -88,8 +88,10 @@ static void *id3_read_mem(struct id3_tag *id3, void *buf, int size)
 	 */
 	if (buf != NULL)
 	{
-		if (size > ID3_FD_BUFSIZE)
-			return NULL;
+		/*
+		 * The caller owns `buf', so there is no need to apply the
+		 * ID3_FD_BUFSIZE limit of the fd/fp readers here.
+		 */
 		memcpy(buf, id3->s.me.id3_ptr, size);
 	}
 
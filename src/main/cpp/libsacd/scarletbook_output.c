@@ -29,13 +29,12 @@
 #include <assert.h>
 #include <pthread.h>
 #include <sys/atomic.h>
-#include <signal.h>
+#include <time.h>
 
 #include <charset.h>
 #include <utils.h>
 #include "Logger.h"
-#include <jni.h>
-#include "Logger.h"
+#include "Trace.h"
 
 #include "scarletbook_output.h"
 #include "scarletbook_read.h"
@@ -96,6 +95,9 @@ struct scarletbook_output_s {
     void *playback_context;
     playback_audio_callback_t playback_audio_cb;
     playback_progress_callback_t playback_progress_cb;
+    playback_read_stats_callback_t playback_read_stats_cb;
+
+    int dst_procs;  // DST decode threads per track, <= 0 uses the decoder default
 
     scarletbook_handle_t *sb_handle;
 };
@@ -112,6 +114,12 @@ static scarletbook_format_handler_t const *find_output_format(char const *name)
     return NULL;
 }
 
+static inline int64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 static void destroy_ripping_queue(scarletbook_output_t *output) {
     struct list_head *node_ptr;
     scarletbook_output_format_t *output_format_ptr;
@@ -492,11 +500,18 @@ frame_error_callback(int frame_count, int frame_error_code, const char *frame_er
                      void *userdata) {
     scarletbook_output_format_t *ft = (scarletbook_output_format_t *) userdata;
 
-    wchar_t *wide_frame_error_mesage;
-    CHAR2WCHAR(wide_frame_error_mesage, frame_error_message);
-    //ft->cb_fwprintf(stderr, L"\n ERROR in dst_decoder: %s in frame: %d\n", wide_frame_error_mesage, frame_count); //frame_error_message
-    free(wide_frame_error_mesage);
-    LOGD("ERROR in dst_decoder: %s in frame: %d", frame_error_message, frame_count);
+    // a damaged stream fails on every frame: log the first error, then one per second of audio
+    if (ft->dst_error_count++ % SACD_FRAME_RATE == 0) {
+        LOGD("ERROR in dst_decoder: %s in frame: %d (%d frames rejected)", frame_error_message,
+             frame_count, ft->dst_error_count);
+    }
+}
+
+// write_block() failed: record it and let processing_thread() stop this track
+static void frame_write_failed(scarletbook_output_format_t *ft) {
+    LOGD("ERROR in frame_read_callback:write_block()...writting in file: %s  ", ft->filename);
+    ft->error_nr = -1;
+    snprintf(ft->error_str, sizeof(ft->error_str), "write_block() failed");
 }
 
 static void
@@ -514,9 +529,7 @@ frame_read_callback(scarletbook_handle_t *handle, uint8_t *frame_data, size_t fr
             rezult = write_block(ft, frame_data, frame_size);
             if (rezult == -1) {
                 //ft->cb_fwprintf(stderr, L"\n ERROR in frame_read_callback():write_block()..at writting in dsdiff master file. \n");
-                LOGD("ERROR in frame_read_callback:write_block()...writting in file: %s  ",
-                     ft->filename);
-                raise(SIGINT);
+                frame_write_failed(ft);
             }
             ft->sb_handle->count_frames++;
         }
@@ -531,8 +544,7 @@ frame_read_callback(scarletbook_handle_t *handle, uint8_t *frame_data, size_t fr
                                                     &handle->area[ft->area].area_tracklist_time->duration[ft->track]);
             //uint32_t frame_timecode = TIME_FRAMECOUNT(&handle->audio_sector.frame[handle->frame_info_idx].timecode);
             uint32_t frame_timecode = TIME_FRAMECOUNT(&handle->frame.timecode);
-            LOGD("frame_timecode %d %d %d", frame_timecode, frame_count_time_start,
-                 frame_count_time_end);
+            //LOGD("frame_timecode %d %d %d", frame_timecode, frame_count_time_start, frame_count_time_end);
             if (frame_timecode >= frame_count_time_start &&
                 frame_timecode < frame_count_time_end) {
                 if (ft->dsd_encoded_export && ft->dst_encoded_import) {
@@ -543,9 +555,7 @@ frame_read_callback(scarletbook_handle_t *handle, uint8_t *frame_data, size_t fr
                     rezult = write_block(ft, frame_data, frame_size);
                     if (rezult == -1) {
                         //ft->cb_fwprintf(stderr, L"\n ERROR in frame_read_callback():write_block()..at writting in dsf/dsdiff file. \n");
-                        LOGD("ERROR in frame_read_callback:write_block()...writting in file: %s  ",
-                             ft->filename);
-                        raise(SIGINT);
+                        frame_write_failed(ft);
                     }
                     ft->sb_handle->count_frames++;
                 }
@@ -574,6 +584,7 @@ static void *processing_thread(void *arg) {
     int checked_for_non_encrypted_disc = 0;
     int no_tracks_with_errors = 0;
 
+    qy_set_thread_name("sacdProcess");
     sysAtomicSet(&output->processing, 1);
     sysAtomicSet(&output->pause_processing, 0);
     sysAtomicSet(&output->seek_requested, 0);
@@ -585,8 +596,9 @@ static void *processing_thread(void *arg) {
         list_del(node_ptr);
 
         if (ft->dsd_encoded_export && ft->dst_encoded_import) {
-            ft->dst_decoder = dst_decoder_create(ft->channel_count, frame_decoded_callback,
-                                                 frame_error_callback, ft);
+            ft->dst_error_count = 0;
+            ft->dst_decoder = dst_decoder_create(ft->channel_count, output->dst_procs,
+                                                 frame_decoded_callback, frame_error_callback, ft);
         }
         output->stats_current_file_total_sectors = ft->length_lsn;
         output->stats_current_file_sectors_processed = 0;
@@ -679,8 +691,15 @@ static void *processing_thread(void *arg) {
                     //LOGD("current_lsn %d", ft->current_lsn);
 
                     // read some blocks
+                    int64_t read_start_us = output->playback_read_stats_cb ? monotonic_us() : 0;
+                    QY_TRACE_BEGIN("sacdRead");
                     blocks_readed = sacd_read_block_raw(ft->sb_handle->sacd, ft->current_lsn,
                                                         block_size, output->read_buffer);
+                    QY_TRACE_END();
+                    if (output->playback_read_stats_cb) {
+                        output->playback_read_stats_cb(output->playback_context, blocks_readed,
+                                                       monotonic_us() - read_start_us);
+                    }
 
                     if (blocks_readed == 0) {
                         LOGD("Error:blocks_readed = 0, current_lsn:%d, end_lsn:%d, block_size:%d \n",
@@ -710,7 +729,9 @@ static void *processing_thread(void *arg) {
 
                     // encrypted blocks need to be decrypted first
                     if (encrypted && non_encrypted_disc == 0) {
+                        QY_TRACE_BEGIN("sacdDecrypt");
                         sacd_decrypt(ft->sb_handle->sacd, output->read_buffer, block_size);
+                        QY_TRACE_END();
                     }
 
                     //debug
@@ -719,6 +740,7 @@ static void *processing_thread(void *arg) {
                     // process DSD & DST frames
                     if (ft->handler.flags & OUTPUT_FLAG_DSD ||
                         ft->handler.flags & OUTPUT_FLAG_DST) {
+                        QY_TRACE_BEGIN("sacdFrames");
                         int rezult_proc_frames = scarletbook_process_frames(ft->sb_handle,
                                                                             output->read_buffer,
                                                                             block_size,
@@ -726,10 +748,15 @@ static void *processing_thread(void *arg) {
                                                                             end_lsn,
                                                                             frame_read_callback,
                                                                             ft);
+                        QY_TRACE_END();
                         if (rezult_proc_frames < 0) {
                             LOGD("Error in return of scarlet_process_frames!, current_lsn:%d, end_lsn:%d, block_size:%d \n",
                                  ft->current_lsn, end_lsn, block_size);
                         }
+                        if (ft->error_nr != 0) {
+                            no_tracks_with_errors++;
+                            break;
+                        }
                         if (ft->current_lsn >= end_lsn) {
                             LOGD("End track no. %d. After last call to scarletbook_process_frames. current_lsn >= end_lsn, current_lsn:%d, end_lsn:%d, block_size:%d \n",
                                  ft->track, ft->current_lsn, end_lsn, block_size);
@@ -890,6 +917,15 @@ scarletbook_output_create_for_player(scarletbook_handle_t *handle,
     return output;
 }
 
+void scarletbook_output_set_read_stats_callback(scarletbook_output_t *output,
+                                                playback_read_stats_callback_t read_stats_cb) {
+    if (output) output->playback_read_stats_cb = read_stats_cb;
+}
+
+void scarletbook_output_set_dst_procs(scarletbook_output_t *output, int procs) {
+    if (output) output->dst_procs = procs;
+}
+
 scarletbook_output_t *
 scarletbook_output_create(scarletbook_handle_t *handle, stats_track_callback_t cb_track,
                           stats_progress_callback_t cb_progress, fwprintf_callback_t cb_fwprintf) {
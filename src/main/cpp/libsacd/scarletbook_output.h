@@ -82,6 +82,13 @@ typedef int (*playback_audio_callback_t)(void *context, uint8_t *data, size_t si
 typedef void (*playback_progress_callback_t)(void *context, int track_index, uint32_t current_ms,
                                              uint32_t total_ms, float progress);
 
+/**
+ * 读取统计回调 (可选)，每次 sacd_read_block_raw 之后调用
+ * @param blocks 读到的扇区数
+ * @param elapsed_us 本次读取耗时 (微秒)
+ */
+typedef void (*playback_read_stats_callback_t)(void *context, uint32_t blocks, int64_t elapsed_us);
+
 struct scarletbook_output_format_t {
     int area;
     int track;
@@ -104,10 +111,11 @@ struct scarletbook_output_format_t {
     scarletbook_format_handler_t handler;
     void *priv;
 
-    int error_nr;
+    int error_nr;           // != 0: writing this track failed, processing of it stops
     char error_str[256];
 
     dst_decoder_t *dst_decoder;
+    int dst_error_count;    // frames rejected by the DST decoder
 
     scarletbook_handle_t *sb_handle;
     fwprintf_callback_t cb_fwprintf;
@@ -134,6 +142,13 @@ scarletbook_output_create_for_player(scarletbook_handle_t *handle,
                                      playback_audio_callback_t audio_cb,
                                      playback_progress_callback_t progress_cb);
 
+// 需在 scarletbook_output_start 之前设置，context 与音频回调相同
+void scarletbook_output_set_read_stats_callback(scarletbook_output_t *output,
+                                                playback_read_stats_callback_t read_stats_cb);
+
+// DST 解码线程数，<= 0 使用解码器默认值；需在 scarletbook_output_start 之前设置
+void scarletbook_output_set_dst_procs(scarletbook_output_t *output, int procs);
+
 scarletbook_output_t *
 scarletbook_output_create(scarletbook_handle_t *, stats_track_callback_t, stats_progress_callback_t,
                           fwprintf_callback_t);
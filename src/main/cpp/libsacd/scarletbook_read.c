@@ -27,7 +27,6 @@
 #ifndef __APPLE__
 
 #include <malloc.h>
-#include <android/log.h>
 
 #endif
 
@@ -68,7 +67,28 @@ static const uint8_t my_friendly_zeros[2048];
 /* Prototypes for internal functions */
 static int scarletbook_read_master_toc(scarletbook_handle_t *);
 
-static int scarletbook_read_area_toc(scarletbook_handle_t *, int);
+static int scarletbook_read_area_toc(scarletbook_handle_t *, int, uint32_t);
+
+// Text fields in the TOCs are NUL terminated strings at an offset into the TOC buffer.
+// Both the offset and the string come from the disc, keep them inside the buffer.
+static char *read_toc_text(const uint8_t *base, uint32_t offset, const uint8_t *end,
+                           const char *charset) {
+    const char *text = (const char *) base + offset;
+    if (offset == 0 || (const uint8_t *) text >= end)
+        return NULL;
+    return charset_convert(text, strnlen(text, (size_t) (end - (const uint8_t *) text)), charset,
+                           "UTF-8");
+}
+
+static void free_area(scarletbook_area_t *area);
+
+// Release an area whose TOC could not be used, so that the slot can be reused
+static void discard_area(scarletbook_area_t *area) {
+    if (area->area_toc)
+        free_area(area);
+    free(area->area_data);
+    memset(area, 0, sizeof(scarletbook_area_t));
+}
 
 
 scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
@@ -83,6 +103,7 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
 
     if (!sb->frame.data) {
         LOGD("malloc(MAX_DST_SIZE) failed");
+        free(sb);
         return NULL;
     }
 
@@ -92,19 +113,13 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
     sb->mulch_area_idx = -1;
     if (scarletbook_read_master_toc(sb) == 0) {
         fwprintf(stderr, L"scarletbook_open: Can't read Master TOC !!\n");
-        if (sb->frame.data) {
-            free(sb->frame.data);
-        }
-        free(sb);
+        scarletbook_close(sb);
         return NULL;
     }
 
     if (!sb->master_toc) {
         LOGD("scarletbook_open: Master TOC ptr is NULL even though read returned success!\n");
-        if (sb->frame.data) {
-            free(sb->frame.data);
-        }
-        free(sb);
+        scarletbook_close(sb);
         return NULL;
     }
 
@@ -118,9 +133,10 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
         if (sb->area[sb->area_count].area_data == NULL) {
             LOGD("Can't alocate memory for Area 1 (TWOCHTOC) TOC-1 !!\n");
         } else {
-            if (!sacd_read_block_raw(sacd, sb->master_toc->area_1_toc_1_start,
-                                     (uint32_t) sb->master_toc->area_1_toc_size,
-                                     sb->area[sb->area_count].area_data)) {
+            if (sacd_read_block_raw(sacd, sb->master_toc->area_1_toc_1_start,
+                                    (uint32_t) sb->master_toc->area_1_toc_size,
+                                    sb->area[sb->area_count].area_data) !=
+                sb->master_toc->area_1_toc_size) {
                 LOGD("Can't read Area 1 (TWOCHTOC) TOC-1 !! Trying to read and use TOC-2...\n");
                 flag_use_toc2 = 1;
             } else
@@ -134,9 +150,10 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
                     LOGD("Error: Can't alocate memory for backup Area 1 (TWOCHTOC) TOC-2.\n");
                     flag_use_toc2 = 0;
                 } else {
-                    if (!sacd_read_block_raw(sacd, sb->master_toc->area_1_toc_2_start,
-                                             (uint32_t) sb->master_toc->area_1_toc_size,
-                                             sb->area[2].area_data)) {
+                    if (sacd_read_block_raw(sacd, sb->master_toc->area_1_toc_2_start,
+                                            (uint32_t) sb->master_toc->area_1_toc_size,
+                                            sb->area[2].area_data) !=
+                        sb->master_toc->area_1_toc_size) {
                         LOGD("Warning: can't read Area 1 (TWOCHTOC) TOC-2 !! There are some errros on disc !\n");
                         flag_use_toc2 = 0;
                     } else  // compare
@@ -158,15 +175,19 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
                                (size_t) ((size_t) sb->master_toc->area_1_toc_size * SACD_LSN_SIZE));
 
                     free(sb->area[2].area_data);
+                    sb->area[2].area_data = NULL;
                 }
 
             }
 
             if (((flag_use_toc1 == 1) || (flag_use_toc2 == 1)) &&
-                (scarletbook_read_area_toc(sb, sb->area_count) == 1)) {
+                (scarletbook_read_area_toc(sb, sb->area_count,
+                                           sb->master_toc->area_1_toc_size) == 1)) {
                 ++sb->area_count;
-            } else
+            } else {
                 LOGD("libsacdread: Erors processing Area 1 (TWOCHTOC)!!\n");
+                discard_area(&sb->area[sb->area_count]);
+            }
         }
 
     }
@@ -181,9 +202,10 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
         if (!sb->area[sb->area_count].area_data) {
             LOGD("Error: can't alocate memory for Area 2 (MULCHTOC) TOC-1 !!\n");
         } else {
-            if (!sacd_read_block_raw(sacd, sb->master_toc->area_2_toc_1_start,
-                                     (uint32_t) sb->master_toc->area_2_toc_size,
-                                     sb->area[sb->area_count].area_data)) {
+            if (sacd_read_block_raw(sacd, sb->master_toc->area_2_toc_1_start,
+                                    (uint32_t) sb->master_toc->area_2_toc_size,
+                                    sb->area[sb->area_count].area_data) !=
+                sb->master_toc->area_2_toc_size) {
                 LOGD("Error: can't read Area 2 (MULCHTOC) TOC-1 !! Trying to read and use TOC-2...\n");
                 flag_use_toc2 = 1;
             } else
@@ -198,9 +220,10 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
                     LOGD("Error: can't alocate memory for backup Area 2 (MULCHTOC)  TOC-2.\n");
                     flag_use_toc2 = 0;
                 } else {
-                    if (!sacd_read_block_raw(sacd, sb->master_toc->area_2_toc_2_start,
-                                             (uint32_t) sb->master_toc->area_2_toc_size,
-                                             sb->area[3].area_data)) {
+                    if (sacd_read_block_raw(sacd, sb->master_toc->area_2_toc_2_start,
+                                            (uint32_t) sb->master_toc->area_2_toc_size,
+                                            sb->area[3].area_data) !=
+                        sb->master_toc->area_2_toc_size) {
                         LOGD("Warning: can't read Area 2 (MULCHTOC) TOC-2 !! There are some errros on disc !\n");
                         flag_use_toc2 = 0;
                     } else // compare
@@ -218,24 +241,27 @@ scarletbook_handle_t *scarletbook_open(sacd_reader_t *sacd) {
                     }
                     if (flag_use_toc2 == 1)
                         memcpy((void *) sb->area[sb->area_count].area_data,
-                               (void *) sb->area[2].area_data,
-                               (size_t) ((size_t) sb->master_toc->area_1_toc_size * SACD_LSN_SIZE));
+                               (void *) sb->area[3].area_data,
+                               (size_t) ((size_t) sb->master_toc->area_2_toc_size * SACD_LSN_SIZE));
 
                     free(sb->area[3].area_data);
+                    sb->area[3].area_data = NULL;
                 }
             }
 
             if (((flag_use_toc1 == 1) || (flag_use_toc2 == 1)) &&
-                (scarletbook_read_area_toc(sb, sb->area_count) == 1)) {
+                (scarletbook_read_area_toc(sb, sb->area_count,
+                                           sb->master_toc->area_2_toc_size) == 1)) {
                 ++sb->area_count;
-            } else
+            } else {
                 LOGD("Error processing Area 2 (MULCHTOC). \n");
+                discard_area(&sb->area[sb->area_count]);
+            }
         }
     }
 
     if (sb->area_count == 0) {
-        free(sb->frame.data);
-        free(sb);
+        scarletbook_close(sb);
         return NULL;
     }
 
@@ -269,17 +295,15 @@ static void free_area(scarletbook_area_t *area) {
 }
 
 void scarletbook_close(scarletbook_handle_t *handle) {
+    int i;
+
     if (!handle)
         return;
 
-    if (has_two_channel(handle)) {
-        free_area(&handle->area[handle->twoch_area_idx]);
-        free(handle->area[handle->twoch_area_idx].area_data);
-    }
-
-    if (has_multi_channel(handle)) {
-        free_area(&handle->area[handle->mulch_area_idx]);
-        free(handle->area[handle->mulch_area_idx].area_data);
+    // both areas of a malformed disc may claim to be 2 channel, free by slot rather than by index
+    for (i = 0; i < handle->area_count; i++) {
+        free_area(&handle->area[i]);
+        free(handle->area[i].area_data);
     }
 
     {
@@ -321,14 +345,15 @@ void scarletbook_close(scarletbook_handle_t *handle) {
 static int scarletbook_read_master_toc(scarletbook_handle_t *handle) {
     int i;
     uint8_t *p;
+    const uint8_t *master_end;
     master_toc_t *master_toc;
 
     handle->master_data = malloc(MASTER_TOC_LEN * SACD_LSN_SIZE);
     if (!handle->master_data)
         return 0;
 
-    if (!sacd_read_block_raw(handle->sacd, START_OF_MASTER_TOC, MASTER_TOC_LEN,
-                             handle->master_data))
+    if (sacd_read_block_raw(handle->sacd, START_OF_MASTER_TOC, MASTER_TOC_LEN,
+                            handle->master_data) != MASTER_TOC_LEN)
         return 0;
 
     master_toc = handle->master_toc = (master_toc_t *) handle->master_data;
@@ -381,6 +406,7 @@ static int scarletbook_read_master_toc(scarletbook_handle_t *handle) {
 
     // point to eof master header
     p = handle->master_data + SACD_LSN_SIZE;
+    master_end = handle->master_data + MASTER_TOC_LEN * SACD_LSN_SIZE;
 
     // set pointers to text content
     for (i = 0; i < MAX_LANGUAGE_COUNT; i++) {
@@ -414,91 +440,39 @@ static int scarletbook_read_master_toc(scarletbook_handle_t *handle) {
             char *current_charset = (char *) character_set[
                     handle->master_toc->locales[i].character_set & 0x07];
 
-            if (master_text->album_title_position)
-                handle->master_text.album_title = charset_convert(
-                        (char *) master_text + master_text->album_title_position,
-                        strlen((char *) master_text + master_text->album_title_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_title_phonetic_position)
-                handle->master_text.album_title_phonetic = charset_convert(
-                        (char *) master_text + master_text->album_title_phonetic_position,
-                        strlen((char *) master_text + master_text->album_title_phonetic_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_artist_position)
-                handle->master_text.album_artist = charset_convert(
-                        (char *) master_text + master_text->album_artist_position,
-                        strlen((char *) master_text + master_text->album_artist_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_artist_phonetic_position)
-                handle->master_text.album_artist_phonetic = charset_convert(
-                        (char *) master_text + master_text->album_artist_phonetic_position,
-                        strlen((char *) master_text + master_text->album_artist_phonetic_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_publisher_position)
-                handle->master_text.album_publisher = charset_convert(
-                        (char *) master_text + master_text->album_publisher_position,
-                        strlen((char *) master_text + master_text->album_publisher_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_publisher_phonetic_position)
-                handle->master_text.album_publisher_phonetic = charset_convert(
-                        (char *) master_text + master_text->album_publisher_phonetic_position,
-                        strlen((char *) master_text +
-                               master_text->album_publisher_phonetic_position), current_charset,
-                        "UTF-8");
-            if (master_text->album_copyright_position)
-                handle->master_text.album_copyright = charset_convert(
-                        (char *) master_text + master_text->album_copyright_position,
-                        strlen((char *) master_text + master_text->album_copyright_position),
-                        current_charset, "UTF-8");
-            if (master_text->album_copyright_phonetic_position)
-                handle->master_text.album_copyright_phonetic = charset_convert(
-                        (char *) master_text + master_text->album_copyright_phonetic_position,
-                        strlen((char *) master_text +
-                               master_text->album_copyright_phonetic_position), current_charset,
-                        "UTF-8");
-
-            if (master_text->disc_title_position)
-                handle->master_text.disc_title = charset_convert(
-                        (char *) master_text + master_text->disc_title_position,
-                        strlen((char *) master_text + master_text->disc_title_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_title_phonetic_position)
-                handle->master_text.disc_title_phonetic = charset_convert(
-                        (char *) master_text + master_text->disc_title_phonetic_position,
-                        strlen((char *) master_text + master_text->disc_title_phonetic_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_artist_position)
-                handle->master_text.disc_artist = charset_convert(
-                        (char *) master_text + master_text->disc_artist_position,
-                        strlen((char *) master_text + master_text->disc_artist_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_artist_phonetic_position)
-                handle->master_text.disc_artist_phonetic = charset_convert(
-                        (char *) master_text + master_text->disc_artist_phonetic_position,
-                        strlen((char *) master_text + master_text->disc_artist_phonetic_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_publisher_position)
-                handle->master_text.disc_publisher = charset_convert(
-                        (char *) master_text + master_text->disc_publisher_position,
-                        strlen((char *) master_text + master_text->disc_publisher_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_publisher_phonetic_position)
-                handle->master_text.disc_publisher_phonetic = charset_convert(
-                        (char *) master_text + master_text->disc_publisher_phonetic_position,
-                        strlen((char *) master_text +
-                               master_text->disc_publisher_phonetic_position), current_charset,
-                        "UTF-8");
-            if (master_text->disc_copyright_position)
-                handle->master_text.disc_copyright = charset_convert(
-                        (char *) master_text + master_text->disc_copyright_position,
-                        strlen((char *) master_text + master_text->disc_copyright_position),
-                        current_charset, "UTF-8");
-            if (master_text->disc_copyright_phonetic_position)
-                handle->master_text.disc_copyright_phonetic = charset_convert(
-                        (char *) master_text + master_text->disc_copyright_phonetic_position,
-                        strlen((char *) master_text +
-                               master_text->disc_copyright_phonetic_position), current_charset,
-                        "UTF-8");
+            handle->master_text.album_title = read_toc_text(
+                    p, master_text->album_title_position, master_end, current_charset);
+            handle->master_text.album_title_phonetic = read_toc_text(
+                    p, master_text->album_title_phonetic_position, master_end, current_charset);
+            handle->master_text.album_artist = read_toc_text(
+                    p, master_text->album_artist_position, master_end, current_charset);
+            handle->master_text.album_artist_phonetic = read_toc_text(
+                    p, master_text->album_artist_phonetic_position, master_end, current_charset);
+            handle->master_text.album_publisher = read_toc_text(
+                    p, master_text->album_publisher_position, master_end, current_charset);
+            handle->master_text.album_publisher_phonetic = read_toc_text(
+                    p, master_text->album_publisher_phonetic_position, master_end, current_charset);
+            handle->master_text.album_copyright = read_toc_text(
+                    p, master_text->album_copyright_position, master_end, current_charset);
+            handle->master_text.album_copyright_phonetic = read_toc_text(
+                    p, master_text->album_copyright_phonetic_position, master_end, current_charset);
+
+            handle->master_text.disc_title = read_toc_text(
+                    p, master_text->disc_title_position, master_end, current_charset);
+            handle->master_text.disc_title_phonetic = read_toc_text(
+                    p, master_text->disc_title_phonetic_position, master_end, current_charset);
+            handle->master_text.disc_artist = read_toc_text(
+                    p, master_text->disc_artist_position, master_end, current_charset);
+            handle->master_text.disc_artist_phonetic = read_toc_text(
+                    p, master_text->disc_artist_phonetic_position, master_end, current_charset);
+            handle->master_text.disc_publisher = read_toc_text(
+                    p, master_text->disc_publisher_position, master_end, current_charset);
+            handle->master_text.disc_publisher_phonetic = read_toc_text(
+                    p, master_text->disc_publisher_phonetic_position, master_end, current_charset);
+            handle->master_text.disc_copyright = read_toc_text(
+                    p, master_text->disc_copyright_position, master_end, current_charset);
+            handle->master_text.disc_copyright_phonetic = read_toc_text(
+                    p, master_text->disc_copyright_phonetic_position, master_end, current_charset);
         }
 
         p += SACD_LSN_SIZE;
@@ -512,15 +486,20 @@ static int scarletbook_read_master_toc(scarletbook_handle_t *handle) {
     return 1;
 }
 
-static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx) {
+static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx,
+                                     uint32_t area_sectors) {
     int i, j;
     area_toc_t *area_toc;
     uint8_t *area_data;
+    uint8_t *area_end;
     uint8_t *p;
     int sacd_text_idx = 0;
     scarletbook_area_t *area = &handle->area[area_idx];
     char *current_charset;
 
+    if (area_sectors == 0)
+        return 0;
+
     p = area_data = area->area_data;
     area_toc = area->area_toc = (area_toc_t *) area_data;
 
@@ -541,6 +520,9 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
     SWAP16(area_toc->index_list_offset);
     SWAP16(area_toc->access_list_offset);
 
+    // area_toc->size comes from the disc, never walk past what was actually read
+    area_end = area_data + (size_t) min(area_toc->size, area_sectors) * SACD_LSN_SIZE;
+
     CHECK_ZERO(area_toc->reserved01);
     CHECK_ZERO(area_toc->reserved03);
     CHECK_ZERO(area_toc->reserved04);
@@ -553,25 +535,14 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
     current_charset = (char *) character_set[
             area->area_toc->languages[sacd_text_idx].character_set & 0x07];
 
-    if (area_toc->area_description_offset)
-        area->description = charset_convert((char *) area_toc + area_toc->area_description_offset,
-                                            strlen((char *) area_toc +
-                                                   area_toc->area_description_offset),
-                                            current_charset, "UTF-8");
-    if (area_toc->copyright_offset)
-        area->copyright = charset_convert((char *) area_toc + area_toc->copyright_offset,
-                                          strlen((char *) area_toc + area_toc->copyright_offset),
-                                          current_charset, "UTF-8");
-    if (area_toc->area_description_phonetic_offset)
-        area->description_phonetic = charset_convert(
-                (char *) area_toc + area_toc->area_description_phonetic_offset,
-                strlen((char *) area_toc + area_toc->area_description_phonetic_offset),
-                current_charset, "UTF-8");
-    if (area_toc->copyright_phonetic_offset)
-        area->copyright_phonetic = charset_convert(
-                (char *) area_toc + area_toc->copyright_phonetic_offset,
-                strlen((char *) area_toc + area_toc->copyright_phonetic_offset), current_charset,
-                "UTF-8");
+    area->description = read_toc_text(area_data, area_toc->area_description_offset, area_end,
+                                      current_charset);
+    area->copyright = read_toc_text(area_data, area_toc->copyright_offset, area_end,
+                                    current_charset);
+    area->description_phonetic = read_toc_text(
+            area_data, area_toc->area_description_phonetic_offset, area_end, current_charset);
+    area->copyright_phonetic = read_toc_text(
+            area_data, area_toc->copyright_phonetic_offset, area_end, current_charset);
 
     if (area_toc->version.major > SUPPORTED_VERSION_MAJOR ||
         area_toc->version.minor > SUPPORTED_VERSION_MINOR) {
@@ -590,7 +561,7 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
     // Area TOC size is SACD_LSN_SIZE
     p += SACD_LSN_SIZE;
 
-    while (p < (area_data + area_toc->size * SACD_LSN_SIZE)) {
+    while (p < area_end) {
         if (strncmp((char *) p, "SACDTTxt", 8) == 0) {
             // we discard all other SACDTTxt entries
             if (sacd_text_idx == 0) {
@@ -601,15 +572,24 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
                     area_text = area->area_text = (area_text_t *) p;
                     SWAP16(area_text->track_text_position[i]);
                     if (area_text->track_text_position[i] > 0) {
+                        // positions, counts and strings all come from the disc: stay inside the TOC
+                        const char *text_end = (const char *) area_end;
                         track_ptr = (char *) (p + area_text->track_text_position[i]);
+                        if (track_ptr + 4 >= text_end)
+                            continue;
                         track_amount = *track_ptr;
                         track_ptr += 4;
                         for (j = 0; j < track_amount; j++) {
+                            if (track_ptr + 2 >= text_end)
+                                break;
                             track_type = *track_ptr;
                             track_ptr++;
                             track_ptr++;                         // skip unknown 0x20
                             if (*track_ptr != 0) {
-                                int track_text_len = strlen(track_ptr);
+                                size_t remaining = (size_t) (text_end - track_ptr);
+                                int track_text_len = (int) strnlen(track_ptr, remaining);
+                                if ((size_t) track_text_len == remaining)
+                                    break;                       // not terminated inside the TOC
                                 if (track_text_len > 255) {
                                     fwprintf(stdout,
                                              L"\n\n Error: The lenght of track text is bigger than 255!!; area_idx=%d; track_type=0x%02x; track number=%d",
@@ -622,17 +602,16 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
 
                                 // check if exists illegal char code  
                                 // [e.g Savall - The Celtic Viol - La Viole Celtique - The Treble Viol- AVSA9865 - has incorrect char code = 0x19 in text of Composer in tracks 5,6,7,15,21 !!]
-                                char *track_ptr1 = track_ptr;
-                                for (int te = 0; te < (int) strlen(track_ptr); te++) {
-                                    if (*(uint8_t *) track_ptr1 < (uint8_t) 0x20) {
-                                        *((uint8_t *) track_ptr1) = (uint8_t) 0x20;
-                                        fwprintf(stdout,
-                                                 L"\n\n Warning: Illegal char in the track text! Corrected.; area_idx=%d; track_type=0x%02x; track number=%d\n",
-                                                 area_idx, track_type, i + 1);
-                                        LOGW("Warning: Illegal char in the track text! Corrected. ;area_idx=%d; track_type=0x%02x; track number=%d",
-                                             area_idx, track_type, i + 1);
+                                int illegal_chars = 0;
+                                for (int te = 0; te < track_text_len; te++) {
+                                    if ((uint8_t) track_ptr[te] < (uint8_t) 0x20) {
+                                        track_ptr[te] = (char) 0x20;
+                                        illegal_chars++;
                                     }
-                                    track_ptr1++;
+                                }
+                                if (illegal_chars > 0) {
+                                    LOGW("Warning: %d illegal chars in the track text! Corrected. ;area_idx=%d; track_type=0x%02x; track number=%d",
+                                         illegal_chars, area_idx, track_type, i + 1);
                                 }
                                 //DEBUG
 
@@ -650,48 +629,50 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
                                 }
                                 //DEBUG
 
+                                area_track_text_t *track_text = &area->area_track_text[i];
+                                char **slot = NULL;
                                 switch (track_type) {
                                     case TRACK_TYPE_TITLE:
-                                        area->area_track_text[i].track_type_title = track_text_converted_ptr;
+                                        slot = &track_text->track_type_title;
                                         break;
                                     case TRACK_TYPE_PERFORMER:
-                                        area->area_track_text[i].track_type_performer = track_text_converted_ptr;
+                                        slot = &track_text->track_type_performer;
                                         break;
                                     case TRACK_TYPE_SONGWRITER:
-                                        area->area_track_text[i].track_type_songwriter = track_text_converted_ptr;
+                                        slot = &track_text->track_type_songwriter;
                                         break;
                                     case TRACK_TYPE_COMPOSER:
-                                        area->area_track_text[i].track_type_composer = track_text_converted_ptr;
+                                        slot = &track_text->track_type_composer;
                                         break;
                                     case TRACK_TYPE_ARRANGER:
-                                        area->area_track_text[i].track_type_arranger = track_text_converted_ptr;
+                                        slot = &track_text->track_type_arranger;
                                         break;
                                     case TRACK_TYPE_MESSAGE:
-                                        area->area_track_text[i].track_type_message = track_text_converted_ptr;
+                                        slot = &track_text->track_type_message;
                                         break;
                                     case TRACK_TYPE_EXTRA_MESSAGE:
-                                        area->area_track_text[i].track_type_extra_message = track_text_converted_ptr;
+                                        slot = &track_text->track_type_extra_message;
                                         break;
                                     case TRACK_TYPE_TITLE_PHONETIC:
-                                        area->area_track_text[i].track_type_title_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_title_phonetic;
                                         break;
                                     case TRACK_TYPE_PERFORMER_PHONETIC:
-                                        area->area_track_text[i].track_type_performer_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_performer_phonetic;
                                         break;
                                     case TRACK_TYPE_SONGWRITER_PHONETIC:
-                                        area->area_track_text[i].track_type_songwriter_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_songwriter_phonetic;
                                         break;
                                     case TRACK_TYPE_COMPOSER_PHONETIC:
-                                        area->area_track_text[i].track_type_composer_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_composer_phonetic;
                                         break;
                                     case TRACK_TYPE_ARRANGER_PHONETIC:
-                                        area->area_track_text[i].track_type_arranger_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_arranger_phonetic;
                                         break;
                                     case TRACK_TYPE_MESSAGE_PHONETIC:
-                                        area->area_track_text[i].track_type_message_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_message_phonetic;
                                         break;
                                     case TRACK_TYPE_EXTRA_MESSAGE_PHONETIC:
-                                        area->area_track_text[i].track_type_extra_message_phonetic = track_text_converted_ptr;
+                                        slot = &track_text->track_type_extra_message_phonetic;
                                         break;
                                     default:
                                         fwprintf(stdout, L"\n\n Error: Unknown track text type!!");
@@ -699,12 +680,19 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
                                              track_type);
                                         break;
                                 }
+                                // a repeated type replaces the earlier text
+                                if (slot) {
+                                    free(*slot);
+                                    *slot = track_text_converted_ptr;
+                                } else {
+                                    free(track_text_converted_ptr);
+                                }
                             }
                             if (j < track_amount - 1) {
-                                while (*track_ptr != 0)
+                                while (track_ptr < text_end && *track_ptr != 0)
                                     track_ptr++;
 
-                                while (*track_ptr == 0)
+                                while (track_ptr < text_end && *track_ptr == 0)
                                     track_ptr++;
                             }
                         }
@@ -714,6 +702,8 @@ static int scarletbook_read_area_toc(scarletbook_handle_t *handle, int area_idx)
             sacd_text_idx++;
             p += SACD_LSN_SIZE;
         } else if (strncmp((char *) p, "SACD_IGL", 8) == 0) {
+            if (p + SACD_LSN_SIZE * 2 > area_end)
+                break;
             area->area_isrc_genre = (area_isrc_genre_t *) p;
             p += SACD_LSN_SIZE * 2;
         } else if (strncmp((char *) p, "SACD_ACC", 8) == 0) {
@@ -786,6 +776,7 @@ scarletbook_process_frames(scarletbook_handle_t *handle, uint8_t *read_buffer, i
     uint8_t *read_buffer_ptr_blocks = read_buffer;
     uint8_t *read_buffer_ptr;
     int sector_bad_reads = 0;
+    int timecode_gap_logged = 0;
     int nr_frames_proccesed = 0;
     read_buffer_ptr = read_buffer_ptr_blocks;
 
@@ -842,6 +833,12 @@ scarletbook_process_frames(scarletbook_handle_t *handle, uint8_t *read_buffer, i
                 sector_bad_reads = 1;
                 continue;
             }
+            // packet must not run past the end of this sector; the rest of the sector is unusable
+            if (read_buffer_ptr + packet->packet_length > read_buffer_ptr_blocks + SACD_LSN_SIZE) {
+                sector_bad_reads = 1;
+                handle->frame.started = 0;
+                break;
+            }
             switch (packet->data_type) {
                 case DATA_TYPE_AUDIO:
                     if (packet->frame_start) {
@@ -864,9 +861,10 @@ scarletbook_process_frames(scarletbook_handle_t *handle, uint8_t *read_buffer, i
                         uint32_t frametimecode_prev = TIME_FRAMECOUNT(&handle->frame.timecode);
                         uint32_t frametimecode_current = TIME_FRAMECOUNT(
                                 &handle->audio_sector.frame[frame_info_idx].timecode);
-                        if (frametimecode_prev > 0) {
-                            // check if is consecutive
+                        if (frametimecode_prev > 0 && !timecode_gap_logged) {
+                            // check if is consecutive; corrupt sectors would log every frame, once per call is enough
                             if (frametimecode_current != frametimecode_prev + 1) {
+                                timecode_gap_logged = 1;
                                 LOGD("Error : scarletbook_process_frames(), frametimecode not succesive! frametimecode_current:%u, frametimecode_prev:%u",
                                      frametimecode_current, frametimecode_prev);
                             }
@@ -1,5 +1,14 @@
 #include "AudioProbe.h"
 #include "ProbeUtils.h"
+#include "HeaderProbe.h"
+#include "ProbeCache.h"
+#include "CoverStore.h"
+#include "CueParser.h"
+#include "LoudnessAnalyzer.h"
+#include "DemuxerHandoff.h"
+#include "SacdHandoff.h"
+#include "ProbeInterrupt.h"
+#include "ScanStats.h"
 #include "Logger.h"
 
 extern "C" {
@@ -10,9 +19,11 @@ extern "C" {
 #include <libavutil/avutil.h>
 }
 #include <unistd.h>
+#include <string.h>
 #include <sstream>
 #include <algorithm>
 #include <mutex>
+#include <chrono>
 
 // ==========================================
 // 辅助工具与锁
@@ -21,6 +32,18 @@ extern "C" {
 static std::once_flag ffmpeg_init_flag;
 static std::mutex sacd_mutex;
 
+// CUE 引用的整轨镜像探测结果，进程内跨调用共享
+#define IMAGE_CACHE_MAX 32
+#define IMAGE_CACHE_NETWORK_TTL_MS (10 * 60 * 1000)
+
+struct ImageCacheEntry {
+    std::string validator; // 本地文件的 size + mtime，网络文件为空
+    int64_t timeMs = 0;
+    InternalMetadata meta;
+};
+static std::mutex image_mutex;
+static std::map<std::string, ImageCacheEntry> image_cache;
+
 
 static bool fileExists(const std::string &path) {
     // 如果是网络流 (http/rtmp 等)，access 无法检测，暂且认为它"存在"交给 FFmpeg 处理
@@ -57,6 +80,61 @@ static std::string getPathNoQuery(const std::string &path) {
     return (qPos != std::string::npos) ? lower.substr(0, qPos) : lower;
 }
 
+// HeaderProbe 能解析的容器，按 avformat 已识别的 demuxer 判断 (DFF 的 demuxer 名为 iff)
+static bool isHeaderProbeFormat(const AVInputFormat *iformat) {
+    static const char *kNames[] = {"flac", "wav", "dsf", "iff"};
+    if (!iformat || !iformat->name) return false;
+    for (const char *name: kNames) {
+        if (strcmp(iformat->name, name) == 0) return true;
+    }
+    return false;
+}
+
+/**
+ * 文件开头交给 HeaderProbe 解析，只处理它支持的容器
+ * 优先使用 avformat_open_input 已缓冲的字节；缓冲区已不从 0 开始 (read_header 跳到了数据区)
+ * 且 allowSeek 时才回读 HEAD_SIZE 字节，读完恢复 AVIOContext 位置
+ */
+static bool readHeaderInfo(AVFormatContext *fmt_ctx, HeaderInfo &info, bool allowSeek) {
+    AVIOContext *pb = fmt_ctx->pb;
+    if (!pb || !isHeaderProbeFormat(fmt_ctx->iformat)) return false;
+
+    // pos 为缓冲区末尾对应的文件偏移
+    int64_t buffered = pb->buf_end - pb->buffer;
+    if (buffered > 0 && pb->pos - buffered == 0) {
+        if (HeaderProbe::parse(pb->buffer, (size_t) buffered, info) && info.isComplete()) return true;
+        if (buffered >= (int64_t) HeaderProbe::HEAD_SIZE) return false;
+        info = HeaderInfo();
+    }
+    if (!allowSeek || !pb->seekable) return false;
+
+    int64_t pos = avio_tell(pb);
+    if (avio_seek(pb, 0, SEEK_SET) < 0) return false;
+    std::vector<uint8_t> head(HeaderProbe::HEAD_SIZE);
+    int n = avio_read(pb, head.data(), (int) head.size());
+    avio_seek(pb, pos, SEEK_SET);
+    if (n <= 0) return false;
+    return HeaderProbe::parse(head.data(), n, info) && info.isComplete();
+}
+
+// read_header 已给出的参数是否足够 (无需解码数据包)
+static bool isCodecParamsComplete(AVFormatContext *fmt_ctx) {
+    for (int i = 0; i < (int) fmt_ctx->nb_streams; i++) {
+        AVStream *st = fmt_ctx->streams[i];
+        AVCodecParameters *p = st->codecpar;
+        if (p->codec_type != AVMEDIA_TYPE_AUDIO) continue;
+        if (p->codec_id == AV_CODEC_ID_NONE || p->sample_rate <= 0 ||
+            p->ch_layout.nb_channels <= 0 || st->duration == AV_NOPTS_VALUE) {
+            return false;
+        }
+        // 无损编码需要真实位深，容器未给出时 (如部分 ALAC) 仍需解码
+        const AVCodecDescriptor *desc = avcodec_descriptor_get(p->codec_id);
+        bool lossy = desc && (desc->props & AV_CODEC_PROP_LOSSY);
+        return lossy || p->bits_per_raw_sample > 0;
+    }
+    return false;
+}
+
 // ==========================================
 // 1. FFProbe (Standard)
 // ==========================================
@@ -106,18 +184,34 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
     av_dict_set(&options, "probesize", "512000", 0); // 减小探测大小，加速失败反馈
     av_dict_set(&options, "analyzeduration", "1000000", 0);
 
+    auto probeStart = std::chrono::steady_clock::now();
+    bool network = path.find("://") != std::string::npos && path.find("file://") != 0;
+
+    // 网络上下文探测完可能交给播放器继续使用，需要可转接的中断回调
+    fmt_ctx = avformat_alloc_context();
+    void *relay = network ? DemuxerHandoff::installRelay(fmt_ctx) : nullptr;
+    // 批量探测被取消时中断连接与读取
+    DemuxerHandoff::bindInterrupt(fmt_ctx, ProbeInterrupt::callback, nullptr);
+
     // 尝试打开
     int ret = avformat_open_input(&fmt_ctx, path.c_str(), nullptr, &options);
     if (ret < 0) {
         LOGE("probeStandard: avformat_open_input failed: %d, path: %s", ret, path.c_str());
         av_dict_free(&options);
+        if (relay) DemuxerHandoff::releaseRelay(relay);
         return meta; // 失败直接返回，交给后续 fallback
     }
     av_dict_free(&options);
 
-    if (avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
+    // 快速路径：容器头已包含全部参数时跳过 find_stream_info (它会读取并解码数据包)
+    // 网络文件在 read_header 已给出全部参数时不再为容器头回读 (多一次 Range 请求)
+    HeaderInfo header;
+    bool paramsComplete = isCodecParamsComplete(fmt_ctx);
+    bool headerComplete = readHeaderInfo(fmt_ctx, header, !network || !paramsComplete);
+    bool fast = headerComplete || paramsComplete;
+    if (!fast && avformat_find_stream_info(fmt_ctx, nullptr) < 0) {
         LOGE("probeStandard: avformat_find_stream_info failed");
-        avformat_close_input(&fmt_ctx);
+        DemuxerHandoff::close(&fmt_ctx);
         return meta;
     }
 
@@ -142,10 +236,15 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
     else if (!trackStr.empty()) curTrack = parse_int(trackStr);
 
     int audioIdx = -1;
-    for (int i = 0; i < fmt_ctx->nb_streams; i++) {
-        if (fmt_ctx->streams[i]->disposition & AV_DISPOSITION_ATTACHED_PIC) {
-            AVPacket pkt = fmt_ctx->streams[i]->attached_pic;
-            if (pkt.data && pkt.size > 0) meta.coverData.assign(pkt.data, pkt.data + pkt.size);
+    for (int i = 0; i < (int) fmt_ctx->nb_streams; i++) {
+        if ((fmt_ctx->streams[i]->disposition & AV_DISPOSITION_ATTACHED_PIC) &&
+            meta.coverPath.empty()) {
+            // 直接从数据包写盘，不复制到内存
+            const AVPacket &pkt = fmt_ctx->streams[i]->attached_pic;
+            if (pkt.data && pkt.size > 0) {
+                meta.coverPath = CoverStore::save(pkt.data, pkt.size,
+                                                  fmt_ctx->streams[i]->codecpar->codec_id);
+            }
         }
         if (fmt_ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_AUDIO && audioIdx < 0) {
             audioIdx = i;
@@ -155,7 +254,7 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
     // 如果找不到音频流，说明可能不是常规音频文件（可能是 ISO）
     if (audioIdx < 0) {
         LOGW("probeStandard: No audio stream found. Might be ISO/SACD.");
-        avformat_close_input(&fmt_ctx);
+        DemuxerHandoff::close(&fmt_ctx);
         return meta; // success 依然是 false
     }
 
@@ -180,13 +279,16 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
     track.album = meta.albumTitle;
     track.genre = meta.genre;
 
+    AVStream *audioStream = fmt_ctx->streams[audioIdx];
     if (fmt_ctx->duration != AV_NOPTS_VALUE) {
         track.durationMs = fmt_ctx->duration / 1000;
-        track.endMs = track.durationMs;
+    } else if (audioStream->duration != AV_NOPTS_VALUE) {
+        // 跳过 find_stream_info 时总时长未汇总到 fmt_ctx
+        track.durationMs = av_rescale_q(audioStream->duration, audioStream->time_base, {1, 1000});
     }
     track.bitRate = fmt_ctx->bit_rate;
 
-    AVCodecParameters *p = fmt_ctx->streams[audioIdx]->codecpar;
+    AVCodecParameters *p = audioStream->codecpar;
     track.sampleRate = p->sample_rate;
     track.channels = p->ch_layout.nb_channels;
     track.bitDepth = (p->bits_per_raw_sample > 0) ? p->bits_per_raw_sample : 16;
@@ -201,11 +303,80 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
         track.sampleRate = p->sample_rate * 8;
     }
 
+    // 容器头解析结果优先 (DSF/DFF 的 1bit 采样率与 FLAC 的真实位深更准确)
+    if (headerComplete) {
+        if (!header.format.empty()) track.format = header.format;
+        track.sampleRate = header.sampleRate;
+        track.channels = header.channels;
+        track.bitDepth = header.bitDepth;
+        track.durationMs = header.durationMs();
+    }
+    track.endMs = track.durationMs;
+
+    int64_t fileSize = fmt_ctx->pb ? avio_size(fmt_ctx->pb) : -1;
+    if (track.bitRate <= 0 && fileSize > 0 && track.durationMs > 0) {
+        track.bitRate = fileSize * 8 * 1000 / track.durationMs;
+    }
+
+    int64_t probeUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - probeStart).count();
+    int64_t bytesRead = fmt_ctx->pb ? fmt_ctx->pb->bytes_read : 0;
+    ScanStats::add(network ? ScanStats::PROBE_NETWORK_COUNT : ScanStats::PROBE_LOCAL_COUNT);
+    if (fast) ScanStats::add(network ? ScanStats::PROBE_NETWORK_FAST : ScanStats::PROBE_LOCAL_FAST);
+    ScanStats::add(network ? ScanStats::PROBE_NETWORK_US : ScanStats::PROBE_LOCAL_US, probeUs);
+    ScanStats::add(network ? ScanStats::PROBE_NETWORK_BYTES : ScanStats::PROBE_LOCAL_BYTES, bytesRead);
+
     meta.tracks.push_back(track);
     meta.success = true;
     if (meta.totalTracks == 0) meta.totalTracks = 1;
 
-    avformat_close_input(&fmt_ctx);
+    if (network) {
+        // 探测后通常紧接着播放，保留连接与已探测的流信息
+        DemuxerHandoff::offer(path, DemuxerHandoff::headersKey(headers), fmt_ctx, !fast);
+        fmt_ctx = nullptr;
+    } else {
+        DemuxerHandoff::close(&fmt_ctx);
+    }
+    return meta;
+}
+
+// 整轨镜像只探测一次：进程内按 (路径, size + mtime) 或 TTL 复用，本地文件同时写入持久化缓存
+static InternalMetadata
+probeImage(const std::string &target, const std::map<std::string, std::string> &headers) {
+    bool network = target.find("://") != std::string::npos && target.find("file://") != 0;
+    std::string validator = network ? "" : ProbeCache::makeValidator(target, "");
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    {
+        std::lock_guard<std::mutex> lock(image_mutex);
+        auto it = image_cache.find(target);
+        if (it != image_cache.end()) {
+            bool valid = network ? now - it->second.timeMs < IMAGE_CACHE_NETWORK_TTL_MS
+                                 : !validator.empty() && it->second.validator == validator;
+            if (valid) return it->second.meta;
+            image_cache.erase(it);
+        }
+    }
+
+    InternalMetadata meta;
+    std::string persistKey = "image\n" + target;
+    if (!ProbeCache::lookup(persistKey, validator, meta)) {
+        meta = probeStandard(target, headers, "");
+        ProbeCache::store(persistKey, validator, meta);
+    }
+    // 失败 (网络抖动、文件尚未写完) 不缓存，下次重新探测
+    if (!meta.success) return meta;
+
+    std::lock_guard<std::mutex> lock(image_mutex);
+    if (image_cache.size() >= IMAGE_CACHE_MAX) {
+        auto oldest = image_cache.begin();
+        for (auto it = image_cache.begin(); it != image_cache.end(); ++it) {
+            if (it->second.timeMs < oldest->second.timeMs) oldest = it;
+        }
+        image_cache.erase(oldest);
+    }
+    image_cache[target] = {validator, now, meta};
     return meta;
 }
 
@@ -213,108 +384,41 @@ probeStandard(const std::string &path, const std::map<std::string, std::string>
 // 2. CueProbe
 // ==========================================
 static InternalMetadata
-probeCue(JNIEnv *env, const std::string &path,
+probeCue(const std::string &path,
          const std::map<std::string, std::string> &headers,
          const std::string &audioUrl) {
     InternalMetadata meta;
     meta.uri = path;
 
-    std::string content = ProbeUtils::readContent(env, path, headers);
+    std::string content = ProbeUtils::readContent(path, headers);
     if (content.empty()) return meta;
-    std::stringstream ss(content);
-    std::string line;
-
-    struct TempTrack {
-        int num;
-        std::string title;
-        std::string performer;
-        std::string file;
-        int64_t start;
-    };
-    std::vector<TempTrack> temps;
-    std::string curFile, curTitle, curPerf;
-    int curNum = 0;
-    int64_t curStart = 0;
-
-    auto unquote = [](std::string s) {
-        size_t f = s.find_first_not_of(" \t\r\n");
-        if (f == std::string::npos) return std::string("");
-        s = s.substr(f);
-        size_t l = s.find_last_not_of(" \t\r\n");
-        if (l != std::string::npos) s = s.substr(0, l + 1);
-        if (s.size() >= 2 && s.front() == '"' && s.back() == '"') return s.substr(1, s.size() - 2);
-        return s;
-    };
-
-    auto parseMs = [](const std::string &s) -> int64_t {
-        int m, sec, f;
-        if (sscanf(s.c_str(), "%d:%d:%d", &m, &sec, &f) == 3)
-            return (int64_t) m * 60000 + sec * 1000 + f * 1000 / 75;
-        return 0;
-    };
 
-    while (std::getline(ss, line)) {
-        if (!line.empty() && line.back() == '\r') line.pop_back();
-        std::stringstream ls(line);
-        std::string cmd, val;
-        ls >> cmd;
-        std::getline(ls, val);
-        val = unquote(val);
-
-        if (cmd == "TITLE") { if (curNum == 0) meta.albumTitle = val; else curTitle = val; }
-        else if (cmd == "PERFORMER") {
-            if (curNum == 0) meta.albumArtist = val; else curPerf = val;
-        } else if (cmd == "REM") {
-            if (val.find("GENRE") == 0 && val.length() >= 6) meta.genre = val.substr(6);
-            else if (val.find("DATE") == 0 && val.length() >= 5) meta.date = val.substr(5);
-            else if (val.find("COMMENT") == 0 && val.length() >= 8) meta.description = val.substr(8);
-        } else if (cmd == "FILE") {
-            std::string tempFile = val;
-            size_t lastSpace = val.find_last_of(' ');
-            if (lastSpace != std::string::npos) {
-                std::string possibleType = val.substr(lastSpace + 1);
-                // 简单的类型检测
-                if (possibleType == "WAVE" || possibleType == "MP3" || possibleType == "BINARY" ||
-                    possibleType == "FLAC" || possibleType == "APE" || possibleType == "DSD") {
-                    tempFile = val.substr(0, lastSpace);
-                }
-                curFile = unquote(tempFile);
-            } else {
-                curFile = unquote(val);
-            }
-        } else if (cmd == "TRACK") {
-            if (curNum > 0) temps.push_back({curNum, curTitle, curPerf, curFile, curStart});
-            sscanf(val.c_str(), "%d", &curNum);
-            curTitle = "Track " + std::to_string(curNum);
-            curPerf = meta.albumArtist;
-            curStart = 0;
-        } else if (cmd == "INDEX") {
-            int id;
-            char buf[32];
-            if (sscanf(val.c_str(), "%d %s", &id, buf) == 2 && id == 1) curStart = parseMs(buf);
-        }
-    }
-    if (curNum > 0) temps.push_back({curNum, curTitle, curPerf, curFile, curStart});
+    CueSheet sheet;
+    if (!CueParser::parse(content.data(), content.size(), sheet)) return meta;
+    meta.albumTitle = sheet.title;
+    meta.albumArtist = sheet.performer;
+    meta.genre = sheet.genre;
+    meta.date = sheet.date;
+    meta.description = sheet.comment;
+    const std::vector<CueTrack> &temps = sheet.tracks;
 
-    if (temps.empty()) return meta;
     meta.success = true;
     meta.totalTracks = (int) temps.size();
 
     bool isNetworkOverride = !audioUrl.empty();
-    std::map<std::string, InternalMetadata> fileCache;
 
     for (size_t i = 0; i < temps.size(); ++i) {
         InternalTrack it;
-        it.trackId = temps[i].num;
+        it.trackId = temps[i].number;
         it.discNumber = 1;
 
         std::ostringstream titleStream;
-        titleStream << std::setw(2) << std::setfill('0') << temps[i].num << ". " << temps[i].title;
+        titleStream << std::setw(2) << std::setfill('0') << temps[i].number << ". " << temps[i].title;
         it.title = titleStream.str();
         it.artist = temps[i].performer;
         it.album = meta.albumTitle;
         it.genre = meta.genre;
-        it.startMs = temps[i].start;
+        it.startMs = temps[i].startMs;
 
         // 定义用于探测元数据的实际路径 (本地路径 或 网络URL)
         std::string probeTarget;
@@ -364,13 +468,9 @@ probeCue(JNIEnv *env, const std::string &path,
         // --- 统一探测逻辑 ---
         // 只有当 probeTarget 非空时才进行探测
         if (!probeTarget.empty()) {
-            if (fileCache.find(probeTarget) == fileCache.end()) {
-                // 这里传入 headers 是为了让 probeStandard 能处理这就网络 URL 需要鉴权的情况
-                fileCache[probeTarget] = probeStandard(probeTarget, headers, "");
-            }
-
-            // 从缓存中读取元数据
-            const auto &fm = fileCache[probeTarget];
+            // 这里传入 headers 是为了让 probeStandard 能处理这就网络 URL 需要鉴权的情况
+            // 同一镜像的所有分轨 (以及之后的调用) 共享一次探测
+            InternalMetadata fm = probeImage(probeTarget, headers);
             if (fm.success && !fm.tracks.empty()) {
                 const auto &ft = fm.tracks[0];
                 it.format = ft.format;
@@ -384,7 +484,7 @@ probeCue(JNIEnv *env, const std::string &path,
             int64_t endPos = -1;
             // 如果还有下一轨，且下一轨属于同一个文件，则当前轨结束于下一轨开始
             if (i < temps.size() - 1 && temps[i + 1].file == temps[i].file) {
-                endPos = temps[i + 1].start;
+                endPos = temps[i + 1].startMs;
             }
                 // 否则（这是最后一轨，或者下一轨换文件了），使用探测到的总时长
             else if (fm.success && !fm.tracks.empty() && fm.tracks[0].durationMs > 0) {
@@ -425,42 +525,11 @@ probeSacd(const std::string &path, const std::map<std::string, std::string> &hea
     meta.uri = path;
     std::lock_guard<std::mutex> lock(sacd_mutex);
 
-    sacd_reader_t *reader = nullptr;
-    FFmpegNetworkStream *netStream = nullptr;
-    bool isNetwork = (path.find("http") == 0 || path.find("https") == 0);
-
-    if (isNetwork) {
-        netStream = new FFmpegNetworkStream();
-        // FFmpegNetworkStream 内部应该会处理 Headers，确保 UA 被传递
-        if (!netStream->open(path, headers)) {
-            LOGE("probeSacd: FFmpegNetworkStream open failed");
-            delete netStream;
-            return meta;
-        }
-        sacd_io_callbacks_t cb;
-        cb.context = netStream;
-        cb.read = FFmpegNetworkStream::read_cb;
-        cb.seek = FFmpegNetworkStream::seek_cb;
-        cb.tell = FFmpegNetworkStream::tell_cb;
-        cb.get_size = FFmpegNetworkStream::get_size_cb;
-        reader = sacd_open_callbacks(&cb);
-    } else {
-        reader = sacd_open(path.c_str());
-    }
-
-    if (!reader) {
-        LOGE("probeSacd: sacd_open failed");
-        if (netStream) delete netStream;
-        return meta;
-    }
-
-    scarletbook_handle_t *handle = scarletbook_open(reader);
-    if (!handle) {
-        LOGE("probeSacd: scarletbook_open failed (Not a valid SACD ISO)");
-        sacd_close(reader);
-        if (netStream) delete netStream;
+    SacdHandles sacd;
+    if (!SacdHandoff::open(path, headers, sacd)) {
         return meta;
     }
+    scarletbook_handle_t *handle = sacd.handle;
 
     // --- 解析成功，提取数据 ---
     master_toc_t *mtoc = handle->master_toc;
@@ -469,7 +538,7 @@ probeSacd(const std::string &path, const std::map<std::string, std::string> &hea
     meta.success = true;
     if (mtext->disc_title) meta.albumTitle = mtext->disc_title;
     if (mtext->disc_artist) meta.albumArtist = mtext->disc_artist;
-    if (mtoc->disc_genre) meta.genre = genreStr(mtoc->disc_genre->genre);
+    meta.genre = genreStr(mtoc->disc_genre[0].genre);
 
     char d[32];
     snprintf(d, 32, "%04d-%02d-%02d", mtoc->disc_date_year, mtoc->disc_date_month,
@@ -478,65 +547,93 @@ probeSacd(const std::string &path, const std::map<std::string, std::string> &hea
     meta.totalDiscs = mtoc->album_set_size;
     meta.description =
             std::to_string(mtoc->version.major) + "." + std::to_string(mtoc->version.minor);
-    if (mtoc->disc_catalog_number) meta.extraInfo = mtoc->disc_catalog_number;
-
-    scarletbook_area_t *target = nullptr;
-    // 优先找立体声区域
-    for (int i = 0; i < handle->area_count; i++) {
-        if (handle->area[i].area_toc->channel_count == 2) {
-            target = &handle->area[i];
-            break;
-        }
-    }
-    // 找不到立体声就找多声道
-    if (!target && handle->area_count > 0) target = &handle->area[0];
+    // 不足 16 字节时以 0x00 结尾，写满时没有结束符
+    meta.extraInfo.assign(mtoc->disc_catalog_number,
+                          strnlen(mtoc->disc_catalog_number, sizeof(mtoc->disc_catalog_number)));
+
+    // 只列出 SacdPlayer 实际播放的区域（立体声优先，否则多声道），
+    // 其他区域无法选择播放，列出来只会让同一首歌出现两次
+    int areaIdx = (handle->twoch_area_idx >= 0) ? handle->twoch_area_idx : handle->mulch_area_idx;
+
+    auto toMs = [](const area_tracklist_time_t &tm) {
+        return (int64_t) tm.minutes * 60000 + tm.seconds * 1000 + tm.frames * 1000 / 75;
+    };
+    if (areaIdx >= 0 && handle->area[areaIdx].area_toc) {
+        scarletbook_area_t *area = &handle->area[areaIdx];
+        area_toc_t *toc = area->area_toc;
+        meta.totalTracks = toc->track_count;
+
+        // sample_frequency 以 64 * 44.1kHz 为 4
+        int sampleRate = toc->sample_frequency > 0 ? 44100 * 16 * toc->sample_frequency : 2822400;
+        std::string format = (toc->frame_format == FRAME_FORMAT_DST ? "DST" : "DSD") +
+                             std::to_string(sampleRate / 44100);
 
-    if (target) {
-        meta.totalTracks = target->area_toc->track_count;
-        for (int i = 0; i < target->area_toc->track_count; i++) {
+        for (int i = 0; i < toc->track_count; i++) {
             InternalTrack t;
             t.trackId = i + 1;
             t.discNumber = mtoc->album_sequence_number;
             t.path = path;
             t.album = meta.albumTitle;
             t.genre = meta.genre;
+            t.sacdArea = areaIdx;
 
-            area_track_text_t *txt = &target->area_track_text[i];
+            area_track_text_t *txt = &area->area_track_text[i];
             t.title = (txt->track_type_title) ? txt->track_type_title : "Track " +
                                                                         std::to_string(i + 1);
             t.artist = (txt->track_type_performer) ? txt->track_type_performer : meta.albumArtist;
 
-            auto toMs = [](const area_tracklist_time_t &tm) {
-                return (int64_t) tm.minutes * 60000 + tm.seconds * 1000 + tm.frames * 1000 / 75;
-            };
-            t.startMs = toMs(target->area_tracklist_time->start[i]);
-            t.durationMs = toMs(target->area_tracklist_time->duration[i]);
+            t.startMs = toMs(area->area_tracklist_time->start[i]);
+            t.durationMs = toMs(area->area_tracklist_time->duration[i]);
             t.endMs = t.startMs + t.durationMs;
 
-            t.format = (target->area_toc->frame_format == FRAME_FORMAT_DST) ? "DST64" : "DSD64";
-            t.sampleRate = 2822400;
-            t.channels = target->area_toc->channel_count;
+            t.format = format;
+            t.sampleRate = sampleRate;
+            t.channels = toc->channel_count;
             t.bitDepth = 1;
             meta.tracks.push_back(t);
         }
     }
-    scarletbook_close(handle);
-    sacd_close(reader); // reader 会通过回调关闭 netStream?
-    if (netStream) delete netStream;
 
+    // 句柄暂存，随后的 SacdPlayer::prepare 不必再次打开
+    SacdHandoff::offer(path, headers, sacd);
     return meta;
 }
 
+// CUE 的结果还取决于它引用的镜像：镜像路径另存一条 Blob，校验值附加各镜像的 size + mtime
+static std::string cueImagesKey(const std::string &cacheKey) {
+    return "cue-images\n" + cacheKey;
+}
+
+static std::string cueImagesValidator(const std::string &images) {
+    std::string validator;
+    std::istringstream in(images);
+    std::string image;
+    while (std::getline(in, image)) {
+        validator += "|" + ProbeCache::makeValidator(image, "");
+    }
+    return validator;
+}
+
+static std::string cueImages(const InternalMetadata &meta) {
+    std::vector<std::string> paths;
+    for (const auto &t: meta.tracks) {
+        if (std::find(paths.begin(), paths.end(), t.path) == paths.end()) paths.push_back(t.path);
+    }
+    std::string images;
+    for (const auto &p: paths) images += p + "\n";
+    return images;
+}
+
 // ==========================================
 // 4. 入口分发
 // ==========================================
 InternalMetadata
 AudioProbe::probe(
-        JNIEnv *env,
         const std::string &source,
         const std::map<std::string, std::string> &headers,
         const std::string &filename,
-        const std::string &audioUrl
+        const std::string &audioUrl,
+        const std::string &validator
 ) {
 
     std::string nameToCheck = filename;
@@ -551,20 +648,50 @@ AudioProbe::probe(
     meta.uri = source;
     meta.success = false;
 
+    // 文件未变化时直接返回上次的结果，只需一次 stat
+    std::string cacheKey = audioUrl.empty() ? source : source + "\n" + audioUrl;
+    bool isCue = endsWith(nameToCheck, ".cue");
+    std::string cacheValidator;
+    std::string cueValidator;
+    if (ProbeCache::isOpen()) {
+        cacheValidator = ProbeCache::makeValidator(source, validator);
+        std::string images;
+        if (isCue) {
+            cueValidator = cacheValidator;
+            // 没有镜像列表时无法校验镜像，只能重新解析
+            cacheValidator = ProbeCache::lookupBlob(cueImagesKey(cacheKey), cueValidator, images)
+                             ? cueValidator + cueImagesValidator(images) : "";
+        }
+        if (ProbeCache::lookup(cacheKey, cacheValidator, meta)) {
+            LOGD("AudioProbe: cache hit");
+            LoudnessAnalyzer::attach(meta, source, validator);
+            return meta;
+        }
+    }
+
     try {
         // 解析 CUE
-        if (endsWith(nameToCheck, ".cue")) {
+        if (isCue) {
             LOGD("AudioProbe: Detected .cue extension, using probeCue");
-            return probeCue(env, source, headers, audioUrl);
-        }
-        // 解析 Sacd
-        if (endsWith(nameToCheck, ".iso")) {
+            meta = probeCue(source, headers, audioUrl);
+            if (meta.success && !cueValidator.empty()) {
+                std::string images = cueImages(meta);
+                ProbeCache::storeBlob(cueImagesKey(cacheKey), cueValidator, images);
+                cacheValidator = cueValidator + cueImagesValidator(images);
+            }
+        } else if (endsWith(nameToCheck, ".iso")) {
+            // 解析 Sacd
             LOGD("AudioProbe: Detected .iso extension, skipping FFmpeg, using probeSacd");
-            return probeSacd(source, headers);
+            meta = probeSacd(source, headers);
+        } else {
+            LOGD("AudioProbe: Attempting standard FFmpeg probe");
+            meta = probeStandard(source, headers, filename);
         }
 
-        LOGD("AudioProbe: Attempting standard FFmpeg probe");
-        meta = probeStandard(source, headers, filename);
+        if (meta.success && !cacheValidator.empty()) {
+            ProbeCache::store(cacheKey, cacheValidator, meta);
+        }
+        LoudnessAnalyzer::attach(meta, source, validator);
         return meta;
     } catch (const std::exception &e) {
         LOGE("Native crash prevented in probe: %s", e.what());
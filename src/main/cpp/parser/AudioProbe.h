@@ -4,7 +4,7 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <jni.h> // 引入 JNI 头文件
+#include <math.h>
 #include "FFmpegNetworkStream.h"
 
 // 保持结构体定义不变
@@ -24,6 +24,12 @@ struct InternalTrack {
     int channels = 0;
     int bitDepth = 0;
     int64_t bitRate = 0;
+    int sacdArea = -1; // SACD 镜像的区域序号 (scarletbook area 下标)，其他格式为 -1
+    // 响度分析结果 (见 LoudnessAnalyzer)，未分析为 NAN；不写入探测缓存，每次从分析缓存填入
+    float trackGainDb = NAN;
+    float trackPeak = NAN;
+    float albumGainDb = NAN;
+    float albumPeak = NAN;
 };
 
 struct InternalMetadata {
@@ -37,7 +43,7 @@ struct InternalMetadata {
     std::string extraInfo;
     int totalTracks = 0;
     int totalDiscs = 1;
-    std::vector<uint8_t> coverData;
+    std::string coverPath; // 已保存到磁盘的封面 (见 CoverStore)
     std::vector<InternalTrack> tracks;
     bool success = false;
 };
@@ -45,11 +51,11 @@ struct InternalMetadata {
 class AudioProbe {
 public:
     static InternalMetadata probe(
-            JNIEnv *env,
             const std::string &source,
             const std::map<std::string, std::string> &headers,
             const std::string &filename,
-            const std::string &audioUrl
+            const std::string &audioUrl,
+            const std::string &validator = "" // 网络文件的 ETag / Last-Modified，用于结果缓存
     );
 };
 
@@ -0,0 +1,179 @@
+#include "BatchProbe.h"
+#include "Logger.h"
+#include "CpuAffinity.h"
+#include "Trace.h"
+#include "ProbeInterrupt.h"
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <set>
+
+#define MAX_PROBE_THREADS 16
+
+namespace {
+
+    struct Queue {
+        std::vector<int> indices;
+        std::atomic<size_t> next{0};
+    };
+
+    struct Shared {
+        const BatchProbe::Work *work;
+        const BatchProbe::DoneCallback *callback;
+        std::mutex callbackMutex;
+        std::atomic<bool> cancelled{false};
+        std::atomic<int> delivered{0};
+        std::atomic<int64_t> workUs{0};
+    };
+
+    // 进行中的批次，供 cancelAll 使用
+    std::mutex gActiveMutex;
+    std::set<Shared *> gActive;
+
+    int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void workerLoop(JavaVM *vm, Shared *shared, Queue *queue, std::string name, bool background) {
+        qy_set_thread_name(name.c_str());
+        if (background) setBackgroundThread();
+
+        JNIEnv *env = nullptr;
+        JavaVMAttachArgs args = {JNI_VERSION_1_6, name.c_str(), nullptr};
+        if (vm->AttachCurrentThread(&env, &args) != JNI_OK) {
+            LOGE("BatchProbe: AttachCurrentThread failed");
+            return;
+        }
+
+        // 取消时中断本线程中进行的网络连接与读取
+        ProbeInterrupt::Scope interruptScope(&shared->cancelled);
+        while (!shared->cancelled.load()) {
+            size_t slot = queue->next.fetch_add(1);
+            if (slot >= queue->indices.size()) break;
+
+            int index = queue->indices[slot];
+            int64_t workStart = nowUs();
+            (*shared->work)(env, index);
+            shared->workUs += nowUs() - workStart;
+
+            // 取消后的结果 (可能是被中断的半成品) 丢弃，不计入完成数
+            std::lock_guard<std::mutex> lock(shared->callbackMutex);
+            if (shared->cancelled.load()) break;
+            shared->delivered++;
+            if (!(*shared->callback)(env, index)) {
+                shared->cancelled.store(true);
+            }
+        }
+
+        vm->DetachCurrentThread();
+    }
+
+}
+
+bool BatchProbe::isNetworkSource(const std::string &source) {
+    return source.find("://") != std::string::npos && source.find("file://") != 0;
+}
+
+int BatchProbe::run(JavaVM *vm,
+                    const std::vector<Request> &requests,
+                    const std::map<std::string, std::string> &headers,
+                    int localThreads,
+                    int networkThreads,
+                    const ResultCallback &callback,
+                    Stats *stats) {
+    if (requests.empty()) return 0;
+
+    std::vector<std::string> sources;
+    sources.reserve(requests.size());
+    for (const auto &req: requests) sources.push_back(req.source);
+
+    // 每个结果只在 work 与 callback 之间传递一次
+    std::vector<InternalMetadata> results(requests.size());
+    static const std::map<std::string, std::string> kNoHeaders;
+    int completed = forEach(
+            vm, sources, localThreads, networkThreads, "Probe",
+            [&](JNIEnv *env, int index) {
+                const Request &req = requests[index];
+                // 本地文件忽略 headers，与单文件接口的 Standard 模式一致
+                bool network = isNetworkSource(req.source);
+                results[index] = AudioProbe::probe(req.source,
+                                                   network ? headers : kNoHeaders,
+                                                   req.filename, "", req.validator);
+            },
+            [&](JNIEnv *env, int index) {
+                bool keepGoing = callback(env, index, results[index]);
+                results[index] = InternalMetadata();
+                return keepGoing;
+            }, false, stats);
+    return completed;
+}
+
+int BatchProbe::forEach(JavaVM *vm,
+                        const std::vector<std::string> &sources,
+                        int localThreads,
+                        int networkThreads,
+                        const char *name,
+                        const Work &work,
+                        const DoneCallback &callback,
+                        bool background,
+                        Stats *stats) {
+    if (sources.empty()) return 0;
+
+    Queue localQueue, networkQueue;
+    for (int i = 0; i < (int) sources.size(); ++i) {
+        if (isNetworkSource(sources[i])) networkQueue.indices.push_back(i);
+        else localQueue.indices.push_back(i);
+    }
+
+    // 线程数不超过任务数
+    localThreads = std::min(std::max(localThreads, 1), MAX_PROBE_THREADS);
+    networkThreads = std::min(std::max(networkThreads, 1), MAX_PROBE_THREADS);
+    localThreads = std::min(localThreads, (int) localQueue.indices.size());
+    networkThreads = std::min(networkThreads, (int) networkQueue.indices.size());
+
+    Shared shared;
+    shared.work = &work;
+    shared.callback = &callback;
+    {
+        std::lock_guard<std::mutex> lock(gActiveMutex);
+        gActive.insert(&shared);
+    }
+
+    int64_t start = nowUs();
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < localThreads; ++i) {
+        workers.emplace_back(workerLoop, vm, &shared, &localQueue, std::string(name) + "Local",
+                             background);
+    }
+    for (int i = 0; i < networkThreads; ++i) {
+        workers.emplace_back(workerLoop, vm, &shared, &networkQueue, std::string(name) + "Net",
+                             background);
+    }
+    for (auto &t: workers) t.join();
+    {
+        std::lock_guard<std::mutex> lock(gActiveMutex);
+        gActive.erase(&shared);
+    }
+
+    Stats result;
+    result.total = (int64_t) sources.size();
+    result.delivered = shared.delivered.load();
+    result.elapsedMs = (nowUs() - start) / 1000;
+    result.workMs = shared.workUs.load() / 1000;
+    result.cancelled = shared.cancelled.load() ? 1 : 0;
+    if (stats) *stats = result;
+    LOGD("BatchProbe(%s): %lld/%lld files in %lldms, serial estimate %lldms, local=%zu x%d, network=%zu x%d%s",
+         name, (long long) result.delivered, (long long) result.total, (long long) result.elapsedMs,
+         (long long) result.workMs, localQueue.indices.size(), localThreads,
+         networkQueue.indices.size(), networkThreads, result.cancelled ? " (cancelled)" : "");
+    return (int) result.delivered;
+}
+
+void BatchProbe::cancelAll() {
+    std::lock_guard<std::mutex> lock(gActiveMutex);
+    for (Shared *shared: gActive) shared->cancelled.store(true);
+}
@@ -0,0 +1,88 @@
+#ifndef QYPLAYER_BATCHPROBE_H
+#define QYPLAYER_BATCHPROBE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <jni.h>
+#include "AudioProbe.h"
+
+/**
+ * 批量探测 (媒体库扫描)
+ *
+ * 本地文件与网络地址分别放入两个队列，由两组工作线程并行处理：
+ * 本地受磁盘 IO 限制，线程不宜多；网络主要在等待 RTT，可以多开。
+ * 工作线程 attach 到 JVM，用于在回调中构造 Java 结果对象。
+ *
+ * 取消 (回调返回 false 或 cancelAll) 经 ProbeInterrupt 传到进行中的网络连接与读取，
+ * 被中断的任务结果直接丢弃，不再回调。
+ */
+class BatchProbe {
+public:
+    /**
+     * 一批任务的统计，JNI 以 long[STATS_SIZE] 按字段顺序返回给 Java
+     */
+    struct Stats {
+        int64_t total = 0;      // 任务数
+        int64_t delivered = 0;  // 已回调的结果数 (取消后丢弃的不计)
+        int64_t elapsedMs = 0;  // 整批墙钟耗时
+        int64_t workMs = 0;     // 各任务耗时之和，即逐个串行处理的估计耗时 (对比基线)
+        int64_t cancelled = 0;  // 1 表示被取消
+    };
+    static const int STATS_SIZE = 5;
+
+    struct Request {
+        std::string source;
+        std::string filename; // 网盘文件的原始文件名，可为空
+        std::string validator; // 网络文件的 ETag / Last-Modified，可为空
+    };
+
+    /**
+     * 每个文件完成后回调一次 (已串行化，不会并发调用)
+     * @param env 当前工作线程的 JNIEnv
+     * @return false 取消剩余任务
+     */
+    using ResultCallback = std::function<bool(JNIEnv *env, int index, InternalMetadata &meta)>;
+
+    /**
+     * 阻塞直到全部完成或被取消
+     * @param stats 可为 nullptr
+     * @return 已回调的文件数
+     */
+    static int run(JavaVM *vm,
+                   const std::vector<Request> &requests,
+                   const std::map<std::string, std::string> &headers,
+                   int localThreads,
+                   int networkThreads,
+                   const ResultCallback &callback,
+                   Stats *stats = nullptr);
+
+    /**
+     * 通用任务：work 在工作线程并行执行 (不加锁)，完成后串行调用 callback
+     * @param name 日志与线程名前缀
+     * @param background 工作线程以低优先级运行在小核上 (分析类任务)
+     * @return 已回调的任务数
+     */
+    using Work = std::function<void(JNIEnv *env, int index)>;
+    using DoneCallback = std::function<bool(JNIEnv *env, int index)>;
+
+    static int forEach(JavaVM *vm,
+                       const std::vector<std::string> &sources,
+                       int localThreads,
+                       int networkThreads,
+                       const char *name,
+                       const Work &work,
+                       const DoneCallback &callback,
+                       bool background = false,
+                       Stats *stats = nullptr);
+
+    /**
+     * 取消所有进行中的批量任务，可在任意线程调用
+     */
+    static void cancelAll();
+
+    static bool isNetworkSource(const std::string &source);
+};
+
+#endif //QYPLAYER_BATCHPROBE_H
@@ -0,0 +1,215 @@
+#include "CharsetDetector.h"
+#include "Logger.h"
+#include <errno.h>
+
+// 主机构建使用 glibc 自带的 iconv，接口相同
+#ifdef __ANDROID__
+extern "C" {
+#include <libiconv/iconv.h>
+}
+#else
+#include <iconv.h>
+#endif
+
+namespace {
+
+    enum Candidate {
+        CAND_GBK = 0,
+        CAND_BIG5,
+        CAND_SJIS,
+        CAND_COUNT
+    };
+
+    // iconv 编码名：使用各自的 Windows 超集，兼容厂商扩展字符
+    const char *kIconvNames[CAND_COUNT] = {"GBK", "CP950", "CP932"};
+
+    inline bool inRange(uint8_t c, uint8_t lo, uint8_t hi) { return c >= lo && c <= hi; }
+
+    /**
+     * 按候选编码的字节结构遍历，返回常用区得分 (每个多字节字符 0~2 分) 的千分比；
+     * 结构不合法返回 -1
+     */
+    int scoreCandidate(Candidate cand, const uint8_t *p, size_t size) {
+        int64_t score = 0;
+        int64_t multi = 0;
+        size_t i = 0;
+        while (i < size) {
+            uint8_t c = p[i];
+            if (c < 0x80) {
+                i++;
+                continue;
+            }
+            if (cand == CAND_SJIS && inRange(c, 0xA1, 0xDF)) {
+                // 半角片假名：合法但在 CUE 中很少见
+                multi++;
+                i++;
+                continue;
+            }
+            if (i + 1 >= size) return -1;
+            uint8_t t = p[i + 1];
+            int s = 0;
+            switch (cand) {
+                case CAND_GBK:
+                    if (!inRange(c, 0x81, 0xFE) || !inRange(t, 0x40, 0xFE) || t == 0x7F) return -1;
+                    if (inRange(c, 0xB0, 0xD7) && inRange(t, 0xA1, 0xFE)) s = 2;
+                    else if (inRange(c, 0xA1, 0xA9) && inRange(t, 0xA1, 0xFE)) s = 1;
+                    break;
+                case CAND_BIG5:
+                    if (!inRange(c, 0xA1, 0xF9) ||
+                        !(inRange(t, 0x40, 0x7E) || inRange(t, 0xA1, 0xFE))) {
+                        return -1;
+                    }
+                    if (inRange(c, 0xA4, 0xC6)) s = 2;
+                    else if (inRange(c, 0xA1, 0xA3)) s = 1;
+                    break;
+                case CAND_SJIS:
+                    if (!(inRange(c, 0x81, 0x9F) || inRange(c, 0xE0, 0xFC)) ||
+                        !(inRange(t, 0x40, 0x7E) || inRange(t, 0x80, 0xFC))) {
+                        return -1;
+                    }
+                    if (c == 0x82 || c == 0x83 || inRange(c, 0x88, 0x98)) s = 2;
+                    else if (c == 0x81) s = 1;
+                    break;
+                default:
+                    return -1;
+            }
+            score += s;
+            multi++;
+            i += 2;
+        }
+        return multi > 0 ? (int) (score * 1000 / (multi * 2)) : 0;
+    }
+
+}
+
+bool CharsetDetector::isValidUtf8(const uint8_t *p, size_t size) {
+    size_t i = 0;
+    while (i < size) {
+        uint8_t c = p[i];
+        if (c < 0x80) {
+            i++;
+            continue;
+        }
+        int len;
+        uint32_t cp;
+        if ((c & 0xE0) == 0xC0) {
+            len = 2;
+            cp = c & 0x1F;
+        } else if ((c & 0xF0) == 0xE0) {
+            len = 3;
+            cp = c & 0x0F;
+        } else if ((c & 0xF8) == 0xF0) {
+            len = 4;
+            cp = c & 0x07;
+        } else {
+            return false;
+        }
+        if (i + len > size) return false;
+        for (int k = 1; k < len; ++k) {
+            if ((p[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (p[i + k] & 0x3F);
+        }
+        // 拒绝过长编码、代理区和超出 Unicode 范围的码点
+        if ((len == 2 && cp < 0x80) || (len == 3 && cp < 0x800) || (len == 4 && cp < 0x10000) ||
+            (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+bool CharsetDetector::convert(const uint8_t *data, size_t size, const char *from,
+                              std::string &out, bool strict) {
+    iconv_t cd = iconv_open("UTF-8", from);
+    if (cd == (iconv_t) -1) {
+        LOGE("CharsetDetector: iconv_open %s failed", from);
+        return false;
+    }
+
+    // CJK 双字节 -> UTF-8 三字节，按 1.5 倍预分配
+    out.clear();
+    out.resize(size + size / 2 + 16);
+    char *in = (char *) data;
+    size_t inLeft = size;
+    size_t used = 0;
+    bool ok = true;
+
+    while (inLeft > 0) {
+        char *outPtr = &out[used];
+        size_t outLeft = out.size() - used;
+        size_t ret = iconv(cd, &in, &inLeft, &outPtr, &outLeft);
+        used = out.size() - outLeft;
+        if (ret != (size_t) -1) break;
+
+        if (errno == E2BIG) {
+            out.resize(out.size() * 2);
+        } else if (errno == EILSEQ && !strict) {
+            if (out.size() - used < 3) out.resize(out.size() * 2);
+            out.replace(used, 3, "\xEF\xBF\xBD");
+            used += 3;
+            in++;
+            inLeft--;
+        } else {
+            // 严格模式下的非法序列，或末尾不完整的多字节字符
+            ok = !strict && errno == EINVAL;
+            break;
+        }
+    }
+    iconv_close(cd);
+    out.resize(used);
+    return ok;
+}
+
+std::string CharsetDetector::toUtf8(const uint8_t *data, size_t size, std::string *encoding,
+                                    const char *fallback) {
+    std::string out;
+    if (!data || size == 0) return out;
+
+    // 1. BOM
+    if (size >= 3 && data[0] == 0xEF && data[1] == 0xBB && data[2] == 0xBF) {
+        if (encoding) *encoding = "UTF-8";
+        return std::string((const char *) data + 3, size - 3);
+    }
+    if (size >= 2 && ((data[0] == 0xFF && data[1] == 0xFE) || (data[0] == 0xFE && data[1] == 0xFF))) {
+        const char *name = data[0] == 0xFF ? "UTF-16LE" : "UTF-16BE";
+        if (encoding) *encoding = name;
+        convert(data + 2, size - 2, name, out, false);
+        return out;
+    }
+
+    // 2. 严格 UTF-8 (纯 ASCII 也在这里返回)
+    if (isValidUtf8(data, size)) {
+        if (encoding) *encoding = "UTF-8";
+        return std::string((const char *) data, size);
+    }
+
+    // 3. 双字节编码打分，平分时按 GBK > Big5 > Shift-JIS
+    int best = -1;
+    int bestScore = -1;
+    for (int c = 0; c < CAND_COUNT; ++c) {
+        int s = scoreCandidate((Candidate) c, data, size);
+        if (s > bestScore) {
+            best = c;
+            bestScore = s;
+        }
+    }
+    if (best >= 0 && convert(data, size, kIconvNames[best], out, true)) {
+        if (encoding) *encoding = kIconvNames[best];
+        return out;
+    }
+    // 得分最高的候选转换失败时，依次尝试其余候选
+    for (int c = 0; c < CAND_COUNT; ++c) {
+        if (c != best && scoreCandidate((Candidate) c, data, size) >= 0 &&
+            convert(data, size, kIconvNames[c], out, true)) {
+            if (encoding) *encoding = kIconvNames[c];
+            return out;
+        }
+    }
+
+    // 4. 兜底：宽容解码 (默认 GBK)
+    LOGW("CharsetDetector: strict decode failed, falling back to %s lenient mode", fallback);
+    if (encoding) *encoding = fallback;
+    convert(data, size, fallback, out, false);
+    return out;
+}
@@ -0,0 +1,35 @@
+#ifndef QYPLAYER_CHARSETDETECTOR_H
+#define QYPLAYER_CHARSETDETECTOR_H
+
+#include <string>
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * 文本编码检测与转换 (CUE 等文本文件)
+ *
+ * 顺序：BOM -> 严格 UTF-8 -> GBK / Big5 / Shift-JIS 启发式打分 -> GBK 宽容解码。
+ * 打分按各编码的双字节结构统计"常用区"字符所占比例 (GB2312 一级汉字、Big5 常用字、
+ * 平假名/片假名与 JIS 第一水准汉字)，结构不合法的候选直接淘汰。
+ * 转换使用 libiconv，不依赖 JVM，可在未 attach 的线程中调用。
+ */
+class CharsetDetector {
+public:
+    /**
+     * @param encoding 可选，输出检测到的编码名
+     * @param fallback 所有候选都无法严格转换时的宽容解码编码 (ID3 的 ISO-8859-1 文本帧传 "ISO-8859-1")
+     * @return UTF-8 文本 (不含 BOM)
+     */
+    static std::string toUtf8(const uint8_t *data, size_t size, std::string *encoding = nullptr,
+                              const char *fallback = "GBK");
+
+    static bool isValidUtf8(const uint8_t *data, size_t size);
+
+    /**
+     * @param strict true 时遇到非法序列返回 false；否则以 U+FFFD 替换后继续
+     */
+    static bool convert(const uint8_t *data, size_t size, const char *from,
+                        std::string &out, bool strict);
+};
+
+#endif //QYPLAYER_CHARSETDETECTOR_H
@@ -0,0 +1,285 @@
+#include "CoverStore.h"
+#include "ScanStats.h"
+#include "Logger.h"
+#include <mutex>
+#include <chrono>
+#include <atomic>
+#include <unordered_set>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/md5.h>
+#include <libavutil/imgutils.h>
+#include <libswscale/swscale.h>
+}
+
+#define THUMB_SUBDIR "thumbs/"
+
+const char *CoverStore::DEFAULT_DIR = "/sdcard/Music/.covers/";
+
+namespace {
+
+    struct State {
+        std::mutex mutex;
+        std::string dir = CoverStore::DEFAULT_DIR;
+        int thumbnailSize = 0;
+        bool loaded = false;
+        std::unordered_set<std::string> covers;
+        std::unordered_set<std::string> thumbs;
+    };
+
+    State gState;
+    std::atomic<int> gTmpSeq{0};
+
+    void makeDirs(const std::string &path) {
+        std::string cur;
+        for (char c: path) {
+            cur += c;
+            if (c == '/' && access(cur.c_str(), F_OK) != 0) mkdir(cur.c_str(), 0777);
+        }
+    }
+
+    void listDir(const std::string &dir, std::unordered_set<std::string> &out) {
+        DIR *d = opendir(dir.c_str());
+        if (!d) return;
+        while (struct dirent *e = readdir(d)) {
+            if (e->d_name[0] != '.') out.insert(e->d_name);
+        }
+        closedir(d);
+    }
+
+    // 首次使用时建立索引，之后只查内存
+    void ensureLoadedLocked() {
+        if (gState.loaded) return;
+        makeDirs(gState.dir);
+        makeDirs(gState.dir + THUMB_SUBDIR);
+        listDir(gState.dir, gState.covers);
+        listDir(gState.dir + THUMB_SUBDIR, gState.thumbs);
+        gState.loaded = true;
+        LOGD("CoverStore: %s, %zu covers, %zu thumbnails", gState.dir.c_str(),
+             gState.covers.size(), gState.thumbs.size());
+    }
+
+    std::string md5Hex(const uint8_t *data, size_t size) {
+        static const char kHex[] = "0123456789abcdef";
+        uint8_t digest[16];
+        av_md5_sum(digest, data, size);
+        std::string hex(32, '0');
+        for (int i = 0; i < 16; ++i) {
+            hex[i * 2] = kHex[digest[i] >> 4];
+            hex[i * 2 + 1] = kHex[digest[i] & 0x0F];
+        }
+        return hex;
+    }
+
+    const char *extensionOf(AVCodecID codecId) {
+        switch (codecId) {
+            case AV_CODEC_ID_PNG:
+                return ".png";
+            case AV_CODEC_ID_BMP:
+                return ".bmp";
+            case AV_CODEC_ID_WEBP:
+                return ".webp";
+            case AV_CODEC_ID_GIF:
+                return ".gif";
+            default:
+                return ".jpg";
+        }
+    }
+
+    // 写临时文件再 rename，其它线程/进程不会读到写了一半的文件
+    bool writeFileAtomic(const std::string &path, const uint8_t *data, size_t size) {
+        std::string tmp = path + ".tmp" + std::to_string(gTmpSeq.fetch_add(1));
+        int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return false;
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = write(fd, data + written, size - written);
+            if (n <= 0) break;
+            written += n;
+        }
+        close(fd);
+        if (written != size || rename(tmp.c_str(), path.c_str()) != 0) {
+            unlink(tmp.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    std::string baseName(const std::string &path) {
+        size_t slash = path.find_last_of('/');
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        size_t dot = name.find_last_of('.');
+        return dot == std::string::npos ? name : name.substr(0, dot);
+    }
+
+}
+
+void CoverStore::configure(const std::string &dir, int thumbnailSize) {
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    std::string newDir = dir.empty() ? DEFAULT_DIR : dir;
+    if (newDir.back() != '/') newDir += '/';
+    if (newDir != gState.dir) {
+        gState.dir = newDir;
+        gState.loaded = false;
+        gState.covers.clear();
+        gState.thumbs.clear();
+    }
+    gState.thumbnailSize = thumbnailSize > 0 ? thumbnailSize : 0;
+}
+
+std::string CoverStore::save(const uint8_t *data, size_t size, AVCodecID codecId) {
+    if (!data || size == 0) return "";
+
+    std::string hash = md5Hex(data, size);
+    std::string name = hash + extensionOf(codecId);
+    std::string thumbName = hash + ".jpg";
+
+    std::string dir;
+    int thumbnailSize;
+    bool needCover, needThumb;
+    {
+        std::lock_guard<std::mutex> lock(gState.mutex);
+        ensureLoadedLocked();
+        dir = gState.dir;
+        thumbnailSize = gState.thumbnailSize;
+        needCover = gState.covers.count(name) == 0;
+        needThumb = thumbnailSize > 0 && gState.thumbs.count(thumbName) == 0;
+    }
+
+    std::string path = dir + name;
+    if (needCover) {
+        if (!writeFileAtomic(path, data, size)) {
+            LOGE("CoverStore: failed to write %s", path.c_str());
+            return "";
+        }
+        std::lock_guard<std::mutex> lock(gState.mutex);
+        gState.covers.insert(name);
+        ScanStats::add(ScanStats::COVER_SAVED);
+        ScanStats::add(ScanStats::COVER_SAVED_BYTES, (int64_t) size);
+    } else {
+        ScanStats::add(ScanStats::COVER_DEDUPED);
+    }
+
+    if (needThumb) {
+        auto start = std::chrono::steady_clock::now();
+        bool ok = writeThumbnail(data, size, codecId, thumbnailSize, dir + THUMB_SUBDIR + thumbName);
+        ScanStats::add(ScanStats::THUMB_US, std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count());
+        if (ok) {
+            ScanStats::add(ScanStats::THUMB_CREATED);
+            std::lock_guard<std::mutex> lock(gState.mutex);
+            gState.thumbs.insert(thumbName);
+        } else {
+            ScanStats::add(ScanStats::THUMB_FAILED);
+        }
+    }
+    return path;
+}
+
+std::string CoverStore::thumbnailPath(const std::string &coverPath) {
+    if (coverPath.empty()) return "";
+    std::string dir;
+    {
+        std::lock_guard<std::mutex> lock(gState.mutex);
+        dir = gState.dir;
+    }
+    std::string path = dir + THUMB_SUBDIR + baseName(coverPath) + ".jpg";
+    return access(path.c_str(), F_OK) == 0 ? path : "";
+}
+
+// 解码 -> 等比缩放到 maxSize 以内 -> MJPEG 编码
+bool CoverStore::writeThumbnail(const uint8_t *data, size_t size, AVCodecID codecId,
+                                int maxSize, const std::string &path) {
+    const AVCodec *decoder = avcodec_find_decoder(codecId);
+    const AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    if (!decoder || !encoder) {
+        LOGW("CoverStore: thumbnail codec unavailable (%d)", codecId);
+        return false;
+    }
+
+    bool ok = false;
+    AVCodecContext *decCtx = avcodec_alloc_context3(decoder);
+    AVCodecContext *encCtx = nullptr;
+    AVPacket *pkt = av_packet_alloc();
+    AVFrame *src = av_frame_alloc();
+    AVFrame *dst = av_frame_alloc();
+    SwsContext *sws = nullptr;
+
+    do {
+        if (!decCtx || !pkt || !src || !dst) break;
+        if (avcodec_open2(decCtx, decoder, nullptr) < 0) break;
+
+        // 引用原数据，不复制
+        pkt->data = (uint8_t *) data;
+        pkt->size = (int) size;
+        if (avcodec_send_packet(decCtx, pkt) < 0) break;
+        avcodec_send_packet(decCtx, nullptr);
+        if (avcodec_receive_frame(decCtx, src) < 0) break;
+
+        int w = src->width, h = src->height;
+        if (w <= 0 || h <= 0) break;
+        if (w > maxSize || h > maxSize) {
+            if (w >= h) {
+                h = (int) ((int64_t) h * maxSize / w);
+                w = maxSize;
+            } else {
+                w = (int) ((int64_t) w * maxSize / h);
+                h = maxSize;
+            }
+        }
+        // 4:2:0 需要偶数尺寸
+        w = FFMAX(2, w & ~1);
+        h = FFMAX(2, h & ~1);
+
+        sws = sws_getContext(src->width, src->height, (AVPixelFormat) src->format,
+                             w, h, AV_PIX_FMT_YUVJ420P, SWS_BICUBIC, nullptr, nullptr, nullptr);
+        if (!sws) break;
+        dst->format = AV_PIX_FMT_YUVJ420P;
+        dst->width = w;
+        dst->height = h;
+        if (av_frame_get_buffer(dst, 0) < 0) break;
+        sws_scale(sws, src->data, src->linesize, 0, src->height, dst->data, dst->linesize);
+
+        encCtx = avcodec_alloc_context3(encoder);
+        if (!encCtx) break;
+        encCtx->width = w;
+        encCtx->height = h;
+        encCtx->pix_fmt = AV_PIX_FMT_YUVJ420P;
+        encCtx->color_range = AVCOL_RANGE_JPEG;
+        encCtx->time_base = {1, 25};
+        encCtx->flags |= AV_CODEC_FLAG_QSCALE;
+        encCtx->global_quality = FF_QP2LAMBDA * 3;
+        if (avcodec_open2(encCtx, encoder, nullptr) < 0) break;
+
+        dst->quality = encCtx->global_quality;
+        dst->pts = 0;
+        av_packet_unref(pkt);
+        if (avcodec_send_frame(encCtx, dst) < 0) break;
+        avcodec_send_frame(encCtx, nullptr);
+        if (avcodec_receive_packet(encCtx, pkt) < 0) break;
+
+        ok = writeFileAtomic(path, pkt->data, pkt->size);
+    } while (false);
+
+    if (!ok) {
+        LOGW("CoverStore: failed to create thumbnail %s", path.c_str());
+    }
+
+    // pkt->data 可能仍指向调用方的数据，先清空再释放
+    if (pkt && !pkt->buf) {
+        pkt->data = nullptr;
+        pkt->size = 0;
+    }
+    av_packet_free(&pkt);
+    sws_freeContext(sws);
+    av_frame_free(&src);
+    av_frame_free(&dst);
+    avcodec_free_context(&decCtx);
+    avcodec_free_context(&encCtx);
+    return ok;
+}
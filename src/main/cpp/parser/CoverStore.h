@@ -0,0 +1,48 @@
+#ifndef QYPLAYER_COVERSTORE_H
+#define QYPLAYER_COVERSTORE_H
+
+#include <string>
+#include <stdint.h>
+
+extern "C" {
+#include <libavcodec/codec_id.h>
+}
+
+/**
+ * 内嵌封面存储
+ *
+ * 以图片内容的 MD5 命名：同一专辑的多首曲目封面相同，只保存一份。
+ * 数据直接从 attached_pic 数据包写入磁盘 (先写临时文件再 rename)，不在内存中复制。
+ * 已保存的哈希在首次使用时从目录列表加载到内存，重复扫描只需一次哈希计算与查表。
+ *
+ * 可选生成固定尺寸的 JPEG 缩略图，保存在 <dir>/thumbs/ 下，文件名与原图相同。
+ */
+class CoverStore {
+public:
+    static const char *DEFAULT_DIR;
+
+    /**
+     * @param dir 保存目录，空字符串恢复默认目录
+     * @param thumbnailSize 缩略图最长边像素，<= 0 不生成
+     */
+    static void configure(const std::string &dir, int thumbnailSize);
+
+    /**
+     * 保存封面 (已存在则直接返回路径)
+     * @param data attached_pic 数据 (须带 AV_INPUT_BUFFER_PADDING_SIZE 填充，生成缩略图时会送给解码器)
+     * @param codecId 图片编码 (MJPEG/PNG...)，用于选择扩展名和解码器
+     * @return 原图路径，失败返回空字符串
+     */
+    static std::string save(const uint8_t *data, size_t size, AVCodecID codecId);
+
+    /**
+     * 原图路径对应的缩略图路径，缩略图不存在时返回空字符串
+     */
+    static std::string thumbnailPath(const std::string &coverPath);
+
+private:
+    static bool writeThumbnail(const uint8_t *data, size_t size, AVCodecID codecId,
+                               int maxSize, const std::string &path);
+};
+
+#endif //QYPLAYER_COVERSTORE_H
@@ -0,0 +1,141 @@
+#include "CueParser.h"
+#include <string.h>
+#include <stdio.h>
+
+namespace {
+
+    // 指向原缓冲区的片段 [begin, end)
+    struct Span {
+        const char *begin;
+        const char *end;
+
+        size_t size() const { return end - begin; }
+
+        bool empty() const { return begin >= end; }
+
+        bool equals(const char *s) const {
+            size_t n = strlen(s);
+            return size() == n && memcmp(begin, s, n) == 0;
+        }
+
+        bool startsWith(const char *s) const {
+            size_t n = strlen(s);
+            return size() >= n && memcmp(begin, s, n) == 0;
+        }
+
+        std::string str() const { return empty() ? std::string() : std::string(begin, size()); }
+    };
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+    Span trim(Span s) {
+        while (s.begin < s.end && isSpace(*s.begin)) s.begin++;
+        while (s.end > s.begin && isSpace(*(s.end - 1))) s.end--;
+        return s;
+    }
+
+    Span unquote(Span s) {
+        s = trim(s);
+        if (s.size() >= 2 && *s.begin == '"' && *(s.end - 1) == '"') {
+            s.begin++;
+            s.end--;
+        }
+        return s;
+    }
+
+    // 拆出第一个以空白分隔的单词，rest 为剩余部分
+    Span nextWord(Span s, Span &rest) {
+        s = trim(s);
+        const char *p = s.begin;
+        while (p < s.end && !isSpace(*p)) p++;
+        rest = {p, s.end};
+        return {s.begin, p};
+    }
+
+    // mm:ss:ff (75 帧/秒)
+    int64_t parseMs(Span s) {
+        char buf[32];
+        size_t n = s.size() < sizeof(buf) - 1 ? s.size() : sizeof(buf) - 1;
+        memcpy(buf, s.begin, n);
+        buf[n] = 0;
+        int m, sec, f;
+        if (sscanf(buf, "%d:%d:%d", &m, &sec, &f) == 3) {
+            return (int64_t) m * 60000 + (int64_t) sec * 1000 + (int64_t) f * 1000 / 75;
+        }
+        return 0;
+    }
+
+    int parseInt(Span s) {
+        int v = 0;
+        // 曲目号最多两位，截断超长数字避免溢出
+        for (const char *p = s.begin; p < s.end && *p >= '0' && *p <= '9' && v < 100000; ++p) v = v * 10 + (*p - '0');
+        return v;
+    }
+
+}
+
+bool CueParser::parse(const char *data, size_t size, CueSheet &out) {
+    static const char *kFileTypes[] = {"WAVE", "MP3", "BINARY", "FLAC", "APE", "DSD", "AIFF",
+                                       "MOTOROLA"};
+
+    CueTrack cur;
+    std::string curFile;
+    bool inTrack = false;
+
+    const char *p = data;
+    const char *end = data + size;
+    while (p < end) {
+        const char *lineEnd = (const char *) memchr(p, '\n', end - p);
+        if (!lineEnd) lineEnd = end;
+        Span line = {p, lineEnd};
+        p = lineEnd + 1;
+
+        Span val;
+        Span cmd = nextWord(line, val);
+        if (cmd.empty()) continue;
+        val = trim(val);
+
+        if (cmd.equals("TITLE")) {
+            if (inTrack) cur.title = unquote(val).str();
+            else out.title = unquote(val).str();
+        } else if (cmd.equals("PERFORMER")) {
+            if (inTrack) cur.performer = unquote(val).str();
+            else out.performer = unquote(val).str();
+        } else if (cmd.equals("REM")) {
+            Span rest;
+            Span key = nextWord(val, rest);
+            if (key.equals("GENRE")) out.genre = unquote(rest).str();
+            else if (key.equals("DATE")) out.date = unquote(rest).str();
+            else if (key.equals("COMMENT")) out.comment = unquote(rest).str();
+        } else if (cmd.equals("FILE")) {
+            // FILE "name" TYPE，去掉末尾的类型关键字
+            Span name = val;
+            const char *space = name.end;
+            while (space > name.begin && !isSpace(*(space - 1))) space--;
+            if (space > name.begin) {
+                Span type = {space, name.end};
+                for (const char *t: kFileTypes) {
+                    if (type.equals(t)) {
+                        name.end = space;
+                        break;
+                    }
+                }
+            }
+            curFile = unquote(name).str();
+        } else if (cmd.equals("TRACK")) {
+            if (inTrack) out.tracks.push_back(cur);
+            inTrack = true;
+            cur = CueTrack();
+            cur.number = parseInt(val);
+            cur.title = "Track " + std::to_string(cur.number);
+            cur.performer = out.performer;
+            cur.file = curFile;
+        } else if (cmd.equals("INDEX") && inTrack) {
+            Span rest;
+            Span id = nextWord(val, rest);
+            if (parseInt(id) == 1) cur.startMs = parseMs(trim(rest));
+        }
+    }
+    if (inTrack) out.tracks.push_back(cur);
+    return !out.tracks.empty();
+}
@@ -0,0 +1,39 @@
+#ifndef QYPLAYER_CUEPARSER_H
+#define QYPLAYER_CUEPARSER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+struct CueTrack {
+    int number = 0;
+    std::string title;
+    std::string performer;
+    std::string file;    // 所属 FILE 条目 (原样，未解析路径)
+    int64_t startMs = 0; // INDEX 01
+};
+
+struct CueSheet {
+    std::string title;
+    std::string performer;
+    std::string genre;
+    std::string date;
+    std::string comment;
+    std::vector<CueTrack> tracks;
+};
+
+/**
+ * CUE 解析
+ *
+ * 直接在 UTF-8 缓冲区上按指针扫描行与字段，只有最终保留的值才会复制成 std::string。
+ */
+class CueParser {
+public:
+    /**
+     * @return 是否解析出至少一个 TRACK
+     */
+    static bool parse(const char *data, size_t size, CueSheet &out);
+};
+
+#endif //QYPLAYER_CUEPARSER_H
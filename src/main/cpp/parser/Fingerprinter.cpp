@@ -0,0 +1,108 @@
+#include "Fingerprinter.h"
+#include "ProbeCache.h"
+#include "PcmDecoder.h"
+#include "ScanStats.h"
+#include "chromaprint.h"
+#include <time.h>
+
+namespace {
+
+    int64_t threadCpuUs() {
+        struct timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    std::string cacheKey(const std::string &source, int maxSeconds) {
+        return "fp\n" + std::to_string(maxSeconds) + "\n" + source;
+    }
+
+    // 缓存值："<durationMs>\n<fingerprint>"
+    bool decodeCached(const std::string &value, FingerprintResult &out) {
+        size_t nl = value.find('\n');
+        if (nl == std::string::npos || nl + 1 >= value.size()) return false;
+        out.durationMs = strtoll(value.c_str(), nullptr, 10);
+        out.fingerprint = value.substr(nl + 1);
+        out.success = true;
+        out.cached = true;
+        return true;
+    }
+
+}
+
+FingerprintResult Fingerprinter::compute(const std::string &source,
+                                         const std::map<std::string, std::string> &headers,
+                                         int maxSeconds,
+                                         const std::string &validator) {
+    if (maxSeconds <= 0) maxSeconds = DEFAULT_SECONDS;
+
+    FingerprintResult result;
+    std::string key = cacheKey(source, maxSeconds);
+    std::string cacheValidator = ProbeCache::isOpen() ? ProbeCache::makeValidator(source, validator) : "";
+    std::string cachedValue;
+    if (!cacheValidator.empty() && ProbeCache::lookupBlob(key, cacheValidator, cachedValue) &&
+        decodeCached(cachedValue, result)) {
+        ScanStats::add(ScanStats::FINGERPRINT_CACHED);
+        return result;
+    }
+
+    int64_t cpuStart = threadCpuUs();
+    int64_t audioMs = 0;
+    result = decodeAndFingerprint(source, headers, maxSeconds, audioMs);
+    int64_t cpuUs = threadCpuUs() - cpuStart;
+
+    if (result.success) {
+        ProbeCache::storeBlob(key, cacheValidator,
+                              std::to_string((long long) result.durationMs) + "\n" + result.fingerprint);
+    }
+
+    if (result.success) {
+        ScanStats::add(ScanStats::FINGERPRINT_COMPUTED);
+        ScanStats::add(ScanStats::FINGERPRINT_AUDIO_MS, audioMs);
+        ScanStats::add(ScanStats::FINGERPRINT_CPU_US, cpuUs);
+    } else {
+        ScanStats::add(ScanStats::FINGERPRINT_FAILED);
+    }
+    return result;
+}
+
+FingerprintResult
+Fingerprinter::decodeAndFingerprint(const std::string &source,
+                                    const std::map<std::string, std::string> &headers,
+                                    int maxSeconds, int64_t &audioMs) {
+    FingerprintResult result;
+    PcmDecoder decoder;
+    if (!decoder.open(source, headers) || !decoder.setOutput(1, SAMPLE_RATE, AV_SAMPLE_FMT_S16)) {
+        return result;
+    }
+
+    ChromaprintContext *ctx = chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
+    if (!ctx) return result;
+    if (!chromaprint_start(ctx, SAMPLE_RATE, 1)) {
+        chromaprint_free(ctx);
+        return result;
+    }
+
+    int64_t remaining = (int64_t) maxSeconds * SAMPLE_RATE;
+    uint8_t **data = nullptr;
+    int n;
+    while (remaining > 0 && (n = decoder.read(data)) > 0) {
+        if (n > remaining) n = (int) remaining;
+        if (!chromaprint_feed(ctx, (const int16_t *) data[0], n)) break;
+        remaining -= n;
+    }
+
+    int64_t fedSamples = (int64_t) maxSeconds * SAMPLE_RATE - remaining;
+    char *fp = nullptr;
+    if (fedSamples > 0 && chromaprint_finish(ctx) && chromaprint_get_fingerprint(ctx, &fp) && fp) {
+        result.fingerprint = fp;
+        chromaprint_dealloc(fp);
+    }
+    chromaprint_free(ctx);
+
+    audioMs = fedSamples * 1000 / SAMPLE_RATE;
+    result.durationMs = decoder.getDurationMs();
+    if (result.durationMs <= 0) result.durationMs = audioMs;
+    result.success = !result.fingerprint.empty();
+    return result;
+}
@@ -0,0 +1,44 @@
+#ifndef QYPLAYER_FINGERPRINTER_H
+#define QYPLAYER_FINGERPRINTER_H
+
+#include <string>
+#include <map>
+#include <stdint.h>
+
+struct FingerprintResult {
+    bool success = false;
+    std::string fingerprint; // chromaprint 压缩编码 (URL-safe base64)，可直接用于 AcoustID 查询
+    int64_t durationMs = 0;  // 整个文件的时长 (AcoustID 查询需要)
+    bool cached = false;
+};
+
+/**
+ * 音频指纹
+ *
+ * 只解码开头 maxSeconds 秒：PcmDecoder 输出 11025Hz 单声道 S16
+ * (chromaprint 内部的工作格式，省掉它自己的重采样) -> chromaprint。
+ *
+ * 结果写入 ProbeCache (key 前缀 "fp")，文件未变化时直接返回缓存。线程安全。
+ */
+class Fingerprinter {
+public:
+    static const int SAMPLE_RATE = 11025;
+    // AcoustID 推荐的指纹长度
+    static const int DEFAULT_SECONDS = 120;
+
+    /**
+     * @param maxSeconds 参与计算的音频长度，<= 0 时使用 DEFAULT_SECONDS
+     * @param validator 网络文件的 ETag / Last-Modified (可为空)
+     */
+    static FingerprintResult compute(const std::string &source,
+                                     const std::map<std::string, std::string> &headers,
+                                     int maxSeconds,
+                                     const std::string &validator = "");
+
+private:
+    static FingerprintResult decodeAndFingerprint(const std::string &source,
+                                                  const std::map<std::string, std::string> &headers,
+                                                  int maxSeconds, int64_t &audioMs);
+};
+
+#endif //QYPLAYER_FINGERPRINTER_H
@@ -0,0 +1,164 @@
+#include "HeaderProbe.h"
+#include <string.h>
+
+static inline uint16_t rl16(const uint8_t *p) { return p[0] | (p[1] << 8); }
+
+static inline uint32_t rl32(const uint8_t *p) {
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static inline uint64_t rl64(const uint8_t *p) { return rl32(p) | ((uint64_t) rl32(p + 4) << 32); }
+
+static inline uint16_t rb16(const uint8_t *p) { return (p[0] << 8) | p[1]; }
+
+static inline uint32_t rb32(const uint8_t *p) {
+    return ((uint32_t) p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline uint64_t rb64(const uint8_t *p) { return ((uint64_t) rb32(p) << 32) | rb32(p + 4); }
+
+static std::string dsdName(int sampleRate) {
+    return "DSD" + std::to_string(sampleRate / 44100);
+}
+
+bool HeaderProbe::parse(const uint8_t *data, size_t size, HeaderInfo &out) {
+    if (!data || size < 12) return false;
+
+    // FLAC 前面可能有 ID3v2
+    size_t offset = 0;
+    if (memcmp(data, "ID3", 3) == 0 && size >= 10) {
+        offset = 10 + (((data[6] & 0x7F) << 21) | ((data[7] & 0x7F) << 14) |
+                       ((data[8] & 0x7F) << 7) | (data[9] & 0x7F));
+        if (offset + 4 > size) return false;
+    }
+
+    if (memcmp(data + offset, "fLaC", 4) == 0) {
+        return parseFlac(data + offset, size - offset, out);
+    }
+    if ((memcmp(data, "RIFF", 4) == 0 || memcmp(data, "RF64", 4) == 0) &&
+        memcmp(data + 8, "WAVE", 4) == 0) {
+        return parseWav(data, size, out);
+    }
+    if (memcmp(data, "DSD ", 4) == 0) return parseDsf(data, size, out);
+    if (memcmp(data, "FRM8", 4) == 0 && size >= 16 && memcmp(data + 12, "DSD ", 4) == 0) {
+        return parseDff(data, size, out);
+    }
+    return false;
+}
+
+// fLaC + METADATA_BLOCK_HEADER(4) + STREAMINFO(34)，STREAMINFO 必须是第一个块
+bool HeaderProbe::parseFlac(const uint8_t *data, size_t size, HeaderInfo &out) {
+    out.format = "flac";
+    if (size < 4 + 4 + 34) return true;
+    const uint8_t *hdr = data + 4;
+    if ((hdr[0] & 0x7F) != 0) return true;
+
+    const uint8_t *si = hdr + 4;
+    out.sampleRate = (si[10] << 12) | (si[11] << 4) | (si[12] >> 4);
+    out.channels = ((si[12] >> 1) & 0x07) + 1;
+    out.bitDepth = (((si[12] & 0x01) << 4) | (si[13] >> 4)) + 1;
+    out.totalSamples = ((int64_t) (si[13] & 0x0F) << 32) | rb32(si + 14);
+    return true;
+}
+
+bool HeaderProbe::parseWav(const uint8_t *data, size_t size, HeaderInfo &out) {
+    bool rf64 = memcmp(data, "RF64", 4) == 0;
+    int blockAlign = 0;
+    int formatTag = 0;
+    uint64_t ds64DataSize = 0;
+
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t *chunk = data + pos;
+        uint32_t chunkSize = rl32(chunk + 4);
+        const uint8_t *body = chunk + 8;
+        size_t avail = size - pos - 8;
+
+        if (memcmp(chunk, "ds64", 4) == 0 && avail >= 16) {
+            ds64DataSize = rl64(body + 8);
+        } else if (memcmp(chunk, "fmt ", 4) == 0 && avail >= 16) {
+            formatTag = rl16(body);
+            out.channels = rl16(body + 2);
+            out.sampleRate = (int) rl32(body + 4);
+            blockAlign = rl16(body + 12);
+            out.bitDepth = rl16(body + 14);
+            // WAVE_FORMAT_EXTENSIBLE：有效位深与真实格式在扩展部分
+            if (formatTag == 0xFFFE && chunkSize >= 40 && avail >= 40) {
+                int validBits = rl16(body + 18);
+                if (validBits > 0) out.bitDepth = validBits;
+                formatTag = rl16(body + 24);
+            }
+        } else if (memcmp(chunk, "data", 4) == 0) {
+            uint64_t dataSize = chunkSize;
+            if (rf64 && chunkSize == 0xFFFFFFFF) dataSize = ds64DataSize;
+            if (blockAlign > 0) out.totalSamples = (int64_t) (dataSize / blockAlign);
+            break;
+        }
+        // 块按偶数字节对齐
+        pos += 8 + (size_t) chunkSize + (chunkSize & 1);
+    }
+
+    // 1 = 整数 PCM，3 = 浮点 PCM；其它编码 (ADPCM/MP3...) 交给 FFmpeg
+    if (formatTag == 1 || formatTag == 3) {
+        out.format = "pcm";
+    } else {
+        out.format.clear();
+        out.totalSamples = 0;
+    }
+    return true;
+}
+
+// "DSD " 块 (28 字节) 后紧跟 "fmt " 块，小端
+bool HeaderProbe::parseDsf(const uint8_t *data, size_t size, HeaderInfo &out) {
+    if (size < 28 + 52 || memcmp(data + 28, "fmt ", 4) != 0) return true;
+    const uint8_t *fmt = data + 28;
+    out.channels = (int) rl32(fmt + 24);
+    out.sampleRate = (int) rl32(fmt + 28);
+    out.bitDepth = 1;
+    out.totalSamples = (int64_t) rl64(fmt + 36);
+    out.format = dsdName(out.sampleRate);
+    return true;
+}
+
+// FRM8 容器，大端；PROP/SND 中取 FS 与 CHNL，随后的 DSD/DST 块给出时长
+bool HeaderProbe::parseDff(const uint8_t *data, size_t size, HeaderInfo &out) {
+    out.bitDepth = 1;
+    size_t pos = 16;
+    while (pos + 12 <= size) {
+        const uint8_t *chunk = data + pos;
+        uint64_t chunkSize = rb64(chunk + 4);
+        const uint8_t *body = chunk + 12;
+        size_t avail = size - pos - 12;
+
+        if (memcmp(chunk, "PROP", 4) == 0 && avail >= 4 && memcmp(body, "SND ", 4) == 0) {
+            size_t sub = 4;
+            size_t end = chunkSize < avail ? (size_t) chunkSize : avail;
+            while (sub + 12 <= end) {
+                const uint8_t *sc = body + sub;
+                uint64_t scSize = rb64(sc + 4);
+                if (memcmp(sc, "FS  ", 4) == 0 && sub + 16 <= end) {
+                    out.sampleRate = (int) rb32(sc + 12);
+                } else if (memcmp(sc, "CHNL", 4) == 0 && sub + 14 <= end) {
+                    out.channels = rb16(sc + 12);
+                }
+                sub += 12 + (size_t) scSize + (scSize & 1);
+            }
+        } else if (memcmp(chunk, "DSD ", 4) == 0) {
+            if (out.channels > 0) out.totalSamples = (int64_t) (chunkSize * 8 / out.channels);
+            break;
+        } else if (memcmp(chunk, "DST ", 4) == 0) {
+            // DST 压缩：FRTE 给出帧数与帧率 (通常 75 帧/秒)
+            if (avail >= 18 && memcmp(body, "FRTE", 4) == 0) {
+                uint32_t frames = rb32(body + 12);
+                uint16_t frameRate = rb16(body + 16);
+                if (frameRate > 0 && out.sampleRate > 0) {
+                    out.totalSamples = (int64_t) frames * out.sampleRate / frameRate;
+                }
+            }
+            break;
+        }
+        pos += 12 + (size_t) chunkSize + (chunkSize & 1);
+    }
+    if (out.sampleRate > 0) out.format = dsdName(out.sampleRate);
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef QYPLAYER_HEADERPROBE_H
+#define QYPLAYER_HEADERPROBE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+/**
+ * 容器头快速解析
+ *
+ * FLAC (STREAMINFO)、WAV (fmt/data)、DSF (fmt)、DFF (PROP/DSD) 的采样率、声道、位深和总样本数
+ * 都在文件开头几 KB 内，直接解析即可，无需 avformat_find_stream_info 解码数据包。
+ * 字段不全 (例如 WAV 的 data 块在缓冲之外) 时返回不完整结果，由调用方回退。
+ */
+struct HeaderInfo {
+    std::string format;        // flac / pcm / DSD64 ...
+    int sampleRate = 0;        // DSD 为 1bit 采样率 (2822400...)
+    int channels = 0;
+    int bitDepth = 0;
+    int64_t totalSamples = 0;  // 每声道样本数 (DSD 为 bit 数)
+
+    bool isComplete() const {
+        return sampleRate > 0 && channels > 0 && bitDepth > 0 && totalSamples > 0;
+    }
+
+    int64_t durationMs() const {
+        return sampleRate > 0 ? totalSamples * 1000 / sampleRate : 0;
+    }
+};
+
+class HeaderProbe {
+public:
+    // 调用方至少提供的头部字节数
+    static const size_t HEAD_SIZE = 64 * 1024;
+
+    /**
+     * @return 是否识别出容器 (识别出但字段不全时也返回 true，需检查 isComplete)
+     */
+    static bool parse(const uint8_t *data, size_t size, HeaderInfo &out);
+
+private:
+    static bool parseFlac(const uint8_t *data, size_t size, HeaderInfo &out);
+
+    static bool parseWav(const uint8_t *data, size_t size, HeaderInfo &out);
+
+    static bool parseDsf(const uint8_t *data, size_t size, HeaderInfo &out);
+
+    static bool parseDff(const uint8_t *data, size_t size, HeaderInfo &out);
+};
+
+#endif //QYPLAYER_HEADERPROBE_H
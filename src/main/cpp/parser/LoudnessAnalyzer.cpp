@@ -0,0 +1,229 @@
+#include "LoudnessAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "PcmDecoder.h"
+#include "ProbeCache.h"
+#include "ScanStats.h"
+#include <time.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+extern "C" {
+#include <libavutil/channel_layout.h>
+}
+
+// 超过该采样率时先降采样 (DSD 解码输出 352.8kHz 以上)，对 K 计权响度没有影响
+#define MAX_ANALYSIS_RATE 192000
+
+namespace {
+
+    int64_t threadCpuUs() {
+        struct timespec ts{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+
+    std::string cacheKey(const std::string &source, int64_t startMs, int64_t endMs) {
+        return "lufs\n" + std::to_string((long long) startMs) + "\n" +
+               std::to_string((long long) endMs) + "\n" + source;
+    }
+
+    /*
+     * 缓存值：
+     *   第一行 "integratedLufs truePeak hasAlbum albumLufs albumPeak"
+     *   第二行 稀疏直方图 "bin:count,bin:count,..."
+     */
+    std::string encode(const LoudnessResult &r) {
+        char line[160];
+        snprintf(line, sizeof(line), "%.3f %.6f %d %.3f %.6f\n", r.integratedLufs, r.truePeak,
+                 r.hasAlbum ? 1 : 0, r.albumLufs, r.albumPeak);
+        std::string out = line;
+        for (size_t i = 0; i < r.histogram.size(); ++i) {
+            if (r.histogram[i] == 0) continue;
+            out += std::to_string(i) + ":" + std::to_string(r.histogram[i]) + ",";
+        }
+        return out;
+    }
+
+    bool decode(const std::string &value, LoudnessResult &r) {
+        const char *p = value.c_str();
+        char *end;
+        r.integratedLufs = strtod(p, &end);
+        if (end == p) return false;
+        r.truePeak = strtod(p = end, &end);
+        r.hasAlbum = strtol(p = end, &end, 10) != 0;
+        r.albumLufs = strtod(p = end, &end);
+        r.albumPeak = strtod(p = end, &end);
+        if (end == p || *end != '\n') return false;
+
+        r.histogram.assign(LoudnessMeter::HISTOGRAM_BINS, 0);
+        p = end + 1;
+        while (*p) {
+            long bin = strtol(p, &end, 10);
+            if (end == p || *end != ':') return false;
+            long count = strtol(p = end + 1, &end, 10);
+            if (end == p || bin < 0 || bin >= LoudnessMeter::HISTOGRAM_BINS) return false;
+            r.histogram[bin] = (uint32_t) count;
+            p = *end == ',' ? end + 1 : end;
+        }
+        r.success = true;
+        r.cached = true;
+        return true;
+    }
+
+    // BS.1770 声道权重：LFE 不计，环绕声道 +1.5dB
+    std::vector<float> channelWeights(const AVChannelLayout &layout) {
+        std::vector<float> weights(layout.nb_channels, 1.0f);
+        for (int c = 0; c < layout.nb_channels; ++c) {
+            switch (av_channel_layout_channel_from_index(&layout, c)) {
+                case AV_CHAN_LOW_FREQUENCY:
+                case AV_CHAN_LOW_FREQUENCY_2:
+                    weights[c] = 0.0f;
+                    break;
+                case AV_CHAN_SIDE_LEFT:
+                case AV_CHAN_SIDE_RIGHT:
+                case AV_CHAN_BACK_LEFT:
+                case AV_CHAN_BACK_RIGHT:
+                    weights[c] = 1.41f;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return weights;
+    }
+
+    std::string validatorFor(const std::string &source, const std::string &validator) {
+        return ProbeCache::isOpen() ? ProbeCache::makeValidator(source, validator) : "";
+    }
+
+}
+
+bool LoudnessAnalyzer::lookup(const std::string &source, int64_t startMs, int64_t endMs,
+                              const std::string &cacheValidator, LoudnessResult &out) {
+    std::string value;
+    return !cacheValidator.empty() &&
+           ProbeCache::lookupBlob(cacheKey(source, startMs, endMs), cacheValidator, value) &&
+           decode(value, out);
+}
+
+void LoudnessAnalyzer::store(const std::string &source, int64_t startMs, int64_t endMs,
+                             const std::string &cacheValidator, const LoudnessResult &result) {
+    if (!result.success || cacheValidator.empty()) return;
+    ProbeCache::storeBlob(cacheKey(source, startMs, endMs), cacheValidator, encode(result));
+}
+
+LoudnessResult LoudnessAnalyzer::analyze(const std::string &source,
+                                         const std::map<std::string, std::string> &headers,
+                                         int64_t startMs, int64_t endMs,
+                                         const std::string &validator) {
+    LoudnessResult result;
+    std::string cacheValidator = validatorFor(source, validator);
+    if (lookup(source, startMs, endMs, cacheValidator, result)) {
+        ScanStats::add(ScanStats::LOUDNESS_CACHED);
+        return result;
+    }
+
+    int64_t cpuStart = threadCpuUs();
+    PcmDecoder decoder;
+    bool opened = decoder.open(source, headers);
+    int64_t audioMs = 0;
+    if (opened) {
+        // 先按原采样率打开，再决定是否需要降采样
+        opened = decoder.setOutput(0, 0, AV_SAMPLE_FMT_FLTP);
+        int rate = decoder.getSampleRate();
+        if (opened && rate > MAX_ANALYSIS_RATE) {
+            opened = decoder.setOutput(0, rate % 44100 == 0 ? 176400 : 192000, AV_SAMPLE_FMT_FLTP);
+        }
+    }
+    if (opened && startMs > 0) opened = decoder.seek(startMs);
+
+    if (opened) {
+        int rate = decoder.getSampleRate();
+        std::vector<float> weights = channelWeights(decoder.getChannelLayout());
+        LoudnessMeter meter(rate, decoder.getChannels(), weights.data());
+
+        int64_t remaining = endMs > startMs ? (endMs - startMs) * rate / 1000 : INT64_MAX;
+        int64_t total = 0;
+        uint8_t **data = nullptr;
+        int n;
+        while (remaining > 0 && (n = decoder.read(data)) > 0) {
+            if (n > remaining) n = (int) remaining;
+            meter.process((const float *const *) data, n);
+            remaining -= n;
+            total += n;
+        }
+
+        if (total > 0) {
+            result.success = true;
+            result.integratedLufs = meter.integratedLufs();
+            result.truePeak = meter.truePeak();
+            result.histogram = meter.histogram();
+            audioMs = total * 1000 / rate;
+        }
+    }
+    int64_t cpuUs = threadCpuUs() - cpuStart;
+
+    store(source, startMs, endMs, cacheValidator, result);
+
+    if (result.success) {
+        ScanStats::add(ScanStats::LOUDNESS_ANALYZED);
+        ScanStats::add(ScanStats::LOUDNESS_AUDIO_MS, audioMs);
+        ScanStats::add(ScanStats::LOUDNESS_CPU_US, cpuUs);
+    } else {
+        ScanStats::add(ScanStats::LOUDNESS_FAILED);
+    }
+    return result;
+}
+
+void LoudnessAnalyzer::applyAlbum(const std::vector<LoudnessResult *> &tracks,
+                                  const std::vector<std::string> &sources,
+                                  const std::vector<int64_t> &startMs,
+                                  const std::vector<int64_t> &endMs,
+                                  const std::vector<std::string> &validators) {
+    std::vector<uint32_t> merged(LoudnessMeter::HISTOGRAM_BINS, 0);
+    double peak = 0;
+    bool any = false;
+    for (const LoudnessResult *t: tracks) {
+        if (!t->success) continue;
+        for (size_t i = 0; i < t->histogram.size() && i < merged.size(); ++i) {
+            merged[i] += t->histogram[i];
+        }
+        peak = std::max(peak, t->truePeak);
+        any = true;
+    }
+    if (!any) return;
+
+    double albumLufs = LoudnessMeter::gatedLoudness(merged);
+    for (size_t i = 0; i < tracks.size(); ++i) {
+        LoudnessResult *t = tracks[i];
+        if (!t->success) continue;
+        bool changed = !t->hasAlbum || t->albumLufs != albumLufs || t->albumPeak != peak;
+        t->hasAlbum = true;
+        t->albumLufs = albumLufs;
+        t->albumPeak = peak;
+        if (changed) store(sources[i], startMs[i], endMs[i], validatorFor(sources[i], validators[i]), *t);
+    }
+}
+
+void LoudnessAnalyzer::attach(InternalMetadata &meta, const std::string &source,
+                              const std::string &validator) {
+    if (!meta.success || !ProbeCache::isOpen()) return;
+
+    // CUE 的各曲目通常指向同一个文件，校验值只计算一次
+    std::string lastPath;
+    std::string lastValidator;
+    for (auto &t: meta.tracks) {
+        if (t.path != lastPath) {
+            lastPath = t.path;
+            lastValidator = validatorFor(t.path, t.path == source ? validator : "");
+        }
+        LoudnessResult r;
+        if (!lookup(t.path, t.startMs, t.endMs, lastValidator, r)) continue;
+        t.trackGainDb = (float) gainDb(r.integratedLufs);
+        t.trackPeak = (float) r.truePeak;
+        if (r.hasAlbum) {
+            t.albumGainDb = (float) gainDb(r.albumLufs);
+            t.albumPeak = (float) r.albumPeak;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef QYPLAYER_LOUDNESSANALYZER_H
+#define QYPLAYER_LOUDNESSANALYZER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <stdint.h>
+#include <math.h>
+#include "AudioProbe.h"
+
+struct LoudnessResult {
+    bool success = false;
+    bool cached = false;
+    double integratedLufs = 0;
+    double truePeak = 0;       // 线性
+    bool hasAlbum = false;
+    double albumLufs = 0;
+    double albumPeak = 0;
+    std::vector<uint32_t> histogram; // 块响度直方图，用于合并计算专辑响度
+};
+
+/**
+ * 响度分析 (ReplayGain 2.0 / EBU R128)
+ *
+ * PcmDecoder 解码为平面 float (> 192kHz 时降到 176.4k/192k) -> LoudnessMeter。
+ * 结果连同块响度直方图写入 ProbeCache (key 前缀 "lufs")，专辑增益由同专辑曲目的直方图合并得到，
+ * 已分析过的曲目重新组合专辑时无需再次解码。
+ *
+ * AudioProbe::probe 返回前通过 attach() 把缓存中的增益填入曲目，播放时直接使用，无需分析。
+ */
+class LoudnessAnalyzer {
+public:
+    // ReplayGain 2.0 参考响度
+    static constexpr double REFERENCE_LUFS = -18.0;
+
+    /**
+     * 分析 [startMs, endMs) 区间；endMs <= startMs 表示到文件结尾
+     */
+    static LoudnessResult analyze(const std::string &source,
+                                  const std::map<std::string, std::string> &headers,
+                                  int64_t startMs, int64_t endMs,
+                                  const std::string &validator = "");
+
+    /**
+     * 合并同专辑曲目的直方图，填入各自的专辑响度与峰值并更新缓存
+     */
+    static void applyAlbum(const std::vector<LoudnessResult *> &tracks,
+                           const std::vector<std::string> &sources,
+                           const std::vector<int64_t> &startMs,
+                           const std::vector<int64_t> &endMs,
+                           const std::vector<std::string> &validators);
+
+    /**
+     * 从缓存中为 meta 的各曲目填入增益 (未分析过的曲目保持 NAN)
+     */
+    static void attach(InternalMetadata &meta, const std::string &source, const std::string &validator);
+
+    static double gainDb(double lufs) {
+        return lufs > -HUGE_VAL ? REFERENCE_LUFS - lufs : 0;
+    }
+
+private:
+    static bool lookup(const std::string &source, int64_t startMs, int64_t endMs,
+                       const std::string &cacheValidator, LoudnessResult &out);
+
+    static void store(const std::string &source, int64_t startMs, int64_t endMs,
+                      const std::string &cacheValidator, const LoudnessResult &result);
+};
+
+#endif //QYPLAYER_LOUDNESSANALYZER_H
@@ -0,0 +1,187 @@
+#include "LoudnessMeter.h"
+#include <math.h>
+#include <algorithm>
+
+// 直方图下限与分辨率
+#define HIST_MIN_LUFS (-70.0)
+#define HIST_STEP_LU 0.1
+#define ABSOLUTE_GATE_LUFS (-70.0)
+#define RELATIVE_GATE_LU (-10.0)
+// 每相 FIR 长度
+#define TRUE_PEAK_TAPS 12
+
+namespace {
+
+    inline double energyToLufs(double e) { return -0.691 + 10.0 * log10(e); }
+
+    inline double lufsToEnergy(double l) { return pow(10.0, (l + 0.691) / 10.0); }
+
+    inline double binEnergy(int bin) {
+        return lufsToEnergy(HIST_MIN_LUFS + (bin + 0.5) * HIST_STEP_LU);
+    }
+
+}
+
+LoudnessMeter::LoudnessMeter(int sampleRate, int channels, const float *weights)
+        : mChannels(channels), mState(channels), mHistogram(HISTOGRAM_BINS, 0) {
+    // K 计权系数 (BS.1770 给出的是 48kHz 值，这里按模拟原型对任意采样率重新推导)
+    double f0 = 1681.974450955533;
+    double G = 3.999843853973347;
+    double Q = 0.7071752369554196;
+    double K = tan(M_PI * f0 / sampleRate);
+    double Vh = pow(10.0, G / 20.0);
+    double Vb = pow(Vh, 0.4996667741545416);
+    double a0 = 1.0 + K / Q + K * K;
+    mShelf = {(Vh + Vb * K / Q + K * K) / a0, 2.0 * (K * K - Vh) / a0,
+              (Vh - Vb * K / Q + K * K) / a0, 2.0 * (K * K - 1.0) / a0,
+              (1.0 - K / Q + K * K) / a0};
+
+    f0 = 38.13547087602444;
+    Q = 0.5003270373238773;
+    K = tan(M_PI * f0 / sampleRate);
+    a0 = 1.0 + K / Q + K * K;
+    mHighPass = {1.0, -2.0, 1.0, 2.0 * (K * K - 1.0) / a0, (1.0 - K / Q + K * K) / a0};
+
+    for (int c = 0; c < channels; ++c) {
+        if (weights) mState[c].weight = weights[c];
+    }
+    mSubBlockSize = std::max(1, (sampleRate + 5) / 10);
+
+    // 真峰值：采样率越高，采样点之间的峰值误差越小，过采样倍数随之降低
+    mOversample = sampleRate < 96000 ? 4 : (sampleRate < 192000 ? 2 : 1);
+    mTaps = TRUE_PEAK_TAPS;
+    if (mOversample > 1) {
+        // Hann 窗 sinc 低通，截止频率为原 Nyquist
+        int n = mTaps * mOversample;
+        std::vector<double> h(n);
+        for (int i = 0; i < n; ++i) {
+            double x = (i - (n - 1) / 2.0) / mOversample;
+            double sinc = x == 0 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+            double window = 0.5 - 0.5 * cos(2.0 * M_PI * (i + 0.5) / n);
+            h[i] = sinc * window;
+        }
+        mPhases.resize(mOversample * mTaps);
+        for (int p = 0; p < mOversample; ++p) {
+            double sum = 0;
+            for (int j = 0; j < mTaps; ++j) sum += h[j * mOversample + p];
+            // 每相直流增益归一化为 1
+            for (int j = 0; j < mTaps; ++j) {
+                mPhases[p * mTaps + j] = (float) (h[(mTaps - 1 - j) * mOversample + p] / sum);
+            }
+        }
+        for (auto &s: mState) s.history.assign(mTaps - 1, 0.0f);
+    }
+}
+
+void LoudnessMeter::process(const float *const *planes, int samples) {
+    if (samples <= 0) return;
+    updatePeak(planes, samples);
+
+    int offset = 0;
+    while (offset < samples) {
+        int count = std::min(samples - offset, mSubBlockSize - mSubBlockFill);
+        filterSegment(planes, offset, count);
+        offset += count;
+        mSubBlockFill += count;
+        if (mSubBlockFill == mSubBlockSize) finishSubBlock();
+    }
+}
+
+void LoudnessMeter::filterSegment(const float *const *planes, int offset, int count) {
+    const Biquad s = mShelf;
+    const Biquad h = mHighPass;
+    for (int c = 0; c < mChannels; ++c) {
+        ChannelState &st = mState[c];
+        if (st.weight == 0.0f) continue;
+        const float *x = planes[c] + offset;
+        // 转置直接 II 型，状态放在局部变量中，循环体无分支
+        double z0 = st.z[0], z1 = st.z[1], z2 = st.z[2], z3 = st.z[3];
+        double sum = 0;
+        for (int i = 0; i < count; ++i) {
+            double in = x[i];
+            double y1 = s.b0 * in + z0;
+            z0 = s.b1 * in - s.a1 * y1 + z1;
+            z1 = s.b2 * in - s.a2 * y1;
+            double y2 = h.b0 * y1 + z2;
+            z2 = h.b1 * y1 - h.a1 * y2 + z3;
+            z3 = h.b2 * y1 - h.a2 * y2;
+            sum += y2 * y2;
+        }
+        st.z[0] = z0;
+        st.z[1] = z1;
+        st.z[2] = z2;
+        st.z[3] = z3;
+        st.sum += sum;
+    }
+}
+
+void LoudnessMeter::finishSubBlock() {
+    double energy = 0;
+    for (auto &st: mState) {
+        energy += st.weight * st.sum;
+        st.sum = 0;
+    }
+    energy /= mSubBlockSize;
+    mSubBlockFill = 0;
+
+    mSubBlocks[mSubBlockCount % 4] = energy;
+    mSubBlockCount++;
+    if (mSubBlockCount < 4) return;
+
+    double block = (mSubBlocks[0] + mSubBlocks[1] + mSubBlocks[2] + mSubBlocks[3]) / 4.0;
+    if (block <= 0) return;
+    double lufs = energyToLufs(block);
+    if (lufs < ABSOLUTE_GATE_LUFS) return;
+    int bin = (int) ((lufs - HIST_MIN_LUFS) / HIST_STEP_LU);
+    mHistogram[std::min(bin, HISTOGRAM_BINS - 1)]++;
+}
+
+void LoudnessMeter::updatePeak(const float *const *planes, int samples) {
+    float peak = (float) mPeak;
+    for (int c = 0; c < mChannels; ++c) {
+        const float *x = planes[c];
+        for (int i = 0; i < samples; ++i) peak = std::max(peak, fabsf(x[i]));
+    }
+
+    if (mOversample > 1) {
+        int keep = mTaps - 1;
+        mScratch.resize(keep + samples);
+        for (int c = 0; c < mChannels; ++c) {
+            ChannelState &st = mState[c];
+            // 历史 + 本段拼成连续缓冲，点积无需取模
+            std::copy(st.history.begin(), st.history.end(), mScratch.begin());
+            std::copy(planes[c], planes[c] + samples, mScratch.begin() + keep);
+            const float *in = mScratch.data();
+            for (int p = 0; p < mOversample; ++p) {
+                const float *coef = &mPhases[p * mTaps];
+                for (int i = 0; i < samples; ++i) {
+                    float acc = 0;
+                    for (int j = 0; j < TRUE_PEAK_TAPS; ++j) acc += coef[j] * in[i + j];
+                    peak = std::max(peak, fabsf(acc));
+                }
+            }
+            std::copy(mScratch.end() - keep, mScratch.end(), st.history.begin());
+        }
+    }
+    mPeak = peak;
+}
+
+double LoudnessMeter::gatedLoudness(const std::vector<uint32_t> &histogram) {
+    double sum = 0;
+    uint64_t count = 0;
+    for (int i = 0; i < (int) histogram.size(); ++i) {
+        sum += histogram[i] * binEnergy(i);
+        count += histogram[i];
+    }
+    if (count == 0) return -HUGE_VAL;
+
+    double relative = energyToLufs(sum / count) + RELATIVE_GATE_LU;
+    int start = relative <= HIST_MIN_LUFS ? 0 : (int) ((relative - HIST_MIN_LUFS) / HIST_STEP_LU);
+    sum = 0;
+    count = 0;
+    for (int i = start; i < (int) histogram.size(); ++i) {
+        sum += histogram[i] * binEnergy(i);
+        count += histogram[i];
+    }
+    return count > 0 ? energyToLufs(sum / count) : -HUGE_VAL;
+}
@@ -0,0 +1,78 @@
+#ifndef QYPLAYER_LOUDNESSMETER_H
+#define QYPLAYER_LOUDNESSMETER_H
+
+#include <vector>
+#include <stdint.h>
+
+/**
+ * ITU-R BS.1770-4 / EBU R128 响度测量
+ *
+ * - K 计权：高架 + 高通两级双二阶 (按采样率计算系数)，每声道状态常驻寄存器
+ * - 400ms 块、75% 重叠 (100ms 子块)，块响度按 0.1 LU 计入直方图 (-70 ~ +30 LUFS)
+ * - 门限：绝对 -70 LUFS，相对 -10 LU；直方图可直接相加，专辑响度 = 合并后的直方图再门限
+ * - 真峰值：4 倍 (< 96kHz) / 2 倍 (< 192kHz) 多相 FIR 过采样，定长点积可被编译器向量化
+ *
+ * 输入为平面 float。非线程安全。
+ */
+class LoudnessMeter {
+public:
+    static const int HISTOGRAM_BINS = 1000;
+
+    /**
+     * @param weights 每声道权重 (LFE 为 0，环绕声道为 1.41)，nullptr 表示全部为 1
+     */
+    LoudnessMeter(int sampleRate, int channels, const float *weights = nullptr);
+
+    void process(const float *const *planes, int samples);
+
+    /**
+     * @return 积分响度 (LUFS)，无有效块 (静音) 时返回 -HUGE_VAL
+     */
+    double integratedLufs() const { return gatedLoudness(mHistogram); }
+
+    /**
+     * @return 真峰值 (线性，1.0 = 0 dBTP)
+     */
+    double truePeak() const { return mPeak; }
+
+    const std::vector<uint32_t> &histogram() const { return mHistogram; }
+
+    static double gatedLoudness(const std::vector<uint32_t> &histogram);
+
+private:
+    struct Biquad {
+        double b0, b1, b2, a1, a2;
+    };
+
+    struct ChannelState {
+        double z[4] = {}; // 两级双二阶的延迟单元
+        double sum = 0;   // 当前子块的平方和
+        float weight = 1.0f;
+        std::vector<float> history; // 真峰值 FIR 的输入历史 (taps - 1 个样本)
+    };
+
+    void filterSegment(const float *const *planes, int offset, int count);
+
+    void finishSubBlock();
+
+    void updatePeak(const float *const *planes, int samples);
+
+    int mChannels;
+    Biquad mShelf{};
+    Biquad mHighPass{};
+    std::vector<ChannelState> mState;
+
+    int mSubBlockSize;
+    int mSubBlockFill = 0;
+    double mSubBlocks[4] = {}; // 最近 4 个子块的加权均方
+    int mSubBlockCount = 0;
+    std::vector<uint32_t> mHistogram;
+
+    int mOversample;
+    int mTaps;
+    std::vector<float> mPhases; // [phase][tap]，每相系数已反序
+    std::vector<float> mScratch;
+    double mPeak = 0;
+};
+
+#endif //QYPLAYER_LOUDNESSMETER_H
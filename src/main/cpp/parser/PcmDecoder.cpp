@@ -0,0 +1,200 @@
+#include "PcmDecoder.h"
+#include "Logger.h"
+#include "ProbeInterrupt.h"
+#include <mutex>
+
+extern "C" {
+#include <libavutil/opt.h>
+#include <libavutil/channel_layout.h>
+}
+
+static std::once_flag gNetworkInit;
+
+PcmDecoder::~PcmDecoder() {
+    if (mOut) av_freep(&mOut[0]);
+    av_freep(&mOut);
+    av_channel_layout_uninit(&mOutLayout);
+    av_frame_free(&mFrame);
+    av_packet_free(&mPacket);
+    swr_free(&mSwrCtx);
+    avcodec_free_context(&mCodecCtx);
+    avformat_close_input(&mFmtCtx);
+}
+
+bool PcmDecoder::open(const std::string &source, const std::map<std::string, std::string> &headers) {
+    std::call_once(gNetworkInit, []() { avformat_network_init(); });
+
+    AVDictionary *options = nullptr;
+    if (!headers.empty()) {
+        std::string h;
+        for (const auto &p: headers) h += p.first + ": " + p.second + "\r\n";
+        av_dict_set(&options, "headers", h.c_str(), 0);
+    }
+    av_dict_set(&options, "timeout", "10000000", 0);
+    av_dict_set(&options, "rw_timeout", "10000000", 0);
+    // 批量分析被取消时中断连接与读取
+    mFmtCtx = avformat_alloc_context();
+    if (mFmtCtx) mFmtCtx->interrupt_callback = ProbeInterrupt::get();
+    int ret = avformat_open_input(&mFmtCtx, source.c_str(), nullptr, &options);
+    av_dict_free(&options);
+    if (ret < 0) {
+        LOGE("PcmDecoder: open failed: %d, path: %s", ret, source.c_str());
+        return false;
+    }
+
+    mStreamIndex = av_find_best_stream(mFmtCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+    // 容器头未给出采样率/声道时才需要 find_stream_info
+    if (mStreamIndex < 0 || mFmtCtx->streams[mStreamIndex]->codecpar->sample_rate <= 0 ||
+        mFmtCtx->streams[mStreamIndex]->codecpar->ch_layout.nb_channels <= 0) {
+        if (avformat_find_stream_info(mFmtCtx, nullptr) < 0) return false;
+        mStreamIndex = av_find_best_stream(mFmtCtx, AVMEDIA_TYPE_AUDIO, -1, -1, nullptr, 0);
+        if (mStreamIndex < 0) return false;
+    }
+    // 跳过封面等其它流的数据包
+    for (unsigned i = 0; i < mFmtCtx->nb_streams; ++i) {
+        if ((int) i != mStreamIndex) mFmtCtx->streams[i]->discard = AVDISCARD_ALL;
+    }
+
+    mStream = mFmtCtx->streams[mStreamIndex];
+    const AVCodec *codec = avcodec_find_decoder(mStream->codecpar->codec_id);
+    if (!codec) return false;
+    mCodecCtx = avcodec_alloc_context3(codec);
+    if (!mCodecCtx || avcodec_parameters_to_context(mCodecCtx, mStream->codecpar) < 0) return false;
+    mCodecCtx->pkt_timebase = mStream->time_base;
+    // 批量时由工作线程池并行，单个解码器不再开线程
+    mCodecCtx->thread_count = 1;
+    if (avcodec_open2(mCodecCtx, codec, nullptr) < 0) return false;
+
+    mPacket = av_packet_alloc();
+    mFrame = av_frame_alloc();
+    return mPacket && mFrame;
+}
+
+bool PcmDecoder::setOutput(int channels, int sampleRate, AVSampleFormat format) {
+    if (!mCodecCtx) return false;
+
+    av_channel_layout_uninit(&mOutLayout);
+    int inChannels = mCodecCtx->ch_layout.nb_channels;
+    if (channels > 0) {
+        av_channel_layout_default(&mOutLayout, channels);
+    } else if (inChannels <= 8 && mCodecCtx->ch_layout.order != AV_CHANNEL_ORDER_UNSPEC) {
+        av_channel_layout_copy(&mOutLayout, &mCodecCtx->ch_layout);
+    } else {
+        av_channel_layout_default(&mOutLayout, inChannels < 8 ? inChannels : 8);
+    }
+    mOutRate = sampleRate > 0 ? sampleRate : mCodecCtx->sample_rate;
+    mOutFormat = format;
+
+    swr_free(&mSwrCtx);
+    if (swr_alloc_set_opts2(&mSwrCtx, &mOutLayout, mOutFormat, mOutRate,
+                            &mCodecCtx->ch_layout, mCodecCtx->sample_fmt,
+                            mCodecCtx->sample_rate, 0, nullptr) < 0 ||
+        swr_init(mSwrCtx) < 0) {
+        LOGE("PcmDecoder: swr init failed");
+        swr_free(&mSwrCtx);
+        return false;
+    }
+    return true;
+}
+
+bool PcmDecoder::seek(int64_t ms) {
+    if (!mFmtCtx || ms <= 0) return mFmtCtx != nullptr;
+    int64_t ts = ms * 1000;
+    if (mFmtCtx->start_time != AV_NOPTS_VALUE) ts += mFmtCtx->start_time;
+    if (av_seek_frame(mFmtCtx, -1, ts, AVSEEK_FLAG_BACKWARD) < 0) {
+        LOGW("PcmDecoder: seek to %lldms failed", (long long) ms);
+        return false;
+    }
+    avcodec_flush_buffers(mCodecCtx);
+    // 参数未变时 swr_init 只清空延迟缓冲
+    if (mSwrCtx) swr_init(mSwrCtx);
+    mSkipUntilMs = ms;
+    mDecoderDrained = false;
+    mFinished = false;
+    return true;
+}
+
+int64_t PcmDecoder::getDurationMs() const {
+    if (!mFmtCtx) return 0;
+    if (mFmtCtx->duration != AV_NOPTS_VALUE) return mFmtCtx->duration / 1000;
+    if (mStream && mStream->duration != AV_NOPTS_VALUE) {
+        return av_rescale_q(mStream->duration, mStream->time_base, {1, 1000});
+    }
+    return 0;
+}
+
+int PcmDecoder::convert(const AVFrame *frame, uint8_t **&data) {
+    int inSamples = frame ? frame->nb_samples : 0;
+    int needed = swr_get_out_samples(mSwrCtx, inSamples);
+    if (needed <= 0) return 0;
+    if (needed > mOutCapacity) {
+        if (mOut) av_freep(&mOut[0]);
+        av_freep(&mOut);
+        if (av_samples_alloc_array_and_samples(&mOut, nullptr, mOutLayout.nb_channels, needed,
+                                               mOutFormat, 0) < 0) {
+            mOutCapacity = 0;
+            return -1;
+        }
+        mOutCapacity = needed;
+    }
+    int converted = swr_convert(mSwrCtx, mOut, mOutCapacity,
+                                frame ? (const uint8_t **) frame->extended_data : nullptr,
+                                inSamples);
+    if (converted < 0) return converted;
+
+    int planes = av_sample_fmt_is_planar(mOutFormat) ? mOutLayout.nb_channels : 1;
+    for (int i = 0; i < planes; ++i) mPlanes[i] = mOut[i];
+    data = mPlanes;
+    return converted;
+}
+
+int PcmDecoder::read(uint8_t **&data) {
+    if (!mSwrCtx) return -1;
+
+    while (!mFinished) {
+        int ret = avcodec_receive_frame(mCodecCtx, mFrame);
+        if (ret >= 0) {
+            int64_t pts = mFrame->best_effort_timestamp;
+            int n = convert(mFrame, data);
+            av_frame_unref(mFrame);
+            if (n < 0) return n;
+
+            if (mSkipUntilMs >= 0 && pts != AV_NOPTS_VALUE) {
+                if (mStream->start_time != AV_NOPTS_VALUE) pts -= mStream->start_time;
+                int64_t frameMs = av_rescale_q(pts, mStream->time_base, {1, 1000});
+                int64_t skip = (mSkipUntilMs - frameMs) * mOutRate / 1000;
+                if (skip >= n) continue;
+                if (skip > 0) {
+                    int bps = av_get_bytes_per_sample(mOutFormat);
+                    bool planar = av_sample_fmt_is_planar(mOutFormat);
+                    int planes = planar ? mOutLayout.nb_channels : 1;
+                    int64_t offset = skip * bps * (planar ? 1 : mOutLayout.nb_channels);
+                    for (int i = 0; i < planes; ++i) mPlanes[i] += offset;
+                    n -= (int) skip;
+                }
+                mSkipUntilMs = -1;
+            }
+            if (n > 0) return n;
+            continue;
+        }
+        if (ret == AVERROR_EOF) {
+            // 冲刷 swr 中残留的样本
+            mFinished = true;
+            int n = convert(nullptr, data);
+            return n > 0 ? n : 0;
+        }
+        if (ret != AVERROR(EAGAIN)) return ret;
+
+        ret = av_read_frame(mFmtCtx, mPacket);
+        if (ret < 0) {
+            if (mDecoderDrained) return ret;
+            avcodec_send_packet(mCodecCtx, nullptr);
+            mDecoderDrained = true;
+            continue;
+        }
+        // 个别损坏的包跳过即可
+        if (mPacket->stream_index == mStreamIndex) avcodec_send_packet(mCodecCtx, mPacket);
+        av_packet_unref(mPacket);
+    }
+    return 0;
+}
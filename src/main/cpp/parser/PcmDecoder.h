@@ -0,0 +1,83 @@
+#ifndef QYPLAYER_PCMDECODER_H
+#define QYPLAYER_PCMDECODER_H
+
+#include <string>
+#include <map>
+#include <stdint.h>
+
+extern "C" {
+#include <libavformat/avformat.h>
+#include <libavcodec/avcodec.h>
+#include <libswresample/swresample.h>
+}
+
+/**
+ * 离线分析用的轻量解码器 (指纹、响度)
+ *
+ * avformat -> 单线程解码 -> swr 转为指定格式，按帧拉取。
+ * 不经过 FFPlayer：没有输出设备、缓冲队列和播放线程；批量时由外部线程池并行。
+ * 非线程安全，每个任务各自创建。
+ */
+class PcmDecoder {
+public:
+    PcmDecoder() = default;
+
+    ~PcmDecoder();
+
+    PcmDecoder(const PcmDecoder &) = delete;
+
+    PcmDecoder &operator=(const PcmDecoder &) = delete;
+
+    bool open(const std::string &source, const std::map<std::string, std::string> &headers);
+
+    /**
+     * 设置输出格式，必须在 open 之后、read 之前调用
+     * @param channels <= 0 保持原声道 (最多 8 声道)
+     * @param sampleRate <= 0 保持原采样率
+     */
+    bool setOutput(int channels, int sampleRate, AVSampleFormat format);
+
+    /**
+     * 定位到 ms，之前的样本在 read 中按时间戳精确丢弃
+     */
+    bool seek(int64_t ms);
+
+    /**
+     * 拉取下一段输出
+     * @param data 输出平面指针 (交错格式只有 data[0])，在下次调用前有效
+     * @return 每声道样本数，0 表示结束，< 0 表示出错
+     */
+    int read(uint8_t **&data);
+
+    int getSampleRate() const { return mOutRate; }
+
+    int getChannels() const { return mOutLayout.nb_channels; }
+
+    const AVChannelLayout &getChannelLayout() const { return mOutLayout; }
+
+    int64_t getDurationMs() const;
+
+private:
+    int convert(const AVFrame *frame, uint8_t **&data);
+
+    AVFormatContext *mFmtCtx = nullptr;
+    AVCodecContext *mCodecCtx = nullptr;
+    SwrContext *mSwrCtx = nullptr;
+    AVPacket *mPacket = nullptr;
+    AVFrame *mFrame = nullptr;
+    AVStream *mStream = nullptr;
+    int mStreamIndex = -1;
+
+    AVChannelLayout mOutLayout{};
+    int mOutRate = 0;
+    AVSampleFormat mOutFormat = AV_SAMPLE_FMT_NONE;
+    uint8_t **mOut = nullptr;
+    int mOutCapacity = 0;
+    uint8_t *mPlanes[AV_NUM_DATA_POINTERS] = {};
+
+    int64_t mSkipUntilMs = -1; // seek 后需要丢弃的目标位置
+    bool mDecoderDrained = false;
+    bool mFinished = false;
+};
+
+#endif //QYPLAYER_PCMDECODER_H
@@ -0,0 +1,520 @@
+#include "ProbeCache.h"
+#include "Logger.h"
+#include <mutex>
+#include <unordered_map>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+ * 文件布局 (主机字节序，缓存不跨设备)：
+ *   Header  : magic "QYPC" | version u32 | reserved u64
+ *   Record* : payloadLen u32 | checksum u32 | payload
+ *   payload : kind u8 | key | validator | InternalMetadata 或字符串 (Blob)
+ * 字符串为 u32 长度 + 字节。尾部不完整或校验失败的记录 (写入时崩溃) 在打开时截掉。
+ */
+
+#define CACHE_FILE_NAME "probe_cache.bin"
+#define CACHE_MAGIC 0x43505951 // "QYPC"
+#define HEADER_SIZE 16
+#define RECORD_HEADER_SIZE 8
+#define MAX_RECORD_SIZE (4 * 1024 * 1024)
+// 失效字节超过该值且超过有效字节时压缩
+#define COMPACT_MIN_DEAD_BYTES (1024 * 1024)
+
+namespace {
+
+    enum RecordKind : uint8_t {
+        KIND_METADATA = 0,
+        KIND_BLOB,
+        KIND_COUNT
+    };
+
+    struct Entry {
+        uint64_t offset; // payload 起始位置
+        uint32_t length;
+        uint8_t kind;
+        uint64_t seq;    // 最近一次命中或写入的序号，压缩时据此淘汰
+    };
+
+    struct State {
+        std::mutex mutex;
+        std::string path;
+        int fd = -1;
+        const uint8_t *map = nullptr;
+        size_t mapSize = 0;
+        size_t fileSize = 0;
+        size_t liveBytes = 0;
+        size_t deadBytes = 0;
+        int maxEntries = 0;
+        std::unordered_map<std::string, Entry> index;
+        size_t counts[KIND_COUNT] = {};
+        uint64_t clock = 0;
+        int hits = 0;
+        int misses = 0;
+    };
+
+    State gState;
+
+    uint32_t checksum(const uint8_t *data, size_t size) {
+        uint32_t h = 2166136261u; // FNV-1a
+        for (size_t i = 0; i < size; ++i) {
+            h ^= data[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    class Writer {
+    public:
+        std::vector<uint8_t> buf;
+
+        template<typename T>
+        void put(T v) {
+            const auto *p = (const uint8_t *) &v;
+            buf.insert(buf.end(), p, p + sizeof(T));
+        }
+
+        void putString(const std::string &s) {
+            put<uint32_t>((uint32_t) s.size());
+            buf.insert(buf.end(), s.begin(), s.end());
+        }
+    };
+
+    class Reader {
+    public:
+        Reader(const uint8_t *data, size_t size) : mData(data), mSize(size) {}
+
+        template<typename T>
+        bool get(T &v) {
+            if (mPos + sizeof(T) > mSize) return false;
+            memcpy(&v, mData + mPos, sizeof(T));
+            mPos += sizeof(T);
+            return true;
+        }
+
+        bool getString(std::string &s) {
+            uint32_t len;
+            if (!get(len) || mPos + len > mSize) return false;
+            s.assign((const char *) mData + mPos, len);
+            mPos += len;
+            return true;
+        }
+
+    private:
+        const uint8_t *mData;
+        size_t mSize;
+        size_t mPos = 0;
+    };
+
+    void writeMetadata(Writer &w, const InternalMetadata &meta) {
+        w.putString(meta.uri);
+        w.putString(meta.albumTitle);
+        w.putString(meta.albumArtist);
+        w.putString(meta.genre);
+        w.putString(meta.date);
+        w.putString(meta.description);
+        w.putString(meta.lyrics);
+        w.putString(meta.extraInfo);
+        w.putString(meta.coverPath);
+        w.put<int32_t>(meta.totalTracks);
+        w.put<int32_t>(meta.totalDiscs);
+        w.put<uint32_t>((uint32_t) meta.tracks.size());
+        for (const auto &t: meta.tracks) {
+            w.put<int32_t>(t.trackId);
+            w.put<int32_t>(t.discNumber);
+            w.putString(t.title);
+            w.putString(t.artist);
+            w.putString(t.album);
+            w.putString(t.genre);
+            w.putString(t.path);
+            w.put<int64_t>(t.startMs);
+            w.put<int64_t>(t.endMs);
+            w.put<int64_t>(t.durationMs);
+            w.putString(t.format);
+            w.put<int32_t>(t.sampleRate);
+            w.put<int32_t>(t.channels);
+            w.put<int32_t>(t.bitDepth);
+            w.put<int64_t>(t.bitRate);
+            w.put<int32_t>(t.sacdArea);
+        }
+    }
+
+    bool readMetadata(Reader &r, InternalMetadata &meta) {
+        int32_t totalTracks, totalDiscs;
+        uint32_t trackCount;
+        if (!r.getString(meta.uri) || !r.getString(meta.albumTitle) ||
+            !r.getString(meta.albumArtist) || !r.getString(meta.genre) ||
+            !r.getString(meta.date) || !r.getString(meta.description) ||
+            !r.getString(meta.lyrics) || !r.getString(meta.extraInfo) ||
+            !r.getString(meta.coverPath) || !r.get(totalTracks) || !r.get(totalDiscs) ||
+            !r.get(trackCount)) {
+            return false;
+        }
+        meta.totalTracks = totalTracks;
+        meta.totalDiscs = totalDiscs;
+        meta.tracks.clear();
+        for (uint32_t i = 0; i < trackCount; ++i) {
+            InternalTrack t;
+            int32_t trackId, discNumber, sampleRate, channels, bitDepth, sacdArea;
+            int64_t startMs, endMs, durationMs, bitRate;
+            if (!r.get(trackId) || !r.get(discNumber) || !r.getString(t.title) ||
+                !r.getString(t.artist) || !r.getString(t.album) || !r.getString(t.genre) ||
+                !r.getString(t.path) || !r.get(startMs) || !r.get(endMs) || !r.get(durationMs) ||
+                !r.getString(t.format) || !r.get(sampleRate) || !r.get(channels) ||
+                !r.get(bitDepth) || !r.get(bitRate) || !r.get(sacdArea)) {
+                return false;
+            }
+            t.trackId = trackId;
+            t.discNumber = discNumber;
+            t.startMs = startMs;
+            t.endMs = endMs;
+            t.durationMs = durationMs;
+            t.sampleRate = sampleRate;
+            t.channels = channels;
+            t.bitDepth = bitDepth;
+            t.bitRate = bitRate;
+            t.sacdArea = sacdArea;
+            meta.tracks.push_back(t);
+        }
+        meta.success = true;
+        return true;
+    }
+
+    void unmapLocked() {
+        if (gState.map) munmap((void *) gState.map, gState.mapSize);
+        gState.map = nullptr;
+        gState.mapSize = 0;
+    }
+
+    // 追加写入后文件变长，按需重新映射
+    bool ensureMappedLocked(size_t end) {
+        if (gState.map && end <= gState.mapSize) return true;
+        unmapLocked();
+        if (gState.fileSize == 0) return false;
+        void *p = mmap(nullptr, gState.fileSize, PROT_READ, MAP_SHARED, gState.fd, 0);
+        if (p == MAP_FAILED) {
+            LOGE("ProbeCache: mmap failed: %s", strerror(errno));
+            return false;
+        }
+        gState.map = (const uint8_t *) p;
+        gState.mapSize = gState.fileSize;
+        return end <= gState.mapSize;
+    }
+
+    bool writeHeader(int fd) {
+        uint8_t header[HEADER_SIZE] = {0};
+        uint32_t magic = CACHE_MAGIC;
+        uint32_t version = ProbeCache::VERSION;
+        memcpy(header, &magic, 4);
+        memcpy(header + 4, &version, 4);
+        return pwrite(fd, header, HEADER_SIZE, 0) == HEADER_SIZE;
+    }
+
+    bool overLimitLocked(size_t slack) {
+        if (gState.maxEntries <= 0) return false;
+        for (size_t count: gState.counts) {
+            if (count > (size_t) gState.maxEntries + slack) return true;
+        }
+        return false;
+    }
+
+    // 新记录覆盖同 key 的旧记录时，旧记录计为失效字节
+    void indexLocked(const std::string &key, uint64_t offset, uint32_t length, uint8_t kind) {
+        auto it = gState.index.find(key);
+        if (it != gState.index.end()) {
+            gState.deadBytes += RECORD_HEADER_SIZE + it->second.length;
+            gState.liveBytes -= RECORD_HEADER_SIZE + it->second.length;
+            gState.counts[it->second.kind]--;
+        }
+        gState.index[key] = {offset, length, kind, ++gState.clock};
+        gState.liveBytes += RECORD_HEADER_SIZE + length;
+        gState.counts[kind]++;
+    }
+
+    void resetIndexLocked() {
+        gState.index.clear();
+        gState.liveBytes = 0;
+        gState.deadBytes = 0;
+        for (size_t &count: gState.counts) count = 0;
+    }
+
+    // 顺序扫描记录建立索引，返回有效数据的结束位置
+    size_t buildIndexLocked() {
+        resetIndexLocked();
+        if (!ensureMappedLocked(HEADER_SIZE)) return HEADER_SIZE;
+
+        size_t pos = HEADER_SIZE;
+        while (pos + RECORD_HEADER_SIZE <= gState.mapSize) {
+            uint32_t len, sum;
+            memcpy(&len, gState.map + pos, 4);
+            memcpy(&sum, gState.map + pos + 4, 4);
+            const uint8_t *payload = gState.map + pos + RECORD_HEADER_SIZE;
+            if (len == 0 || len > MAX_RECORD_SIZE ||
+                pos + RECORD_HEADER_SIZE + len > gState.mapSize ||
+                checksum(payload, len) != sum) {
+                break;
+            }
+
+            Reader r(payload, len);
+            uint8_t kind;
+            std::string key;
+            if (!r.get(kind) || kind >= KIND_COUNT || !r.getString(key)) break;
+
+            indexLocked(key, pos + RECORD_HEADER_SIZE, len, kind);
+            pos += RECORD_HEADER_SIZE + len;
+        }
+        return pos;
+    }
+
+    bool openFileLocked() {
+        int fd = ::open(gState.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            LOGE("ProbeCache: open %s failed: %s", gState.path.c_str(), strerror(errno));
+            return false;
+        }
+
+        struct stat st{};
+        fstat(fd, &st);
+        uint32_t header[2] = {0, 0};
+        bool valid = st.st_size >= HEADER_SIZE && pread(fd, header, 8, 0) == 8 &&
+                     header[0] == CACHE_MAGIC && header[1] == ProbeCache::VERSION;
+        if (!valid) {
+            if (st.st_size > 0) {
+                LOGD("ProbeCache: version mismatch (%u), discarding", header[1]);
+            }
+            if (ftruncate(fd, 0) != 0 || !writeHeader(fd)) {
+                ::close(fd);
+                return false;
+            }
+            st.st_size = HEADER_SIZE;
+        }
+
+        gState.fd = fd;
+        gState.fileSize = st.st_size;
+        size_t end = buildIndexLocked();
+        if (end < gState.fileSize) {
+            // 截掉写入中断的尾部
+            LOGD("ProbeCache: truncating %zu corrupt bytes", gState.fileSize - end);
+            unmapLocked();
+            if (ftruncate(fd, end) == 0) gState.fileSize = end;
+        }
+        return true;
+    }
+
+    void closeFileLocked() {
+        unmapLocked();
+        if (gState.fd >= 0) ::close(gState.fd);
+        gState.fd = -1;
+        gState.fileSize = 0;
+        resetIndexLocked();
+    }
+
+    // 重写有效记录到临时文件再替换：按访问顺序写出，每种记录只保留最近访问的 maxEntries 条
+    void compactLocked() {
+        if (!ensureMappedLocked(gState.fileSize)) return;
+
+        std::vector<Entry> entries;
+        entries.reserve(gState.index.size());
+        for (const auto &it: gState.index) entries.push_back(it.second);
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry &a, const Entry &b) { return a.seq < b.seq; });
+        std::vector<bool> keep(entries.size(), true);
+        if (gState.maxEntries > 0) {
+            size_t kept[KIND_COUNT] = {};
+            for (size_t i = entries.size(); i-- > 0;) {
+                keep[i] = kept[entries[i].kind]++ < (size_t) gState.maxEntries;
+            }
+        }
+
+        std::string tmpPath = gState.path + ".tmp";
+        int fd = ::open(tmpPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) return;
+        bool ok = writeHeader(fd);
+        off_t pos = HEADER_SIZE;
+        for (size_t i = 0; ok && i < entries.size(); ++i) {
+            if (!keep[i]) continue;
+            const uint8_t *record = gState.map + entries[i].offset - RECORD_HEADER_SIZE;
+            size_t size = RECORD_HEADER_SIZE + entries[i].length;
+            ok = pwrite(fd, record, size, pos) == (ssize_t) size;
+            pos += size;
+        }
+        ::close(fd);
+        if (!ok || rename(tmpPath.c_str(), gState.path.c_str()) != 0) {
+            unlink(tmpPath.c_str());
+            return;
+        }
+
+        closeFileLocked();
+        openFileLocked();
+        LOGD("ProbeCache: compacted to %zu bytes, %zu entries", gState.fileSize,
+             gState.index.size());
+    }
+
+}
+
+bool ProbeCache::open(const std::string &dir, int maxEntries) {
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    closeFileLocked();
+    if (dir.empty()) return false;
+
+    gState.path = dir;
+    if (gState.path.back() != '/') gState.path += '/';
+    gState.path += CACHE_FILE_NAME;
+    gState.maxEntries = maxEntries;
+    gState.hits = 0;
+    gState.misses = 0;
+    if (!openFileLocked()) return false;
+
+    LOGD("ProbeCache: opened %s, %zu entries, %zu bytes", gState.path.c_str(),
+         gState.index.size(), gState.fileSize);
+    if (overLimitLocked(0)) compactLocked();
+    return true;
+}
+
+void ProbeCache::close() {
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    if (gState.fd >= 0) {
+        LOGD("ProbeCache: closing, hits=%d misses=%d", gState.hits, gState.misses);
+    }
+    closeFileLocked();
+}
+
+bool ProbeCache::isOpen() {
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    return gState.fd >= 0;
+}
+
+std::string ProbeCache::makeValidator(const std::string &source,
+                                      const std::string &remoteValidator) {
+    std::string path = source;
+    if (path.find("file://") == 0) {
+        path = path.substr(7);
+    } else if (path.find("://") != std::string::npos) {
+        return remoteValidator;
+    }
+
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0) return "";
+    return std::to_string((long long) st.st_size) + ":" +
+           std::to_string((long long) st.st_mtim.tv_sec) + "." +
+           std::to_string((long) st.st_mtim.tv_nsec);
+}
+
+namespace {
+
+    // 定位 key 对应的记录并核对类型与校验值，成功时 r 停在 validator 之后并刷新访问序号
+    bool findLocked(const std::string &key, uint8_t kind, const std::string &validator, Reader &r) {
+        auto it = gState.index.find(key);
+        if (it == gState.index.end() || it->second.kind != kind ||
+            !ensureMappedLocked(it->second.offset + it->second.length)) {
+            return false;
+        }
+        r = Reader(gState.map + it->second.offset, it->second.length);
+        uint8_t storedKind;
+        std::string storedKey, storedValidator;
+        if (!r.get(storedKind) || !r.getString(storedKey) || !r.getString(storedValidator) ||
+            storedValidator != validator) {
+            return false;
+        }
+        it->second.seq = ++gState.clock;
+        return true;
+    }
+
+    Writer beginRecord(uint8_t kind, const std::string &key, const std::string &validator) {
+        Writer w;
+        w.put<uint32_t>(0); // 长度与校验和稍后回填
+        w.put<uint32_t>(0);
+        w.put<uint8_t>(kind);
+        w.putString(key);
+        w.putString(validator);
+        return w;
+    }
+
+    void appendRecord(const std::string &key, uint8_t kind, Writer &w) {
+        uint32_t len = (uint32_t) (w.buf.size() - RECORD_HEADER_SIZE);
+        if (len > MAX_RECORD_SIZE) return;
+        uint32_t sum = checksum(w.buf.data() + RECORD_HEADER_SIZE, len);
+        memcpy(w.buf.data(), &len, 4);
+        memcpy(w.buf.data() + 4, &sum, 4);
+
+        std::lock_guard<std::mutex> lock(gState.mutex);
+        if (gState.fd < 0) return;
+
+        if (pwrite(gState.fd, w.buf.data(), w.buf.size(), gState.fileSize) != (ssize_t) w.buf.size()) {
+            LOGE("ProbeCache: write failed: %s", strerror(errno));
+            // 截掉可能写了一半的记录
+            if (ftruncate(gState.fd, gState.fileSize) != 0) closeFileLocked();
+            return;
+        }
+
+        indexLocked(key, gState.fileSize + RECORD_HEADER_SIZE, len, kind);
+        gState.fileSize += w.buf.size();
+
+        bool tooManyDead = gState.deadBytes > COMPACT_MIN_DEAD_BYTES &&
+                           gState.deadBytes > gState.liveBytes;
+        // 超出上限 1/8 再压缩，避免每次写入都重写文件
+        if (tooManyDead || overLimitLocked(gState.maxEntries / 8)) compactLocked();
+    }
+
+}
+
+bool ProbeCache::lookup(const std::string &key, const std::string &validator,
+                        InternalMetadata &out) {
+    if (validator.empty()) return false;
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    if (gState.fd < 0) return false;
+
+    Reader r(nullptr, 0);
+    if (!findLocked(key, KIND_METADATA, validator, r) || !readMetadata(r, out)) {
+        gState.misses++;
+        return false;
+    }
+    gState.hits++;
+    return true;
+}
+
+void ProbeCache::store(const std::string &key, const std::string &validator,
+                       const InternalMetadata &meta) {
+    if (validator.empty() || !meta.success) return;
+
+    Writer w = beginRecord(KIND_METADATA, key, validator);
+    writeMetadata(w, meta);
+    appendRecord(key, KIND_METADATA, w);
+}
+
+bool ProbeCache::lookupBlob(const std::string &key, const std::string &validator,
+                            std::string &out) {
+    if (validator.empty()) return false;
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    if (gState.fd < 0) return false;
+
+    Reader r(nullptr, 0);
+    if (!findLocked(key, KIND_BLOB, validator, r) || !r.getString(out)) {
+        gState.misses++;
+        return false;
+    }
+    gState.hits++;
+    return true;
+}
+
+void ProbeCache::storeBlob(const std::string &key, const std::string &validator,
+                           const std::string &value) {
+    if (validator.empty() || value.empty()) return;
+
+    Writer w = beginRecord(KIND_BLOB, key, validator);
+    w.putString(value);
+    appendRecord(key, KIND_BLOB, w);
+}
+
+void ProbeCache::clear() {
+    std::lock_guard<std::mutex> lock(gState.mutex);
+    if (gState.fd < 0) return;
+    unmapLocked();
+    resetIndexLocked();
+    if (ftruncate(gState.fd, HEADER_SIZE) == 0) gState.fileSize = HEADER_SIZE;
+}
@@ -0,0 +1,62 @@
+#ifndef QYPLAYER_PROBECACHE_H
+#define QYPLAYER_PROBECACHE_H
+
+#include <string>
+#include "AudioProbe.h"
+
+/**
+ * 探测结果持久化缓存
+ *
+ * 单文件、只追加的二进制表，启动时 mmap 整个文件建立 key -> 偏移 的索引。
+ * 每条记录带有校验值 (validator)：本地文件为 size + mtime，网络文件为 ETag / Last-Modified，
+ * 不一致即视为失效。重复扫描未变化的文件只需要一次 stat。
+ *
+ * 被覆盖的旧记录在失效字节过半或条目超出上限时压缩掉。元数据与 Blob 各自计算上限，
+ * 按最近访问 (命中或写入) 的顺序淘汰；压缩时按访问顺序重写，因此顺序在重启后大致保留。
+ * 文件头带版本号，InternalMetadata 结构变化时递增 VERSION，旧文件会被整体丢弃。
+ *
+ * 线程安全，批量探测的工作线程可直接调用。
+ */
+class ProbeCache {
+public:
+    static const uint32_t VERSION = 4;
+
+    /**
+     * 打开 (或创建) dir 下的缓存文件；dir 为空时关闭缓存
+     * @param maxEntries 条目上限，元数据与 Blob 分别计数
+     */
+    static bool open(const std::string &dir, int maxEntries);
+
+    static void close();
+
+    static bool isOpen();
+
+    /**
+     * 计算校验值：本地文件 stat 得到 size + mtime；网络地址使用调用方给出的 ETag / Last-Modified
+     * @return 空字符串表示无法校验，不应使用缓存
+     */
+    static std::string makeValidator(const std::string &source, const std::string &remoteValidator);
+
+    static bool lookup(const std::string &key, const std::string &validator, InternalMetadata &out);
+
+    /**
+     * 只缓存成功的结果 (失败可能是暂时的网络错误)
+     */
+    static void store(const std::string &key, const std::string &validator,
+                      const InternalMetadata &meta);
+
+    /**
+     * 任意字符串值 (如音频指纹)，与元数据共用同一张表，key 需自带前缀以免冲突
+     */
+    static bool lookupBlob(const std::string &key, const std::string &validator, std::string &out);
+
+    static void storeBlob(const std::string &key, const std::string &validator,
+                          const std::string &value);
+
+    /**
+     * 清空全部条目
+     */
+    static void clear();
+};
+
+#endif //QYPLAYER_PROBECACHE_H
@@ -4,43 +4,25 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <jni.h>
-#include <android/log.h>
 #include <sys/stat.h>
 #include <unistd.h>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include "Logger.h"
+#include "CharsetDetector.h"
+#include "ProbeInterrupt.h"
 
 extern "C" {
-#include <libavutil/md5.h>
 #include <libavformat/avformat.h>
 #include <libavutil/dict.h>
 }
 
 
-static const std::string COVER_SAVE_DIR = "/sdcard/Music/.covers/";
-
 class ProbeUtils {
 private:
-    static std::string computeMD5(const std::string &str) {
-        uint8_t digest[16];
-        av_md5_sum(digest, (const uint8_t *) str.c_str(), str.length());
-        std::stringstream ss;
-        for (auto b: digest) ss << std::hex << std::setw(2) << std::setfill('0') << (int) b;
-        return ss.str();
-    }
-
-    static bool ensureDirectoryExists(const std::string &path) {
-        if (access(path.c_str(), F_OK) == 0) return true;
-        std::string cur;
-        for (char c: path) {
-            cur += c;
-            if (c == '/' && access(cur.c_str(), F_OK) != 0) mkdir(cur.c_str(), 0777);
-        }
-        if (access(path.c_str(), F_OK) != 0) mkdir(path.c_str(), 0777);
-        return true;
-    }
+    // 文本文件 (CUE) 大小上限，防止误读大文件
+    static constexpr size_t MAX_TEXT_SIZE = 8 * 1024 * 1024;
 
     static std::vector<uint8_t>
     readRawBytes(const std::string &path, const std::map<std::string, std::string> &headers) {
@@ -57,13 +39,21 @@ private:
         av_dict_set(&opts, "timeout", "10000000", 0);
 
         AVIOContext *ctx = nullptr;
-        if (avio_open2(&ctx, path.c_str(), AVIO_FLAG_READ, nullptr, &opts) >= 0) {
-            int bufSize = 4096;
-            std::vector<uint8_t> buffer(bufSize);
+        AVIOInterruptCB interrupt = ProbeInterrupt::get();
+        if (avio_open2(&ctx, path.c_str(), AVIO_FLAG_READ, &interrupt, &opts) >= 0) {
+            // 已知大小时一次分配，直接读入结果缓冲区
+            int64_t size = avio_size(ctx);
+            size_t capacity = size > 0 && size < (int64_t) MAX_TEXT_SIZE ? (size_t) size : 64 * 1024;
+            result.resize(capacity);
+            size_t used = 0;
             int bytesRead;
-            while ((bytesRead = avio_read(ctx, buffer.data(), bufSize)) > 0) {
-                result.insert(result.end(), buffer.begin(), buffer.begin() + bytesRead);
+            while (used < MAX_TEXT_SIZE) {
+                if (used == result.size()) result.resize(std::min(result.size() * 2, MAX_TEXT_SIZE));
+                bytesRead = avio_read(ctx, result.data() + used, (int) (result.size() - used));
+                if (bytesRead <= 0) break;
+                used += bytesRead;
             }
+            result.resize(used);
             avio_close(ctx);
         } else {
             LOGE("ProbeUtils: Failed to open IO: %s", path.c_str());
@@ -72,64 +62,18 @@ private:
         return result;
     }
 
-    // 核心修改：使用传入的 env，而不是全局获取
-    static std::string decodeViaJava(JNIEnv *env, const std::vector<uint8_t> &data) {
-        if (!env || data.empty()) return "";
-
-        std::string result = "";
-
-        // 1. 找到 Kotlin 辅助类
-        jclass clazz = env->FindClass("com/qytech/audioplayer/utils/CharsetNativeHelper");
-        if (clazz) {
-            jmethodID mid = env->GetStaticMethodID(clazz, "decodeRawDataStrict",
-                                                   "([B)Ljava/lang/String;");
-            if (mid) {
-                jbyteArray jData = env->NewByteArray(data.size());
-                env->SetByteArrayRegion(jData, 0, data.size(), (const jbyte *) data.data());
-
-                jstring jStr = (jstring) env->CallStaticObjectMethod(clazz, mid, jData);
-
-                if (jStr) {
-                    const char *chars = env->GetStringUTFChars(jStr, nullptr);
-                    if (chars) {
-                        result = chars;
-                        env->ReleaseStringUTFChars(jStr, chars);
-                    }
-                    env->DeleteLocalRef(jStr);
-                }
-                env->DeleteLocalRef(jData);
-            }
-            env->DeleteLocalRef(clazz);
-        }
-        return result;
-    }
-
 public:
-    static std::string saveCoverAuto(const std::string &uri, const std::vector<uint8_t> &data) {
-        if (data.empty() || !ensureDirectoryExists(COVER_SAVE_DIR)) return "";
-        std::string fullPath = COVER_SAVE_DIR + computeMD5(uri) + ".jpg";
-        if (access(fullPath.c_str(), F_OK) == 0) return fullPath;
-
-        FILE *fp = fopen(fullPath.c_str(), "wb");
-        if (fp) {
-            fwrite(data.data(), 1, data.size(), fp);
-            fclose(fp);
-            return fullPath;
-        }
-        return "";
-    }
-
-    // 核心修改：接收 JNIEnv* 参数
+    /**
+     * 读取文本文件 (CUE 等) 并转换为 UTF-8，编码检测在 native 完成，无需 JNIEnv
+     */
     static std::string
-    readContent(JNIEnv *env, const std::string &path,
+    readContent(const std::string &path,
                 const std::map<std::string, std::string> &headers = {}) {
-        // 1. C++ 负责 IO
         std::vector<uint8_t> rawData = readRawBytes(path, headers);
         if (rawData.empty()) {
             return "";
         }
-        // 2. Java 负责解码 (传入 env)
-        return decodeViaJava(env, rawData);
+        return CharsetDetector::toUtf8(rawData.data(), rawData.size());
     }
 
     static std::string resolvePath(const std::string &base, const std::string &rel) {
@@ -0,0 +1,12 @@
+#include "ScanStats.h"
+
+std::atomic<int64_t> ScanStats::sCounters[COUNTER_COUNT] = {};
+
+void ScanStats::snapshot(int64_t *out) {
+    out[0] = SNAPSHOT_VERSION;
+    for (int i = 0; i < COUNTER_COUNT; i++) out[1 + i] = sCounters[i].load(std::memory_order_relaxed);
+}
+
+void ScanStats::reset() {
+    for (auto &counter: sCounters) counter.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,69 @@
+#ifndef QYPLAYER_SCANSTATS_H
+#define QYPLAYER_SCANSTATS_H
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * 媒体库扫描统计：进程内累计的计数与耗时，各扫描模块直接累加，不加锁
+ *
+ * 快照为定长 int64 数组，布局：
+ *   [0] SNAPSHOT_VERSION
+ *   [1, 1 + COUNTER_COUNT)  计数器，按 Counter 顺序
+ * 调整布局时需同步递增版本号并修改 Kotlin 侧的 ScanStats。
+ */
+class ScanStats {
+public:
+    enum Counter {
+        // AudioProbe 完整探测 (不含缓存命中)，按本地 / 网络分组
+        PROBE_LOCAL_COUNT = 0,
+        PROBE_LOCAL_FAST,        // 跳过 avformat_find_stream_info 的次数
+        PROBE_LOCAL_US,          // 探测耗时之和
+        PROBE_LOCAL_BYTES,       // AVIOContext 读取字节之和
+        PROBE_NETWORK_COUNT,
+        PROBE_NETWORK_FAST,
+        PROBE_NETWORK_US,
+        PROBE_NETWORK_BYTES,
+        // CoverStore
+        COVER_SAVED,             // 新写入的封面
+        COVER_DEDUPED,           // 内容已存在而跳过写入的封面
+        COVER_SAVED_BYTES,
+        THUMB_CREATED,
+        THUMB_FAILED,
+        THUMB_US,                // 缩略图解码、缩放、编码耗时之和 (含失败)
+        // Fingerprinter，CPU 时间为计算线程的 CPU 时间 (与并发线程数无关，即单核吞吐)
+        FINGERPRINT_COMPUTED,
+        FINGERPRINT_CACHED,
+        FINGERPRINT_FAILED,
+        FINGERPRINT_AUDIO_MS,    // 已计算指纹的音频时长之和
+        FINGERPRINT_CPU_US,
+        // LoudnessAnalyzer，同样按分析线程的 CPU 时间计
+        LOUDNESS_ANALYZED,
+        LOUDNESS_CACHED,
+        LOUDNESS_FAILED,
+        LOUDNESS_AUDIO_MS,
+        LOUDNESS_CPU_US,
+        // TagReader (不支持的格式回退到完整探测，计入 PROBE_*)
+        TAG_READ,
+        TAG_UNSUPPORTED,
+        TAG_US,                  // 含不支持格式的判断耗时
+        TAG_BYTES,
+        COUNTER_COUNT
+    };
+
+    static const int SNAPSHOT_VERSION = 1;
+    static const int SNAPSHOT_SIZE = 1 + COUNTER_COUNT;
+
+    static void add(Counter counter, int64_t value = 1) {
+        sCounters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    static void snapshot(int64_t *out);
+
+    static void reset();
+
+private:
+    static std::atomic<int64_t> sCounters[COUNTER_COUNT];
+};
+
+#endif //QYPLAYER_SCANSTATS_H
@@ -0,0 +1,536 @@
+#include "TagReader.h"
+#include "HeaderProbe.h"
+#include "CharsetDetector.h"
+#include "ScanStats.h"
+#include <chrono>
+#include <algorithm>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+extern "C" {
+#include "id3.h"
+#include "genre.dat"
+}
+
+// 单个文本帧 / Vorbis comment 块的读取上限，超过的 (通常是内嵌封面) 直接跳过
+#define MAX_TEXT_FRAME_SIZE (256 * 1024)
+#define MAX_COMMENT_SIZE (1024 * 1024)
+
+namespace {
+
+    struct Tags {
+        std::string title;
+        std::string artist;
+        std::string album;
+        std::string albumArtist;
+        std::string genre;
+        std::string date;
+        std::string comment;
+        std::string track;      // "3" 或 "3/12"
+        std::string trackTotal;
+        std::string disc;
+        std::string discTotal;
+    };
+
+    /**
+     * pread 封装：文件头缓存在内存中，落在其中的读取不产生 IO
+     */
+    class FileReader {
+    public:
+        FileReader(int fd, int64_t size) : mFd(fd), mSize(size) {
+            mHead.resize((size_t) std::min<int64_t>(size, TagReader::HEAD_SIZE));
+            ssize_t n = pread(fd, mHead.data(), mHead.size(), 0);
+            mHead.resize(n > 0 ? (size_t) n : 0);
+            mBytesRead = mHead.size();
+        }
+
+        bool read(int64_t offset, size_t len, uint8_t *dst) {
+            if (offset < 0 || offset + (int64_t) len > mSize) return false;
+            if (offset + (int64_t) len <= (int64_t) mHead.size()) {
+                memcpy(dst, mHead.data() + offset, len);
+                return true;
+            }
+            ssize_t n = pread(mFd, dst, len, offset);
+            if (n > 0) mBytesRead += n;
+            return n == (ssize_t) len;
+        }
+
+        const std::vector<uint8_t> &head() const { return mHead; }
+
+        int64_t size() const { return mSize; }
+
+        int64_t bytesRead() const { return mBytesRead; }
+
+    private:
+        int mFd;
+        int64_t mSize;
+        std::vector<uint8_t> mHead;
+        int64_t mBytesRead = 0;
+    };
+
+    inline uint32_t be32(const uint8_t *p) {
+        return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 | (uint32_t) p[2] << 8 | p[3];
+    }
+
+    inline uint32_t le32(const uint8_t *p) {
+        return (uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 | (uint32_t) p[1] << 8 | p[0];
+    }
+
+    inline uint32_t syncsafe(const uint8_t *p) {
+        return (uint32_t) (p[0] & 0x7F) << 21 | (uint32_t) (p[1] & 0x7F) << 14 |
+               (uint32_t) (p[2] & 0x7F) << 7 | (p[3] & 0x7F);
+    }
+
+    void trimRight(std::string &s) {
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\0')) s.pop_back();
+    }
+
+    // ==========================================
+    // ID3v2
+    // ==========================================
+
+    /**
+     * 按帧编码解码为 UTF-8，多值 (v2.4 以 \0 分隔) 只取第一个
+     */
+    std::string decodeId3Text(uint8_t encoding, const uint8_t *p, size_t len, size_t *consumed = nullptr) {
+        std::string out;
+        size_t n = 0;
+        if (encoding == ID3_ENCODING_UTF16 || encoding == ID3_ENCODING_UTF16BE) {
+            while (n + 1 < len && (p[n] || p[n + 1])) n += 2;
+            if (consumed) *consumed = std::min(len, n + 2);
+            if (n > 0) {
+                CharsetDetector::convert(p, n, encoding == ID3_ENCODING_UTF16 ? "UTF-16" : "UTF-16BE",
+                                         out, false);
+            }
+        } else {
+            while (n < len && p[n]) n++;
+            if (consumed) *consumed = std::min(len, n + 1);
+            if (encoding == ID3_ENCODING_UTF8) {
+                out.assign((const char *) p, n);
+            } else {
+                // 标注为 ISO-8859-1 的帧常常实际是 GBK 等本地编码
+                out = CharsetDetector::toUtf8(p, n, nullptr, "ISO-8859-1");
+            }
+        }
+        trimRight(out);
+        return out;
+    }
+
+    std::string id3Text(struct id3_tag *tag, uint32_t id) {
+        struct id3_frame *frame = id3_get_frame(tag, id, 1);
+        if (!frame || !frame->fr_data || frame->fr_size < 2) return "";
+        const auto *data = (const uint8_t *) frame->fr_data;
+        return decodeId3Text(data[0], data + 1, frame->fr_size - 1);
+    }
+
+    std::string id3Comment(struct id3_tag *tag) {
+        struct id3_frame *frame = id3_get_frame(tag, ID3_COMM, 1);
+        // 编码 (1) + 语言 (3) + 描述 + 正文
+        if (!frame || !frame->fr_data || frame->fr_size < 5) return "";
+        const auto *data = (const uint8_t *) frame->fr_data;
+        size_t consumed = 0;
+        decodeId3Text(data[0], data + 4, frame->fr_size - 4, &consumed);
+        if (4 + consumed >= (size_t) frame->fr_size) return "";
+        return decodeId3Text(data[0], data + 4 + consumed, frame->fr_size - 4 - consumed);
+    }
+
+    // "(17)"、"17"、"(17)Rock" -> 名称
+    std::string id3Genre(const std::string &raw) {
+        size_t count = sizeof(genre_table) / sizeof(genre_table[0]);
+        std::string s = raw;
+        if (!s.empty() && s[0] == '(') {
+            size_t close = s.find(')');
+            if (close != std::string::npos) {
+                std::string rest = s.substr(close + 1);
+                if (!rest.empty()) return rest;
+                s = s.substr(1, close - 1);
+            }
+        }
+        if (!s.empty() && s.find_first_not_of("0123456789") == std::string::npos) {
+            size_t index = (size_t) atoi(s.c_str());
+            if (index < count) return genre_table[index];
+        }
+        return raw;
+    }
+
+    bool isTextFrame(const uint8_t *id, int version) {
+        if (version == 2) return id[0] == 'T' || memcmp(id, "COM", 3) == 0;
+        return id[0] == 'T' || memcmp(id, "COMM", 4) == 0;
+    }
+
+    /**
+     * 读取 offset 处的 ID3v2 标签。逐帧读取帧头，只把文本帧拼成一个精简标签交给 libid3，
+     * 封面 (APIC)、GEOB、PRIV 等帧的内容不会被读取。
+     */
+    bool readId3(FileReader &f, int64_t offset, Tags &tags) {
+        uint8_t hdr[10];
+        if (!f.read(offset, sizeof(hdr), hdr) || memcmp(hdr, "ID3", 3) != 0) return false;
+        int version = hdr[3];
+        uint8_t flags = hdr[5];
+        if (version < 2 || version > 4) return false;
+        int64_t end = offset + 10 + syncsafe(hdr + 6);
+        if (end > f.size()) end = f.size();
+
+        std::vector<uint8_t> buf(hdr, hdr + sizeof(hdr));
+        int64_t pos = offset + 10;
+        // 整个标签做过反同步处理时帧边界不可靠，交给 FFmpeg
+        if (flags & 0x80) return false;
+        if (flags & 0x40) {
+            uint8_t ext[4];
+            if (!f.read(pos, 4, ext)) return false;
+            pos += version == 4 ? syncsafe(ext) : be32(ext) + 4;
+        }
+
+        int frameHeaderSize = version == 2 ? 6 : 10;
+        uint8_t fh[10];
+        while (pos + frameHeaderSize <= end) {
+            if (!f.read(pos, frameHeaderSize, fh) || fh[0] == 0) break; // 填充区
+            uint32_t size = version == 2 ? ((uint32_t) fh[3] << 16 | fh[4] << 8 | fh[5])
+                                         : (version == 4 ? syncsafe(fh + 4) : be32(fh + 4));
+            if (pos + frameHeaderSize + size > end) break;
+            if (isTextFrame(fh, version) && size <= MAX_TEXT_FRAME_SIZE) {
+                size_t at = buf.size();
+                buf.resize(at + frameHeaderSize + size);
+                memcpy(buf.data() + at, fh, frameHeaderSize);
+                if (!f.read(pos + frameHeaderSize, size, buf.data() + at + frameHeaderSize)) break;
+            }
+            pos += frameHeaderSize + size;
+        }
+
+        // 重写标签头：去掉扩展头与 footer 标记，大小改为精简后的长度
+        uint32_t bodySize = (uint32_t) (buf.size() - 10);
+        buf[5] = flags & ~(0x40 | 0x10);
+        buf[6] = (bodySize >> 21) & 0x7F;
+        buf[7] = (bodySize >> 14) & 0x7F;
+        buf[8] = (bodySize >> 7) & 0x7F;
+        buf[9] = bodySize & 0x7F;
+
+        struct id3_tag *tag = id3_open_mem(buf.data(), ID3_OPENF_NONE);
+        if (!tag) return false;
+        tags.title = id3Text(tag, ID3_TIT2);
+        tags.artist = id3Text(tag, ID3_TPE1);
+        tags.album = id3Text(tag, ID3_TALB);
+        tags.albumArtist = id3Text(tag, ID3_TPE2);
+        tags.genre = id3Genre(id3Text(tag, ID3_TCON));
+        tags.date = id3Text(tag, ID3_TDRC);
+        if (tags.date.empty()) tags.date = id3Text(tag, ID3_TYER);
+        tags.comment = id3Comment(tag);
+        tags.track = id3Text(tag, ID3_TRCK);
+        tags.disc = id3Text(tag, ID3_TPOS);
+        id3_close(tag);
+        return true;
+    }
+
+    // ID3v1 (文件末尾 128 字节)，仅在没有 ID3v2 时使用
+    bool readId3v1(FileReader &f, Tags &tags) {
+        uint8_t b[128];
+        if (f.size() < 128 || !f.read(f.size() - 128, sizeof(b), b) || memcmp(b, "TAG", 3) != 0) {
+            return false;
+        }
+        auto field = [&](int offset, int len) {
+            int n = 0;
+            while (n < len && b[offset + n]) n++;
+            std::string s = CharsetDetector::toUtf8(b + offset, n, nullptr, "ISO-8859-1");
+            trimRight(s);
+            return s;
+        };
+        tags.title = field(3, 30);
+        tags.artist = field(33, 30);
+        tags.album = field(63, 30);
+        tags.date = field(93, 4);
+        tags.comment = field(97, b[125] == 0 ? 28 : 30);
+        if (b[125] == 0 && b[126] != 0) tags.track = std::to_string(b[126]);
+        if (b[127] < sizeof(genre_table) / sizeof(genre_table[0])) tags.genre = genre_table[b[127]];
+        return true;
+    }
+
+    // ==========================================
+    // Vorbis comment (FLAC / Ogg)
+    // ==========================================
+
+    void parseVorbisComment(const uint8_t *p, size_t size, Tags &tags) {
+        size_t pos = 0;
+        if (size < 8) return;
+        pos += 4 + (size_t) le32(p); // vendor
+        if (pos + 4 > size) return;
+        uint32_t count = le32(p + pos);
+        pos += 4;
+
+        static const struct {
+            const char *key;
+            std::string Tags::*field;
+        } kFields[] = {
+                {"TITLE",        &Tags::title},
+                {"ARTIST",       &Tags::artist},
+                {"ALBUM",        &Tags::album},
+                {"ALBUMARTIST",  &Tags::albumArtist},
+                {"ALBUM ARTIST", &Tags::albumArtist},
+                {"ALBUM_ARTIST", &Tags::albumArtist},
+                {"GENRE",        &Tags::genre},
+                {"DATE",         &Tags::date},
+                {"YEAR",         &Tags::date},
+                {"COMMENT",      &Tags::comment},
+                {"DESCRIPTION",  &Tags::comment},
+                {"TRACKNUMBER",  &Tags::track},
+                {"TRACKTOTAL",   &Tags::trackTotal},
+                {"TOTALTRACKS",  &Tags::trackTotal},
+                {"DISCNUMBER",   &Tags::disc},
+                {"DISCTOTAL",    &Tags::discTotal},
+                {"TOTALDISCS",   &Tags::discTotal},
+        };
+
+        // 截断的块 (超出读取上限) 解析到哪里算哪里
+        for (uint32_t i = 0; i < count && pos + 4 <= size; ++i) {
+            uint32_t len = le32(p + pos);
+            pos += 4;
+            if (len > size - pos) break;
+            const char *entry = (const char *) p + pos;
+            pos += len;
+
+            const char *eq = (const char *) memchr(entry, '=', len);
+            if (!eq) continue;
+            size_t keyLen = eq - entry;
+            for (const auto &f: kFields) {
+                if (strlen(f.key) == keyLen && strncasecmp(entry, f.key, keyLen) == 0) {
+                    std::string &dst = tags.*(f.field);
+                    // 同名字段出现多次时保留第一个
+                    if (dst.empty()) dst.assign(eq + 1, entry + len - eq - 1);
+                    break;
+                }
+            }
+        }
+    }
+
+    /**
+     * @param offset "fLaC" 的位置
+     */
+    bool readFlac(FileReader &f, int64_t offset, Tags &tags, HeaderInfo &info) {
+        uint8_t bh[4];
+        int64_t pos = offset + 4;
+        bool last = false;
+        while (!last && f.read(pos, 4, bh)) {
+            last = (bh[0] & 0x80) != 0;
+            int type = bh[0] & 0x7F;
+            uint32_t len = (uint32_t) bh[1] << 16 | bh[2] << 8 | bh[3];
+            if (type == 0 && len >= 34) {
+                // "fLaC" + STREAMINFO 交给 HeaderProbe
+                uint8_t si[8 + 34];
+                memcpy(si, "fLaC", 4);
+                memcpy(si + 4, bh, 4);
+                if (f.read(pos + 4, 34, si + 8)) HeaderProbe::parse(si, sizeof(si), info);
+            } else if (type == 4) {
+                std::vector<uint8_t> block(std::min<uint32_t>(len, MAX_COMMENT_SIZE));
+                if (f.read(pos + 4, block.size(), block.data())) {
+                    parseVorbisComment(block.data(), block.size(), tags);
+                }
+                return true;
+            }
+            pos += 4 + len;
+        }
+        return info.sampleRate > 0;
+    }
+
+    /**
+     * 拼出第一条逻辑流的第二个包 (注释头)，只读取其所在页的数据
+     */
+    bool readOgg(FileReader &f, Tags &tags, std::string &format) {
+        int64_t pos = 0;
+        uint32_t serial = 0;
+        int packetIndex = 0;
+        std::vector<uint8_t> packet;
+        uint8_t page[27];
+        uint8_t laces[255];
+
+        while (packetIndex < 2 && f.read(pos, sizeof(page), page)) {
+            if (memcmp(page, "OggS", 4) != 0) return false;
+            uint32_t pageSerial = le32(page + 14);
+            int segments = page[26];
+            if (!f.read(pos + 27, segments, laces)) return false;
+            int64_t body = pos + 27 + segments;
+            int64_t bodySize = 0;
+            for (int i = 0; i < segments; ++i) bodySize += laces[i];
+
+            if (pos == 0) {
+                serial = pageSerial;
+                uint8_t id[8];
+                if (bodySize < 8 || !f.read(body, 8, id)) return false;
+                if (memcmp(id, "\x01vorbis", 7) == 0) format = "vorbis";
+                else if (memcmp(id, "OpusHead", 8) == 0) format = "opus";
+                else return false;
+            }
+
+            if (pageSerial == serial) {
+                int64_t offset = 0;
+                int64_t spanStart = -1;
+                int64_t spanEnd = -1;
+                for (int i = 0; i < segments && packetIndex < 2; ++i) {
+                    if (packetIndex == 1) {
+                        if (spanStart < 0) spanStart = offset;
+                        spanEnd = offset + laces[i];
+                    }
+                    offset += laces[i];
+                    if (laces[i] < 255) packetIndex++;
+                }
+                if (spanStart >= 0 && packet.size() < MAX_COMMENT_SIZE) {
+                    size_t at = packet.size();
+                    size_t len = (size_t) std::min<int64_t>(spanEnd - spanStart, MAX_COMMENT_SIZE - at);
+                    packet.resize(at + len);
+                    if (!f.read(body + spanStart, len, packet.data() + at)) return false;
+                }
+            }
+            pos = body + bodySize;
+        }
+
+        if (format == "vorbis" && packet.size() > 7 && memcmp(packet.data(), "\x03vorbis", 7) == 0) {
+            parseVorbisComment(packet.data() + 7, packet.size() - 7, tags);
+        } else if (format == "opus" && packet.size() > 8 && memcmp(packet.data(), "OpusTags", 8) == 0) {
+            parseVorbisComment(packet.data() + 8, packet.size() - 8, tags);
+        }
+        return true;
+    }
+
+    // ==========================================
+    // AIFF / DSF
+    // ==========================================
+
+    // 80 位扩展精度浮点 (AIFF COMM 的采样率)
+    double readExtended(const uint8_t *p) {
+        int exponent = ((p[0] & 0x7F) << 8 | p[1]) - 16383;
+        uint64_t mantissa = 0;
+        for (int i = 0; i < 8; ++i) mantissa = mantissa << 8 | p[2 + i];
+        return ldexp((double) mantissa, exponent - 63);
+    }
+
+    bool readAiff(FileReader &f, Tags &tags, HeaderInfo &info) {
+        int64_t pos = 12;
+        uint8_t ch[8];
+        while (f.read(pos, 8, ch)) {
+            uint32_t size = be32(ch + 4);
+            if (memcmp(ch, "COMM", 4) == 0 && size >= 18) {
+                uint8_t comm[18];
+                if (f.read(pos + 8, sizeof(comm), comm)) {
+                    info.format = "pcm";
+                    info.channels = comm[0] << 8 | comm[1];
+                    info.totalSamples = be32(comm + 2);
+                    info.bitDepth = comm[6] << 8 | comm[7];
+                    info.sampleRate = (int) readExtended(comm + 8);
+                }
+            } else if (memcmp(ch, "ID3 ", 4) == 0 || memcmp(ch, "id3 ", 4) == 0) {
+                readId3(f, pos + 8, tags);
+            }
+            pos += 8 + size + (size & 1);
+        }
+        return info.sampleRate > 0;
+    }
+
+    bool readDsf(FileReader &f, Tags &tags, HeaderInfo &info) {
+        const auto &head = f.head();
+        HeaderProbe::parse(head.data(), head.size(), info);
+        if (head.size() < 28) return false;
+        uint64_t metadataOffset = 0;
+        for (int i = 7; i >= 0; --i) metadataOffset = metadataOffset << 8 | head[20 + i];
+        if (metadataOffset > 0) readId3(f, (int64_t) metadataOffset, tags);
+        return true;
+    }
+
+    int parseNumber(const std::string &s, int *total) {
+        int n = 0, t = 0;
+        if (sscanf(s.c_str(), "%d/%d", &n, &t) == 2 && total && t > 0) *total = t;
+        return n;
+    }
+
+}
+
+InternalMetadata TagReader::read(const std::string &path) {
+    InternalMetadata meta;
+    meta.uri = path;
+    meta.success = false;
+
+    auto start = std::chrono::steady_clock::now();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return meta;
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return meta;
+    }
+
+    FileReader f(fd, st.st_size);
+    const auto &head = f.head();
+    Tags tags;
+    HeaderInfo info;
+    std::string format;
+    bool ok = false;
+
+    if (head.size() >= 10 && memcmp(head.data(), "ID3", 3) == 0) {
+        // ID3v2 开头：可能是 MP3，也可能是带 ID3 前缀的 FLAC
+        int64_t after = 10 + syncsafe(head.data() + 6) + ((head[5] & 0x10) ? 10 : 0);
+        uint8_t magic[4];
+        if (f.read(after, 4, magic) && memcmp(magic, "fLaC", 4) == 0) {
+            format = "flac";
+            ok = readFlac(f, after, tags, info);
+        } else if (strcasecmp(path.c_str() + std::max<size_t>(path.size(), 4) - 4, ".mp3") == 0) {
+            format = "mp3";
+            ok = readId3(f, 0, tags);
+        }
+    } else if (head.size() >= 4 && memcmp(head.data(), "fLaC", 4) == 0) {
+        format = "flac";
+        ok = readFlac(f, 0, tags, info);
+    } else if (head.size() >= 4 && memcmp(head.data(), "OggS", 4) == 0) {
+        ok = readOgg(f, tags, format);
+    } else if (head.size() >= 12 && memcmp(head.data(), "FORM", 4) == 0 &&
+               (memcmp(head.data() + 8, "AIFF", 4) == 0 || memcmp(head.data() + 8, "AIFC", 4) == 0)) {
+        format = "aiff";
+        ok = readAiff(f, tags, info);
+    } else if (head.size() >= 4 && memcmp(head.data(), "DSD ", 4) == 0) {
+        ok = readDsf(f, tags, info);
+        format = info.format.empty() ? "dsd" : info.format;
+    } else if (head.size() >= 2 && head[0] == 0xFF && (head[1] & 0xE0) == 0xE0 &&
+               strcasecmp(path.c_str() + std::max<size_t>(path.size(), 4) - 4, ".mp3") == 0) {
+        format = "mp3";
+        ok = readId3v1(f, tags);
+        if (!ok) ok = true; // 没有标签的 MP3，标题取文件名
+    }
+    close(fd);
+
+    if (ok) {
+        meta.albumTitle = tags.album;
+        meta.albumArtist = tags.albumArtist.empty() ? tags.artist : tags.albumArtist;
+        meta.genre = tags.genre;
+        meta.date = tags.date;
+        meta.description = tags.comment;
+        if (!tags.trackTotal.empty()) meta.totalTracks = atoi(tags.trackTotal.c_str());
+        if (!tags.discTotal.empty()) meta.totalDiscs = atoi(tags.discTotal.c_str());
+
+        InternalTrack track;
+        track.trackId = std::max(1, parseNumber(tags.track, &meta.totalTracks));
+        track.discNumber = std::max(1, parseNumber(tags.disc, &meta.totalDiscs));
+        track.path = path;
+        track.title = tags.title;
+        if (track.title.empty()) track.title = path.substr(path.find_last_of("/\\") + 1);
+        track.artist = tags.artist;
+        track.album = tags.album;
+        track.genre = tags.genre;
+        track.format = info.format == "pcm" || info.format.empty() ? format : info.format;
+        track.sampleRate = info.sampleRate;
+        track.channels = info.channels;
+        track.bitDepth = info.bitDepth;
+        track.durationMs = info.durationMs();
+        track.endMs = track.durationMs;
+        if (track.durationMs > 0) track.bitRate = (int64_t) st.st_size * 8 * 1000 / track.durationMs;
+        meta.tracks.push_back(track);
+        meta.success = true;
+    }
+
+    ScanStats::add(ok ? ScanStats::TAG_READ : ScanStats::TAG_UNSUPPORTED);
+    ScanStats::add(ScanStats::TAG_US, std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    ScanStats::add(ScanStats::TAG_BYTES, f.bytesRead());
+    return meta;
+}
@@ -0,0 +1,30 @@
+#ifndef QYPLAYER_TAGREADER_H
+#define QYPLAYER_TAGREADER_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "AudioProbe.h"
+
+/**
+ * 仅读取标签的快速扫描 (不打开 FFmpeg 解复用器)
+ *
+ * - MP3 / DSF / AIFF：定位 ID3v2 标签后交给 libid3 解析；封面等二进制帧在读取时直接跳过，
+ *   只读入文本帧 (同时绕开 libid3 对大帧的限制)。文本按帧编码转为 UTF-8，
+ *   ISO-8859-1 帧先经 CharsetDetector 检测 (国内常见的 GBK 标签)
+ * - FLAC / Ogg Vorbis / Opus：原生解析 Vorbis comment，跳过 PICTURE 块
+ *
+ * 全部使用 pread：先读文件头 HEAD_SIZE 字节，标签在其中时不再有额外 IO。
+ * FLAC / DSF / AIFF 顺带从文件头得到采样率等参数。仅支持本地文件。
+ */
+class TagReader {
+public:
+    static const size_t HEAD_SIZE = 4096;
+
+    /**
+     * @return 格式不支持或读取失败时 success 为 false，调用方可回退到 AudioProbe::probe
+     */
+    static InternalMetadata read(const std::string &path);
+};
+
+#endif //QYPLAYER_TAGREADER_H
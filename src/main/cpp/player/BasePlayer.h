@@ -2,6 +2,10 @@
 #define QYPLAYER_BASEPLAYER_H
 
 #include "PlayerDefines.h"
+#include "PlayerStats.h"
+#include "StartupProfile.h"
+#include "MemoryBudget.h"
+#include "Trace.h"
 #include "DsdUtils.h"
 #include "Logger.h"
 #include <mutex>
@@ -23,10 +27,23 @@ public:
 
     virtual void setDsdConfig(DsdMode mode, int d2pSampleRate = -1) {
         mDsdMode = mode;
+        mRequestedD2pSampleRate = d2pSampleRate;
         mTargetD2pSampleRate = d2pSampleRate;
         LOGD("DsdConfig: mode = %d, d2pSampleRate = %d", mode, d2pSampleRate);
     }
 
+    // 最大 PCM 输出声道数，<= 0 表示按系统属性协商；需在 prepare 之前设置
+    virtual void setMaxOutputChannels(int channels) {
+        mMaxOutputChannels = channels;
+        LOGD("MaxOutputChannels: %d", channels);
+    }
+
+    // 需在 prepare 之前设置
+    virtual void setOutputEncoding(PcmEncoding encoding) {
+        mOutputEncoding = encoding;
+        LOGD("OutputEncoding: %d", encoding);
+    }
+
     virtual void prepare() = 0;
 
     virtual void play() = 0;
@@ -54,6 +71,11 @@ public:
 
     virtual bool isDsd() const = 0;
 
+    // 实际输出的 PCM 编码 (DSD Native 时无意义)
+    virtual PcmEncoding getOutputEncoding() const {
+        return getBitPerSample() == 32 ? PCM_ENCODING_32BIT : PCM_ENCODING_16BIT;
+    }
+
     bool isPlaying() const {
         return mState == STATE_PLAYING;
     }
@@ -62,8 +84,36 @@ public:
         return mState;
     }
 
+    // 无锁，可在任意线程轮询
+    const PlayerStats &getStats() const {
+        return mStats;
+    }
+
+    // 无锁，可在任意线程轮询
+    const MemoryAccount &getMemory() const {
+        return mMemory;
+    }
 protected:
+    // 回调 onAudioData，同时统计回调耗时与送出字节数
+    void emitAudioData(uint8_t *data, int size) {
+        if (!mCallback) return;
+        QY_TRACE_SCOPE("onAudioData");
+        int64_t start = PlayerStats::nowUs();
+        mCallback->onAudioData(data, size);
+        mStats.record(PlayerStats::HIST_CALLBACK, PlayerStats::nowUs() - start);
+        mStats.add(PlayerStats::COUNTER_DELIVERED_BYTES, size);
+
+        // 起播剖析只经回调输出 (Kotlin 侧 StartupProfile、qyplay 的 startup 行)
+        int64_t profile[StartupProfile::SNAPSHOT_SIZE];
+        if (mStartup.finish(profile)) {
+            mCallback->onStartupProfile(profile, StartupProfile::SNAPSHOT_SIZE);
+        }
+    }
+
     IPlayerCallback *mCallback = nullptr;
+    PlayerStats mStats;
+    MemoryAccount mMemory;
+    StartupProfile mStartup;
 
     std::atomic<PlayerState> mState{STATE_IDLE};
     std::mutex mStateMutex;
@@ -84,7 +134,12 @@ protected:
 
     // DSD 配置
     DsdMode mDsdMode = DSD_MODE_NATIVE;
-    int mTargetD2pSampleRate = 192000;
+    int mRequestedD2pSampleRate = 192000;
+    int mTargetD2pSampleRate = 192000; // 实际使用的 D2P 采样率，prepare 时按 DsdCalibration 可能低于设置值
+
+    // PCM 输出编码
+    PcmEncoding mOutputEncoding = PCM_ENCODING_AUTO;
+    int mMaxOutputChannels = -1;
 
     bool is4ChannelSupported = false;
 };
@@ -0,0 +1,102 @@
+#include "DecoderThreadPolicy.h"
+#include "Logger.h"
+#include <thread>
+
+// 起播延迟上限：超过则认为多线程得不偿失
+#define MAX_THREADED_FIRST_FRAME_US (300 * 1000)
+// 多线程 RTF 低于此值时才以单线程测量基线 (2 线程时单线程 RTF 约不超过 0.7，不会欠载)
+#define MAX_RTF_FOR_SINGLE_PROBE 0.35
+// 多线程吞吐至少提升 10% 才保留
+#define MIN_THREADED_GAIN 0.9
+
+// 需要多线程且解码器支持帧线程的 codec；未列出的保持单线程
+const DecoderThreadPolicy::Rule DecoderThreadPolicy::kRules[] = {
+        {AV_CODEC_ID_WAVPACK, 2, FF_THREAD_FRAME},
+        {AV_CODEC_ID_TAK,     2, FF_THREAD_FRAME},
+        {AV_CODEC_ID_NONE,    0, 0},
+};
+
+std::mutex DecoderThreadPolicy::sMutex;
+std::map<AVCodecID, DecoderThreadPolicy::Stats> DecoderThreadPolicy::sStats;
+
+bool DecoderThreadPolicy::apply(AVCodecContext *ctx, const AVCodec *codec) {
+    // 默认单线程，avcodec 的 auto (0) 会按核数开线程
+    ctx->thread_count = 1;
+    if (!codec) return false;
+
+    const Rule *rule = nullptr;
+    for (const Rule *r = kRules; r->id != AV_CODEC_ID_NONE; ++r) {
+        if (r->id == codec->id) {
+            rule = r;
+            break;
+        }
+    }
+    if (!rule) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        auto it = sStats.find(codec->id);
+        if (it != sStats.end() && it->second.disabled) {
+            LOGD("DecoderThreadPolicy: %s fallback to single thread", codec->name);
+            return false;
+        }
+        if (it != sStats.end() && it->second.rtfSingle < 0 && it->second.rtfThreaded >= 0 &&
+            it->second.rtfThreaded < MAX_RTF_FOR_SINGLE_PROBE) {
+            LOGD("DecoderThreadPolicy: %s single thread baseline", codec->name);
+            return false;
+        }
+    }
+
+    // 解码器未声明支持对应线程模型时 avcodec 会忽略设置，这里直接跳过
+    int threadType = 0;
+    if ((rule->threadType & FF_THREAD_FRAME) && (codec->capabilities & AV_CODEC_CAP_FRAME_THREADS)) {
+        threadType |= FF_THREAD_FRAME;
+    }
+    if ((rule->threadType & FF_THREAD_SLICE) && (codec->capabilities & AV_CODEC_CAP_SLICE_THREADS)) {
+        threadType |= FF_THREAD_SLICE;
+    }
+    if (threadType == 0) return false;
+
+    int cores = (int) std::thread::hardware_concurrency();
+    int threads = rule->threadCount;
+    if (cores > 0 && threads > cores) threads = cores;
+    if (threads <= 1) return false;
+
+    ctx->thread_count = threads;
+    ctx->thread_type = threadType;
+    LOGD("DecoderThreadPolicy: %s threads=%d type=%d", codec->name, threads, threadType);
+    return true;
+}
+
+void DecoderThreadPolicy::report(AVCodecID id, bool threaded, double rtf, int64_t firstFrameUs) {
+    if (rtf <= 0) return;
+    std::lock_guard<std::mutex> lock(sMutex);
+    Stats &stats = sStats[id];
+    if (threaded) {
+        stats.rtfThreaded = rtf;
+        stats.firstFrameThreadedUs = firstFrameUs;
+    } else {
+        stats.rtfSingle = rtf;
+    }
+    LOGD("DecoderThreadPolicy: %s %s rtf=%.3f firstFrame=%lldus",
+         avcodec_get_name(id), threaded ? "threaded" : "single", rtf, (long long) firstFrameUs);
+
+    // 两种模式都测量过才比较
+    if (stats.disabled || stats.rtfSingle <= 0 || stats.rtfThreaded <= 0) return;
+
+    // 吞吐无明显提升，或单线程本已足够快而多线程拖慢起播时降级
+    bool noGain = stats.rtfThreaded >= stats.rtfSingle * MIN_THREADED_GAIN;
+    bool slowStart = stats.firstFrameThreadedUs > MAX_THREADED_FIRST_FRAME_US && stats.rtfSingle < 0.5;
+    if (noGain || slowStart) {
+        stats.disabled = true;
+        LOGD("DecoderThreadPolicy: disable threading for %s (noGain=%d slowStart=%d)",
+             avcodec_get_name(id), noGain, slowStart);
+    }
+}
+
+double DecoderThreadPolicy::getRtf(AVCodecID id, bool threaded) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    auto it = sStats.find(id);
+    if (it == sStats.end()) return -1;
+    return threaded ? it->second.rtfThreaded : it->second.rtfSingle;
+}
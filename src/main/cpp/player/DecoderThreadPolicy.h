@@ -0,0 +1,66 @@
+#ifndef QYPLAYER_DECODERTHREADPOLICY_H
+#define QYPLAYER_DECODERTHREADPOLICY_H
+
+#include <stdint.h>
+#include <mutex>
+#include <map>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+/**
+ * 解码器多线程策略
+ *
+ * WavPack/TAK 等重负载无损格式单核解码在 ARM 上偶有欠载。这里按 codec 配置
+ * thread_count/thread_type (仅在解码器声明支持时生效)，并记录每个 codec 的实时率 (RTF)。
+ * FFmpeg 的 APE、TrueHD/MLP、DTS 解码器不支持帧/片线程，无法由此加速。
+ *
+ * RTF 为解码线程阻塞在 send/receive 中的墙钟时间 / 音频时长，即解码线程的吞吐；
+ * 帧线程下工作线程的 CPU 时间与之重叠，不计入，因此它不代表总 CPU 开销。
+ *
+ * 帧线程每多一个线程就多一帧延迟：多线程 RTF 有足够余量时，下一次会话以单线程运行一次
+ * 测得基线；若多线程吞吐没有明显提升，或单线程本已足够快而多线程拖慢起播，
+ * 则在本进程内将其降级为单线程。
+ */
+class DecoderThreadPolicy {
+public:
+    /**
+     * 在 avcodec_open2 之前调用
+     * @return 是否启用了多线程
+     */
+    static bool apply(AVCodecContext *ctx, const AVCodec *codec);
+
+    /**
+     * 一次播放会话结束后上报测量结果
+     * @param rtf 解码耗时 / 音频时长，< 1 表示快于实时
+     * @param firstFrameUs 首个 packet 送入到首帧输出的耗时
+     */
+    static void report(AVCodecID id, bool threaded, double rtf, int64_t firstFrameUs);
+
+    /**
+     * 最近一次测得的 RTF，未测量返回 -1
+     */
+    static double getRtf(AVCodecID id, bool threaded);
+
+private:
+    struct Rule {
+        AVCodecID id;
+        int threadCount;
+        int threadType;
+    };
+
+    struct Stats {
+        double rtfSingle = -1;
+        double rtfThreaded = -1;
+        int64_t firstFrameThreadedUs = -1;
+        bool disabled = false;
+    };
+
+    static const Rule kRules[];
+
+    static std::mutex sMutex;
+    static std::map<AVCodecID, Stats> sStats;
+};
+
+#endif //QYPLAYER_DECODERTHREADPOLICY_H
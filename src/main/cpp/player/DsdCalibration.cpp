@@ -0,0 +1,263 @@
+#include "DsdCalibration.h"
+#include "FFmpegD2pDecoder.h"
+#include "PlayerStats.h"
+#include "Trace.h"
+#include "Logger.h"
+#include <thread>
+#include <atomic>
+
+extern "C" {
+#include "dst_init.h"
+#include "dst_fram.h"
+}
+
+// SACD 每秒 75 帧
+#define DSD_FRAMES_PER_SECOND 75
+// D2P 自测：2 帧预热 (滤波器延迟)，计时 36 帧 (约 0.5 秒音频)
+#define D2P_WARMUP_FRAMES 2
+#define D2P_CALIBRATION_FRAMES 36
+
+std::mutex &DsdCalibration::sMutex = *new std::mutex;
+std::map<int, DsdCalibration::DstResult> &DsdCalibration::sDst = *new std::map<int, DstResult>;
+std::map<std::pair<int, int>, double> &DsdCalibration::sD2p = *new std::map<std::pair<int, int>, double>;
+std::set<int> &DsdCalibration::sD2pPending = *new std::set<int>;
+
+double DsdCalibration::runDst(const std::vector<std::vector<uint8_t>> &frames, int channelCount,
+                              int workers, int64_t deadlineUs, bool &complete) {
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<int> failed{0};
+    std::atomic<int> decoded{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back([&] {
+            qy_set_thread_name("dstCalibrate");
+            auto *decoder = new ebunch();
+            bool ok = DST_InitDecoder(decoder, channelCount, 64) == 0;
+            std::vector<uint8_t> out((size_t) MAX_DSDBITS_INFRAME / 8 * channelCount);
+            ready.fetch_add(1);
+            // 各线程的解码器初始化完成后同时开始，计时只含解码
+            while (!go.load()) std::this_thread::yield();
+            int errors = 0;
+            size_t f = 0;
+            for (; ok && f < frames.size(); f++) {
+                if (f > 0 && PlayerStats::nowUs() >= deadlineUs) break;
+                auto &frame = frames[f];
+                if (DST_FramDSTDecode((uint8_t *) frame.data(), out.data(), (int) frame.size(), (int) f,
+                                      decoder) != DSTErr_NoError) {
+                    errors++;
+                }
+            }
+            decoded.fetch_add((int) f);
+            if (!ok || errors == (int) f) failed.fetch_add(1);
+            if (ok) DST_CloseDecoder(decoder);
+            delete decoder;
+        });
+    }
+    while (ready.load() < workers) std::this_thread::yield();
+    int64_t start = PlayerStats::nowUs();
+    go.store(true);
+    for (auto &t: threads) t.join();
+    int64_t elapsedUs = PlayerStats::nowUs() - start;
+    complete = decoded.load() == workers * (int) frames.size();
+    if (failed.load() > 0) return -1;
+
+    // 到达截止时刻的线程各自停在不同的帧，按实际解码的总帧数计算
+    double audioUs = (double) decoded.load() * 1000000.0 / DSD_FRAMES_PER_SECOND;
+    return elapsedUs / audioUs;
+}
+
+bool DsdCalibration::calibrateDst(const std::vector<std::vector<uint8_t>> &frames, int channelCount,
+                                  int64_t deadlineUs) {
+    if (hasDstResult(channelCount)) return true;
+    if (frames.empty() || channelCount <= 0) return false;
+    QY_TRACE_SCOPE("dstCalibrate");
+
+    DstResult result{};
+    for (double &rtf: result.rtf) rtf = -1;
+    // 读帧超出预算时帧数不足，单帧的测量误差很大
+    result.complete = (int) frames.size() >= DST_CALIBRATION_FRAMES;
+    int cores = (int) std::thread::hardware_concurrency();
+    int maxWorkers = cores > 0 && cores < MAX_DST_WORKERS ? cores : MAX_DST_WORKERS;
+    for (int workers = 1; workers <= maxWorkers; workers++) {
+        if (workers > 1 && PlayerStats::nowUs() >= deadlineUs) {
+            result.truncated = true;
+            result.complete = false;
+            LOGD("DsdCalibration: DST %dch, budget used up before %d worker(s)", channelCount, workers);
+            break;
+        }
+        bool decodedAll = false;
+        double rtf = runDst(frames, channelCount, workers, deadlineUs, decodedAll);
+        if (!decodedAll) result.complete = false;
+        if (rtf < 0) {
+            if (workers == 1) {
+                LOGW("DsdCalibration: DST frames undecodable (%dch), skip", channelCount);
+                return false;
+            }
+            break;
+        }
+        result.rtf[workers] = rtf;
+        LOGD("DsdCalibration: DST %dch, %d worker(s), rtf %.3f", channelCount, workers, rtf);
+        // 余量已足够，或多加线程没有带来提升 (核数受限 / 被调度到小核)，不再继续
+        if (rtf <= RTF_LIMIT / 2) break;
+        if (workers > 1 && rtf > result.rtf[workers - 1] * 0.9) break;
+    }
+
+    if (!result.complete) {
+        LOGD("DsdCalibration: DST %dch result incomplete (%zu frames), re-measure on next prepare",
+             channelCount, frames.size());
+    }
+    std::lock_guard<std::mutex> lock(sMutex);
+    sDst[channelCount] = result;
+    return true;
+}
+
+bool DsdCalibration::hasDstResult(int channelCount) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    auto it = sDst.find(channelCount);
+    return it != sDst.end() && it->second.complete;
+}
+
+double DsdCalibration::getDstRtf(int channelCount, int workers) {
+    if (workers < 1 || workers > MAX_DST_WORKERS) return -1;
+    std::lock_guard<std::mutex> lock(sMutex);
+    auto it = sDst.find(channelCount);
+    return it != sDst.end() ? it->second.rtf[workers] : -1;
+}
+
+double DsdCalibration::getBestDstRtf(int channelCount) {
+    double best = -1;
+    for (int workers = 1; workers <= MAX_DST_WORKERS; workers++) {
+        double rtf = getDstRtf(channelCount, workers);
+        if (rtf >= 0 && (best < 0 || rtf < best)) best = rtf;
+    }
+    return best;
+}
+
+int DsdCalibration::chooseDstWorkers(int channelCount, double extraRtf) {
+    DstResult result{};
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        auto it = sDst.find(channelCount);
+        if (it == sDst.end()) return DEFAULT_DST_WORKERS;
+        result = it->second;
+    }
+    int bestWorkers = 1;
+    int maxMeasured = 1;
+    double best = -1;
+    for (int workers = 1; workers <= MAX_DST_WORKERS; workers++) {
+        double rtf = result.rtf[workers];
+        if (rtf < 0) continue;
+        if (rtf + extraRtf <= RTF_LIMIT) return workers;
+        maxMeasured = workers;
+        if (best < 0 || rtf < best) {
+            best = rtf;
+            bestWorkers = workers;
+        }
+    }
+    // 预算内只测到了较少的线程数且仍在随线程数下降：多用一个线程
+    if (result.truncated && bestWorkers == maxMeasured && maxMeasured < MAX_DST_WORKERS) bestWorkers++;
+    LOGW("DsdCalibration: DST %dch not real-time with headroom (rtf %.3f + %.3f), use %d worker(s)",
+         channelCount, best, extraRtf, bestWorkers);
+    return bestWorkers;
+}
+
+bool DsdCalibration::findD2p(int dsdRate, int pcmRate, double &rtf) {
+    std::lock_guard<std::mutex> lock(sMutex);
+    auto it = sD2p.find(std::make_pair(dsdRate, pcmRate));
+    if (it == sD2p.end()) return false;
+    rtf = it->second;
+    return true;
+}
+
+double DsdCalibration::getD2pRtf(int dsdRate, int pcmRate) {
+    double rtf = -1;
+    return findD2p(dsdRate, pcmRate, rtf) ? rtf : -1;
+}
+
+double DsdCalibration::measureD2p(int dsdRate, int pcmRate) {
+    if (dsdRate <= 0 || pcmRate <= 0) return -1;
+    double rtf = -1;
+    if (findD2p(dsdRate, pcmRate, rtf)) return rtf;
+    QY_TRACE_SCOPE("d2pCalibrate");
+
+    std::pair<int, int> key(dsdRate, pcmRate);
+    FFmpegD2pDecoder decoder;
+    bool ok = decoder.init(dsdRate, pcmRate, 16);
+    // 与 SacdPlayer 相同，每次送入一帧 (1/75 秒) 的立体声 DSD
+    std::vector<uint8_t> in((size_t) dsdRate / 8 / DSD_FRAMES_PER_SECOND * 2);
+    std::vector<uint8_t> out(1024 * 1024);
+    uint32_t seed = 0x12345678;
+    for (auto &b: in) {
+        seed = seed * 1664525u + 1013904223u;
+        b = (uint8_t) (seed >> 24);
+    }
+
+    int64_t start = 0;
+    for (int i = 0; ok && i < D2P_WARMUP_FRAMES + D2P_CALIBRATION_FRAMES; i++) {
+        if (i == D2P_WARMUP_FRAMES) start = PlayerStats::nowUs();
+        if (decoder.process(in.data(), (int) in.size(), out.data()) < 0) ok = false;
+    }
+    if (ok) {
+        int64_t elapsedUs = PlayerStats::nowUs() - start;
+        rtf = elapsedUs / (D2P_CALIBRATION_FRAMES * 1000000.0 / DSD_FRAMES_PER_SECOND);
+        LOGD("DsdCalibration: D2P %d -> %d, rtf %.3f", dsdRate, pcmRate, rtf);
+    } else {
+        LOGW("DsdCalibration: D2P %d -> %d unavailable", dsdRate, pcmRate);
+    }
+
+    std::lock_guard<std::mutex> lock(sMutex);
+    sD2p[key] = rtf;
+    return rtf;
+}
+
+bool DsdCalibration::pickD2pRate(int dsdRate, double scale, int requestedRate, double extraRtf, bool measure,
+                                 int &rate) {
+    static const int kFallbackRates[] = {352800, 176400, 88200, 44100};
+    auto lookup = [&](int pcmRate, double &rtf) {
+        if (!measure) return findD2p(dsdRate, pcmRate, rtf);
+        rtf = measureD2p(dsdRate, pcmRate);
+        return true;
+    };
+
+    rate = requestedRate;
+    double rtf;
+    if (!lookup(requestedRate, rtf)) return false;
+    if (rtf < 0 || rtf * scale + extraRtf <= RTF_LIMIT) return true;
+    for (int lower: kFallbackRates) {
+        if (lower >= requestedRate) continue;
+        double lowerRtf;
+        if (!lookup(lower, lowerRtf)) return false;
+        if (lowerRtf >= 0 && lowerRtf * scale + extraRtf <= RTF_LIMIT) {
+            LOGW("DsdCalibration: D2P %d Hz not real-time (rtf %.3f + %.3f), fall back to %d Hz",
+                 requestedRate, rtf * scale, extraRtf, lower);
+            rate = lower;
+            return true;
+        }
+    }
+    LOGW("DsdCalibration: D2P not real-time at any rate (rtf %.3f + %.3f), keep %d Hz",
+         rtf * scale, extraRtf, requestedRate);
+    return true;
+}
+
+int DsdCalibration::chooseD2pRate(int dsdRate, int channels, int requestedRate, double extraRtf) {
+    if (dsdRate <= 0 || requestedRate <= 0) return requestedRate;
+    double scale = channels > 2 ? channels / 2.0 : 1.0;
+    if (extraRtf < 0) extraRtf = 0;
+
+    int rate;
+    if (pickD2pRate(dsdRate, scale, requestedRate, extraRtf, false, rate)) return rate;
+    {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (!sD2pPending.insert(dsdRate).second) return requestedRate;
+    }
+    // 测量期间本次播放按请求的采样率进行
+    std::thread([=] {
+        qy_set_thread_name("d2pCalibrate");
+        int chosen;
+        pickD2pRate(dsdRate, scale, requestedRate, extraRtf, true, chosen);
+        std::lock_guard<std::mutex> lock(sMutex);
+        sD2pPending.erase(dsdRate);
+    }).detach();
+    return requestedRate;
+}
@@ -0,0 +1,97 @@
+#ifndef QYPLAYER_DSDCALIBRATION_H
+#define QYPLAYER_DSDCALIBRATION_H
+
+#include <stdint.h>
+#include <mutex>
+#include <map>
+#include <set>
+#include <vector>
+#include <utility>
+
+/**
+ * DSD 解码能力自测：DST 解码与 D2P 转换的实时率 (RTF = 处理耗时 / 音频时长，< 1 表示快于实时)
+ *
+ * 设备之间能否实时完成 6 声道 DST + D2P 差别很大。首次需要时做一次短测量，结果在本进程内缓存：
+ *  - DST：取当前曲目开头的 DST_CALIBRATION_FRAMES 帧，由 1..MAX_DST_WORKERS 个线程各自解码一遍，
+ *    按总吞吐计算 RTF (包含大小核与线程争用的影响)，按声道数缓存。测量在 prepare 中同步进行，
+ *    读帧与解码共用 DST_CALIBRATION_BUDGET_US 的预算，到时未测完的线程数不再测量。
+ *    帧不足或预算用尽时的结果只供本次 prepare 使用，下次 prepare 重新测量
+ *  - D2P：用伪随机 DSD 数据驱动 FFmpegD2pDecoder (耗时与内容无关)，按 (DSD 采样率, 输出采样率) 缓存。
+ *    每个采样率约 0.5 秒音频，逐级回落时在慢设备上可达数秒，因此在后台线程测量，不阻塞 prepare
+ * 播放器据此在起播前选择 DST 解码线程数，D2P 无法实时时降低输出采样率，而不是等到欠载。
+ */
+class DsdCalibration {
+public:
+    static const int MAX_DST_WORKERS = 4;
+    // 尚无自测结果 (自测失败或帧读取超出预算) 时的 DST 解码线程数
+    static const int DEFAULT_DST_WORKERS = 2;
+    // 16 帧约 213 ms 音频
+    static const int DST_CALIBRATION_FRAMES = 16;
+    // DST 自测的总时间预算 (读帧 + 各线程数的解码)
+    static const int64_t DST_CALIBRATION_BUDGET_US = 80 * 1000;
+    // 选择配置时的 RTF 上限，给读取、回调与系统负载留出余量
+    static constexpr double RTF_LIMIT = 0.6;
+
+    /**
+     * 测量并缓存 DST 解码 RTF，已有该声道数的完整结果时直接返回
+     * @param frames     一段连续的 DST 帧
+     * @param deadlineUs PlayerStats::nowUs() 时基下的截止时刻，到时正在进行的解码在当前帧后停止，
+     *                   按已解码的帧计算 RTF (每个线程至少解码一帧)
+     * @return 是否有可用结果 (帧全部解码失败时不缓存)
+     */
+    static bool calibrateDst(const std::vector<std::vector<uint8_t>> &frames, int channelCount,
+                             int64_t deadlineUs);
+
+    // 是否已有完整的测量结果 (不完整的结果仍可用于选择，但下次 prepare 会重新测量)
+    static bool hasDstResult(int channelCount);
+
+    // workers 个线程并行解码的 RTF，未测量返回 -1
+    static double getDstRtf(int channelCount, int workers);
+
+    // 各线程数中最低的 RTF，未测量返回 -1
+    static double getBestDstRtf(int channelCount);
+
+    /**
+     * DST RTF + extraRtf 不超过 RTF_LIMIT 的最少线程数；都不满足时取 RTF 最低者，
+     * 预算用尽而更多线程未测量时再多用一个线程；未测量返回 DEFAULT_DST_WORKERS
+     */
+    static int chooseDstWorkers(int channelCount, double extraRtf);
+
+    // 已测得的立体声 D2P RTF，未测量或测量失败返回 -1
+    static double getD2pRtf(int dsdRate, int pcmRate);
+
+    /**
+     * 选择 D2P 输出采样率：requestedRate 的 RTF (按声道数折算) + extraRtf 超过 RTF_LIMIT 时，
+     * 依次尝试更低的 44.1k 系采样率；都不满足时保持 requestedRate。
+     * 只使用已有的测量结果，不足时在后台线程补测并返回 requestedRate，之后的 prepare 再据此选择
+     */
+    static int chooseD2pRate(int dsdRate, int channels, int requestedRate, double extraRtf);
+
+private:
+    struct DstResult {
+        double rtf[MAX_DST_WORKERS + 1]; // 下标为线程数，-1 为未测量
+        bool truncated;                  // 预算用尽，更多线程数未测量
+        bool complete;                   // 帧数足够且每次都解码完全部帧
+    };
+
+    // complete 返回是否每个线程都解码完了全部帧
+    static double runDst(const std::vector<std::vector<uint8_t>> &frames, int channelCount, int workers,
+                         int64_t deadlineUs, bool &complete);
+
+    // 立体声 D2P 的 RTF (有缓存直接返回)，失败返回 -1 (同样缓存)
+    static double measureD2p(int dsdRate, int pcmRate);
+
+    static bool findD2p(int dsdRate, int pcmRate, double &rtf);
+
+    // measure 为 false 时只查缓存，遇到未测量的采样率返回 false
+    static bool pickD2pRate(int dsdRate, double scale, int requestedRate, double extraRtf, bool measure,
+                            int &rate);
+
+    // 后台测量线程是分离的，进程退出时可能仍在运行，以下对象不析构
+    static std::mutex &sMutex;
+    static std::map<int, DstResult> &sDst;
+    static std::map<std::pair<int, int>, double> &sD2p;
+    static std::set<int> &sD2pPending; // 正在后台测量的 DSD 采样率
+};
+
+#endif //QYPLAYER_DSDCALIBRATION_H
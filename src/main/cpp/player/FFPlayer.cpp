@@ -1,4 +1,6 @@
 #include "FFPlayer.h"
+#include "DsdCalibration.h"
+#include <time.h>
 
 #define DEFAULT_BUFFER_SIZE 2 * 1024 * 1024
 
@@ -8,10 +10,18 @@ static int64_t getNowMs() {
             std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
+// 辅助函数：当前线程 CPU 时间纳秒
+static int64_t threadCpuTimeNs() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
 FFPlayer::FFPlayer(IPlayerCallback *callback) : BasePlayer(callback) {
     initFFmpeg();
     outBuffer.reserve(DEFAULT_BUFFER_SIZE);
     outBuffer.resize(DEFAULT_BUFFER_SIZE);
+    mMemory.set(MemoryAccount::POOL_OUTPUT_BUFFER, (int64_t) outBuffer.size());
 }
 
 FFPlayer::~FFPlayer() {
@@ -54,6 +64,8 @@ void FFPlayer::prepare() {
         mState = STATE_PREPARING;
         audioQueue.start();
     }
+    mStats.reset();
+    mStartup.reset();
 
     AVDictionary *options = nullptr;
     bool isNetwork = false;
@@ -66,6 +78,7 @@ void FFPlayer::prepare() {
     }
 
     if (isNetwork) {
+        mStartup.setFlag(StartupProfile::FLAG_NETWORK);
         // 构造 Headers
         std::string customHeaders;
         bool hasUserAgent = false;
@@ -94,25 +107,40 @@ void FFPlayer::prepare() {
         av_dict_set(&options, "buffer_size", "4194304", 0); // 4MB 输入缓冲
         av_dict_set(&options, "seekable", "1", 0);
     }
-    fmtCtx = avformat_alloc_context();
-    fmtCtx->interrupt_callback.callback = interrupt_cb;
-    fmtCtx->interrupt_callback.opaque = this;
+
+    // 刚探测过的网络地址直接接管探测时打开的解复用器
+    bool streamInfoFound = false;
+    if (isNetwork) {
+        fmtCtx = DemuxerHandoff::take(mUrl, DemuxerHandoff::headersKey(mHeaders), &options,
+                                      streamInfoFound);
+    }
 
     int ret;
-    if ((ret = avformat_open_input(&fmtCtx, mUrl.c_str(), nullptr, &options)) != 0) {
-        if (mIsExit.load()) {
+    if (fmtCtx) {
+        LOGD("prepare: reusing probed demuxer (streamInfo=%d)", streamInfoFound);
+        mStartup.setFlag(StartupProfile::FLAG_REUSED_HANDLE);
+        av_dict_free(&options);
+        DemuxerHandoff::bindInterrupt(fmtCtx, interrupt_cb, this);
+    } else {
+        fmtCtx = avformat_alloc_context();
+        fmtCtx->interrupt_callback.callback = interrupt_cb;
+        fmtCtx->interrupt_callback.opaque = this;
+        if ((ret = avformat_open_input(&fmtCtx, mUrl.c_str(), nullptr, &options)) != 0) {
+            if (mIsExit.load()) {
+                releaseFFmpeg();
+                return;
+            }
+            LOGE("Open input failed: %d path %s", ret, mUrl.c_str());
+            std::lock_guard<std::mutex> lock(mStateMutex);
+            mState = STATE_ERROR;
+            if (mCallback) mCallback->onError(-1, "Open input failed");
             releaseFFmpeg();
             return;
         }
-        LOGE("Open input failed: %d path %s", ret, mUrl.c_str());
-        std::lock_guard<std::mutex> lock(mStateMutex);
-        mState = STATE_ERROR;
-        if (mCallback) mCallback->onError(-1, "Open input failed");
-        releaseFFmpeg();
-        return;
     }
+    mStartup.mark(StartupProfile::MILESTONE_OPENED);
 
-    if ((ret = avformat_find_stream_info(fmtCtx, nullptr)) < 0) {
+    if (!streamInfoFound && (ret = avformat_find_stream_info(fmtCtx, nullptr)) < 0) {
         if (mIsExit.load()) {
             releaseFFmpeg();
             return;
@@ -123,6 +151,7 @@ void FFPlayer::prepare() {
         releaseFFmpeg();
         return;
     }
+    mStartup.mark(StartupProfile::MILESTONE_STREAM_INFO);
 
     // 查找音频流
     audioStreamIndex = -1;
@@ -153,6 +182,7 @@ void FFPlayer::prepare() {
         }
         codecCtx = avcodec_alloc_context3(codec);
         avcodec_parameters_to_context(codecCtx, codecPar);
+        mDecoderThreaded = DecoderThreadPolicy::apply(codecCtx, codec);
 
         if ((ret = avcodec_open2(codecCtx, codec, nullptr)) < 0) {
             std::lock_guard<std::mutex> lock(mStateMutex);
@@ -168,8 +198,19 @@ void FFPlayer::prepare() {
         isMsbf = isMsbfCodec(codecCtx->codec_id);
         is4ChannelSupported = SystemProperties::is4ChannelSupported();
     }
+    // D2P 无法实时时在起播前降低输出采样率 (自测在后台进行，结果出来前按请求的采样率)，
+    // DSD 解码器的 sample_rate 为 DSD 采样率 / 8
+    mTargetD2pSampleRate = mRequestedD2pSampleRate;
+    if (mIsSourceDsd && mDsdMode == DSD_MODE_D2P) {
+        mTargetD2pSampleRate = DsdCalibration::chooseD2pRate(codecCtx->sample_rate * 8,
+                                                             codecCtx->ch_layout.nb_channels,
+                                                             mRequestedD2pSampleRate, 0);
+    }
     timeBase = &fmtCtx->streams[audioStreamIndex]->time_base;
 
+    // DSD Native/DoP 送出 32bit 帧；PCM 与 D2P 路径由 initSwrContext 中的 resolveOutputFormat 覆盖
+    mResolvedEncoding = PCM_ENCODING_32BIT;
+
     // Resampler
     if ((!mIsSourceDsd) || (mIsSourceDsd && mDsdMode == DSD_MODE_D2P)) {
         if (initSwrContext() < 0) {
@@ -179,6 +220,7 @@ void FFPlayer::prepare() {
             return;
         }
     }
+    mStartup.mark(StartupProfile::MILESTONE_CODEC_OPENED);
 
     extractAudioInfo();
     if (mStartTimeMs > 0) {
@@ -193,43 +235,37 @@ void FFPlayer::prepare() {
         }
         mState = STATE_PREPARED;
     }
+    mStartup.mark(StartupProfile::MILESTONE_PREPARED);
     if (mCallback) mCallback->onPrepared();
 }
 
 int FFPlayer::initSwrContext() {
-    if (swrCtx) swr_free(&swrCtx);
-    swrCtx = swr_alloc();
-
     AVChannelLayout inLayout = codecCtx->ch_layout;
-    AVChannelLayout outLayout;
-    av_channel_layout_default(&outLayout, CHANNEL_OUT_STEREO);
+    negotiateOutputLayout(&inLayout);
+    AVChannelLayout outLayout = mOutLayout;
 
     int outRate = mIsSourceDsd ? mTargetD2pSampleRate : codecCtx->sample_rate;
-    outputSampleFormat = mIsSourceDsd ? AV_SAMPLE_FMT_S16 : getOutputSampleFormat(
-            codecCtx->sample_fmt);
-
-    av_opt_set_chlayout(swrCtx, "in_chlayout", &inLayout, 0);
-    av_opt_set_int(swrCtx, "in_sample_rate", codecCtx->sample_rate, 0);
-    av_opt_set_sample_fmt(swrCtx, "in_sample_fmt", codecCtx->sample_fmt, 0);
-
-    av_opt_set_chlayout(swrCtx, "out_chlayout", &outLayout, 0);
-    av_opt_set_int(swrCtx, "out_sample_rate", outRate, 0);
-    av_opt_set_sample_fmt(swrCtx, "out_sample_fmt", outputSampleFormat, 0);
+    resolveOutputFormat(codecCtx->sample_fmt);
 
-    if (swr_init(swrCtx) < 0) {
+    swrCtx = swrCache.acquire(&inLayout, codecCtx->sample_rate, codecCtx->sample_fmt,
+                              &outLayout, outRate, outputSampleFormat);
+    if (!swrCtx) {
         LOGE("SwrInit Failed");
         if (mCallback) mCallback->onError(-6, "Resampler init failed");
         return -1;
     }
+    mStats.set(PlayerStats::COUNTER_SWR_REBUILDS, swrCache.getRebuildCount());
     return 0;
 }
 
 void FFPlayer::play() {
     if (mState == STATE_PREPARED || mState == STATE_PAUSED || mState == STATE_COMPLETED) {
+        mStartup.mark(StartupProfile::MILESTONE_PLAY);
         {
             std::lock_guard<std::mutex> lock(mStateMutex);
             mState = STATE_PLAYING;
         }
+        mAudioDelivered.store(false);
         if (!readThread) readThread = new std::thread(&FFPlayer::readLoop, this);
         if (!decodeThread) decodeThread = new std::thread(&FFPlayer::decodingLoop, this);
         stateCond.notify_all();
@@ -275,6 +311,9 @@ void FFPlayer::stop() {
         delete decodeThread;
         decodeThread = nullptr;
     }
+    // 线程已退出，队列中的数据不会再被消费，立即归还预算
+    audioQueue.flush();
+    updateQueueStats();
 }
 
 void FFPlayer::release() {
@@ -296,8 +335,16 @@ void FFPlayer::seek(long ms) {
 
     if (mState != STATE_IDLE && mState != STATE_ERROR && mState != STATE_STOPPED) {
         std::lock_guard<std::mutex> lock(mSeekMutex);
-        mSeekTargetMs = targetAbsoluteMs;
-        mIsSeeking.store(true);
+        mSeekRequestUs.store(av_gettime_relative());
+        mAudioDelivered.store(false);
+        // 目标仍在 PCM 缓存内 (且没有待处理的常规 Seek) 时直接重放，不动解复用器和解码器
+        if (!mIsSeeking.load() && !mFlushCodec.load() && mPcmRing.contains(targetAbsoluteMs)) {
+            mReplayTargetMs.store(targetAbsoluteMs);
+        } else {
+            mReplayTargetMs.store(-1);
+            mSeekTargetMs = targetAbsoluteMs;
+            mIsSeeking.store(true);
+        }
         stateCond.notify_all();
     }
 }
@@ -307,10 +354,12 @@ void FFPlayer::seek(long ms) {
 // 包含 Seek 修复、智能 EOF、贪婪缓存
 // ---------------------------------------------------------------------
 void FFPlayer::readLoop() {
+    qy_set_thread_name("readThread");
     AVPacket *packet = av_packet_alloc();
     int consecutiveErrors = 0;
     const int MAX_ERRORS = 10;
     long lastReadPosMs = 0;
+    bool rangeEnded = false; // 已读到播放区间终点
 
     // 起始位置跳转
     if (mStartTimeMs > 0) {
@@ -323,6 +372,7 @@ void FFPlayer::readLoop() {
         LOGD("mStartTimeMs %ld avformat_seek_file targetPts %ld", mStartTimeMs, targetPts);
         avformat_seek_file(fmtCtx, audioStreamIndex, minPts, targetPts, maxPts, 0);
     }
+    mStartup.mark(StartupProfile::MILESTONE_OUTPUT_STARTED);
 
     while (!mIsExit.load()) {
         // --- 1. Seek 处理 ---
@@ -338,7 +388,9 @@ void FFPlayer::readLoop() {
             }
 
             if (targetMs >= 0) {
+                QY_TRACE_SCOPE("seek");
                 mIsEOF.store(false);
+                rangeEnded = false;
                 consecutiveErrors = 0;
 
                 // IO 复位：防止因中断导致的 Error 状态残留
@@ -349,7 +401,13 @@ void FFPlayer::readLoop() {
                 }
 
                 audioQueue.flush();
-                mFlushCodec.store(true);
+                updateQueueStats();
+                {
+                    // 解码线程可能停在播放完成后的等待中，需在锁内置位并唤醒
+                    std::lock_guard<std::mutex> lock(mStateMutex);
+                    mFlushCodec.store(true);
+                }
+                stateCond.notify_all();
 
                 int64_t targetPts = av_rescale(targetMs, timeBase->den, timeBase->num * 1000LL);
                 int64_t minPts =
@@ -375,16 +433,30 @@ void FFPlayer::readLoop() {
             continue; // Seek 完立即开始下载
         }
 
+        // 区间之外的数据不再读取，与真实 EOF 一样等待 Seek 或退出；
+        // 否则读线程会不断清掉解码线程置上的 EOF，区间结束时被误判为欠载
+        if (rangeEnded) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            continue;
+        }
+
         // --- 2. 缓存控制 ---
         // 移除了 STATE_PAUSED 的检查，实现“暂停时继续下载”
-        if (audioQueue.getSize() > MAX_QUEUE_SIZE) {
+        // 超出全局内存预算时只保留起播阈值的数据量，保证仍能起播/走出缓冲
+        int64_t queueBytes = audioQueue.getSize();
+        if (queueBytes > std::max<int64_t>(MemoryBudget::getPacketQueueLimit(), minStartThresholdBytes) ||
+            (queueBytes > minStartThresholdBytes && MemoryBudget::isOverLimit())) {
             std::this_thread::sleep_for(std::chrono::milliseconds(20));
             continue;
         }
 
         // --- 3. 读取 Packet ---
         if (!packet) packet = av_packet_alloc();
+        int64_t readStart = av_gettime_relative();
+        QY_TRACE_BEGIN("readPacket");
         int ret = av_read_frame(fmtCtx, packet);
+        QY_TRACE_END();
+        mStats.record(PlayerStats::HIST_READ, av_gettime_relative() - readStart);
 
         if (ret < 0) {
             if (mIsExit.load()) break;
@@ -436,9 +508,17 @@ void FFPlayer::readLoop() {
             if (packet->pts != AV_NOPTS_VALUE) {
                 long ptsMs = (long) (packet->pts * av_q2d(*timeBase) * 1000);
                 if (ptsMs > lastReadPosMs) lastReadPosMs = ptsMs;
+                if (mEndTimeMs > 0 && ptsMs >= mEndTimeMs) {
+                    av_packet_unref(packet);
+                    rangeEnded = true;
+                    mIsEOF.store(true);
+                    continue;
+                }
             }
 
             mIsEOF.store(false);
+            mStats.add(PlayerStats::COUNTER_READ_PACKETS);
+            mStats.add(PlayerStats::COUNTER_READ_BYTES, packet->size);
             AVPacket *pktToQueue = av_packet_alloc();
             av_packet_move_ref(pktToQueue, packet);
 
@@ -446,6 +526,7 @@ void FFPlayer::readLoop() {
                 av_packet_free(&pktToQueue);
                 break;
             }
+            updateQueueStats();
         } else {
             av_packet_unref(packet);
         }
@@ -458,6 +539,7 @@ void FFPlayer::readLoop() {
 // 包含水位线控制、缓冲转圈逻辑
 // ---------------------------------------------------------------------
 void FFPlayer::decodingLoop() {
+    qy_set_thread_name("decodeThread");
     AVPacket *packet = av_packet_alloc();
     AVFrame *frame = av_frame_alloc();
     bool isDraining = false;
@@ -465,13 +547,32 @@ void FFPlayer::decodingLoop() {
     while (!mIsExit.load()) {
         if (mState == STATE_STOPPED) break;
 
+        // 0. 播放完成后的 Seek (解码器 flush 或 PCM 缓存回放)：恢复为播放状态，
+        //    否则再次到达结尾时不会回调 onComplete
+        if (mState == STATE_COMPLETED && (mFlushCodec.load() || mReplayTargetMs.load() >= 0)) {
+            std::lock_guard<std::mutex> lock(mStateMutex);
+            if (mState == STATE_COMPLETED) mState = STATE_PLAYING;
+        }
+
         // 1. Seek Flush
         if (mFlushCodec.load()) {
+            QY_TRACE_SCOPE("flushCodec");
             if (codecCtx) avcodec_flush_buffers(codecCtx);
+            // 丢弃 Seek 前残留在重采样器中的样本
+            swrCache.reset(swrCtx);
+            mPcmRingNeedsBase = true;
+            mMissSeekStartUs = mSeekRequestUs.exchange(0);
             mFlushCodec.store(false);
             isDraining = false;
         }
 
+        // 1.1 命中 PCM 缓存的 Seek
+        long replayMs = mReplayTargetMs.exchange(-1);
+        if (replayMs >= 0) {
+            replayFromPcmCache(replayMs);
+            continue;
+        }
+
         // 2. 暂停逻辑 (用户主动)
         if (mState == STATE_PAUSED) {
             std::unique_lock<std::mutex> lock(mStateMutex);
@@ -490,6 +591,12 @@ void FFPlayer::decodingLoop() {
         if (qSize == 0 && !isEOF && !isDraining) {
             if (mState != STATE_BUFFERING) {
                 std::lock_guard<std::mutex> lock(mStateMutex);
+                // 播放中耗尽记为欠载：起播或 Seek 后尚未送出音频时不算 (含已清队列但解码线程尚未 flush 的 Seek)
+                if (mState == STATE_PLAYING && mAudioDelivered.load() && mMissSeekStartUs == 0 &&
+                    mSeekRequestUs.load() == 0) {
+                    mStats.add(PlayerStats::COUNTER_UNDERRUNS);
+                }
+                mBufferingStartUs = av_gettime_relative();
                 mState = STATE_BUFFERING;
                 LOGD("Buffering start...");
                 if (mCallback) mCallback->onBuffering(true);
@@ -503,6 +610,7 @@ void FFPlayer::decodingLoop() {
             if (qSize > minStartThresholdBytes || isEOF) {
                 std::lock_guard<std::mutex> lock(mStateMutex);
                 mState = STATE_PLAYING;
+                mStats.record(PlayerStats::HIST_BUFFERING, av_gettime_relative() - mBufferingStartUs);
                 LOGD("Buffering end. Resuming playback.");
                 if (mCallback) mCallback->onBuffering(false);
             } else {
@@ -514,6 +622,10 @@ void FFPlayer::decodingLoop() {
 
         // 4. 获取数据
         int ret = audioQueue.get(packet, false); // 非阻塞
+        if (ret > 0) {
+            updateQueueStats();
+            mStartup.mark(StartupProfile::MILESTONE_BUFFERED);
+        }
 
         if (ret == 0) {
             if (isEOF) {
@@ -545,7 +657,8 @@ void FFPlayer::decodingLoop() {
                 // 等待 Seek 或 Stop
                 std::unique_lock<std::mutex> lock(mStateMutex);
                 stateCond.wait(lock, [this] {
-                    return mIsExit.load() || mIsSeeking.load() || mState == STATE_STOPPED;
+                    return mIsExit.load() || mIsSeeking.load() || mFlushCodec.load() ||
+                           mReplayTargetMs.load() >= 0 || mState == STATE_STOPPED;
                 });
             } else if (rxRet >= 0) {
                 // 播放残余
@@ -581,22 +694,60 @@ void FFPlayer::decodingLoop() {
 void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
     if (!codecCtx || !frame) return;
 
+    // 本包的解码耗时 (send + 各次 receive，不含转换与回调)
+    int64_t packetDecodeUs = 0;
+
     // 1. Send Packet
     if (packet) {
+        int64_t sendStart = av_gettime_relative();
+        if (mFirstPacketUs == 0) mFirstPacketUs = sendStart;
+        QY_TRACE_BEGIN("sendPacket");
         int ret = avcodec_send_packet(codecCtx, packet);
+        QY_TRACE_END();
+        packetDecodeUs += av_gettime_relative() - sendStart;
         if (ret < 0) {
-            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) LOGE("Send packet error");
+            mDecodeTimeUs += packetDecodeUs;
+            if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF) {
+                LOGE("Send packet error");
+                mStats.add(PlayerStats::COUNTER_DECODE_ERRORS);
+            }
             return;
         }
     }
 
     // 2. Receive Frames
     while (true) {
+        int64_t receiveStart = av_gettime_relative();
+        QY_TRACE_BEGIN("receiveFrame");
         int ret = avcodec_receive_frame(codecCtx, frame);
+        QY_TRACE_END();
+        int64_t receiveEnd = av_gettime_relative();
+        packetDecodeUs += receiveEnd - receiveStart;
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) break;
-        if (ret < 0) break;
+        if (ret < 0) {
+            mStats.add(PlayerStats::COUNTER_DECODE_ERRORS);
+            break;
+        }
 
         if (frame->nb_samples <= 0) continue;
+        mStartup.mark(StartupProfile::MILESTONE_FIRST_DECODE);
+
+        // PCM 缓存的起始位置取 Flush 后首帧的时间戳
+        if (mPcmRingNeedsBase) {
+            int64_t ts = frame->best_effort_timestamp;
+            long baseMs = ts != AV_NOPTS_VALUE ? (long) (ts * av_q2d(*timeBase) * 1000)
+                                               : mCurrentPositionMs.load();
+            mPcmRing.reset(baseMs);
+            mPcmRingNeedsBase = false;
+        }
+
+        // RTF 统计
+        if (mFirstFrameLatencyUs < 0 && mFirstPacketUs > 0) {
+            mFirstFrameLatencyUs = receiveEnd - mFirstPacketUs;
+        }
+        if (frame->sample_rate > 0) {
+            mDecodedAudioUs += (int64_t) frame->nb_samples * 1000000 / frame->sample_rate;
+        }
 
         // --- [核心修复 1] 强制标准化 Frame 布局 ---
         // 很多崩溃是因为 layout.order 是 UNSPEC，导致 swr 计算矩阵失败
@@ -638,7 +789,7 @@ void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
         bool swrNeedsReinit = false;
 
         // 比较参数
-        if (!swrCtx ||
+        if ((!swrCtx && !mPassthrough) ||
             mSwrInSampleRate != frame->sample_rate ||
             mSwrInFormat != frame->format ||
             mSwrInChannels != frame->ch_layout.nb_channels ||
@@ -652,41 +803,26 @@ void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
         }
 
         if (swrNeedsReinit) {
-            // 如果存在旧的，先释放
-            if (swrCtx) {
-                swr_free(&swrCtx);
-                swrCtx = nullptr;
-            }
-
-            swrCtx = swr_alloc();
-            if (!swrCtx) {
-                LOGE("Failed to allocate swrCtx");
-                continue;
-            }
+            // 切换前先排空旧上下文中的延迟样本，避免上一段尾部被截断
+            drainSwrContext();
 
             // --- 配置 Output ---
-            AVChannelLayout outLayout;
-            av_channel_layout_default(&outLayout, CHANNEL_OUT_STEREO);
+            // 输出布局在 prepare 时已按设备能力协商好 (AudioTrack 已按它创建)，这里不再变化
             int actualOutRate = mIsSourceDsd ? mTargetD2pSampleRate
                                              : frame->sample_rate; // 使用 frame 的 rate
 
-            av_opt_set_chlayout(swrCtx, "out_chlayout", &outLayout, 0);
-            av_opt_set_int(swrCtx, "out_sample_rate", actualOutRate, 0);
-            av_opt_set_sample_fmt(swrCtx, "out_sample_fmt", outputSampleFormat, 0);
-
-            // --- 配置 Input (完全基于当前 Frame) ---
-            // 这一点至关重要：告诉 Swr 实际进来的数据到底是什么
-            av_opt_set_chlayout(swrCtx, "in_chlayout", &frame->ch_layout, 0);
-            av_opt_set_int(swrCtx, "in_sample_rate", frame->sample_rate, 0);
-            av_opt_set_sample_fmt(swrCtx, "in_sample_fmt", (AVSampleFormat) frame->format, 0);
-
-            // 显式设置声道数，防止 rematrix 混淆
-            av_opt_set_int(swrCtx, "ich", frame->ch_layout.nb_channels, 0);
-
-            if (swr_init(swrCtx) < 0) {
-                LOGE("Failed to swr_init");
-                swr_free(&swrCtx);
-                continue;
+            mPassthrough = canPassthrough(frame, actualOutRate);
+            if (!mPassthrough) {
+                // --- 配置 Input (完全基于当前 Frame) ---
+                // 这一点至关重要：告诉 Swr 实际进来的数据到底是什么
+                // 参数组合之前出现过时直接复用缓存中的上下文，不再重建滤波器组
+                swrCtx = swrCache.acquire(&frame->ch_layout, frame->sample_rate,
+                                          (AVSampleFormat) frame->format,
+                                          &mOutLayout, actualOutRate, outputSampleFormat);
+                if (!swrCtx) {
+                    LOGE("Failed to acquire swrCtx");
+                    continue;
+                }
             }
 
             // 更新缓存状态
@@ -698,8 +834,23 @@ void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
             av_channel_layout_uninit(&codecCtx->ch_layout);
             av_channel_layout_copy(&codecCtx->ch_layout, &frame->ch_layout);
 
-            LOGD("Swr Re-initialized: %dHz %dch fmt%d -> %dHz Stereo",
-                 frame->sample_rate, frame->ch_layout.nb_channels, frame->format, actualOutRate);
+            LOGD("Swr switched: %dHz %dch fmt%d -> %dHz %dch%s (rebuilds=%lld, %lldus)",
+                 frame->sample_rate, frame->ch_layout.nb_channels, frame->format, actualOutRate,
+                 mOutChannels, mPassthrough ? " passthrough" : "",
+                 (long long) swrCache.getRebuildCount(), (long long) swrCache.getRebuildTimeUs());
+            mStats.set(PlayerStats::COUNTER_SWR_REBUILDS, swrCache.getRebuildCount());
+        }
+
+        // --- 直通：格式/布局/采样率均一致，直接拷贝 ---
+        if (mPassthrough) {
+            int samples = frame->nb_samples * mOutChannels;
+            ensureBufferCapacity(samples * av_get_bytes_per_sample(outputSampleFormat));
+            if (outBuffer.empty()) continue;
+            int64_t cpuStart = threadCpuTimeNs();
+            memcpy(outBuffer.data(), frame->data[0],
+                   samples * av_get_bytes_per_sample(outputSampleFormat));
+            deliverPcm(outBuffer.data(), samples, cpuStart);
+            continue;
         }
 
         // --- 执行转换 ---
@@ -715,7 +866,7 @@ void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
 
             if (out_samples > 0) {
                 int outSampleSize = av_get_bytes_per_sample(outputSampleFormat);
-                int outChannels = 2; // Stereo
+                int outChannels = mOutChannels;
                 int requiredBufferSize = out_samples * outSampleSize * outChannels;
 
                 ensureBufferCapacity(requiredBufferSize);
@@ -725,20 +876,134 @@ void FFPlayer::handlePcmAudioPacket(AVPacket *packet, AVFrame *frame) {
                 uint8_t *outData[2] = {rawBuffer, nullptr};
                 const uint8_t **inData = (const uint8_t **) frame->extended_data;
 
+                int64_t cpuStart = threadCpuTimeNs();
                 // 转换
+                QY_TRACE_BEGIN("swr");
                 int convertedSamples = swr_convert(swrCtx,
                                                    outData,
                                                    out_samples,
                                                    inData,
                                                    frame->nb_samples);
+                QY_TRACE_END();
 
                 if (convertedSamples > 0) {
-                    int size = convertedSamples * outSampleSize * outChannels;
-                    if (mCallback) mCallback->onAudioData(rawBuffer, size);
+                    deliverPcm(rawBuffer, convertedSamples * outChannels, cpuStart);
                 }
             }
         }
     }
+    mDecodeTimeUs += packetDecodeUs;
+    mStats.record(PlayerStats::HIST_DECODE, packetDecodeUs);
+}
+
+// 参数切换前调用：把旧 SwrContext 中缓存的尾部样本输出，之后该上下文回到缓存等待复用
+void FFPlayer::drainSwrContext() {
+    if (!swrCtx) return;
+    int pending = swr_get_out_samples(swrCtx, 0);
+    if (pending > 0) {
+        int outSampleSize = av_get_bytes_per_sample(outputSampleFormat);
+        int outChannels = mOutChannels;
+        ensureBufferCapacity(pending * outSampleSize * outChannels);
+        uint8_t *outData[2] = {outBuffer.data(), nullptr};
+        int64_t cpuStart = threadCpuTimeNs();
+        int flushed = swr_convert(swrCtx, outData, pending, nullptr, 0);
+        if (flushed > 0) {
+            deliverPcm(outBuffer.data(), flushed * outChannels, cpuStart);
+        }
+    }
+    swrCtx = nullptr;
+}
+
+// Swr 输出 -> 最终编码并回调；S24 packed 由 S32 原地压缩得到
+void FFPlayer::deliverPcm(uint8_t *data, int samples, int64_t cpuStartNs) {
+    int size;
+    if (mResolvedEncoding == PCM_ENCODING_24BIT_PACKED) {
+        size = PcmUtils::packS32ToS24(reinterpret_cast<const int32_t *>(data), data, samples);
+    } else {
+        size = samples * av_get_bytes_per_sample(outputSampleFormat);
+    }
+    mStats.add(PlayerStats::COUNTER_PCM_CONVERT_CPU_NS, threadCpuTimeNs() - cpuStartNs);
+    mStats.add(PlayerStats::COUNTER_PCM_OUTPUT_BYTES, size);
+    mStats.add(PlayerStats::COUNTER_PCM_OUTPUT_FRAMES, samples / mOutChannels);
+
+    recordMissSeek();
+    mAudioDelivered.store(true);
+    mPcmRing.write(data, size);
+    emitAudioData(data, size);
+}
+
+/**
+ * 从 PCM 缓存重放 [targetMs, 缓存末尾)，之后解码线程从原位置继续，缓存与解码输出保持连续
+ * 目标在重放前已被覆盖时退回常规 Seek
+ */
+void FFPlayer::replayFromPcmCache(long targetMs) {
+    int64_t cursor = mPcmRing.msToFrame(targetMs);
+    bool first = true;
+
+    while (!mIsExit.load() && mState != STATE_STOPPED) {
+        // 新的 Seek 请求优先
+        if (mIsSeeking.load() || mReplayTargetMs.load() >= 0) return;
+
+        if (mState == STATE_PAUSED) {
+            std::unique_lock<std::mutex> lock(mStateMutex);
+            stateCond.wait(lock, [this] {
+                return mState != STATE_PAUSED || mIsExit.load() || mIsSeeking.load() ||
+                       mReplayTargetMs.load() >= 0;
+            });
+            continue;
+        }
+
+        int size = mPcmRing.read(cursor, outBuffer.data(), (int) outBuffer.size());
+        if (size <= 0) break;
+
+        if (first) {
+            first = false;
+            int64_t requestUs = mSeekRequestUs.exchange(0);
+            if (requestUs > 0) {
+                int64_t latencyUs = av_gettime_relative() - requestUs;
+                mStats.add(PlayerStats::COUNTER_SEEK_CACHE_HITS);
+                mStats.add(PlayerStats::COUNTER_SEEK_HIT_US, latencyUs);
+                mStats.record(PlayerStats::HIST_SEEK, latencyUs);
+            }
+        }
+
+        mCurrentPositionMs.store((long) mPcmRing.frameToMs(cursor));
+        if (mState == STATE_PLAYING) updateProgress();
+        mAudioDelivered.store(true);
+        emitAudioData(outBuffer.data(), size);
+    }
+
+    if (first && !mIsExit.load()) {
+        LOGD("PCM cache evicted before replay, fallback to seek %ld", targetMs);
+        std::lock_guard<std::mutex> lock(mSeekMutex);
+        mSeekTargetMs = targetMs;
+        mIsSeeking.store(true);
+    }
+}
+
+// 常规 Seek 的延迟：请求到 Flush 后首批数据送出
+void FFPlayer::recordMissSeek() {
+    if (mMissSeekStartUs <= 0) return;
+    int64_t latencyUs = av_gettime_relative() - mMissSeekStartUs;
+    mStats.add(PlayerStats::COUNTER_SEEK_CACHE_MISSES);
+    mStats.add(PlayerStats::COUNTER_SEEK_MISS_US, latencyUs);
+    mStats.record(PlayerStats::HIST_SEEK, latencyUs);
+    mMissSeekStartUs = 0;
+}
+
+// 按最终输出格式分配 PCM 缓存 (DSD Native/DoP 不经过 PCM 路径，不缓存)
+void FFPlayer::configurePcmCache() {
+    bool pcmPath = !mIsSourceDsd || mDsdMode == DSD_MODE_D2P;
+    int bytesPerSample = mResolvedEncoding == PCM_ENCODING_16BIT ? 2 :
+                         mResolvedEncoding == PCM_ENCODING_24BIT_PACKED ? 3 : 4;
+    // 上限 8MB (192kHz/2ch/32bit 时约 5 秒，8ch 时约 1.3 秒)，并且不超过全局内存预算余量的一半，
+    // 给同时存在的其它会话与 PacketQueue 留出空间
+    mMemory.set(MemoryAccount::POOL_PCM_CACHE, 0);
+    int64_t maxBytes = std::min<int64_t>(8 * 1024 * 1024, MemoryBudget::getHeadroom() / 2);
+    mPcmRing.configure(mSampleRate, bytesPerSample * mOutChannels,
+                       pcmPath ? mPcmCacheSeconds : 0, (size_t) maxBytes);
+    mMemory.set(MemoryAccount::POOL_PCM_CACHE, (int64_t) mPcmRing.getCapacityBytes());
+    mPcmRingNeedsBase = true;
 }
 
 void FFPlayer::handleDsdAudioPacket(AVPacket *packet, AVFrame *frame) {
@@ -749,6 +1014,8 @@ void FFPlayer::handleDsdAudioPacket(AVPacket *packet, AVFrame *frame) {
     ensureBufferCapacity(packet->size * 2);
     int outputSize = 0;
     uint8_t *rawBuffer = outBuffer.data();
+    int64_t packStart = av_gettime_relative();
+    QY_TRACE_BEGIN("dsdPack");
 
     if (mDsdMode == DSD_MODE_NATIVE) {
         if (is4ChannelSupported) {
@@ -761,14 +1028,28 @@ void FFPlayer::handleDsdAudioPacket(AVPacket *packet, AVFrame *frame) {
         outputSize = DsdUtils::packDoP(isMsbf, packet->data, packet->size, rawBuffer);
     }
 
+    QY_TRACE_END();
+    mStats.record(PlayerStats::HIST_DECODE, av_gettime_relative() - packStart);
+    mStartup.mark(StartupProfile::MILESTONE_FIRST_DECODE);
+
     if (outputSize > 0) {
         if (outputSize > outBuffer.size()) outputSize = outBuffer.size();
-        if (mCallback) {
-            mCallback->onAudioData(rawBuffer, outputSize);
-        }
+        // DSD 直通没有 PCM 缓存，Seek 延迟取 Flush 后首包送出
+        recordMissSeek();
+        mAudioDelivered.store(true);
+        emitAudioData(rawBuffer, outputSize);
     }
 }
 
+// PacketQueue 的计数本身是原子的，这里只是搬到统计块
+void FFPlayer::updateQueueStats() {
+    int bytes = audioQueue.getSize();
+    mStats.set(PlayerStats::COUNTER_QUEUE_PACKETS, audioQueue.getPacketCount());
+    mStats.set(PlayerStats::COUNTER_QUEUE_BYTES, bytes);
+    mStats.setMax(PlayerStats::COUNTER_QUEUE_PEAK_BYTES, bytes);
+    mMemory.set(MemoryAccount::POOL_PACKET_QUEUE, bytes);
+}
+
 void FFPlayer::updateProgress() {
     long cur = mCurrentPositionMs.load();
     long relativePosition = cur - mStartTimeMs;
@@ -789,7 +1070,9 @@ void FFPlayer::extractAudioInfo() {
     if (fmtCtx && fmtCtx->duration != AV_NOPTS_VALUE) {
         mDurationMs = (long) (fmtCtx->duration / (double) AV_TIME_BASE * 1000);
     }
-    mChannelCount = codecCtx->ch_layout.nb_channels;
+    // PCM 输出为协商后的布局；DSD Native/DoP 保持源声道数
+    mChannelCount = (!mIsSourceDsd || mDsdMode == DSD_MODE_D2P) ? mOutChannels
+                                                                : codecCtx->ch_layout.nb_channels;
 
     if (mIsSourceDsd) {
         switch (mDsdMode) {
@@ -799,7 +1082,8 @@ void FFPlayer::extractAudioInfo() {
                 break;
             case DSD_MODE_D2P:
                 mSampleRate = mTargetD2pSampleRate;
-                mBitPerSample = 16;
+                mBitPerSample = mResolvedEncoding == PCM_ENCODING_16BIT ? 16 :
+                                mResolvedEncoding == PCM_ENCODING_24BIT_PACKED ? 24 : 32;
                 break;
             case DSD_MODE_DOP:
                 mSampleRate = codecCtx->sample_rate / 2;
@@ -808,7 +1092,8 @@ void FFPlayer::extractAudioInfo() {
         }
     } else {
         mSampleRate = codecCtx->sample_rate;
-        mBitPerSample = outputSampleFormat == AV_SAMPLE_FMT_S32 ? 32 : 16;
+        mBitPerSample = mResolvedEncoding == PCM_ENCODING_16BIT ? 16 :
+                        mResolvedEncoding == PCM_ENCODING_24BIT_PACKED ? 24 : 32;
     }
 
     int64_t bitRate = 0;
@@ -835,20 +1120,38 @@ void FFPlayer::extractAudioInfo() {
     }
     LOGD("Buffering Config: BitRate=%ld, Target 3s=%d, Final Threshold=%d",
          bitRate, targetBytes, minStartThresholdBytes);
+
+    configurePcmCache();
 }
 
 void FFPlayer::releaseFFmpeg() {
-    if (swrCtx) {
-        swr_free(&swrCtx);
-        swrCtx = nullptr;
+    // 至少解码 1s 音频才上报，避免起播即停止的会话干扰策略
+    if (codecCtx && mDecodedAudioUs >= 1000000) {
+        DecoderThreadPolicy::report(codecCtx->codec_id, mDecoderThreaded, getDecodeRtf(),
+                                    mFirstFrameLatencyUs);
     }
+    mPcmRing.configure(0, 0, 0, 0);
+    mMemory.set(MemoryAccount::POOL_PCM_CACHE, 0);
+    mReplayTargetMs.store(-1);
+    mSeekRequestUs.store(0);
+    mMissSeekStartUs = 0;
+    mAudioDelivered.store(false);
+    mDecodeTimeUs = 0;
+    mDecodedAudioUs = 0;
+    mFirstPacketUs = 0;
+    mFirstFrameLatencyUs = -1;
+    swrCtx = nullptr;
+    swrCache.clear();
+    mPassthrough = false;
+    mSwrInSampleRate = 0;
+    mSwrInFormat = -1;
+    mSwrInChannels = 0;
     if (codecCtx) {
         avcodec_free_context(&codecCtx);
         codecCtx = nullptr;
     }
     if (fmtCtx) {
-        avformat_close_input(&fmtCtx);
-        fmtCtx = nullptr;
+        DemuxerHandoff::close(&fmtCtx);
     }
 }
 
@@ -857,6 +1160,7 @@ void FFPlayer::ensureBufferCapacity(size_t requiredSize) {
     if (safeSize > outBuffer.size()) {
         size_t newSize = std::max(safeSize, outBuffer.size() * 3 / 2);
         outBuffer.resize(newSize);
+        mMemory.set(MemoryAccount::POOL_OUTPUT_BUFFER, (int64_t) outBuffer.size());
     }
 }
 
@@ -882,8 +1186,29 @@ int FFPlayer::getBitPerSample() const { return mBitPerSample; }
 
 bool FFPlayer::isDsd() const { return mIsSourceDsd; }
 
+double FFPlayer::getDecodeRtf() const {
+    if (mDecodedAudioUs <= 0) return -1;
+    return (double) mDecodeTimeUs / (double) mDecodedAudioUs;
+}
+
+void FFPlayer::setPcmCacheSeconds(int seconds) { mPcmCacheSeconds = seconds; }
+
+int64_t FFPlayer::getSeekCacheHits() const { return mStats.get(PlayerStats::COUNTER_SEEK_CACHE_HITS); }
+
+int64_t FFPlayer::getSeekCacheMisses() const { return mStats.get(PlayerStats::COUNTER_SEEK_CACHE_MISSES); }
+
+int64_t FFPlayer::getSeekHitLatencyUs() const { return mStats.get(PlayerStats::COUNTER_SEEK_HIT_US); }
+
+int64_t FFPlayer::getSeekMissLatencyUs() const { return mStats.get(PlayerStats::COUNTER_SEEK_MISS_US); }
+
+PcmEncoding FFPlayer::getOutputEncoding() const { return mResolvedEncoding; }
+
 bool FFPlayer::isExit() const { return mIsExit.load(); }
 
+int64_t FFPlayer::getSwrRebuildCount() const { return swrCache.getRebuildCount(); }
+
+int64_t FFPlayer::getSwrRebuildTimeUs() const { return swrCache.getRebuildTimeUs(); }
+
 bool FFPlayer::isDsdCodec(AVCodecID id) {
     return id == AV_CODEC_ID_DSD_LSBF || id == AV_CODEC_ID_DSD_MSBF ||
            id == AV_CODEC_ID_DSD_LSBF_PLANAR || id == AV_CODEC_ID_DSD_MSBF_PLANAR;
@@ -893,6 +1218,76 @@ bool FFPlayer::isMsbfCodec(AVCodecID id) {
     return id == AV_CODEC_ID_DSD_MSBF || id == AV_CODEC_ID_DSD_MSBF_PLANAR;
 }
 
+/**
+ * 按设备能力协商输出声道布局 (Stereo / Quad / 5.1 / 7.1，与 AudioTrack 声道掩码对应)
+ * 源声道数在设备能力范围内且布局可直接映射时原样输出，避免逐帧 rematrix；
+ * 否则选择不超过设备能力的最大布局，由 Swr 下混
+ */
+void FFPlayer::negotiateOutputLayout(const AVChannelLayout *inLayout) {
+    static const AVChannelLayout kQuad = AV_CHANNEL_LAYOUT_QUAD;
+    static const AVChannelLayout k51 = AV_CHANNEL_LAYOUT_5POINT1_BACK;
+    static const AVChannelLayout k51Side = AV_CHANNEL_LAYOUT_5POINT1;
+    static const AVChannelLayout k71 = AV_CHANNEL_LAYOUT_7POINT1;
+
+    int maxChannels = mMaxOutputChannels > 0 ? mMaxOutputChannels
+                                             : SystemProperties::getMaxOutputChannels();
+    int inChannels = inLayout->nb_channels;
+    AVChannelLayout target = AV_CHANNEL_LAYOUT_STEREO;
+
+    if (inChannels >= 8 && maxChannels >= 8) {
+        target = k71;
+    } else if (inChannels >= 6 && maxChannels >= 6) {
+        target = k51;
+    } else if (inChannels >= 4 && maxChannels >= 4) {
+        target = kQuad;
+    }
+
+    // 5.1(side) 在 Android 上按 5.1 输出，声道顺序一致，无需 rematrix
+    if (av_channel_layout_compare(inLayout, &target) == 0 ||
+        (target.nb_channels == 6 && av_channel_layout_compare(inLayout, &k51Side) == 0)) {
+        av_channel_layout_copy(&mOutLayout, inLayout);
+    } else {
+        av_channel_layout_copy(&mOutLayout, &target);
+    }
+    mOutChannels = mOutLayout.nb_channels;
+    LOGD("Output layout: %dch -> %dch (device max %d)", inChannels, mOutChannels, maxChannels);
+}
+
+bool FFPlayer::canPassthrough(const AVFrame *frame, int outRate) const {
+    return frame->format == outputSampleFormat &&
+           frame->sample_rate == outRate &&
+           av_channel_layout_compare(&frame->ch_layout, &mOutLayout) == 0;
+}
+
+// 根据用户配置决定 Swr 输出格式；AUTO 保持原有行为 (DSD 转 PCM 固定 16bit)
+void FFPlayer::resolveOutputFormat(AVSampleFormat inputFormat) {
+    switch (mOutputEncoding) {
+        case PCM_ENCODING_16BIT:
+            outputSampleFormat = AV_SAMPLE_FMT_S16;
+            break;
+        case PCM_ENCODING_24BIT_PACKED:
+        case PCM_ENCODING_32BIT:
+            // 24bit packed 没有对应的 AVSampleFormat，先出 S32 再压缩
+            outputSampleFormat = AV_SAMPLE_FMT_S32;
+            break;
+        case PCM_ENCODING_FLOAT:
+            outputSampleFormat = AV_SAMPLE_FMT_FLT;
+            break;
+        case PCM_ENCODING_AUTO:
+        default:
+            outputSampleFormat = mIsSourceDsd ? AV_SAMPLE_FMT_S16
+                                              : getOutputSampleFormat(inputFormat);
+            break;
+    }
+
+    if (mOutputEncoding == PCM_ENCODING_AUTO) {
+        mResolvedEncoding = outputSampleFormat == AV_SAMPLE_FMT_S32 ? PCM_ENCODING_32BIT
+                                                                    : PCM_ENCODING_16BIT;
+    } else {
+        mResolvedEncoding = mOutputEncoding;
+    }
+}
+
 AVSampleFormat FFPlayer::getOutputSampleFormat(AVSampleFormat inputFormat) {
     return (inputFormat == AV_SAMPLE_FMT_S32 || inputFormat == AV_SAMPLE_FMT_S32P ||
             inputFormat == AV_SAMPLE_FMT_FLT || inputFormat == AV_SAMPLE_FMT_FLTP ||
@@ -12,6 +12,11 @@
 #include <map>
 #include "SystemProperties.h" // 假设你有这个
 #include "DsdUtils.h"         // 假设你有这个
+#include "SwrContextCache.h"
+#include "PcmUtils.h"
+#include "DecoderThreadPolicy.h"
+#include "PcmRingCache.h"
+#include "DemuxerHandoff.h"
 
 extern "C" {
 #include <libavformat/avformat.h>
@@ -83,14 +88,13 @@ public:
         }
     }
 
-    int getPacketCount() {
-        std::lock_guard<std::mutex> lock(mutex);
-        return nb_packets;
+    // 计数为原子量，读取不加锁 (统计轮询与缓冲水位检查都很频繁)
+    int getPacketCount() const {
+        return nb_packets.load(std::memory_order_relaxed);
     }
 
-    int getSize() {
-        std::lock_guard<std::mutex> lock(mutex);
-        return size;
+    int getSize() const {
+        return size.load(std::memory_order_relaxed);
     }
 
 private:
@@ -98,8 +102,8 @@ private:
     std::mutex mutex;
     std::condition_variable cond;
     bool abort_request;
-    int nb_packets;
-    int size;
+    std::atomic<int> nb_packets;
+    std::atomic<int> size;
 };
 
 // === FFPlayer ===
@@ -125,8 +129,25 @@ public:
     int getChannelCount() const override;
     int getBitPerSample() const override;
     bool isDsd() const override;
+    PcmEncoding getOutputEncoding() const override;
     bool isExit() const;
 
+    // Swr 重建统计
+    int64_t getSwrRebuildCount() const;
+    int64_t getSwrRebuildTimeUs() const;
+
+    // 解码实时率 (解码耗时 / 音频时长)，未测量返回 -1
+    double getDecodeRtf() const;
+
+    // PCM 回放缓存时长 (秒，默认 3)，<= 0 关闭；需在 prepare 之前设置
+    void setPcmCacheSeconds(int seconds);
+
+    // Seek 统计：命中 PCM 缓存 / 未命中的次数与累计延迟
+    int64_t getSeekCacheHits() const;
+    int64_t getSeekCacheMisses() const;
+    int64_t getSeekHitLatencyUs() const;
+    int64_t getSeekMissLatencyUs() const;
+
 private:
     void releaseInternal();
     void initFFmpeg();
@@ -140,7 +161,16 @@ private:
 
     void handlePcmAudioPacket(AVPacket *packet, AVFrame *frame);
     void handleDsdAudioPacket(AVPacket *packet, AVFrame *frame);
+    void drainSwrContext();
+    void replayFromPcmCache(long targetMs);
+    void configurePcmCache();
+    void recordMissSeek();
+    void deliverPcm(uint8_t *data, int samples, int64_t cpuStartNs);
+    void resolveOutputFormat(AVSampleFormat inputFormat);
+    void negotiateOutputLayout(const AVChannelLayout *inLayout);
+    bool canPassthrough(const AVFrame *frame, int outRate) const;
     void updateProgress();
+    void updateQueueStats();
     void ensureBufferCapacity(size_t requiredSize);
 
     static bool isDsdCodec(AVCodecID id);
@@ -157,9 +187,31 @@ private:
     // FFmpeg context
     AVFormatContext *fmtCtx = nullptr;
     AVCodecContext *codecCtx = nullptr;
-    SwrContext *swrCtx = nullptr;
+    SwrContext *swrCtx = nullptr; // 由 swrCache 持有
+    SwrContextCache swrCache;
     AVRational *timeBase = nullptr;
-    enum AVSampleFormat outputSampleFormat = AV_SAMPLE_FMT_S16;
+    enum AVSampleFormat outputSampleFormat = AV_SAMPLE_FMT_S16; // Swr 输出格式
+    PcmEncoding mResolvedEncoding = PCM_ENCODING_16BIT;         // 最终送出的编码，每次 prepare 重新确定
+    AVChannelLayout mOutLayout = AV_CHANNEL_LAYOUT_STEREO;        // prepare 时协商，之后固定
+    int mOutChannels = CHANNEL_OUT_STEREO;
+    bool mPassthrough = false; // 输入已是目标格式，跳过 Swr
+
+    // 解码 RTF 统计
+    bool mDecoderThreaded = false;
+    int64_t mDecodeTimeUs = 0;
+    int64_t mDecodedAudioUs = 0;
+    int64_t mFirstPacketUs = 0;
+    int64_t mFirstFrameLatencyUs = -1;
+    int64_t mBufferingStartUs = 0;
+
+    // PCM 回放缓存
+    PcmRingCache mPcmRing;
+    int mPcmCacheSeconds = 3;
+    bool mPcmRingNeedsBase = true;            // Flush 后等待首帧确定起始位置
+    std::atomic<long> mReplayTargetMs{-1};    // 命中缓存的 Seek 目标
+    std::atomic<int64_t> mSeekRequestUs{0};   // 未完成 Seek 的请求时间
+    int64_t mMissSeekStartUs = 0;             // 已 Flush、等待首批数据的 Seek 请求时间
+    std::atomic<bool> mAudioDelivered{false}; // 起播 / Seek 之后已送出音频，此后的耗尽才计为欠载
 
     // Audio Params
     int audioStreamIndex = -1;
@@ -197,8 +249,7 @@ private:
     std::vector<uint8_t> outBuffer;
 
     // --- 缓存控制核心参数 ---
-    // 允许缓存 50MB (约一首无损歌曲)，实现“暂停时继续下载”
-    const int MAX_QUEUE_SIZE = 50 * 1024 * 1024;
+    // 队列上限见 MemoryBudget (默认 50MB，约一首无损歌曲)，实现“暂停时继续下载”
 
     // 起播阈值 (默认256KB，最后3s左右)。
     // 当 Seek 或缓冲耗尽后，必须积攒这么多数据才开始播放，防止频繁卡顿。
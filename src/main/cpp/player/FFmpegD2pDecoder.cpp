@@ -1,8 +1,17 @@
 #include "FFmpegD2pDecoder.h"
+#include "Trace.h"
+#include <string>
 
 #define MAX_OUTPUT_BUFFER_SIZE 1024 * 1024
 #define LOG_TAG "FFmpegD2pDecoder"
 
+// av_err2str 依赖复合字面量取址，GCC 的 C++ 前端不接受 (主机构建)
+static std::string errorString(int err) {
+    char buf[AV_ERROR_MAX_STRING_SIZE] = {0};
+    av_strerror(err, buf, sizeof(buf));
+    return buf;
+}
+
 FFmpegD2pDecoder::FFmpegD2pDecoder() : codecCtx(nullptr), swrCtx(nullptr), frame(nullptr),
                                        packet(nullptr),
                                        outFmt(AV_SAMPLE_FMT_NONE), bytesPerSample(0),
@@ -95,9 +104,11 @@ int FFmpegD2pDecoder::process(uint8_t *inData, int inSize, uint8_t *outData) {
     packet->data = inData;
     packet->size = inSize;
 
+    QY_TRACE_BEGIN("d2pDecode");
     int ret = avcodec_send_packet(codecCtx, packet);
+    QY_TRACE_END();
     if (ret < 0) {
-        LOGE("Failed to send packet: %s", av_err2str(ret));
+        LOGE("Failed to send packet: %s", errorString(ret).c_str());
         av_packet_unref(packet);
         return -1;
     }
@@ -109,7 +120,7 @@ int FFmpegD2pDecoder::process(uint8_t *inData, int inSize, uint8_t *outData) {
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
             break;
         } else if (ret < 0) {
-            LOGE("Failed to receive frame: %s", av_err2str(ret));
+            LOGE("Failed to receive frame: %s", errorString(ret).c_str());
             av_packet_unref(packet);
             return -1;
         }
@@ -130,13 +141,15 @@ int FFmpegD2pDecoder::process(uint8_t *inData, int inSize, uint8_t *outData) {
 
         uint8_t *out_buffers[2] = {outData + totalBytesWritten, nullptr};
 
+        QY_TRACE_BEGIN("d2pSwr");
         int samples = swr_convert(swrCtx, out_buffers, dsd_nb_samples,
                                   (const uint8_t **) frame->data, frame->nb_samples);
+        QY_TRACE_END();
 
         if (samples > 0) {
             totalBytesWritten += samples * 2 * bytesPerSample;
         } else if (samples < 0) {
-            LOGE("swr_convert failed: %s", av_err2str(samples));
+            LOGE("swr_convert failed: %s", errorString(samples).c_str());
             av_frame_unref(frame);
             av_packet_unref(packet);
             return -1;
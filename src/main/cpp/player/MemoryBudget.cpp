@@ -0,0 +1,80 @@
+#include "MemoryBudget.h"
+#include <stdint.h>
+
+namespace {
+    std::atomic<int64_t> gUsed{0};
+    std::atomic<int64_t> gPeak{0};
+    std::atomic<int64_t> gTotalLimit{0};
+    std::atomic<int64_t> gPacketQueueLimit{MemoryBudget::DEFAULT_PACKET_QUEUE_LIMIT};
+
+    void updateMax(std::atomic<int64_t> &target, int64_t value) {
+        int64_t current = target.load(std::memory_order_relaxed);
+        while (value > current &&
+               !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+    }
+}
+
+void MemoryBudget::setLimits(int64_t totalBytes, int64_t packetQueueBytes) {
+    gTotalLimit.store(totalBytes > 0 ? totalBytes : 0, std::memory_order_relaxed);
+    gPacketQueueLimit.store(packetQueueBytes > 0 ? packetQueueBytes : DEFAULT_PACKET_QUEUE_LIMIT,
+                            std::memory_order_relaxed);
+}
+
+int64_t MemoryBudget::getTotalLimit() {
+    return gTotalLimit.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryBudget::getPacketQueueLimit() {
+    return gPacketQueueLimit.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryBudget::getUsed() {
+    return gUsed.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryBudget::getPeak() {
+    return gPeak.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryBudget::getHeadroom() {
+    int64_t limit = getTotalLimit();
+    if (limit <= 0) return INT64_MAX;
+    int64_t headroom = limit - getUsed();
+    return headroom > 0 ? headroom : 0;
+}
+
+bool MemoryBudget::isOverLimit() {
+    int64_t limit = getTotalLimit();
+    return limit > 0 && getUsed() > limit;
+}
+
+void MemoryBudget::add(int64_t delta) {
+    int64_t used = gUsed.fetch_add(delta, std::memory_order_relaxed) + delta;
+    updateMax(gPeak, used);
+}
+
+MemoryAccount::~MemoryAccount() {
+    for (int i = 0; i < POOL_COUNT; i++) set((Pool) i, 0);
+}
+
+void MemoryAccount::set(Pool pool, int64_t bytes) {
+    int64_t delta = bytes - mPools[pool].exchange(bytes, std::memory_order_relaxed);
+    if (delta == 0) return;
+    int64_t total = mTotal.fetch_add(delta, std::memory_order_relaxed) + delta;
+    updateMax(mPeak, total);
+    MemoryBudget::add(delta);
+}
+
+int MemoryAccount::snapshot(int64_t *out, int capacity) const {
+    if (!out || capacity < SNAPSHOT_SIZE) return -1;
+    out[0] = SNAPSHOT_VERSION;
+    out[1] = mTotal.load(std::memory_order_relaxed);
+    out[2] = mPeak.load(std::memory_order_relaxed);
+    int64_t *p = out + 3;
+    for (const auto &pool: mPools) *p++ = pool.load(std::memory_order_relaxed);
+    *p++ = MemoryBudget::getUsed();
+    *p++ = MemoryBudget::getPeak();
+    *p++ = MemoryBudget::getTotalLimit();
+    *p = MemoryBudget::getPacketQueueLimit();
+    return SNAPSHOT_SIZE;
+}
@@ -0,0 +1,105 @@
+#ifndef QYPLAYER_MEMORYBUDGET_H
+#define QYPLAYER_MEMORYBUDGET_H
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * 进程内所有播放会话共享的原生内存预算
+ *
+ * 各会话通过 MemoryAccount 记账，这里汇总总量并给出上限：
+ *   - 总上限：超出后 FFPlayer 的读取线程把 PacketQueue 压到起播阈值，PCM Seek 缓存按余量缩小
+ *   - 单会话 PacketQueue 上限：默认 50MB
+ * 上限只约束可伸缩的缓存，播放必需的固定缓冲照常分配并计入总量。
+ * FFmpeg 内部 (解码器上下文、AVIOContext 等) 的分配不在统计范围内。
+ */
+class MemoryBudget {
+public:
+    static const int64_t DEFAULT_PACKET_QUEUE_LIMIT = 50LL * 1024 * 1024;
+
+    /**
+     * @param totalBytes 所有会话的总上限，<= 0 表示不限
+     * @param packetQueueBytes 单会话 PacketQueue 上限，<= 0 恢复默认值
+     */
+    static void setLimits(int64_t totalBytes, int64_t packetQueueBytes);
+
+    static int64_t getTotalLimit();
+
+    static int64_t getPacketQueueLimit();
+
+    static int64_t getUsed();
+
+    static int64_t getPeak();
+
+    /**
+     * 距总上限的余量，不限时返回 INT64_MAX，已超出时返回 0
+     */
+    static int64_t getHeadroom();
+
+    static bool isOverLimit();
+
+private:
+    friend class MemoryAccount;
+
+    static void add(int64_t delta);
+};
+
+/**
+ * 单个播放会话的内存记账，按缓冲池分项
+ *
+ * 各池只记录当前占用 (set 传入绝对值)，可在任意线程调用，不加锁。
+ * 析构时把剩余占用从全局总量中扣除。
+ * 快照为定长 int64 数组，布局：
+ *   [0] SNAPSHOT_VERSION
+ *   [1] 会话当前占用
+ *   [2] 会话峰值
+ *   [3, 3 + POOL_COUNT)  各池占用，按 Pool 顺序
+ *   其后 4 项为全局：当前占用、峰值、总上限、PacketQueue 上限
+ * 调整布局时需同步递增版本号并修改 Kotlin 侧的 MemoryUsage。
+ */
+class MemoryAccount {
+public:
+    enum Pool {
+        POOL_PACKET_QUEUE = 0,   // PacketQueue 中的压缩数据
+        POOL_PCM_CACHE,          // PcmRingCache (Seek 回放缓存)
+        POOL_OUTPUT_BUFFER,      // 输出缓冲 (FFPlayer / SacdPlayer 的 outBuffer)
+        POOL_SACD_READ,          // scarletbook_output 的扇区读取缓冲
+        POOL_DST,                // DST 解码器：buffer_pool 上界与每个解码线程的状态
+        POOL_HANDOFF,            // SacdHandoff 暂存的镜像句柄，记在其自身的账户上，播放会话中恒为 0
+        POOL_COUNT
+    };
+
+    static const int SNAPSHOT_VERSION = 2;
+    static const int SNAPSHOT_SIZE = 3 + POOL_COUNT + 4;
+
+    MemoryAccount() = default;
+
+    ~MemoryAccount();
+
+    MemoryAccount(const MemoryAccount &) = delete;
+
+    MemoryAccount &operator=(const MemoryAccount &) = delete;
+
+    void set(Pool pool, int64_t bytes);
+
+    int64_t get(Pool pool) const {
+        return mPools[pool].load(std::memory_order_relaxed);
+    }
+
+    int64_t getTotal() const {
+        return mTotal.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @param capacity out 的长度
+     * @return 写入的字段数，capacity 不足时返回 -1
+     */
+    int snapshot(int64_t *out, int capacity) const;
+
+private:
+    std::atomic<int64_t> mPools[POOL_COUNT] = {};
+    std::atomic<int64_t> mTotal{0};
+    std::atomic<int64_t> mPeak{0};
+};
+
+#endif //QYPLAYER_MEMORYBUDGET_H
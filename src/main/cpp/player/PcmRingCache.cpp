@@ -0,0 +1,98 @@
+#include "PcmRingCache.h"
+#include <string.h>
+#include <algorithm>
+
+void PcmRingCache::configure(int sampleRate, int bytesPerFrame, int seconds, size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSampleRate = sampleRate;
+    mBytesPerFrame = bytesPerFrame;
+    mStartFrame = mEndFrame = 0;
+    if (sampleRate <= 0 || bytesPerFrame <= 0 || seconds <= 0) {
+        mCapacityFrames = 0;
+        std::vector<uint8_t>().swap(mBuffer);
+        return;
+    }
+    int64_t frames = (int64_t) sampleRate * seconds;
+    frames = std::min<int64_t>(frames, (int64_t) (maxBytes / bytesPerFrame));
+    mCapacityFrames = frames;
+    mBuffer.resize((size_t) (frames * bytesPerFrame));
+}
+
+void PcmRingCache::reset(int64_t posMs) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStartFrame = mEndFrame = msToFrame(posMs);
+}
+
+bool PcmRingCache::isEmpty() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mEndFrame == mStartFrame;
+}
+
+void PcmRingCache::write(const uint8_t *data, int size) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mCapacityFrames <= 0 || size <= 0) return;
+
+    int64_t frames = size / mBytesPerFrame;
+    // 单次写入超过容量时只保留尾部
+    if (frames > mCapacityFrames) {
+        int64_t skip = frames - mCapacityFrames;
+        data += skip * mBytesPerFrame;
+        mEndFrame += skip;
+        frames = mCapacityFrames;
+    }
+
+    int64_t offset = mEndFrame % mCapacityFrames;
+    int64_t first = std::min(frames, mCapacityFrames - offset);
+    memcpy(mBuffer.data() + offset * mBytesPerFrame, data, (size_t) (first * mBytesPerFrame));
+    if (frames > first) {
+        memcpy(mBuffer.data(), data + first * mBytesPerFrame,
+               (size_t) ((frames - first) * mBytesPerFrame));
+    }
+
+    mEndFrame += frames;
+    if (mEndFrame - mStartFrame > mCapacityFrames) {
+        mStartFrame = mEndFrame - mCapacityFrames;
+    }
+}
+
+bool PcmRingCache::contains(int64_t posMs) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mCapacityFrames <= 0) return false;
+    int64_t frame = msToFrame(posMs);
+    return frame >= mStartFrame && frame < mEndFrame;
+}
+
+int PcmRingCache::read(int64_t &cursorFrame, uint8_t *dst, int maxBytes) const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mCapacityFrames <= 0) return 0;
+    if (cursorFrame < mStartFrame || cursorFrame >= mEndFrame) return 0;
+
+    int64_t frames = std::min<int64_t>(mEndFrame - cursorFrame, maxBytes / mBytesPerFrame);
+    int64_t offset = cursorFrame % mCapacityFrames;
+    int64_t first = std::min(frames, mCapacityFrames - offset);
+    memcpy(dst, mBuffer.data() + offset * mBytesPerFrame, (size_t) (first * mBytesPerFrame));
+    if (frames > first) {
+        memcpy(dst + first * mBytesPerFrame, mBuffer.data(),
+               (size_t) ((frames - first) * mBytesPerFrame));
+    }
+    cursorFrame += frames;
+    return (int) (frames * mBytesPerFrame);
+}
+
+int64_t PcmRingCache::msToFrame(int64_t ms) const {
+    return mSampleRate > 0 ? ms * mSampleRate / 1000 : 0;
+}
+
+int64_t PcmRingCache::frameToMs(int64_t frame) const {
+    return mSampleRate > 0 ? frame * 1000 / mSampleRate : 0;
+}
+
+int64_t PcmRingCache::getStartMs() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return frameToMs(mStartFrame);
+}
+
+int64_t PcmRingCache::getEndMs() const {
+    std::lock_guard<std::mutex> lock(mMutex);
+    return frameToMs(mEndFrame);
+}
@@ -0,0 +1,72 @@
+#ifndef QYPLAYER_PCMRINGCACHE_H
+#define QYPLAYER_PCMRINGCACHE_H
+
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+/**
+ * 最近解码输出的 PCM 环形缓存，按播放位置索引
+ *
+ * 缓存内容是连续的一段输出 (与送给 AudioTrack 的字节完全一致)，覆盖 [startMs, endMs)。
+ * 短距离回退/前跳落在该区间内时直接从内存重放，无需解复用器 Seek 和解码器 Flush。
+ *
+ * 写入在解码线程，查询可在任意线程，内部加锁。
+ */
+class PcmRingCache {
+public:
+    /**
+     * 按输出格式分配容量；seconds <= 0 时禁用
+     * @param maxBytes 容量上限，防止高采样率多声道时占用过大
+     */
+    void configure(int sampleRate, int bytesPerFrame, int seconds, size_t maxBytes);
+
+    /**
+     * 清空缓存，下一次写入的数据从 posMs 开始
+     */
+    void reset(int64_t posMs);
+
+    bool isEnabled() const { return !mBuffer.empty(); }
+
+    size_t getCapacityBytes() const { return mBuffer.size(); }
+
+    bool isEmpty() const;
+
+    /**
+     * 追加数据 (必须与上一次写入在时间上连续)，满时覆盖最旧的数据
+     */
+    void write(const uint8_t *data, int size);
+
+    /**
+     * posMs 是否落在已缓存区间内
+     */
+    bool contains(int64_t posMs) const;
+
+    /**
+     * 从 cursorFrame 开始读取至多 maxBytes 字节，并把 cursorFrame 推进到读取结束处
+     * 以帧为游标，避免分块重放时毫秒取整造成的重复/丢样
+     * @return 读取的字节数，到达缓存末尾或位置已被覆盖返回 0
+     */
+    int read(int64_t &cursorFrame, uint8_t *dst, int maxBytes) const;
+
+    int64_t msToFrame(int64_t ms) const;
+
+    int64_t frameToMs(int64_t frame) const;
+
+    int64_t getStartMs() const;
+
+    int64_t getEndMs() const;
+
+private:
+    mutable std::mutex mMutex;
+    std::vector<uint8_t> mBuffer;
+    int mSampleRate = 0;
+    int mBytesPerFrame = 0;
+    int64_t mCapacityFrames = 0;
+
+    // 以帧为单位的绝对位置：缓存覆盖 [mStartFrame, mEndFrame)
+    int64_t mStartFrame = 0;
+    int64_t mEndFrame = 0;
+};
+
+#endif //QYPLAYER_PCMRINGCACHE_H
@@ -14,6 +14,15 @@ enum DsdMode {
     DSD_MODE_DOP = 2     // DSD over PCM
 };
 
+// PCM 输出编码
+enum PcmEncoding {
+    PCM_ENCODING_AUTO = 0,       // 按源自动选择 (高位深 -> S32，其它 -> S16)
+    PCM_ENCODING_16BIT = 1,      // S16
+    PCM_ENCODING_24BIT_PACKED = 2, // S24_3LE，每样本 3 字节
+    PCM_ENCODING_32BIT = 3,      // S32
+    PCM_ENCODING_FLOAT = 4       // F32
+};
+
 // 播放器状态
 enum PlayerState {
     STATE_IDLE = 0,         // 初始状态，无媒体
@@ -42,6 +51,9 @@ public:
 
     virtual void onBuffering(bool buffering) = 0;
 
+    // 起播耗时剖析，每次 prepare 后在首次 onAudioData 之后回调一次，布局见 StartupProfile；默认忽略
+    virtual void onStartupProfile(const int64_t *profile, int size) {}
+
     virtual ~IPlayerCallback() {}
 };
 
@@ -0,0 +1,60 @@
+#include "PlayerStats.h"
+#include <chrono>
+
+void LatencyHistogram::record(int64_t us) {
+    if (us < 0) us = 0;
+    int bucket = 0;
+    if (us > 0) {
+        bucket = 64 - __builtin_clzll((unsigned long long) us);
+        if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+    }
+    mBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    mSumUs.fetch_add(us, std::memory_order_relaxed);
+    mCount.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t max = mMaxUs.load(std::memory_order_relaxed);
+    while (us > max && !mMaxUs.compare_exchange_weak(max, us, std::memory_order_relaxed)) {}
+}
+
+void LatencyHistogram::reset() {
+    mCount.store(0, std::memory_order_relaxed);
+    mSumUs.store(0, std::memory_order_relaxed);
+    mMaxUs.store(0, std::memory_order_relaxed);
+    for (auto &bucket: mBuckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::snapshot(int64_t *out) const {
+    out[0] = mCount.load(std::memory_order_relaxed);
+    out[1] = mSumUs.load(std::memory_order_relaxed);
+    out[2] = mMaxUs.load(std::memory_order_relaxed);
+    for (int i = 0; i < BUCKETS; i++) out[3 + i] = mBuckets[i].load(std::memory_order_relaxed);
+}
+
+int64_t PlayerStats::nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void PlayerStats::setMax(Counter counter, int64_t value) {
+    int64_t current = mCounters[counter].load(std::memory_order_relaxed);
+    while (value > current &&
+           !mCounters[counter].compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+}
+
+void PlayerStats::reset() {
+    for (auto &counter: mCounters) counter.store(0, std::memory_order_relaxed);
+    for (auto &histogram: mHistograms) histogram.reset();
+}
+
+int PlayerStats::snapshot(int64_t *out, int capacity) const {
+    if (!out || capacity < SNAPSHOT_SIZE) return -1;
+    out[0] = SNAPSHOT_VERSION;
+    out[1] = nowUs();
+    int64_t *p = out + 2;
+    for (const auto &counter: mCounters) *p++ = counter.load(std::memory_order_relaxed);
+    for (const auto &histogram: mHistograms) {
+        histogram.snapshot(p);
+        p += LatencyHistogram::SNAPSHOT_SIZE;
+    }
+    return SNAPSHOT_SIZE;
+}
@@ -0,0 +1,113 @@
+#ifndef QYPLAYER_PLAYERSTATS_H
+#define QYPLAYER_PLAYERSTATS_H
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * 耗时直方图 (微秒)，桶按 2 的幂划分：
+ * 桶 0 为 < 1us，桶 i 为 [2^(i-1), 2^i) us，最后一个桶收纳其余 (>= 2^(BUCKETS-2) us，约 4 秒)
+ *
+ * 所有字段为独立的 relaxed 原子量：记录与快照都不加锁，快照内各字段间不保证严格一致。
+ */
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 24;
+    // 快照字段：count, sumUs, maxUs, buckets[BUCKETS]
+    static const int SNAPSHOT_SIZE = 3 + BUCKETS;
+
+    void record(int64_t us);
+
+    void reset();
+
+    void snapshot(int64_t *out) const;
+
+    int64_t getCount() const { return mCount.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> mCount{0};
+    std::atomic<int64_t> mSumUs{0};
+    std::atomic<int64_t> mMaxUs{0};
+    std::atomic<int64_t> mBuckets[BUCKETS] = {};
+};
+
+/**
+ * 播放遥测：各阶段耗时、队列水位、缓冲与重建次数
+ *
+ * 由读取/解码线程写入，UI 或诊断上报线程通过 snapshot() 轮询；两端都不加锁、不分配内存。
+ * 快照为定长 int64 数组，布局：
+ *   [0] SNAPSHOT_VERSION
+ *   [1] 快照时间 (steady clock, us)
+ *   [2, 2 + COUNTER_COUNT)  计数器 / 水位，按 Counter 顺序
+ *   其后 HIST_COUNT 个直方图，每个 LatencyHistogram::SNAPSHOT_SIZE 个字段，按 Histogram 顺序
+ * 调整布局时需同步递增版本号并修改 Kotlin 侧的 PlaybackStats。
+ */
+class PlayerStats {
+public:
+    enum Counter {
+        COUNTER_READ_BYTES = 0,      // 读取的压缩数据 (av_read_frame 包 / SACD 扇区)
+        COUNTER_READ_PACKETS,        // 读取的包数 / SACD 扇区数
+        COUNTER_DELIVERED_BYTES,     // 经 onAudioData 送出的字节
+        COUNTER_QUEUE_PACKETS,       // 当前 PacketQueue 包数 (水位)
+        COUNTER_QUEUE_BYTES,         // 当前 PacketQueue 字节数 (水位)
+        COUNTER_QUEUE_PEAK_BYTES,    // PacketQueue 峰值字节数
+        COUNTER_UNDERRUNS,           // 播放中数据耗尽进入缓冲的次数 (不含起播与 Seek)
+        COUNTER_DECODE_ERRORS,
+        COUNTER_SWR_REBUILDS,
+        COUNTER_DST_REBUILDS,        // DST 解码器创建次数 (每次起播/切轨)
+        COUNTER_PCM_OUTPUT_BYTES,    // FFPlayer PCM 路径按最终编码送出的字节 (不含缓存回放)
+        COUNTER_PCM_OUTPUT_FRAMES,   // 同上，帧数；与 BYTES / 采样率一起得到每秒音频的带宽
+        COUNTER_PCM_CONVERT_CPU_NS,  // Swr 转换与编码压缩的线程 CPU 时间 (ns)
+        COUNTER_SEEK_CACHE_HITS,     // 命中 PCM 缓存、直接重放的 Seek
+        COUNTER_SEEK_CACHE_MISSES,   // 未命中 (含 DSD 直通与 SACD) 的 Seek
+        COUNTER_SEEK_HIT_US,         // 命中时请求到首批音频送出的累计延迟
+        COUNTER_SEEK_MISS_US,        // 未命中时的累计延迟
+        COUNTER_COUNT
+    };
+
+    enum Histogram {
+        HIST_READ = 0,   // 单次 av_read_frame / sacd_read_block_raw
+        HIST_DECODE,     // 单个包的解码 (FFPlayer) / 单帧 DSD 转换 (SacdPlayer)
+        HIST_CALLBACK,   // onAudioData 回调
+        HIST_BUFFERING,  // 缓冲时长，count 即缓冲次数
+        HIST_SEEK,       // Seek 请求到首批音频送出
+        HIST_COUNT
+    };
+
+    static const int SNAPSHOT_VERSION = 2;
+    static const int SNAPSHOT_SIZE = 2 + COUNTER_COUNT + HIST_COUNT * LatencyHistogram::SNAPSHOT_SIZE;
+
+    static int64_t nowUs();
+
+    void add(Counter counter, int64_t value = 1) {
+        mCounters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void set(Counter counter, int64_t value) {
+        mCounters[counter].store(value, std::memory_order_relaxed);
+    }
+
+    void setMax(Counter counter, int64_t value);
+
+    int64_t get(Counter counter) const {
+        return mCounters[counter].load(std::memory_order_relaxed);
+    }
+
+    void record(Histogram histogram, int64_t us) {
+        mHistograms[histogram].record(us);
+    }
+
+    void reset();
+
+    /**
+     * @param capacity out 的长度
+     * @return 写入的字段数，capacity 不足时返回 -1
+     */
+    int snapshot(int64_t *out, int capacity) const;
+
+private:
+    std::atomic<int64_t> mCounters[COUNTER_COUNT] = {};
+    LatencyHistogram mHistograms[HIST_COUNT];
+};
+
+#endif //QYPLAYER_PLAYERSTATS_H
@@ -1,5 +1,11 @@
 #include "SacdPlayer.h"
 #include "FFmpegNetworkStream.h"
+#include "SacdHandoff.h"
+
+// SACD 的 DSD64 采样率
+#define SACD_DSD_RATE 2822400
+// DST 自测最多读取的扇区数 (6 声道 16 帧通常不到 128 个扇区)
+#define CALIBRATION_MAX_SECTORS (MAX_PROCESSING_BLOCK_SIZE * 8)
 
 
 // 1. 静态回调函数
@@ -12,6 +18,11 @@ static int scarletbook_audio_callback(void *context, uint8_t *data, size_t size,
     return player->onDecodeData(data, size, track_index);;
 }
 
+static void scarletbook_read_stats_callback(void *context, uint32_t blocks, int64_t elapsed_us) {
+    if (!context) return;
+    static_cast<SacdPlayer *>(context)->onReadStats(blocks, elapsed_us);
+}
+
 static void scarletbook_progress_callback(
         void *context, int track,
         uint32_t current, uint32_t total, float progress) {
@@ -23,9 +34,16 @@ static void scarletbook_progress_callback(
     player->onDecodeProgress(track, current, total, progress);
 }
 
+static void collect_frame_callback(scarletbook_handle_t *handle, uint8_t *frame_data, size_t frame_size,
+                                   void *userdata) {
+    auto *frames = static_cast<std::vector<std::vector<uint8_t>> *>(userdata);
+    frames->emplace_back(frame_data, frame_data + frame_size);
+}
+
 SacdPlayer::SacdPlayer(IPlayerCallback *callback) : BasePlayer(callback) {
     setCpuAffinity(2);
     outBuffer.resize(705600);
+    mMemory.set(MemoryAccount::POOL_OUTPUT_BUFFER, (int64_t) outBuffer.size());
 }
 
 SacdPlayer::~SacdPlayer() {
@@ -53,6 +71,8 @@ void SacdPlayer::prepare() {
             return;
         }
         mState = STATE_PREPARING;
+        mStats.reset();
+        mStartup.reset();
         if (!openSacdHandle()) {
             LOGE("SacdPlayer::prepare: open sacd handle failed");
             mState = STATE_ERROR;
@@ -61,16 +81,19 @@ void SacdPlayer::prepare() {
             }
             return;
         }
+        calibrateDsd();
         extractAudioInfo();
         if (mDsdMode == DSD_MODE_D2P) {
             d2pDecoder = new FFmpegD2pDecoder();
-            d2pDecoder->init(2822400, mTargetD2pSampleRate, 16);
+            d2pDecoder->init(SACD_DSD_RATE, mTargetD2pSampleRate, 16);
         }
         is4ChannelSupported = SystemProperties::is4ChannelSupported();
+        mStartup.mark(StartupProfile::MILESTONE_CODEC_OPENED);
 
         mState = STATE_PREPARED;
         mIsExit = false;
     }
+    mStartup.mark(StartupProfile::MILESTONE_PREPARED);
 
     if (mCallback) {
         mCallback->onPrepared();
@@ -80,6 +103,7 @@ void SacdPlayer::prepare() {
 
 void SacdPlayer::play() {
     LOGD("SacdPlayer::play: trackIndex=%d", trackIndex);
+    mStartup.mark(StartupProfile::MILESTONE_PLAY);
     {
         std::lock_guard<std::mutex> lock(mStateMutex);
         LOGD("SacdPlayer::play: mOutput=%p", mOutput);
@@ -87,6 +111,7 @@ void SacdPlayer::play() {
             scarletbook_output_interrupt(mOutput);
             scarletbook_output_destroy(mOutput);
             mOutput = nullptr;
+            updateOutputMemory();
         }
         if (!mHandle) {
             LOGE("SacdPlayer::play: handle is null");
@@ -111,6 +136,8 @@ void SacdPlayer::play() {
             }
             return;
         }
+        scarletbook_output_set_read_stats_callback(mOutput, scarletbook_read_stats_callback);
+        scarletbook_output_set_dst_procs(mOutput, mDstWorkers);
         LOGD("SacdPlayer::play: enqueue track");
         int ret = scarletbook_output_enqueue_track(mOutput, area_idx, trackIndex, nullptr, "dsdiff",
                                                    1);
@@ -119,6 +146,7 @@ void SacdPlayer::play() {
             scarletbook_output_interrupt(mOutput);
             scarletbook_output_destroy(mOutput);
             mOutput = nullptr;
+            updateOutputMemory();
             mState = STATE_ERROR;
             if (mCallback) {
                 mCallback->onError(-3, "Play failed: enqueue track failed");
@@ -127,8 +155,14 @@ void SacdPlayer::play() {
         }
         mIsExit = false;
         mState = STATE_PLAYING;
+        // D2P/DoP/Native 都经 DSD 输出，DST 区域每次起播都会新建 DST 解码器
+        if (mHandle->area[area_idx].area_toc->frame_format == FRAME_FORMAT_DST) {
+            mStats.add(PlayerStats::COUNTER_DST_REBUILDS);
+        }
+        updateOutputMemory();
         LOGD("SacdPlayer::play: start output");
         scarletbook_output_start(mOutput);
+        mStartup.mark(StartupProfile::MILESTONE_OUTPUT_STARTED);
     }
     LOGD("SacdPlayer::play: finished");
 }
@@ -168,6 +202,7 @@ void SacdPlayer::stop() {
         scarletbook_output_destroy(mOutput);
     }
     mOutput = nullptr;
+    updateOutputMemory();
     LOGD("SacdPlayer::stop: finished");
 }
 
@@ -175,6 +210,7 @@ void SacdPlayer::seek(long ms) {
     if (mState == STATE_PLAYING || mState == STATE_PAUSED) {
         mIsSeeking = true;
         mSeekTargetMs = ms;
+        mSeekRequestUs = PlayerStats::nowUs();
         if (mOutput) {
             // 底层这边是进度百分比
             int progress = ((float) mSeekTargetMs * 100.0f) / mDurationMs;
@@ -185,13 +221,21 @@ void SacdPlayer::seek(long ms) {
     }
 }
 
+void SacdPlayer::updateOutputMemory() {
+    bool active = mOutput != nullptr;
+    bool dst = active && mHandle && area_idx >= 0 &&
+               mHandle->area[area_idx].area_toc->frame_format == FRAME_FORMAT_DST;
+    mMemory.set(MemoryAccount::POOL_SACD_READ, active ? MAX_PROCESSING_BLOCK_SIZE * SACD_LSN_SIZE : 0);
+    mMemory.set(MemoryAccount::POOL_DST, dst ? (int64_t) dst_decoder_max_memory(mDstWorkers) : 0);
+}
+
 void SacdPlayer::release() {
     releaseInternal();
 }
 
 void SacdPlayer::releaseInternal() {
     stop();
-    closeSacdHandle();
+    closeSacdHandle(false);
     mState = STATE_IDLE;
 
     if (d2pDecoder) {
@@ -227,7 +271,10 @@ int SacdPlayer::getBitPerSample() const {
 int SacdPlayer::onDecodeData(uint8_t *data, size_t size, int track_index) {
     if (mIsExit) return -1;
     if (mIsSeeking) return 0;
+    mStartup.mark(StartupProfile::MILESTONE_FIRST_DECODE);
     // LOGD("onDecodeData: track_index=%d, size=%zu", track_index, size);
+    int64_t convertStart = PlayerStats::nowUs();
+    QY_TRACE_BEGIN("dsdConvert");
     int out_size = 0;
     switch (mDsdMode) {
         case DSD_MODE_NATIVE:
@@ -246,14 +293,29 @@ int SacdPlayer::onDecodeData(uint8_t *data, size_t size, int track_index) {
             out_size = DsdUtils::packDoP(true, data, size, outBuffer.data());
             break;
     }
+    QY_TRACE_END();
+    mStats.record(PlayerStats::HIST_DECODE, PlayerStats::nowUs() - convertStart);
     if (out_size > 0) {
-        if (mCallback) {
-            mCallback->onAudioData(outBuffer.data(), out_size);
+        // Seek 由输出线程异步执行，延迟近似取请求后首帧送出
+        int64_t seekRequestUs = mSeekRequestUs.exchange(0);
+        if (seekRequestUs > 0) {
+            int64_t latencyUs = PlayerStats::nowUs() - seekRequestUs;
+            mStats.add(PlayerStats::COUNTER_SEEK_CACHE_MISSES);
+            mStats.add(PlayerStats::COUNTER_SEEK_MISS_US, latencyUs);
+            mStats.record(PlayerStats::HIST_SEEK, latencyUs);
         }
+        emitAudioData(outBuffer.data(), out_size);
     }
     return 0;
 }
 
+void SacdPlayer::onReadStats(uint32_t blocks, int64_t elapsedUs) {
+    mStartup.mark(StartupProfile::MILESTONE_BUFFERED);
+    mStats.record(PlayerStats::HIST_READ, elapsedUs);
+    mStats.add(PlayerStats::COUNTER_READ_PACKETS, blocks);
+    mStats.add(PlayerStats::COUNTER_READ_BYTES, (int64_t) blocks * SACD_LSN_SIZE);
+}
+
 void SacdPlayer::onDecodeProgress(int track, uint32_t current, uint32_t total, float progress) {
     if (mIsSeeking) {
         LOGD("Skip progress update while seeking");
@@ -280,58 +342,25 @@ void SacdPlayer::onDecodeProgress(int track, uint32_t current, uint32_t total, f
 bool SacdPlayer::openSacdHandle() {
     if (isoPath.empty()) return false;
 
-    // 确保之前的 handle 和 stream 都已关闭
-    closeSacdHandle();
-
-    // 判断是否为网络路径
-    bool isNetwork = (isoPath.find("http://") == 0 || isoPath.find("https://") == 0);
-
-    if (isNetwork) {
-        LOGD("SacdPlayer::openSacdHandle: Network stream detected");
-        mNetStream = new FFmpegNetworkStream();
-
-        if (!mNetStream->open(isoPath, mHeaders)) {
-            LOGE("SacdPlayer::openSacdHandle: FFmpegNetworkStream open failed");
-            delete mNetStream;
-            mNetStream = nullptr;
-            return false;
-        }
-
-        sacd_io_callbacks_t cb;
-        cb.context = mNetStream;
-        cb.read = FFmpegNetworkStream::read_cb;
-        cb.seek = FFmpegNetworkStream::seek_cb;
-        cb.tell = FFmpegNetworkStream::tell_cb;
-        cb.get_size = FFmpegNetworkStream::get_size_cb;
-
-        mReader = sacd_open_callbacks(&cb);
-    } else {
-        LOGD("SacdPlayer::openSacdHandle: Local file detected");
-        mReader = sacd_open(isoPath.c_str());
-    }
-
-    if (!mReader) {
-        LOGE("sacd_open failed: %s", isoPath.c_str());
-        if (mNetStream) {
-            mNetStream->close();
-            delete mNetStream;
-            mNetStream = nullptr;
-        }
-        return false;
-    }
+    // 确保之前的 handle 和 stream 都已关闭 (同一镜像的句柄会经 SacdHandoff 直接取回)
+    closeSacdHandle(true);
 
-    mHandle = scarletbook_open(mReader);
-    if (!mHandle) {
-        LOGE("scarletbook_open failed");
-        sacd_close(mReader);
-        mReader = nullptr;
-        // 清理网络流
-        if (mNetStream) {
-            delete mNetStream;
-            mNetStream = nullptr;
-        }
+    // 探测刚打开过的镜像直接复用其句柄，省掉网络连接与 TOC 读取
+    SacdHandles sacd;
+    SacdOpenTiming timing;
+    if (SacdHandoff::isNetwork(isoPath)) mStartup.setFlag(StartupProfile::FLAG_NETWORK);
+    int64_t openStart = StartupProfile::nowUs();
+    if (!SacdHandoff::open(isoPath, mHeaders, sacd, &timing)) {
         return false;
     }
+    if (timing.reused) mStartup.setFlag(StartupProfile::FLAG_REUSED_HANDLE);
+    mStartup.markAt(StartupProfile::MILESTONE_OPENED, openStart + timing.openUs);
+    mStartup.markAt(StartupProfile::MILESTONE_STREAM_INFO, openStart + timing.openUs + timing.tocUs);
+    mNetStream = sacd.netStream;
+    mReader = sacd.reader;
+    mHandle = sacd.handle;
+    mHandlePath = isoPath;
+    mHandleHeaders = mHeaders;
 
     area_idx = (mHandle->twoch_area_idx >= 0) ? mHandle->twoch_area_idx : mHandle->mulch_area_idx;
     if (area_idx < 0) {
@@ -341,23 +370,21 @@ bool SacdPlayer::openSacdHandle() {
     return true;
 }
 
-void SacdPlayer::closeSacdHandle() {
-    if (mHandle) {
-        scarletbook_close(mHandle);
-        mHandle = nullptr;
-    }
-
-    if (mReader) {
-        sacd_close(mReader);
-        mReader = nullptr;
-    }
-
-    if (mNetStream) {
-        mNetStream->close();
-        delete mNetStream;
-        mNetStream = nullptr;
-        LOGD("SacdPlayer::closeSacdHandle: Network stream released");
+void SacdPlayer::closeSacdHandle(bool handOff) {
+    SacdHandles sacd;
+    sacd.netStream = mNetStream;
+    sacd.reader = mReader;
+    sacd.handle = mHandle;
+    mNetStream = nullptr;
+    mReader = nullptr;
+    mHandle = nullptr;
+    if (!handOff || !sacd.handle) {
+        SacdHandoff::close(sacd);
+        return;
     }
+    // 切换曲目时常常马上打开同一镜像，暂存而不是关闭
+    SacdHandoff::offer(mHandlePath, mHandleHeaders, sacd);
+    LOGD("SacdPlayer::closeSacdHandle: handle handed off");
 }
 
 long SacdPlayer::getTrackDurationMs(int track_index) {
@@ -372,6 +399,61 @@ bool SacdPlayer::isDsd() const {
     return mIsSourceDsd;
 }
 
+int SacdPlayer::getDstWorkers() const {
+    return mDstWorkers;
+}
+
+void SacdPlayer::calibrateDsd() {
+    mTargetD2pSampleRate = mRequestedD2pSampleRate;
+    mDstWorkers = DsdCalibration::DEFAULT_DST_WORKERS;
+    if (!mHandle || area_idx < 0) return;
+    int channels = mHandle->area[area_idx].area_toc->channel_count;
+    bool dst = mHandle->area[area_idx].area_toc->frame_format == FRAME_FORMAT_DST;
+
+    if (dst && !DsdCalibration::hasDstResult(channels)) {
+        // 读帧与解码共用一个预算，prepare 最多因此多等 DST_CALIBRATION_BUDGET_US (外加一帧的解码)
+        int64_t deadlineUs = PlayerStats::nowUs() + DsdCalibration::DST_CALIBRATION_BUDGET_US;
+        DsdCalibration::calibrateDst(readTrackFrames(DsdCalibration::DST_CALIBRATION_FRAMES, deadlineUs),
+                                     channels, deadlineUs);
+    }
+    // DST 与 D2P 分别在 DST 解码线程与其输出线程上执行，按两者 RTF 之和留余量
+    double d2pRtf = 0;
+    if (mDsdMode == DSD_MODE_D2P) {
+        mTargetD2pSampleRate = DsdCalibration::chooseD2pRate(
+                SACD_DSD_RATE, 2, mRequestedD2pSampleRate, dst ? DsdCalibration::getBestDstRtf(channels) : 0);
+        d2pRtf = DsdCalibration::getD2pRtf(SACD_DSD_RATE, mTargetD2pSampleRate);
+        if (d2pRtf < 0) d2pRtf = 0;
+    }
+    if (dst) mDstWorkers = DsdCalibration::chooseDstWorkers(channels, d2pRtf);
+    LOGD("calibrateDsd: %dch %s, dst workers %d, d2p rate %d (requested %d)", channels,
+         dst ? "DST" : "DSD", mDstWorkers, mTargetD2pSampleRate, mRequestedD2pSampleRate);
+}
+
+std::vector<std::vector<uint8_t>> SacdPlayer::readTrackFrames(int maxFrames, int64_t deadlineUs) {
+    std::vector<std::vector<uint8_t>> frames;
+    scarletbook_area_t *area = &mHandle->area[area_idx];
+    if (trackIndex < 0 || trackIndex >= area->area_toc->track_count) return frames;
+    uint32_t start = area->area_tracklist_offset->track_start_lsn[trackIndex];
+    uint32_t end = start + std::min<uint32_t>(area->area_tracklist_offset->track_length_lsn[trackIndex],
+                                              CALIBRATION_MAX_SECTORS);
+    std::vector<uint8_t> sectors((size_t) MAX_PROCESSING_BLOCK_SIZE * SACD_LSN_SIZE);
+
+    scarletbook_frame_init(mHandle);
+    for (uint32_t lsn = start; lsn < end && (int) frames.size() < maxFrames;) {
+        uint32_t blocks = std::min<uint32_t>(MAX_PROCESSING_BLOCK_SIZE, end - lsn);
+        uint32_t read = sacd_read_block_raw(mReader, lsn, blocks, sectors.data());
+        if (read == 0) break;
+        lsn += read;
+        scarletbook_process_frames(mHandle, sectors.data(), (int) read, lsn >= end, collect_frame_callback,
+                                   &frames);
+        if (PlayerStats::nowUs() >= deadlineUs) break;
+    }
+    // 拼帧状态留给输出线程重新开始
+    scarletbook_frame_init(mHandle);
+    if ((int) frames.size() > maxFrames) frames.resize(maxFrames);
+    return frames;
+}
+
 void SacdPlayer::extractAudioInfo() {
     mDurationMs = getTrackDurationMs(trackIndex);
     mIsSourceDsd = true;
@@ -4,6 +4,7 @@
 #include "BasePlayer.h"
 #include <vector>
 #include "FFmpegD2pDecoder.h"
+#include "DsdCalibration.h"
 #include "SystemProperties.h"
 #include "FFmpegNetworkStream.h"
 #include <map>
@@ -13,6 +14,7 @@ extern "C" {
 #include "sacd_reader.h"
 #include "scarletbook_read.h"
 #include "scarletbook_output.h"
+#include "dst_decoder.h"
 #include "utils.h"
 }
 
@@ -52,34 +54,57 @@ public:
 
     bool isDsd() const override;
 
+    // DST 解码线程数 (prepare 时按 DsdCalibration 选择)
+    int getDstWorkers() const;
+
     // Internal Callbacks (供 C 语言回调使用)
     int onDecodeData(uint8_t *data, size_t size, int track_index);
 
     void onDecodeProgress(int track, uint32_t current, uint32_t total, float progress);
 
+    void onReadStats(uint32_t blocks, int64_t elapsedUs);
+
 private:
     void releaseInternal();
 
     bool openSacdHandle();
 
-    void closeSacdHandle();
+    /**
+     * @param handOff 切换曲目时暂存到 SacdHandoff 供随后的 prepare 取回；释放时直接关闭
+     */
+    void closeSacdHandle(bool handOff);
 
     long getTrackDurationMs(int track_index);
 
     void extractAudioInfo();
 
+    // 按 DsdCalibration 的自测结果选择 DST 解码线程数与 D2P 采样率，需要时先对当前曲目做一次限时自测
+    void calibrateDsd();
+
+    // 读取当前曲目开头最多 maxFrames 个音频帧，到达 deadlineUs (PlayerStats::nowUs 时基) 后不再读取
+    std::vector<std::vector<uint8_t>> readTrackFrames(int maxFrames, int64_t deadlineUs);
+
+    // 按当前输出 (及是否为 DST 区域) 更新扇区读取缓冲与 DST 解码器的内存记账
+    void updateOutputMemory();
+
 private:
     std::map<std::string, std::string> mHeaders;
     FFmpegNetworkStream *mNetStream = nullptr;
+    // 当前句柄对应的镜像与请求头 (setDataSource 可能已更换 isoPath)
+    std::string mHandlePath;
+    std::map<std::string, std::string> mHandleHeaders;
 
     std::string isoPath;
     int trackIndex = 0;
     int area_idx = -1;
     FFmpegD2pDecoder *d2pDecoder = nullptr;
+    int mDstWorkers = DsdCalibration::DEFAULT_DST_WORKERS;
 
     // Buffers
     std::vector<uint8_t> outBuffer;
 
+    std::atomic<int64_t> mSeekRequestUs{0}; // 未送出首帧的 Seek 请求时间
+
     // Native Handles
     sacd_reader_t *mReader = nullptr;
     scarletbook_handle_t *mHandle = nullptr;
@@ -0,0 +1,30 @@
+#include "StartupProfile.h"
+#include "PlayerStats.h"
+
+void StartupProfile::reset() {
+    mOriginUs.store(nowUs(), std::memory_order_relaxed);
+    for (auto &mark: mMarks) mark.store(-1, std::memory_order_relaxed);
+    mFlags.store(0, std::memory_order_relaxed);
+    mFinished.store(false, std::memory_order_release);
+}
+
+void StartupProfile::markAt(Milestone milestone, int64_t us) {
+    int64_t elapsed = us - mOriginUs.load(std::memory_order_relaxed);
+    if (elapsed < 0) elapsed = 0;
+    int64_t expected = -1;
+    mMarks[milestone].compare_exchange_strong(expected, elapsed, std::memory_order_relaxed);
+}
+
+bool StartupProfile::finish(int64_t *out) {
+    if (mFinished.load(std::memory_order_acquire)) return false;
+    mark(MILESTONE_FIRST_AUDIO);
+    if (mFinished.exchange(true, std::memory_order_acq_rel)) return false;
+    out[0] = SNAPSHOT_VERSION;
+    out[1] = mFlags.load(std::memory_order_relaxed);
+    for (int i = 0; i < MILESTONE_COUNT; i++) out[2 + i] = mMarks[i].load(std::memory_order_relaxed);
+    return true;
+}
+
+int64_t StartupProfile::nowUs() {
+    return PlayerStats::nowUs();
+}
@@ -0,0 +1,74 @@
+#ifndef QYPLAYER_STARTUPPROFILE_H
+#define QYPLAYER_STARTUPPROFILE_H
+
+#include <atomic>
+#include <stdint.h>
+
+/**
+ * 起播耗时剖析：prepare() 到首次 onAudioData 之间各里程碑的时间点
+ *
+ * 时间点为相对 prepare() 开始的微秒数，未到达为 -1；阶段耗时由相邻里程碑求差，
+ * 准备耗时 (time-to-prepared) 即 PREPARED，起播耗时 (time-to-first-audio) 为 FIRST_AUDIO - PLAY
+ * (play() 何时调用由上层决定)。每个里程碑只记录首次到达，字段为 relaxed 原子量，
+ * prepare / play / 读取 / 解码线程都可直接写入。
+ *
+ * 首次 onAudioData 之后 finish() 输出一次结果，经 IPlayerCallback::onStartupProfile 回调。布局：
+ *   [0] SNAPSHOT_VERSION
+ *   [1] 标志位 (Flag)
+ *   [2, 2 + MILESTONE_COUNT)  各里程碑，按 Milestone 顺序
+ * 调整布局时需同步递增版本号并修改 Kotlin 侧的 StartupProfile。
+ */
+class StartupProfile {
+public:
+    enum Milestone {
+        MILESTONE_OPENED = 0,     // 源已打开。FFPlayer: avformat_open_input，网络源含 DNS/TCP/TLS、HTTP 响应与格式探测；
+                                  // SACD: sacd_open，网络镜像为 avio_open2 (DNS/TCP/TLS 与 HTTP 响应)
+        MILESTONE_STREAM_INFO,    // FFPlayer: avformat_find_stream_info；SACD: scarletbook_open (Master / Area TOC)
+        MILESTONE_CODEC_OPENED,   // FFPlayer: avcodec_open2 与 Swr 初始化；SACD: DsdCalibration 限时自测与 D2P 解码器初始化
+        MILESTONE_PREPARED,       // 回调 onPrepared 之前
+        MILESTONE_PLAY,           // play() 被调用
+        MILESTONE_OUTPUT_STARTED, // FFPlayer: 读取线程已启动并完成起始位置定位；SACD: scarletbook_output_start 返回
+        MILESTONE_BUFFERED,       // FFPlayer: 首个包出队 (队列已达 minStartThresholdBytes 或 EOF)；SACD: 首批扇区读取完成
+        MILESTONE_FIRST_DECODE,   // FFPlayer: 首个 AVFrame / DSD 包；SACD: 首个 DSD 帧 (含 DST 解码) 到达
+        MILESTONE_FIRST_AUDIO,    // 首次 onAudioData 返回
+        MILESTONE_COUNT
+    };
+
+    enum Flag {
+        FLAG_NETWORK = 1,       // 网络源
+        FLAG_REUSED_HANDLE = 2  // 接管了探测时打开的解复用器 / SACD 句柄，OPENED 与 STREAM_INFO 近似为 0
+    };
+
+    static const int SNAPSHOT_VERSION = 1;
+    static const int SNAPSHOT_SIZE = 2 + MILESTONE_COUNT;
+
+    // prepare() 开始时调用，以当前时刻为原点
+    void reset();
+
+    void mark(Milestone milestone) {
+        if (mMarks[milestone].load(std::memory_order_relaxed) < 0) markAt(milestone, nowUs());
+    }
+
+    // us 为 nowUs() 时基下的绝对时刻，已记录过的里程碑不会被覆盖
+    void markAt(Milestone milestone, int64_t us);
+
+    void setFlag(Flag flag) {
+        mFlags.fetch_or(flag, std::memory_order_relaxed);
+    }
+
+    /**
+     * 记录 FIRST_AUDIO 并写出结果，每次 reset() 之后只有第一次调用返回 true
+     * @param out 长度 >= SNAPSHOT_SIZE
+     */
+    bool finish(int64_t *out);
+
+    static int64_t nowUs();
+
+private:
+    std::atomic<int64_t> mOriginUs{0};
+    std::atomic<int64_t> mMarks[MILESTONE_COUNT] = {};
+    std::atomic<int> mFlags{0};
+    std::atomic<bool> mFinished{true};
+};
+
+#endif //QYPLAYER_STARTUPPROFILE_H
@@ -0,0 +1,114 @@
+#include "SwrContextCache.h"
+#include "Logger.h"
+#include <chrono>
+
+extern "C" {
+#include <libavutil/opt.h>
+}
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SwrContextCache::SwrContextCache(size_t capacity) : mCapacity(capacity > 0 ? capacity : 1) {
+}
+
+SwrContextCache::~SwrContextCache() {
+    clear();
+}
+
+void SwrContextCache::freeEntry(Entry &entry) {
+    if (entry.ctx) swr_free(&entry.ctx);
+    av_channel_layout_uninit(&entry.inLayout);
+    av_channel_layout_uninit(&entry.outLayout);
+}
+
+SwrContext *SwrContextCache::build(const AVChannelLayout *inLayout, int inRate,
+                                   AVSampleFormat inFormat, const AVChannelLayout *outLayout,
+                                   int outRate, AVSampleFormat outFormat) {
+    SwrContext *ctx = swr_alloc();
+    if (!ctx) {
+        LOGE("SwrContextCache: swr_alloc failed");
+        return nullptr;
+    }
+
+    av_opt_set_chlayout(ctx, "out_chlayout", outLayout, 0);
+    av_opt_set_int(ctx, "out_sample_rate", outRate, 0);
+    av_opt_set_sample_fmt(ctx, "out_sample_fmt", outFormat, 0);
+
+    av_opt_set_chlayout(ctx, "in_chlayout", inLayout, 0);
+    av_opt_set_int(ctx, "in_sample_rate", inRate, 0);
+    av_opt_set_sample_fmt(ctx, "in_sample_fmt", inFormat, 0);
+
+    // 显式设置声道数，防止 rematrix 混淆
+    av_opt_set_int(ctx, "ich", inLayout->nb_channels, 0);
+
+    if (swr_init(ctx) < 0) {
+        LOGE("SwrContextCache: swr_init failed");
+        swr_free(&ctx);
+        return nullptr;
+    }
+    return ctx;
+}
+
+SwrContext *SwrContextCache::acquire(const AVChannelLayout *inLayout, int inRate,
+                                     AVSampleFormat inFormat, const AVChannelLayout *outLayout,
+                                     int outRate, AVSampleFormat outFormat) {
+    if (!inLayout || !outLayout) return nullptr;
+
+    for (auto it = mEntries.begin(); it != mEntries.end(); ++it) {
+        if (it->inRate == inRate && it->inFormat == inFormat &&
+            it->outRate == outRate && it->outFormat == outFormat &&
+            av_channel_layout_compare(&it->inLayout, inLayout) == 0 &&
+            av_channel_layout_compare(&it->outLayout, outLayout) == 0) {
+            // 命中：移到头部，并复位残留的延迟样本
+            if (it != mEntries.begin()) mEntries.splice(mEntries.begin(), mEntries, it);
+            SwrContext *ctx = mEntries.front().ctx;
+            reset(ctx);
+            mHitCount++;
+            return ctx;
+        }
+    }
+
+    // 未命中：完整构建
+    int64_t start = nowUs();
+    SwrContext *ctx = build(inLayout, inRate, inFormat, outLayout, outRate, outFormat);
+    if (!ctx) return nullptr;
+    int64_t cost = nowUs() - start;
+    mRebuildCount++;
+    mRebuildTimeUs += cost;
+
+    Entry entry{};
+    av_channel_layout_copy(&entry.inLayout, inLayout);
+    entry.inRate = inRate;
+    entry.inFormat = inFormat;
+    av_channel_layout_copy(&entry.outLayout, outLayout);
+    entry.outRate = outRate;
+    entry.outFormat = outFormat;
+    entry.ctx = ctx;
+    mEntries.push_front(entry);
+
+    while (mEntries.size() > mCapacity) {
+        freeEntry(mEntries.back());
+        mEntries.pop_back();
+    }
+
+    LOGD("SwrContextCache: built %dHz %dch fmt%d -> %dHz %dch fmt%d in %lldus (rebuilds=%lld)",
+         inRate, inLayout->nb_channels, inFormat, outRate, outLayout->nb_channels, outFormat,
+         (long long) cost, (long long) mRebuildCount.load());
+    return ctx;
+}
+
+void SwrContextCache::reset(SwrContext *ctx) {
+    if (!ctx) return;
+    // 参数不变时 swr_init 只清空内部缓冲，保留已构建的滤波器组
+    if (swr_init(ctx) < 0) {
+        LOGE("SwrContextCache: reset failed");
+    }
+}
+
+void SwrContextCache::clear() {
+    for (auto &entry: mEntries) freeEntry(entry);
+    mEntries.clear();
+}
@@ -0,0 +1,78 @@
+#ifndef QYPLAYER_SWRCONTEXTCACHE_H
+#define QYPLAYER_SWRCONTEXTCACHE_H
+
+#include <list>
+#include <atomic>
+#include <stdint.h>
+
+extern "C" {
+#include <libswresample/swresample.h>
+#include <libavutil/channel_layout.h>
+#include <libavutil/samplefmt.h>
+}
+
+/**
+ * 已初始化 SwrContext 的 LRU 缓存
+ *
+ * 参数交替变化的流 (HLS 码率切换、链式 Ogg、电台插播广告) 会反复触发
+ * swr_free/swr_alloc/swr_init，每次都要重建滤波器组。这里按
+ * (输入布局, 采样率, 格式, 输出配置) 缓存初始化好的上下文，切回旧参数时直接复用。
+ *
+ * 复用时调用 swr_init 复位内部状态：参数未变时 libswresample 会保留已有滤波器组，
+ * 只清空延迟缓冲，开销远小于完整重建。
+ *
+ * 非线程安全，仅在解码线程中使用。
+ */
+class SwrContextCache {
+public:
+    explicit SwrContextCache(size_t capacity = 4);
+
+    ~SwrContextCache();
+
+    /**
+     * 获取与给定参数匹配的 SwrContext，未命中时新建并放入缓存
+     * @return 已初始化的上下文 (所有权归缓存)，失败返回 nullptr
+     */
+    SwrContext *acquire(const AVChannelLayout *inLayout, int inRate, AVSampleFormat inFormat,
+                        const AVChannelLayout *outLayout, int outRate, AVSampleFormat outFormat);
+
+    /**
+     * 丢弃上下文中残留的延迟样本 (Seek 后调用)
+     */
+    void reset(SwrContext *ctx);
+
+    void clear();
+
+    // --- 统计 ---
+    int64_t getRebuildCount() const { return mRebuildCount.load(); }
+
+    int64_t getRebuildTimeUs() const { return mRebuildTimeUs.load(); }
+
+    int64_t getHitCount() const { return mHitCount.load(); }
+
+private:
+    struct Entry {
+        AVChannelLayout inLayout;
+        int inRate;
+        AVSampleFormat inFormat;
+        AVChannelLayout outLayout;
+        int outRate;
+        AVSampleFormat outFormat;
+        SwrContext *ctx;
+    };
+
+    static void freeEntry(Entry &entry);
+
+    SwrContext *build(const AVChannelLayout *inLayout, int inRate, AVSampleFormat inFormat,
+                      const AVChannelLayout *outLayout, int outRate, AVSampleFormat outFormat);
+
+    size_t mCapacity;
+    // 头部为最近使用
+    std::list<Entry> mEntries;
+
+    std::atomic<int64_t> mRebuildCount{0};
+    std::atomic<int64_t> mRebuildTimeUs{0};
+    std::atomic<int64_t> mHitCount{0};
+};
+
+#endif //QYPLAYER_SWRCONTEXTCACHE_H
@@ -0,0 +1,176 @@
+#include "LocalHttpServer.h"
+#include "Trace.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include <stdio.h>
+#include <inttypes.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <chrono>
+#include <algorithm>
+
+#define SEND_CHUNK_SIZE (256 * 1024)
+
+namespace {
+
+    bool sendAll(int fd, const char *data, size_t size) {
+        while (size > 0) {
+            ssize_t n = send(fd, data, size, MSG_NOSIGNAL);
+            if (n <= 0) return false;
+            data += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    std::string fileName(const std::string &path) {
+        size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? path : path.substr(slash + 1);
+    }
+
+}
+
+LocalHttpServer::~LocalHttpServer() {
+    stop();
+}
+
+std::string LocalHttpServer::start(const std::string &path, int delayMs) {
+    struct stat st{};
+    if (stat(path.c_str(), &st) != 0) return "";
+    mPath = path;
+    mFileSize = st.st_size;
+    mDelayMs = delayMs;
+
+    mListenFd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (mListenFd < 0) return "";
+    int on = 1;
+    setsockopt(mListenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(mListenFd, (sockaddr *) &addr, sizeof(addr)) != 0 || listen(mListenFd, 16) != 0 ||
+        getsockname(mListenFd, (sockaddr *) &addr, &len) != 0) {
+        close(mListenFd);
+        mListenFd = -1;
+        return "";
+    }
+
+    mStopped = false;
+    mAcceptThread = std::thread(&LocalHttpServer::acceptLoop, this);
+    return "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/" + fileName(path);
+}
+
+void LocalHttpServer::stop() {
+    if (mListenFd < 0) return;
+    mStopped = true;
+    shutdown(mListenFd, SHUT_RDWR);
+    if (mAcceptThread.joinable()) mAcceptThread.join();
+    close(mListenFd);
+    mListenFd = -1;
+
+    std::vector<std::thread> workers;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (int fd: mConnections) shutdown(fd, SHUT_RDWR);
+        workers.swap(mWorkers);
+    }
+    for (auto &t: workers) t.join();
+}
+
+void LocalHttpServer::acceptLoop() {
+    qy_set_thread_name("httpAccept");
+    while (!mStopped) {
+        int fd = accept4(mListenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (mStopped) break;
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        mConnections.insert(fd);
+        mWorkers.emplace_back(&LocalHttpServer::handle, this, fd);
+    }
+}
+
+void LocalHttpServer::handle(int fd) {
+    qy_set_thread_name("httpWorker");
+    serve(fd);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mConnections.erase(fd);
+    close(fd);
+}
+
+void LocalHttpServer::serve(int fd) {
+    // 读取请求头
+    std::string request;
+    char buf[4096];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 64 * 1024) {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return;
+        request.append(buf, n);
+    }
+    mRequests++;
+
+    bool head = strncmp(request.c_str(), "HEAD ", 5) == 0;
+    int64_t start = 0;
+    int64_t end = mFileSize - 1;
+    bool ranged = false;
+    size_t pos = 0;
+    while ((pos = request.find("\r\n", pos)) != std::string::npos) {
+        pos += 2;
+        if (strncasecmp(request.c_str() + pos, "Range:", 6) == 0) {
+            long long a = -1, b = -1;
+            const char *eq = strchr(request.c_str() + pos, '=');
+            if (eq && sscanf(eq + 1, "%lld-%lld", &a, &b) >= 1 && a >= 0) {
+                start = a;
+                if (b >= a && b < mFileSize) end = b;
+                ranged = true;
+            }
+        }
+    }
+
+    if (mDelayMs > 0) std::this_thread::sleep_for(std::chrono::milliseconds(mDelayMs));
+
+    char header[512];
+    if (ranged && start >= mFileSize) {
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 416 Range Not Satisfiable\r\nContent-Range: bytes */%" PRId64
+                 "\r\nContent-Length: 0\r\nConnection: close\r\n\r\n", mFileSize);
+        sendAll(fd, header, strlen(header));
+        return;
+    }
+    int64_t length = end - start + 1;
+    if (ranged) {
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 206 Partial Content\r\nAccept-Ranges: bytes\r\nContent-Range: bytes %"
+                 PRId64 "-%" PRId64 "/%" PRId64 "\r\nContent-Length: %" PRId64
+                 "\r\nContent-Type: application/octet-stream\r\nConnection: close\r\n\r\n",
+                 start, end, mFileSize, length);
+    } else {
+        snprintf(header, sizeof(header),
+                 "HTTP/1.1 200 OK\r\nAccept-Ranges: bytes\r\nContent-Length: %" PRId64
+                 "\r\nContent-Type: application/octet-stream\r\nConnection: close\r\n\r\n",
+                 length);
+    }
+    if (!sendAll(fd, header, strlen(header)) || head) return;
+
+    int file = open(mPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file >= 0) {
+        std::vector<char> chunk(SEND_CHUNK_SIZE);
+        int64_t offset = start;
+        while (offset <= end && !mStopped) {
+            size_t want = (size_t) std::min<int64_t>(chunk.size(), end - offset + 1);
+            ssize_t n = pread(file, chunk.data(), want, offset);
+            // 播放器关闭或 Seek 时会直接断开连接
+            if (n <= 0 || !sendAll(fd, chunk.data(), n)) break;
+            offset += n;
+            mBytesServed += n;
+        }
+        close(file);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef QYPLAYER_LOCALHTTPSERVER_H
+#define QYPLAYER_LOCALHTTPSERVER_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <atomic>
+
+/**
+ * 主机测试用的本地 HTTP 服务 (仅监听 127.0.0.1)
+ *
+ * 把一个本地文件以 http://127.0.0.1:<port>/<文件名> 的形式提供给播放器，支持 HEAD 与
+ * Range 请求 (Seek 与 SACD 镜像的随机读取都依赖它)。每个连接一个线程，响应后关闭连接。
+ * 可选的 delayMs 在每次响应前等待，模拟网络往返延迟。
+ */
+class LocalHttpServer {
+public:
+    ~LocalHttpServer();
+
+    /**
+     * @return 访问地址，失败返回空串
+     */
+    std::string start(const std::string &path, int delayMs = 0);
+
+    void stop();
+
+    int getRequestCount() const { return mRequests.load(); }
+
+    int64_t getBytesServed() const { return mBytesServed.load(); }
+
+private:
+    void acceptLoop();
+
+    void handle(int fd);
+
+    void serve(int fd);
+
+    std::string mPath;
+    int64_t mFileSize = 0;
+    int mDelayMs = 0;
+    int mListenFd = -1;
+    std::atomic<bool> mStopped{false};
+    std::thread mAcceptThread;
+    std::mutex mMutex;
+    std::vector<std::thread> mWorkers;
+    std::set<int> mConnections; // 播放器可能长时间持有连接，stop 时主动断开
+    std::atomic<int> mRequests{0};
+    std::atomic<int64_t> mBytesServed{0};
+};
+
+#endif //QYPLAYER_LOCALHTTPSERVER_H
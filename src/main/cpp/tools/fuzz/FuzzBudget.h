@@ -0,0 +1,70 @@
+#ifndef QYPLAYER_FUZZBUDGET_H
+#define QYPLAYER_FUZZBUDGET_H
+
+/**
+ * 模糊测试的单输入耗时预算
+ *
+ * 预算 = 基础耗时 + 每 KB 输入的耗时，超出时 abort()，libFuzzer 会把该输入作为崩溃样本保存。
+ * libFuzzer 的 -timeout 只能发现秒级的卡死；这里按输入大小线性给预算，用来捕获随输入
+ * 超线性增长的慢路径 (逐帧日志、重复扫描等)。
+ *
+ * 环境变量 QYFUZZ_BUDGET_SCALE 按倍数放宽预算 (机器较慢、调试构建)，设为 0 关闭检查。
+ * 进程内第一个输入包含 iconv / 分配器等冷启动开销，不计入检查。
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <time.h>
+#include <unistd.h>
+
+class FuzzBudget {
+public:
+    FuzzBudget(const char *target, double baseMs, double perKbMs, size_t size)
+            : mTarget(target), mSize(size) {
+        mBudgetMs = (baseMs + perKbMs * (double) size / 1024.0) * scale();
+        mStartUs = nowUs();
+    }
+
+    ~FuzzBudget() {
+        static bool warmedUp = false;
+        if (!warmedUp) {
+            warmedUp = true;
+            return;
+        }
+        if (mBudgetMs <= 0) return;
+        double elapsedMs = (double) (nowUs() - mStartUs) / 1000.0;
+        if (elapsedMs > mBudgetMs) {
+            // stderr 可能已被 libsacd 的 fwprintf 设为宽字符流
+            dprintf(STDERR_FILENO, "%s: input of %zu bytes took %.2f ms, budget %.2f ms\n",
+                    mTarget, mSize, elapsedMs, mBudgetMs);
+            abort();
+        }
+    }
+
+    FuzzBudget(const FuzzBudget &) = delete;
+
+    FuzzBudget &operator=(const FuzzBudget &) = delete;
+
+private:
+    static double scale() {
+        static double value = [] {
+            const char *env = getenv("QYFUZZ_BUDGET_SCALE");
+            return env ? atof(env) : 1.0;
+        }();
+        return value;
+    }
+
+    static long long nowUs() {
+        struct timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+    }
+
+    const char *mTarget;
+    size_t mSize;
+    double mBudgetMs;
+    long long mStartUs;
+};
+
+#endif //QYPLAYER_FUZZBUDGET_H
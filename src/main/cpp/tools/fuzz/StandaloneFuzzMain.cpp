@@ -0,0 +1,84 @@
+/**
+ * 无 libFuzzer 时 (GCC 构建) 的模糊测试入口
+ *
+ * 不做变异，只依次回放命令行给出的样本文件或目录，用于复现崩溃与回归语料：
+ *   fuzz_sacd_frames crash-1234 corpus/sacd_frames/
+ * 每个输入限时 QYFUZZ_TIMEOUT 秒 (默认 25，与 libFuzzer 的 -timeout 默认值相同)，超时由 SIGALRM 终止进程。
+ * 输出直接写 fd 2：被测代码会用 fwprintf 把 stderr 变成宽字符流，之后的 fprintf 会被丢弃。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+namespace {
+
+    bool readFile(const std::string &path, std::vector<uint8_t> &out) {
+        FILE *fp = fopen(path.c_str(), "rb");
+        if (!fp) return false;
+        out.clear();
+        uint8_t buf[65536];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) out.insert(out.end(), buf, buf + n);
+        fclose(fp);
+        return true;
+    }
+
+    void collect(const std::string &path, std::vector<std::string> &files) {
+        struct stat st{};
+        if (stat(path.c_str(), &st) != 0) {
+            dprintf(STDERR_FILENO, "cannot stat %s\n", path.c_str());
+            return;
+        }
+        if (!S_ISDIR(st.st_mode)) {
+            files.push_back(path);
+            return;
+        }
+        DIR *dir = opendir(path.c_str());
+        if (!dir) return;
+        while (struct dirent *entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') continue;
+            collect(path + "/" + entry->d_name, files);
+        }
+        closedir(dir);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') continue; // 忽略 libFuzzer 参数，便于共用命令行
+        collect(argv[i], files);
+    }
+    if (files.empty()) {
+        dprintf(STDERR_FILENO, "usage: %s FILE|DIR...\n", argv[0]);
+        return 2;
+    }
+
+    const char *env = getenv("QYFUZZ_TIMEOUT");
+    unsigned timeoutSec = env ? (unsigned) atoi(env) : 25;
+    std::vector<uint8_t> data;
+    for (const std::string &file: files) {
+        if (!readFile(file, data)) {
+            dprintf(STDERR_FILENO, "cannot read %s\n", file.c_str());
+            return 1;
+        }
+        // 拷贝到恰好大小的堆内存，越界读写能被 ASan 发现
+        uint8_t *input = (uint8_t *) malloc(data.empty() ? 1 : data.size());
+        if (!data.empty()) memcpy(input, data.data(), data.size());
+        dprintf(STDERR_FILENO, "Running: %s (%zu bytes)\n", file.c_str(), data.size());
+        alarm(timeoutSec);
+        LLVMFuzzerTestOneInput(input, data.size());
+        alarm(0);
+        free(input);
+    }
+    dprintf(STDERR_FILENO, "Executed %zu inputs\n", files.size());
+    return 0;
+}
@@ -0,0 +1,16 @@
+/**
+ * CueParser::parse 的模糊测试 (probeCue 读入 .cue 内容后的解析部分)
+ *
+ * 输入即 .cue 文件内容。解析只做一次线性扫描，预算按 1 ms + 0.5 ms/KB 给出。
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include "CueParser.h"
+#include "FuzzBudget.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    FuzzBudget budget("fuzz_cue", 1.0, 0.5, size);
+    CueSheet sheet;
+    CueParser::parse((const char *) data, size, sheet);
+    return 0;
+}
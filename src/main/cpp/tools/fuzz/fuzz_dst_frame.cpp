@@ -0,0 +1,46 @@
+/**
+ * DST_FramDSTDecode (UnpackDSTframe + 算术解码) 的模糊测试
+ *
+ * 第一个字节选择声道数 (2 / 5 / 6，对应 SACD 的立体声与多声道区)，其余字节为一个 DST 帧。
+ * 帧数据拷贝到恰好大小的堆内存，解包时读过帧尾会被 ASan 发现。
+ * 一帧的解码量只取决于声道数、与帧长无关：6 声道帧在 ASan + UBSan 下完整解码约 30~40 ms，
+ * 预算固定为 150 ms。超出说明解包阶段有随输入失控的循环 (例如帧尾之后的 Rice 游程)。
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FuzzBudget.h"
+
+extern "C" {
+#include "dst_init.h"
+#include "dst_fram.h"
+}
+
+// 一个 SACD 帧 (1/75 秒) 单声道 DSD64 的字节数
+#define DSD64_FRAME_BYTES 4704
+// 与 scarletbook.h 的 MAX_DST_SIZE 相同：拼帧缓冲的大小，也是送入解码器的帧长上限
+#define MAX_DST_FRAME_SIZE (1024 * 64)
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    if (size < 2 || size - 1 > MAX_DST_FRAME_SIZE) return 0;
+    FuzzBudget budget("fuzz_dst_frame", 150.0, 0.0, size);
+
+    static const int channelCounts[] = {2, 5, 6};
+    int channelCount = channelCounts[data[0] % 3];
+    size_t frameSize = size - 1;
+    uint8_t *frame = (uint8_t *) malloc(frameSize);
+    memcpy(frame, data + 1, frameSize);
+    uint8_t *out = (uint8_t *) malloc((size_t) DSD64_FRAME_BYTES * channelCount);
+
+    ebunch *decoder = (ebunch *) malloc(sizeof(ebunch));
+    if (DST_InitDecoder(decoder, channelCount, 64) == 0) {
+        DST_FramDSTDecode(frame, out, (int) frameSize, 0, decoder);
+    }
+    DST_CloseDecoder(decoder);
+
+    free(decoder);
+    free(out);
+    free(frame);
+    return 0;
+}
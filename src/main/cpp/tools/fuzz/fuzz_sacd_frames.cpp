@@ -0,0 +1,55 @@
+/**
+ * scarletbook_process_frames 的模糊测试
+ *
+ * 输入按 2048 字节切成音频扇区 (最后不足一个扇区的部分补零)，与 scarletbook_output 相同，
+ * 每次最多 MAX_PROCESSING_BLOCK_SIZE 个扇区，最后一批作为 last_block。
+ * 扇区缓冲按实际大小分配，扇区内的包长越界会被 ASan 发现。
+ * 预算 2 ms + 1 ms/KB：正常情况每个扇区只做几次 memcpy。
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include "FuzzBudget.h"
+
+extern "C" {
+#include "scarletbook_read.h"
+}
+
+#undef min
+#undef max
+
+namespace {
+    void onFrame(scarletbook_handle_t *handle, uint8_t *frameData, size_t frameSize, void *userdata) {
+        if (frameSize > MAX_DST_SIZE) abort();
+        // 读一遍帧数据，确保拼帧时写入的范围都在 frame.data 内
+        uint32_t sum = 0;
+        for (size_t i = 0; i < frameSize; i++) sum += frameData[i];
+        *(uint32_t *) userdata += sum;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    FuzzBudget budget("fuzz_sacd_frames", 2.0, 1.0, size);
+    int sectors = (int) ((size + SACD_LSN_SIZE - 1) / SACD_LSN_SIZE);
+    if (sectors == 0) return 0;
+
+    uint8_t *buffer = (uint8_t *) calloc((size_t) sectors, SACD_LSN_SIZE);
+    memcpy(buffer, data, size);
+
+    scarletbook_handle_t *handle = (scarletbook_handle_t *) calloc(1, sizeof(scarletbook_handle_t));
+    handle->frame.data = (uint8_t *) malloc(MAX_DST_SIZE);
+    scarletbook_frame_init(handle);
+
+    uint32_t checksum = 0;
+    for (int i = 0; i < sectors; i += MAX_PROCESSING_BLOCK_SIZE) {
+        int blocks = sectors - i < MAX_PROCESSING_BLOCK_SIZE ? sectors - i : MAX_PROCESSING_BLOCK_SIZE;
+        scarletbook_process_frames(handle, buffer + (size_t) i * SACD_LSN_SIZE, blocks,
+                                   i + blocks >= sectors, onFrame, &checksum);
+    }
+
+    free(handle->frame.data);
+    free(handle);
+    free(buffer);
+    return 0;
+}
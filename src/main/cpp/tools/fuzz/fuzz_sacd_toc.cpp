@@ -0,0 +1,113 @@
+/**
+ * scarletbook_open (scarletbook_read_master_toc + scarletbook_read_area_toc) 的模糊测试
+ *
+ * 通过 sacd_open_callbacks 从内存读取一张虚拟光盘：Master TOC 之前的扇区全为零，
+ * 输入从 START_OF_MASTER_TOC 扇区开始放置，之后补零到至少 TOC_WINDOW_SECTORS 个扇区。
+ * Area TOC 的起始扇区与长度来自输入，指向窗口之外时按读取失败处理。
+ * 预算 20 ms + 2 ms/KB：TOC 解析只对文本做字符集转换，应与输入大小成线性。
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "FuzzBudget.h"
+
+extern "C" {
+#include "sacd_reader.h"
+#include "scarletbook_read.h"
+}
+
+#undef min
+#undef max
+
+// Master TOC 之后至少可读的扇区数，足够放下 Master TOC 与两个区的 TOC-1 / TOC-2
+#define TOC_WINDOW_SECTORS 64
+
+namespace {
+    struct MemoryDisc {
+        const uint8_t *data;
+        long size;      // 输入长度
+        long base;      // 输入在虚拟光盘上的偏移
+        long total;     // 虚拟光盘长度
+        long pos;
+    };
+
+    long discRead(void *context, void *buffer, long size) {
+        auto *disc = (MemoryDisc *) context;
+        if (size <= 0 || disc->pos >= disc->total) return 0;
+        if (size > disc->total - disc->pos) size = disc->total - disc->pos;
+        auto *out = (uint8_t *) buffer;
+        for (long done = 0; done < size;) {
+            long at = disc->pos + done;
+            long offset = at - disc->base;
+            long n;
+            if (offset < 0) {
+                n = size - done < -offset ? size - done : -offset;
+                memset(out + done, 0, (size_t) n);
+            } else if (offset < disc->size) {
+                n = size - done < disc->size - offset ? size - done : disc->size - offset;
+                memcpy(out + done, disc->data + offset, (size_t) n);
+            } else {
+                n = size - done;
+                memset(out + done, 0, (size_t) n);
+            }
+            done += n;
+        }
+        disc->pos += size;
+        return size;
+    }
+
+    long discSeek(void *context, long offset, int origin) {
+        auto *disc = (MemoryDisc *) context;
+        long target = origin == SEEK_SET ? offset : origin == SEEK_CUR ? disc->pos + offset : disc->total + offset;
+        if (target < 0) return -1;
+        disc->pos = target;
+        return 0;
+    }
+
+    long discTell(void *context) {
+        return ((MemoryDisc *) context)->pos;
+    }
+
+    long discSize(void *context) {
+        return ((MemoryDisc *) context)->total;
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    FuzzBudget budget("fuzz_sacd_toc", 20.0, 2.0, size);
+    MemoryDisc disc{};
+    disc.data = data;
+    disc.size = (long) size;
+    disc.base = (long) START_OF_MASTER_TOC * SACD_LSN_SIZE;
+    long window = (long) TOC_WINDOW_SECTORS * SACD_LSN_SIZE;
+    long padded = (disc.size + SACD_LSN_SIZE - 1) / SACD_LSN_SIZE * SACD_LSN_SIZE;
+    disc.total = disc.base + (padded > window ? padded : window);
+
+    sacd_io_callbacks_t callbacks{};
+    callbacks.context = &disc;
+    callbacks.read = discRead;
+    callbacks.seek = discSeek;
+    callbacks.tell = discTell;
+    callbacks.get_size = discSize;
+
+    sacd_reader_t *reader = sacd_open_callbacks(&callbacks);
+    if (!reader) return 0;
+    scarletbook_handle_t *handle = scarletbook_open(reader);
+    if (handle) {
+        // 播放器打开后会按曲目表计算扇区范围，这里同样遍历一遍
+        for (int area = 0; area < handle->area_count; area++) {
+            scarletbook_area_t *a = &handle->area[area];
+            if (!a->area_toc || !a->area_tracklist_offset) continue;
+            uint32_t sum = 0;
+            for (int track = 0; track < a->area_toc->track_count; track++) {
+                sum += a->area_tracklist_offset->track_start_lsn[track] +
+                       a->area_tracklist_offset->track_length_lsn[track];
+            }
+            (void) sum;
+        }
+        scarletbook_close(handle);
+    }
+    sacd_close(reader);
+    return 0;
+}
@@ -0,0 +1,511 @@
+/**
+ * qybench: DSD / DST / PCM 热点函数的微基准
+ *
+ * 覆盖：
+ *   DsdUtils::packDoP / packNative / pack4ChannelNative (MSBF/LSBF，DSD64~DSD512 每帧数据量)
+ *   DST_FramDSTDecode          (从 SACD 镜像录制的 DST 帧，需 --iso)
+ *   scarletbook_process_frames (从 SACD 镜像录制的音频扇区，需 --iso)
+ *   FFmpegD2pDecoder::process  (合成的 DSD 数据)
+ *   FFPlayer::handlePcmAudioPacket 中的 swr 转换 (经 SwrContextCache) 与 S32 -> S24 打包
+ *
+ * 结果打印为表格；--json 输出与 Google Benchmark 相同结构的 JSON，可直接用其 compare.py 对比。
+ *
+ * 示例：
+ *   qybench --json base.json
+ *   qybench --iso album.iso --track 0 --filter 'DST|Scarletbook' --repetitions 5
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <getopt.h>
+#include <string>
+#include <vector>
+#include <functional>
+#include <regex>
+#include <algorithm>
+#include "DsdUtils.h"
+#include "PcmUtils.h"
+#include "FFmpegD2pDecoder.h"
+#include "SwrContextCache.h"
+#include "SacdHandoff.h"
+
+extern "C" {
+#include "dst_init.h"
+#include "dst_fram.h"
+}
+
+// libcommon/utils.h 的 min/max 宏会破坏 std::min/std::max
+#undef min
+#undef max
+
+// 一个 SACD 帧 (1/75 秒) 单声道 DSD64 的字节数
+#define DSD64_FRAME_BYTES 4704
+
+namespace {
+
+    struct Options {
+        std::string filter;
+        double minTimeSec = 0.5;
+        int repetitions = 3;
+        std::string jsonPath;
+        std::string isoPath;
+        int track = 0;
+        int recordSectors = 3000;
+    };
+
+    struct Result {
+        std::string name;
+        int64_t iterations;
+        double realNs;   // 每次迭代，取各次重复的中位数
+        double cpuNs;
+        double bytesPerSec;
+    };
+
+    int64_t nowNs(clockid_t clock) {
+        struct timespec ts{};
+        clock_gettime(clock, &ts);
+        return (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec;
+    }
+
+    class Runner {
+    public:
+        explicit Runner(const Options &opt)
+                : mOpt(opt), mFilter(opt.filter.empty() ? ".*" : opt.filter),
+                  mTable(opt.jsonPath == "-" ? stderr : stdout) {} // JSON 写到 stdout 时表格改走 stderr
+
+        void printHeader() {
+            fprintf(mTable, "%-48s %15s %15s %12s %15s\n", "benchmark", "time", "cpu", "iterations",
+                    "throughput");
+        }
+
+        /**
+         * @param bytes 每次迭代处理的字节数，用于计算吞吐
+         */
+        void run(const std::string &name, int64_t bytes, const std::function<void()> &fn) {
+            if (!std::regex_search(name, mFilter)) return;
+
+            // 预热并估算迭代次数，使单次重复耗时约为 minTime
+            fn();
+            int64_t iterations = 1;
+            for (;;) {
+                int64_t start = nowNs(CLOCK_MONOTONIC);
+                for (int64_t i = 0; i < iterations; i++) fn();
+                int64_t elapsed = nowNs(CLOCK_MONOTONIC) - start;
+                if (elapsed >= mOpt.minTimeSec * 1e9 * 0.1 || iterations >= (1LL << 30)) {
+                    iterations = std::max<int64_t>(
+                            1, (int64_t) (iterations * mOpt.minTimeSec * 1e9 / std::max<int64_t>(elapsed, 1)));
+                    break;
+                }
+                iterations *= 10;
+            }
+
+            std::vector<double> real, cpu;
+            for (int r = 0; r < mOpt.repetitions; r++) {
+                int64_t realStart = nowNs(CLOCK_MONOTONIC);
+                int64_t cpuStart = nowNs(CLOCK_THREAD_CPUTIME_ID);
+                for (int64_t i = 0; i < iterations; i++) fn();
+                cpu.push_back((double) (nowNs(CLOCK_THREAD_CPUTIME_ID) - cpuStart) / iterations);
+                real.push_back((double) (nowNs(CLOCK_MONOTONIC) - realStart) / iterations);
+            }
+            std::sort(real.begin(), real.end());
+            std::sort(cpu.begin(), cpu.end());
+            Result result{name, iterations, real[real.size() / 2], cpu[cpu.size() / 2], 0};
+            if (bytes > 0) result.bytesPerSec = bytes * 1e9 / result.realNs;
+            fprintf(mTable, "%-48s %12.0f ns %12.0f ns %12lld %10.1f MB/s\n", name.c_str(),
+                    result.realNs, result.cpuNs, (long long) iterations, result.bytesPerSec / 1e6);
+            fflush(mTable);
+            mResults.push_back(result);
+        }
+
+        void skip(const std::string &name, const char *reason) {
+            if (!std::regex_search(name, mFilter)) return;
+            fprintf(mTable, "%-48s skipped: %s\n", name.c_str(), reason);
+        }
+
+        bool writeJson(const std::string &path, char **argv) const {
+            FILE *fp = path == "-" ? stdout : fopen(path.c_str(), "w");
+            if (!fp) return false;
+
+            char host[256] = {0};
+            gethostname(host, sizeof(host) - 1);
+            char date[64] = {0};
+            time_t now = time(nullptr);
+            strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+
+            fprintf(fp, "{\n  \"context\": {\n");
+            fprintf(fp, "    \"date\": \"%s\",\n", date);
+            fprintf(fp, "    \"host_name\": \"%s\",\n", host);
+            fprintf(fp, "    \"executable\": \"%s\",\n", argv[0]);
+            fprintf(fp, "    \"num_cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+            fprintf(fp, "    \"mhz_per_cpu\": 0,\n");
+#ifdef DEBUG
+            fprintf(fp, "    \"library_build_type\": \"debug\",\n");
+#else
+            fprintf(fp, "    \"library_build_type\": \"release\",\n");
+#endif
+            fprintf(fp, "    \"iso\": \"%s\"\n  },\n", mOpt.isoPath.c_str());
+            fprintf(fp, "  \"benchmarks\": [\n");
+            for (size_t i = 0; i < mResults.size(); i++) {
+                const Result &r = mResults[i];
+                fprintf(fp, "    {\n");
+                fprintf(fp, "      \"name\": \"%s\",\n", r.name.c_str());
+                fprintf(fp, "      \"run_name\": \"%s\",\n", r.name.c_str());
+                fprintf(fp, "      \"run_type\": \"iteration\",\n");
+                fprintf(fp, "      \"repetitions\": %d,\n", mOpt.repetitions);
+                fprintf(fp, "      \"iterations\": %lld,\n", (long long) r.iterations);
+                fprintf(fp, "      \"real_time\": %.3f,\n", r.realNs);
+                fprintf(fp, "      \"cpu_time\": %.3f,\n", r.cpuNs);
+                fprintf(fp, "      \"time_unit\": \"ns\"");
+                if (r.bytesPerSec > 0) fprintf(fp, ",\n      \"bytes_per_second\": %.1f", r.bytesPerSec);
+                fprintf(fp, "\n    }%s\n", i + 1 < mResults.size() ? "," : "");
+            }
+            fprintf(fp, "  ]\n}\n");
+            if (fp != stdout) fclose(fp);
+            return true;
+        }
+
+    private:
+        const Options &mOpt;
+        std::regex mFilter;
+        FILE *mTable;
+        std::vector<Result> mResults;
+    };
+
+    /**
+     * 一阶 sigma-delta 调制的 1kHz 正弦，作为合成 DSD 输入
+     * @param interleaved true: DFF 字节交错 (L R L R ...)；false: DSF 平面 ([L...][R...])，LSB 优先
+     */
+    std::vector<uint8_t> makeDsd(int dsdRate, int bytesPerChannel, bool interleaved) {
+        std::vector<uint8_t> out(bytesPerChannel * 2);
+        for (int ch = 0; ch < 2; ch++) {
+            double integrator = 0;
+            double phase = ch * 0.25;
+            for (int i = 0; i < bytesPerChannel; i++) {
+                uint8_t byte = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    double x = 0.5 * sin(2 * M_PI * phase);
+                    phase += 1000.0 / dsdRate;
+                    int y = integrator >= 0 ? 1 : 0;
+                    integrator += x - (y ? 1.0 : -1.0);
+                    byte = interleaved ? (uint8_t) (byte << 1 | y) : (uint8_t) (byte | y << bit);
+                }
+                if (interleaved) out[i * 2 + ch] = byte;
+                else out[ch * bytesPerChannel + i] = byte;
+            }
+        }
+        return out;
+    }
+
+    void benchDsdUtils(Runner &runner) {
+        typedef int (*PackFn)(bool, const uint8_t *, int, uint8_t *);
+        struct Kernel {
+            const char *name;
+            PackFn fn;
+        };
+        const Kernel kernels[] = {
+                {"packDoP",            DsdUtils::packDoP},
+                {"packNative",         DsdUtils::packNative},
+                {"pack4ChannelNative", DsdUtils::pack4ChannelNative},
+        };
+        std::vector<uint8_t> out;
+        for (const Kernel &k: kernels) {
+            for (int msbf = 1; msbf >= 0; msbf--) {
+                for (int mult = 1; mult <= 8; mult *= 2) {
+                    int bytesPerChannel = DSD64_FRAME_BYTES * mult;
+                    std::vector<uint8_t> in = makeDsd(2822400 * mult, bytesPerChannel, msbf);
+                    // DoP 输出为输入的 2 倍，4 声道 Native 同样翻倍
+                    out.resize(in.size() * 2 + 64);
+                    char name[128];
+                    snprintf(name, sizeof(name), "DsdUtils/%s/%s/DSD%d", k.name, msbf ? "MSBF" : "LSBF",
+                             64 * mult);
+                    runner.run(name, (int64_t) in.size(), [&] {
+                        k.fn(msbf, in.data(), (int) in.size(), out.data());
+                    });
+                }
+            }
+        }
+    }
+
+    void benchD2p(Runner &runner) {
+        struct Config {
+            int dsdRate;
+            int pcmRate;
+            int bits;
+        };
+        const Config configs[] = {
+                {2822400,  88200,  16},
+                {2822400,  176400, 16},
+                {2822400,  176400, 32},
+                {5644800,  176400, 32},
+                {11289600, 352800, 32},
+        };
+        std::vector<uint8_t> out(1024 * 1024);
+        for (const Config &c: configs) {
+            char name[128];
+            snprintf(name, sizeof(name), "FFmpegD2pDecoder/process/DSD%d/%d/%dbit", c.dsdRate / 44100,
+                     c.pcmRate, c.bits);
+            FFmpegD2pDecoder decoder;
+            if (!decoder.init(c.dsdRate, c.pcmRate, c.bits)) {
+                runner.skip(name, "init failed");
+                continue;
+            }
+            // SacdPlayer 每次回调一个 SACD 帧 (DFF 交错)
+            std::vector<uint8_t> in = makeDsd(c.dsdRate, DSD64_FRAME_BYTES * c.dsdRate / 2822400, true);
+            runner.run(name, (int64_t) in.size(), [&] {
+                decoder.process(in.data(), (int) in.size(), out.data());
+            });
+        }
+    }
+
+    void benchSwr(Runner &runner) {
+        struct Config {
+            const char *name;
+            AVChannelLayout inLayout;
+            int inRate;
+            AVSampleFormat inFormat;
+            AVChannelLayout outLayout;
+            int outRate;
+            AVSampleFormat outFormat;
+        };
+        // 常见解码器输出 -> FFPlayer 输出格式；每次转换 4096 帧 (FLAC 常见块大小)
+        const Config configs[] = {
+                {"fltp->s16/stereo/44100",        AV_CHANNEL_LAYOUT_STEREO,     44100, AV_SAMPLE_FMT_FLTP,
+                        AV_CHANNEL_LAYOUT_STEREO, 44100, AV_SAMPLE_FMT_S16},
+                {"fltp->s32/stereo/96000",        AV_CHANNEL_LAYOUT_STEREO,     96000, AV_SAMPLE_FMT_FLTP,
+                        AV_CHANNEL_LAYOUT_STEREO, 96000, AV_SAMPLE_FMT_S32},
+                {"fltp->flt/stereo/48000",        AV_CHANNEL_LAYOUT_STEREO,     48000, AV_SAMPLE_FMT_FLTP,
+                        AV_CHANNEL_LAYOUT_STEREO, 48000, AV_SAMPLE_FMT_FLT},
+                {"s16p->s16/stereo/44100",        AV_CHANNEL_LAYOUT_STEREO,     44100, AV_SAMPLE_FMT_S16P,
+                        AV_CHANNEL_LAYOUT_STEREO, 44100, AV_SAMPLE_FMT_S16},
+                {"s32p->s32/stereo/192000",       AV_CHANNEL_LAYOUT_STEREO,     192000, AV_SAMPLE_FMT_S32P,
+                        AV_CHANNEL_LAYOUT_STEREO, 192000, AV_SAMPLE_FMT_S32},
+                {"fltp->s16/5.1->stereo/48000",   AV_CHANNEL_LAYOUT_5POINT1,    48000, AV_SAMPLE_FMT_FLTP,
+                        AV_CHANNEL_LAYOUT_STEREO, 48000, AV_SAMPLE_FMT_S16},
+                {"fltp->s16/stereo/44100->48000", AV_CHANNEL_LAYOUT_STEREO,     44100, AV_SAMPLE_FMT_FLTP,
+                        AV_CHANNEL_LAYOUT_STEREO, 48000, AV_SAMPLE_FMT_S16},
+        };
+        const int frames = 4096;
+        SwrContextCache cache;
+        for (const Config &c: configs) {
+            std::string name = std::string("Swr/") + c.name;
+            SwrContext *ctx = cache.acquire(&c.inLayout, c.inRate, c.inFormat, &c.outLayout, c.outRate,
+                                            c.outFormat);
+            if (!ctx) {
+                runner.skip(name, "swr init failed");
+                continue;
+            }
+            int channels = c.inLayout.nb_channels;
+            int inBytes = av_get_bytes_per_sample(c.inFormat);
+            std::vector<std::vector<uint8_t>> planes(channels, std::vector<uint8_t>(frames * inBytes));
+            for (int ch = 0; ch < channels; ch++) {
+                for (int i = 0; i < frames; i++) {
+                    double v = 0.5 * sin(2 * M_PI * 997.0 * i / c.inRate + ch);
+                    uint8_t *p = planes[ch].data() + i * inBytes;
+                    if (c.inFormat == AV_SAMPLE_FMT_FLTP) *(float *) p = (float) v;
+                    else if (c.inFormat == AV_SAMPLE_FMT_S16P) *(int16_t *) p = (int16_t) (v * 32767);
+                    else *(int32_t *) p = (int32_t) (v * 2147483647.0);
+                }
+            }
+            std::vector<const uint8_t *> inData(channels);
+            for (int ch = 0; ch < channels; ch++) inData[ch] = planes[ch].data();
+            int outFrames = (int) av_rescale_rnd(frames + 256, c.outRate, c.inRate, AV_ROUND_UP);
+            std::vector<uint8_t> out(
+                    outFrames * c.outLayout.nb_channels * av_get_bytes_per_sample(c.outFormat));
+            uint8_t *outData[1] = {out.data()};
+            runner.run(name, (int64_t) frames * channels * inBytes, [&] {
+                swr_convert(ctx, outData, outFrames, inData.data(), frames);
+            });
+        }
+
+        // PCM_ENCODING_24BIT_PACKED 的原地打包
+        std::vector<int32_t> s32(frames * 2);
+        for (size_t i = 0; i < s32.size(); i++) s32[i] = (int32_t) (i * 2654435761u);
+        std::vector<int32_t> work(s32.size());
+        runner.run("PcmUtils/packS32ToS24/stereo/4096", (int64_t) s32.size() * 4, [&] {
+            memcpy(work.data(), s32.data(), s32.size() * 4);
+            PcmUtils::packS32ToS24(work.data(), (uint8_t *) work.data(), (int) work.size());
+        });
+    }
+
+    struct SacdRecording {
+        std::vector<uint8_t> sectors;
+        std::vector<std::vector<uint8_t>> frames;
+        int channelCount = 0;
+        bool dst = false;
+        std::string error;
+    };
+
+    void recordFrame(scarletbook_handle_t *handle, uint8_t *frameData, size_t frameSize, void *userdata) {
+        auto *frames = (std::vector<std::vector<uint8_t>> *) userdata;
+        frames->emplace_back(frameData, frameData + frameSize);
+    }
+
+    void countFrame(scarletbook_handle_t *handle, uint8_t *frameData, size_t frameSize, void *userdata) {
+        (*(int64_t *) userdata)++;
+    }
+
+    // 从镜像中指定曲目起始处录制一段音频扇区，并切分出其中的音频帧
+    SacdRecording recordSacd(const Options &opt) {
+        SacdRecording rec;
+        SacdHandles handles;
+        if (!SacdHandoff::open(opt.isoPath, {}, handles)) {
+            rec.error = "cannot open iso";
+            return rec;
+        }
+        scarletbook_handle_t *handle = handles.handle;
+        int area = handle->twoch_area_idx >= 0 ? handle->twoch_area_idx : handle->mulch_area_idx;
+        if (area < 0 || opt.track < 0 || opt.track >= handle->area[area].area_toc->track_count) {
+            rec.error = "no such track";
+            SacdHandoff::close(handles);
+            return rec;
+        }
+        rec.channelCount = handle->area[area].area_toc->channel_count;
+        rec.dst = handle->area[area].area_toc->frame_format == FRAME_FORMAT_DST;
+        uint32_t start = handle->area[area].area_tracklist_offset->track_start_lsn[opt.track];
+        uint32_t length = handle->area[area].area_tracklist_offset->track_length_lsn[opt.track];
+        uint32_t count = std::min<uint32_t>(length, (uint32_t) opt.recordSectors);
+
+        rec.sectors.resize((size_t) count * SACD_LSN_SIZE);
+        uint32_t read = sacd_read_block_raw(handles.reader, start, count, rec.sectors.data());
+        rec.sectors.resize((size_t) read * SACD_LSN_SIZE);
+
+        scarletbook_frame_init(handle);
+        for (uint32_t i = 0; i < read; i += MAX_PROCESSING_BLOCK_SIZE) {
+            int blocks = (int) std::min<uint32_t>(MAX_PROCESSING_BLOCK_SIZE, read - i);
+            scarletbook_process_frames(handle, rec.sectors.data() + (size_t) i * SACD_LSN_SIZE, blocks,
+                                       i + blocks >= read, recordFrame, &rec.frames);
+        }
+        SacdHandoff::close(handles);
+        if (rec.frames.empty()) rec.error = "no audio frames recorded";
+        return rec;
+    }
+
+    void benchSacd(Runner &runner, const Options &opt) {
+        const char *dstName = "DST/FramDSTDecode";
+        const char *sectorName = "Scarletbook/process_frames";
+        if (opt.isoPath.empty()) {
+            runner.skip(dstName, "no --iso");
+            runner.skip(sectorName, "no --iso");
+            return;
+        }
+        SacdRecording rec = recordSacd(opt);
+        if (!rec.error.empty()) {
+            runner.skip(dstName, rec.error.c_str());
+            runner.skip(sectorName, rec.error.c_str());
+            return;
+        }
+
+        // 扇区 -> 帧：与 scarletbook_output 相同，每次最多 MAX_PROCESSING_BLOCK_SIZE 个扇区
+        SacdHandles handles;
+        if (SacdHandoff::open(opt.isoPath, {}, handles)) {
+            int sectors = (int) (rec.sectors.size() / SACD_LSN_SIZE);
+            int64_t frames = 0;
+            char name[128];
+            snprintf(name, sizeof(name), "%s/%dch/%s", sectorName, rec.channelCount, rec.dst ? "DST" : "DSD");
+            runner.run(name, (int64_t) rec.sectors.size(), [&] {
+                scarletbook_frame_init(handles.handle);
+                for (int i = 0; i < sectors; i += MAX_PROCESSING_BLOCK_SIZE) {
+                    int blocks = std::min(MAX_PROCESSING_BLOCK_SIZE, sectors - i);
+                    scarletbook_process_frames(handles.handle, rec.sectors.data() + (size_t) i * SACD_LSN_SIZE,
+                                               blocks, i + blocks >= sectors, countFrame, &frames);
+                }
+            });
+            SacdHandoff::close(handles);
+        }
+
+        if (!rec.dst) {
+            runner.skip(dstName, "track is not DST coded");
+            return;
+        }
+        // 单线程逐帧解码，吞吐按输出的 DSD 字节计
+        auto *decoder = new ebunch();
+        if (DST_InitDecoder(decoder, rec.channelCount, 64) != 0) {
+            runner.skip(dstName, "DST_InitDecoder failed");
+            delete decoder;
+            return;
+        }
+        std::vector<uint8_t> out((size_t) DSD64_FRAME_BYTES * rec.channelCount);
+        size_t index = 0;
+        int errors = 0;
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%dch", dstName, rec.channelCount);
+        runner.run(name, (int64_t) out.size(), [&] {
+            std::vector<uint8_t> &frame = rec.frames[index];
+            if (DST_FramDSTDecode(frame.data(), out.data(), (int) frame.size(), (int) index, decoder) != 0) {
+                errors++;
+            }
+            index = (index + 1) % rec.frames.size();
+        });
+        if (errors > 0) fprintf(stderr, "qybench: %d DST frame errors\n", errors);
+        DST_CloseDecoder(decoder);
+        delete decoder;
+    }
+
+    void usage() {
+        fprintf(stderr,
+                "usage: qybench [options]\n"
+                "  --filter REGEX       run benchmarks whose name matches\n"
+                "  --min-time SEC       time per repetition (default 0.5)\n"
+                "  --repetitions N      repetitions, median is reported (default 3)\n"
+                "  --json FILE          write Google Benchmark style JSON (- for stdout)\n"
+                "  --iso PATH           SACD image for DST / sector benchmarks\n"
+                "  --track N            track to record sectors from (default 0)\n"
+                "  --sectors N          sectors to record (default 3000)\n");
+    }
+
+    bool parseOptions(int argc, char **argv, Options &opt) {
+        enum {
+            OPT_FILTER = 256, OPT_MIN_TIME, OPT_REPETITIONS, OPT_JSON, OPT_ISO, OPT_TRACK, OPT_SECTORS
+        };
+        static const struct option longOptions[] = {
+                {"filter",      required_argument, nullptr, OPT_FILTER},
+                {"min-time",    required_argument, nullptr, OPT_MIN_TIME},
+                {"repetitions", required_argument, nullptr, OPT_REPETITIONS},
+                {"json",        required_argument, nullptr, OPT_JSON},
+                {"iso",         required_argument, nullptr, OPT_ISO},
+                {"track",       required_argument, nullptr, OPT_TRACK},
+                {"sectors",     required_argument, nullptr, OPT_SECTORS},
+                {"help",        no_argument,       nullptr, 'h'},
+                {nullptr, 0,                       nullptr, 0}
+        };
+        int c;
+        while ((c = getopt_long(argc, argv, "h", longOptions, nullptr)) != -1) {
+            switch (c) {
+                case OPT_FILTER: opt.filter = optarg; break;
+                case OPT_MIN_TIME: opt.minTimeSec = std::max(0.01, atof(optarg)); break;
+                case OPT_REPETITIONS: opt.repetitions = std::max(1, atoi(optarg)); break;
+                case OPT_JSON: opt.jsonPath = optarg; break;
+                case OPT_ISO: opt.isoPath = optarg; break;
+                case OPT_TRACK: opt.track = atoi(optarg); break;
+                case OPT_SECTORS: opt.recordSectors = std::max(MAX_PROCESSING_BLOCK_SIZE, atoi(optarg)); break;
+                default: return false;
+            }
+        }
+        return optind == argc;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    av_log_set_level(AV_LOG_ERROR);
+    Runner runner(opt);
+    runner.printHeader();
+    benchDsdUtils(runner);
+    benchD2p(runner);
+    benchSwr(runner);
+    benchSacd(runner, opt);
+
+    if (!opt.jsonPath.empty() && !runner.writeJson(opt.jsonPath, argv)) {
+        fprintf(stderr, "qybench: cannot write %s\n", opt.jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,943 @@
+/**
+ * qycorpus: 端到端回归语料，逐字节校验播放输出
+ *
+ * 生成一组确定性的测试文件 (WAV / FLAC / MP3 / DSF / DFF 与一张合成的两轨 SACD 镜像，未压缩与 DST 各一张)，
+ * 按不同的 DsdMode / 输出编码 / 声道限制经 FFPlayer、SacdPlayer 播放，
+ * 对 onAudioData 的输出流求 MD5，与黄金值文件逐条比较 (格式、字节数、MD5 都需一致)。
+ * SIMD、多线程、零拷贝等优化改动后运行一次，任何输出变化都会报告为 FAIL。
+ *
+ * 测试信号全部由整数运算产生 (三角波 + LCG 噪声，DSD 由二阶 Sigma-Delta 调制)，
+ * DSF / DFF / SACD 镜像由本工具直接写出，FLAC / MP3 经 libavcodec 编码。
+ * 黄金值与 FFmpeg 版本、编译器和 CPU 架构相关，更换环境后用 --update 重新生成并人工确认差异。
+ * 基线已有的用例 (自动编码、播放区间、DSD 三种输出模式、两张 SACD 镜像) 的黄金值与优化前的基线输出一致，
+ * 更新黄金值时应以基线构建交叉核对这些用例；输出编码与声道限制用例只能由引入该功能后的代码生成。
+ *
+ * 输出：每个用例一行 PASS / FAIL / NEW / ERROR，存在 FAIL / NEW / ERROR 时退出码为 1。
+ *
+ * 示例：
+ *   qycorpus --golden tools/qycorpus.golden
+ *   qycorpus --golden tools/qycorpus.golden --filter 'iso|dsf'
+ *   qycorpus --golden tools/qycorpus.golden --update
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <endian.h>
+#include <getopt.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <regex>
+#include <algorithm>
+#include "FFPlayer.h"
+#include "SacdPlayer.h"
+
+extern "C" {
+#include <libavutil/md5.h>
+#include <libavutil/opt.h>
+#include <libavutil/channel_layout.h>
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+#include "scarletbook.h"
+}
+
+// libcommon/utils.h 的 min/max 宏会破坏 std::min/std::max
+#undef min
+#undef max
+
+// DSD64 采样率与一个 SACD 帧 (1/75 秒) 单声道的字节数
+#define DSD64_RATE 2822400
+#define DSD64_FRAME_BYTES 4704
+
+namespace {
+
+    struct Options {
+        std::string dir = "/tmp/qycorpus";
+        std::string golden;
+        std::string filter;
+        bool update = false;
+        bool list = false;
+    };
+
+    // ========= 确定性测试信号 =========
+
+    int32_t triangle(int64_t n, int64_t period, int32_t amplitude) {
+        int64_t half = period / 2;
+        int64_t phase = n % period;
+        if (phase < half) return (int32_t) (-amplitude + 2 * (int64_t) amplitude * phase / half);
+        return (int32_t) (amplitude - 2 * (int64_t) amplitude * (phase - half) / (period - half));
+    }
+
+    /**
+     * 交错的 24 bit 整数 PCM (值域 ±2^23)：每声道两路频率不同的三角波加低电平噪声
+     */
+    std::vector<int32_t> makePcm(int sampleRate, int channels, int frames) {
+        std::vector<int32_t> pcm((size_t) frames * channels);
+        uint32_t lcg = 12345;
+        for (int n = 0; n < frames; n++) {
+            for (int ch = 0; ch < channels; ch++) {
+                lcg = lcg * 1664525u + 1013904223u;
+                int32_t noise = (int32_t) (lcg >> 20) - 2048;
+                pcm[(size_t) n * channels + ch] =
+                        triangle(n, sampleRate / (440 + 110 * ch), 5000000) +
+                        triangle(n, sampleRate / (3000 + 500 * ch), 2000000) + noise;
+            }
+        }
+        return pcm;
+    }
+
+    /**
+     * 每声道一路 DSD64 比特流 (MSB 在前，与 DFF / SACD 一致)，由二阶 Sigma-Delta 调制三角波得到
+     */
+    std::vector<std::vector<uint8_t>> makeDsd(int channels, int bytesPerChannel) {
+        const int64_t fullScale = 1 << 23;
+        std::vector<std::vector<uint8_t>> out(channels, std::vector<uint8_t>(bytesPerChannel));
+        for (int ch = 0; ch < channels; ch++) {
+            int64_t integrator1 = 0, integrator2 = 0, feedback = -fullScale;
+            for (int i = 0; i < bytesPerChannel; i++) {
+                uint8_t byte = 0;
+                for (int bit = 0; bit < 8; bit++) {
+                    int64_t n = (int64_t) i * 8 + bit;
+                    int64_t x = triangle(n, DSD64_RATE / (1000 + 500 * ch), (int32_t) (fullScale / 4)) +
+                                triangle(n, DSD64_RATE / 97, (int32_t) (fullScale / 8));
+                    integrator1 += x - feedback;
+                    integrator2 += integrator1 - feedback;
+                    feedback = integrator2 >= 0 ? fullScale : -fullScale;
+                    byte = (uint8_t) (byte << 1 | (feedback > 0));
+                }
+                out[ch][i] = byte;
+            }
+        }
+        return out;
+    }
+
+    // ========= 文件写入 =========
+
+    void putLe(std::vector<uint8_t> &buf, uint64_t value, int bytes) {
+        for (int i = 0; i < bytes; i++) buf.push_back((uint8_t) (value >> (8 * i)));
+    }
+
+    void putBe(std::vector<uint8_t> &buf, uint64_t value, int bytes) {
+        for (int i = bytes - 1; i >= 0; i--) buf.push_back((uint8_t) (value >> (8 * i)));
+    }
+
+    void putTag(std::vector<uint8_t> &buf, const char *tag) {
+        buf.insert(buf.end(), tag, tag + 4);
+    }
+
+    bool writeFile(const std::string &path, const std::vector<uint8_t> &data) {
+        FILE *fp = fopen(path.c_str(), "wb");
+        if (!fp) return false;
+        bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+        return fclose(fp) == 0 && ok;
+    }
+
+    /**
+     * @param bits 16 / 24 为整数 PCM，32 为 IEEE float
+     */
+    bool writeWav(const std::string &path, const std::vector<int32_t> &pcm, int sampleRate, int channels,
+                  int bits) {
+        int bytesPerSample = bits / 8;
+        uint32_t dataSize = (uint32_t) (pcm.size() * bytesPerSample);
+        std::vector<uint8_t> buf;
+        putTag(buf, "RIFF");
+        putLe(buf, 36 + dataSize, 4);
+        putTag(buf, "WAVE");
+        putTag(buf, "fmt ");
+        putLe(buf, 16, 4);
+        putLe(buf, bits == 32 ? 3 : 1, 2);
+        putLe(buf, channels, 2);
+        putLe(buf, sampleRate, 4);
+        putLe(buf, (uint64_t) sampleRate * channels * bytesPerSample, 4);
+        putLe(buf, channels * bytesPerSample, 2);
+        putLe(buf, bits, 2);
+        putTag(buf, "data");
+        putLe(buf, dataSize, 4);
+        for (int32_t sample: pcm) {
+            if (bits == 16) {
+                putLe(buf, (uint16_t) (sample >> 8), 2);
+            } else if (bits == 24) {
+                putLe(buf, (uint32_t) sample, 3);
+            } else {
+                float value = (float) sample / (float) (1 << 23);
+                uint32_t raw;
+                memcpy(&raw, &value, 4);
+                putLe(buf, raw, 4);
+            }
+        }
+        return writeFile(path, buf);
+    }
+
+    /**
+     * 经 libavcodec 编码为 FLAC / MP3，容器由扩展名决定
+     * @param bits FLAC 的有效位深 (16 / 24)，MP3 忽略
+     */
+    bool encodeFile(const std::string &path, const char *encoderName, const std::vector<int32_t> &pcm,
+                    int sampleRate, int channels, int bits) {
+        const AVCodec *codec = avcodec_find_encoder_by_name(encoderName);
+        if (!codec) return false;
+
+        AVFormatContext *oc = nullptr;
+        if (avformat_alloc_output_context2(&oc, nullptr, nullptr, path.c_str()) < 0) return false;
+        oc->flags |= AVFMT_FLAG_BITEXACT;
+        AVStream *stream = avformat_new_stream(oc, nullptr);
+        AVCodecContext *ctx = avcodec_alloc_context3(codec);
+        bool ok = false;
+        AVFrame *frame = nullptr;
+        AVPacket *pkt = nullptr;
+        do {
+            if (!stream || !ctx) break;
+            bool planar = strcmp(encoderName, "libmp3lame") == 0;
+            ctx->sample_fmt = planar ? AV_SAMPLE_FMT_S16P : (bits > 16 ? AV_SAMPLE_FMT_S32 : AV_SAMPLE_FMT_S16);
+            ctx->bits_per_raw_sample = planar ? 0 : bits;
+            ctx->sample_rate = sampleRate;
+            ctx->time_base = {1, sampleRate};
+            ctx->flags |= AV_CODEC_FLAG_BITEXACT;
+            if (planar) ctx->bit_rate = 192000;
+            av_channel_layout_default(&ctx->ch_layout, channels);
+            if (oc->oformat->flags & AVFMT_GLOBALHEADER) ctx->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+            if (avcodec_open2(ctx, codec, nullptr) < 0) break;
+            if (avcodec_parameters_from_context(stream->codecpar, ctx) < 0) break;
+            stream->time_base = ctx->time_base;
+            if (avio_open(&oc->pb, path.c_str(), AVIO_FLAG_WRITE) < 0) break;
+            if (avformat_write_header(oc, nullptr) < 0) break;
+
+            frame = av_frame_alloc();
+            pkt = av_packet_alloc();
+            int frameSize = ctx->frame_size > 0 ? ctx->frame_size : 4096;
+            int totalFrames = (int) (pcm.size() / channels);
+            bool failed = false;
+            for (int pos = 0; !failed; pos += frameSize) {
+                // 数据送完后再送一次 nullptr 冲刷编码器
+                int count = std::max(0, std::min(frameSize, totalFrames - pos));
+                int ret;
+                if (count > 0) {
+                    av_frame_unref(frame);
+                    frame->format = ctx->sample_fmt;
+                    frame->sample_rate = sampleRate;
+                    frame->nb_samples = count;
+                    frame->pts = pos;
+                    av_channel_layout_copy(&frame->ch_layout, &ctx->ch_layout);
+                    if (av_frame_get_buffer(frame, 0) < 0) {
+                        failed = true;
+                        break;
+                    }
+                    for (int n = 0; n < count; n++) {
+                        for (int ch = 0; ch < channels; ch++) {
+                            int32_t sample = pcm[(size_t) (pos + n) * channels + ch];
+                            if (planar) {
+                                ((int16_t *) frame->data[ch])[n] = (int16_t) (sample >> 8);
+                            } else if (bits > 16) {
+                                ((int32_t *) frame->data[0])[n * channels + ch] = (int32_t) ((uint32_t) sample << 8);
+                            } else {
+                                ((int16_t *) frame->data[0])[n * channels + ch] = (int16_t) (sample >> 8);
+                            }
+                        }
+                    }
+                    ret = avcodec_send_frame(ctx, frame);
+                } else {
+                    ret = avcodec_send_frame(ctx, nullptr);
+                }
+                if (ret < 0) failed = true;
+                while (!failed && (ret = avcodec_receive_packet(ctx, pkt)) >= 0) {
+                    av_packet_rescale_ts(pkt, ctx->time_base, stream->time_base);
+                    pkt->stream_index = stream->index;
+                    if (av_interleaved_write_frame(oc, pkt) < 0) failed = true;
+                }
+                if (count <= 0) break;
+            }
+            if (failed) break;
+            ok = av_write_trailer(oc) == 0;
+        } while (false);
+
+        av_packet_free(&pkt);
+        av_frame_free(&frame);
+        avcodec_free_context(&ctx);
+        if (oc->pb) avio_closep(&oc->pb);
+        avformat_free_context(oc);
+        return ok;
+    }
+
+    uint8_t reverseBits(uint8_t b) {
+        b = (uint8_t) ((b & 0xF0) >> 4 | (b & 0x0F) << 4);
+        b = (uint8_t) ((b & 0xCC) >> 2 | (b & 0x33) << 2);
+        return (uint8_t) ((b & 0xAA) >> 1 | (b & 0x55) << 1);
+    }
+
+    // DSF：小端，每声道 4096 字节一块交替存放，LSB 在前，末块补零
+    bool writeDsf(const std::string &path, const std::vector<std::vector<uint8_t>> &dsd) {
+        const int blockSize = 4096;
+        int channels = (int) dsd.size();
+        size_t bytesPerChannel = dsd[0].size();
+        size_t blocks = (bytesPerChannel + blockSize - 1) / blockSize;
+        uint64_t dataSize = (uint64_t) blocks * blockSize * channels;
+        uint64_t fileSize = 28 + 52 + 12 + dataSize;
+
+        std::vector<uint8_t> buf;
+        putTag(buf, "DSD ");
+        putLe(buf, 28, 8);
+        putLe(buf, fileSize, 8);
+        putLe(buf, 0, 8);                      // 无 ID3 元数据
+        putTag(buf, "fmt ");
+        putLe(buf, 52, 8);
+        putLe(buf, 1, 4);                      // 格式版本
+        putLe(buf, 0, 4);                      // DSD raw
+        putLe(buf, channels == 2 ? 2 : 1, 4);  // 声道类型
+        putLe(buf, channels, 4);
+        putLe(buf, DSD64_RATE, 4);
+        putLe(buf, 1, 4);
+        putLe(buf, (uint64_t) bytesPerChannel * 8, 8);
+        putLe(buf, blockSize, 4);
+        putLe(buf, 0, 4);
+        putTag(buf, "data");
+        putLe(buf, 12 + dataSize, 8);
+        for (size_t block = 0; block < blocks; block++) {
+            for (int ch = 0; ch < channels; ch++) {
+                for (int i = 0; i < blockSize; i++) {
+                    size_t pos = block * blockSize + i;
+                    buf.push_back(pos < bytesPerChannel ? reverseBits(dsd[ch][pos]) : 0);
+                }
+            }
+        }
+        return writeFile(path, buf);
+    }
+
+    // DSDIFF：大端 IFF，逐字节交错，MSB 在前
+    bool writeDff(const std::string &path, const std::vector<std::vector<uint8_t>> &dsd) {
+        int channels = (int) dsd.size();
+        size_t bytesPerChannel = dsd[0].size();
+        uint64_t dataSize = (uint64_t) bytesPerChannel * channels;
+        static const char *channelIds[] = {"SLFT", "SRGT"};
+        static const char compression[] = "not compressed";
+        int compressionSize = 4 + 1 + (int) strlen(compression);
+
+        std::vector<uint8_t> prop;
+        putTag(prop, "SND ");
+        putTag(prop, "FS  ");
+        putBe(prop, 4, 8);
+        putBe(prop, DSD64_RATE, 4);
+        putTag(prop, "CHNL");
+        putBe(prop, 2 + 4 * channels, 8);
+        putBe(prop, channels, 2);
+        for (int ch = 0; ch < channels; ch++) putTag(prop, channelIds[ch]);
+        putTag(prop, "CMPR");
+        putBe(prop, compressionSize, 8);
+        putTag(prop, "DSD ");
+        prop.push_back((uint8_t) strlen(compression));
+        prop.insert(prop.end(), compression, compression + strlen(compression));
+        if (compressionSize & 1) prop.push_back(0);
+
+        std::vector<uint8_t> buf;
+        putTag(buf, "FRM8");
+        putBe(buf, 4 + (12 + 4) + (12 + prop.size()) + (12 + dataSize), 8);
+        putTag(buf, "DSD ");
+        putTag(buf, "FVER");
+        putBe(buf, 4, 8);
+        putBe(buf, 0x01050000, 4);
+        putTag(buf, "PROP");
+        putBe(buf, prop.size(), 8);
+        buf.insert(buf.end(), prop.begin(), prop.end());
+        putTag(buf, "DSD ");
+        putBe(buf, dataSize, 8);
+        for (size_t i = 0; i < bytesPerChannel; i++) {
+            for (int ch = 0; ch < channels; ch++) buf.push_back(dsd[ch][i]);
+        }
+        return writeFile(path, buf);
+    }
+
+    // ========= 合成 SACD 镜像 =========
+
+    // 镜像内的扇区位置
+    enum {
+        ISO_AREA_TOC_LSN = 540,
+        ISO_AREA_TOC_SIZE = 3,        // TWOCHTOC, SACDTRL1, SACDTRL2
+        ISO_AUDIO_START_LSN = 600
+    };
+
+    void setTimecode(area_tracklist_time_t &time, int frames) {
+        time.minutes = (uint8_t) (frames / (60 * SACD_FRAME_RATE));
+        time.seconds = (uint8_t) (frames / SACD_FRAME_RATE % 60);
+        time.frames = (uint8_t) (frames % SACD_FRAME_RATE);
+    }
+
+    struct AudioPacket {
+        bool frameStart;
+        int frameIndex;
+        const uint8_t *data;
+        int length;
+    };
+
+    /**
+     * 把若干个音频帧打包为音频扇区：
+     * 扇区头 1 字节 + 包信息 2 字节/包 + 帧信息 3 字节 (DST 为 4 字节)/帧起始 + 包数据，每扇区最多 7 个包
+     * 各轨从新扇区开始，扇区尾部剩余空间留零
+     * @param frames 未压缩时每帧为双声道逐字节交错的 2 * 4704 字节；DST 时为编码后的帧，长度不定
+     * @param dst    DST 帧信息的第 4 字节记录该帧的包数 (libsacd 按包递减，归零即帧完整)
+     */
+    void packAudioSectors(std::vector<uint8_t> &iso, const std::vector<std::vector<uint8_t>> &frames,
+                          int firstFrame, bool dst) {
+        const int frameInfoSize = dst ? AUDIO_FRAME_INFO_SIZE : AUDIO_FRAME_INFO_SIZE - 1;
+        const int frameCount = (int) frames.size();
+        std::vector<std::vector<AudioPacket>> sectors;
+        std::vector<int> packetCount(frameCount, 0);
+        int frame = 0;
+        int offset = 0;
+        while (frame < frameCount) {
+            std::vector<AudioPacket> packets;
+            int used = AUDIO_SECTOR_HEADER_SIZE;
+            int frameStarts = 0;
+            while (frame < frameCount && packets.size() < 7) {
+                const int frameBytes = (int) frames[frame].size();
+                bool start = offset == 0;
+                int overhead = AUDIO_PACKET_INFO_SIZE + (start ? frameInfoSize : 0);
+                int room = SACD_LSN_SIZE - used - overhead;
+                if (room <= 0 || (start && frameStarts == 7)) break;
+                int length = std::min({frameBytes - offset, room, (int) MAX_PACKET_SIZE});
+                packets.push_back({start, firstFrame + frame, frames[frame].data() + offset, length});
+                packetCount[frame]++;
+                used += overhead + length;
+                if (start) frameStarts++;
+                offset += length;
+                if (offset == frameBytes) {
+                    frame++;
+                    offset = 0;
+                }
+            }
+            sectors.push_back(packets);
+        }
+
+        for (const auto &packets: sectors) {
+            int frameStarts = 0;
+            for (const AudioPacket &packet: packets) frameStarts += packet.frameStart;
+            size_t base = iso.size();
+            iso.resize(base + SACD_LSN_SIZE, 0);
+            uint8_t *p = iso.data() + base;
+            // 小端位域：bit0 dst_encoded，bit2-4 frame_info_count，bit5-7 packet_info_count
+            *p++ = (uint8_t) ((dst ? 1 : 0) | frameStarts << 2 | packets.size() << 5);
+            for (const AudioPacket &packet: packets) {
+                *p++ = (uint8_t) ((packet.frameStart ? 0x80 : 0) | DATA_TYPE_AUDIO << 3 | packet.length >> 8);
+                *p++ = (uint8_t) (packet.length & 0xFF);
+            }
+            for (const AudioPacket &packet: packets) {
+                if (!packet.frameStart) continue;
+                area_tracklist_time_t time{};
+                setTimecode(time, packet.frameIndex);
+                *p++ = time.minutes;
+                *p++ = time.seconds;
+                *p++ = time.frames;
+                // 小端位域：bit0-1 声道位 (双声道为 0)，bit2-6 sector_count
+                if (dst) *p++ = (uint8_t) (packetCount[packet.frameIndex - firstFrame] << 2);
+            }
+            for (const AudioPacket &packet: packets) {
+                memcpy(p, packet.data, packet.length);
+                p += packet.length;
+            }
+        }
+    }
+
+    /**
+     * 双声道区域的最小 Scarletbook 镜像
+     * 未压缩时为 FRAME_FORMAT_DSD_3_IN_14；DST 时为 FRAME_FORMAT_DST，每帧以 DST 的"未编码"形式写出
+     * (首字节 DST_Coded = 0 与 7 位零填充，其后为原始交错 DSD)，解码输出与未压缩镜像逐字节一致，
+     * 但读取经过 DST 扇区解析与 libdstdec 的解码线程
+     * @param trackFrames 各轨的帧数，按顺序切分 dsd
+     */
+    bool writeSacdIso(const std::string &path, const std::vector<std::vector<uint8_t>> &dsd,
+                      const std::vector<int> &trackFrames, bool dst = false) {
+        int totalFrames = 0;
+        for (int frames: trackFrames) totalFrames += frames;
+        if ((size_t) totalFrames * DSD64_FRAME_BYTES > dsd[0].size()) return false;
+
+        std::vector<std::vector<uint8_t>> audioFrames(totalFrames);
+        for (int f = 0; f < totalFrames; f++) {
+            std::vector<uint8_t> &out = audioFrames[f];
+            if (dst) out.push_back(0);
+            for (size_t i = (size_t) f * DSD64_FRAME_BYTES; i < (size_t) (f + 1) * DSD64_FRAME_BYTES; i++) {
+                out.push_back(dsd[0][i]);
+                out.push_back(dsd[1][i]);
+            }
+        }
+
+        std::vector<uint8_t> iso((size_t) ISO_AUDIO_START_LSN * SACD_LSN_SIZE, 0);
+        std::vector<uint32_t> trackStart, trackLength;
+        int frame = 0;
+        for (int frames: trackFrames) {
+            size_t startLsn = iso.size() / SACD_LSN_SIZE;
+            packAudioSectors(iso, std::vector<std::vector<uint8_t>>(
+                    audioFrames.begin() + frame, audioFrames.begin() + frame + frames), frame, dst);
+            trackStart.push_back((uint32_t) startLsn);
+            trackLength.push_back((uint32_t) (iso.size() / SACD_LSN_SIZE - startLsn));
+            frame += frames;
+        }
+        uint32_t trackEnd = (uint32_t) (iso.size() / SACD_LSN_SIZE - 1);
+        uint8_t *sector = iso.data();
+
+        // Master TOC + 8 个 SACDText + SACD_Man
+        auto *master = (master_toc_t *) (sector + START_OF_MASTER_TOC * SACD_LSN_SIZE);
+        memcpy(master->id, "SACDMTOC", 8);
+        master->version.major = 1;
+        master->version.minor = 20;
+        master->album_set_size = htobe16(1);
+        master->album_sequence_number = htobe16(1);
+        master->area_1_toc_1_start = htobe32(ISO_AREA_TOC_LSN);
+        master->area_1_toc_size = htobe16(ISO_AREA_TOC_SIZE);
+        master->text_area_count = 1;
+        memcpy(master->locales[0].language_code, "en", 2);
+        master->locales[0].character_set = 2;
+        for (int i = 0; i < MAX_LANGUAGE_COUNT; i++) {
+            memcpy(sector + (START_OF_MASTER_TOC + 1 + i) * SACD_LSN_SIZE, "SACDText", 8);
+        }
+        memcpy(sector + (START_OF_MASTER_TOC + 1 + MAX_LANGUAGE_COUNT) * SACD_LSN_SIZE, "SACD_Man", 8);
+
+        auto *area = (area_toc_t *) (sector + ISO_AREA_TOC_LSN * SACD_LSN_SIZE);
+        memcpy(area->id, "TWOCHTOC", 8);
+        area->version.major = 1;
+        area->version.minor = 20;
+        area->size = htobe16(ISO_AREA_TOC_SIZE);
+        area->max_byte_rate = htobe32(DSD64_RATE * 2 / 8);
+        area->sample_frequency = 4;
+        area->frame_format = dst ? FRAME_FORMAT_DST : FRAME_FORMAT_DSD_3_IN_14;
+        area->channel_count = 2;
+        area->max_available_channels = 2;
+        area->track_count = (uint8_t) trackFrames.size();
+        area->track_start = htobe32(trackStart.front());
+        area->track_end = htobe32(trackEnd);
+        area->total_playtime.minutes = (uint8_t) (totalFrames / (60 * SACD_FRAME_RATE));
+        area->total_playtime.seconds = (uint8_t) (totalFrames / SACD_FRAME_RATE % 60);
+        area->total_playtime.frames = (uint8_t) (totalFrames % SACD_FRAME_RATE);
+        memcpy(area->languages[0].language_code, "en", 2);
+        area->languages[0].character_set = 2;
+
+        auto *offsets = (area_tracklist_offset_t *) (sector + (ISO_AREA_TOC_LSN + 1) * SACD_LSN_SIZE);
+        memcpy(offsets->id, "SACDTRL1", 8);
+        auto *times = (area_tracklist_t *) (sector + (ISO_AREA_TOC_LSN + 2) * SACD_LSN_SIZE);
+        memcpy(times->id, "SACDTRL2", 8);
+        frame = 0;
+        for (size_t i = 0; i < trackFrames.size(); i++) {
+            offsets->track_start_lsn[i] = htobe32(trackStart[i]);
+            offsets->track_length_lsn[i] = htobe32(trackLength[i]);
+            setTimecode(times->start[i], frame);
+            setTimecode(times->duration[i], trackFrames[i]);
+            frame += trackFrames[i];
+        }
+        return writeFile(path, iso);
+    }
+
+    // ========= 语料与用例 =========
+
+    struct Case {
+        std::string name;
+        std::string file;
+        int track = 0;                          // 仅 SACD
+        DsdMode dsdMode = DSD_MODE_NATIVE;
+        int d2pRate = -1;
+        PcmEncoding encoding = PCM_ENCODING_AUTO;
+        int maxChannels = 2;
+        int64_t startMs = 0;
+        int64_t endMs = -1;
+    };
+
+    bool isSacd(const Case &c) {
+        return c.file.size() > 4 && c.file.compare(c.file.size() - 4, 4, ".iso") == 0;
+    }
+
+    /**
+     * 生成全部语料文件
+     * @return 生成失败的文件名 (编码器缺失等)，对应用例记为 ERROR
+     */
+    std::vector<std::string> generateCorpus(const std::string &dir) {
+        std::vector<std::string> failed;
+        auto check = [&](bool ok, const char *file) {
+            if (!ok) failed.emplace_back(file);
+        };
+
+        std::vector<int32_t> pcm44 = makePcm(44100, 2, 44100 * 2);
+        std::vector<int32_t> pcm96 = makePcm(96000, 2, 96000);
+        std::vector<int32_t> pcm48x6 = makePcm(48000, 6, 48000);
+        check(writeWav(dir + "/s16_44k.wav", pcm44, 44100, 2, 16), "s16_44k.wav");
+        check(writeWav(dir + "/s24_96k.wav", pcm96, 96000, 2, 24), "s24_96k.wav");
+        check(writeWav(dir + "/f32_96k.wav", pcm96, 96000, 2, 32), "f32_96k.wav");
+        check(encodeFile(dir + "/s16_44k.flac", "flac", pcm44, 44100, 2, 16), "s16_44k.flac");
+        check(encodeFile(dir + "/s24_96k.flac", "flac", pcm96, 96000, 2, 24), "s24_96k.flac");
+        check(encodeFile(dir + "/s24_48k_6ch.flac", "flac", pcm48x6, 48000, 6, 24), "s24_48k_6ch.flac");
+        check(encodeFile(dir + "/s16_44k.mp3", "libmp3lame", pcm44, 44100, 2, 16), "s16_44k.mp3");
+
+        // 2 秒 DSD64 = 150 个 SACD 帧；镜像切分为 90 + 60 帧两轨
+        std::vector<std::vector<uint8_t>> dsd = makeDsd(2, DSD64_FRAME_BYTES * 150);
+        check(writeDsf(dir + "/dsd64.dsf", dsd), "dsd64.dsf");
+        check(writeDff(dir + "/dsd64.dff", dsd), "dsd64.dff");
+        check(writeSacdIso(dir + "/dsd64.iso", dsd, {90, 60}), "dsd64.iso");
+        check(writeSacdIso(dir + "/dst64.iso", dsd, {90, 60}, true), "dst64.iso");
+        return failed;
+    }
+
+    std::vector<Case> buildCases(const std::string &dir) {
+        std::vector<Case> cases;
+        static const struct {
+            const char *name;
+            PcmEncoding encoding;
+        } encodings[] = {
+                {"auto",  PCM_ENCODING_AUTO},
+                {"s16",   PCM_ENCODING_16BIT},
+                {"s24",   PCM_ENCODING_24BIT_PACKED},
+                {"s32",   PCM_ENCODING_32BIT},
+                {"float", PCM_ENCODING_FLOAT},
+        };
+
+        // PCM：WAV / FLAC 覆盖全部输出编码，其余使用自动编码
+        for (const char *file: {"s16_44k.wav", "s24_96k.wav", "s24_96k.flac"}) {
+            for (const auto &encoding: encodings) {
+                Case c;
+                c.name = std::string(file) + "/" + encoding.name;
+                c.file = dir + "/" + file;
+                c.encoding = encoding.encoding;
+                cases.push_back(c);
+            }
+        }
+        for (const char *file: {"f32_96k.wav", "s16_44k.flac", "s16_44k.mp3"}) {
+            Case c;
+            c.name = std::string(file) + "/auto";
+            c.file = dir + "/" + file;
+            cases.push_back(c);
+        }
+        {
+            // 多声道：下混为双声道 / 原样输出
+            Case c;
+            c.file = dir + "/s24_48k_6ch.flac";
+            c.name = "s24_48k_6ch.flac/2ch";
+            cases.push_back(c);
+            c.name = "s24_48k_6ch.flac/6ch";
+            c.maxChannels = 6;
+            cases.push_back(c);
+        }
+        {
+            // 播放区间 (CUE 分轨的路径)
+            Case c;
+            c.name = "s16_44k.flac/range";
+            c.file = dir + "/s16_44k.flac";
+            c.startMs = 500;
+            c.endMs = 1500;
+            cases.push_back(c);
+        }
+
+        // DSD：三种输出模式，D2P 覆盖多个目标采样率
+        static const struct {
+            const char *name;
+            DsdMode mode;
+            int d2pRate;
+        } dsdModes[] = {
+                {"native",  DSD_MODE_NATIVE, -1},
+                {"dop",     DSD_MODE_DOP,    -1},
+                {"d2p88",   DSD_MODE_D2P,    88200},
+                {"d2p176",  DSD_MODE_D2P,    176400},
+                {"d2p352",  DSD_MODE_D2P,    352800},
+        };
+        for (const char *file: {"dsd64.dsf", "dsd64.dff"}) {
+            for (const auto &mode: dsdModes) {
+                Case c;
+                c.name = std::string(file) + "/" + mode.name;
+                c.file = dir + "/" + file;
+                c.dsdMode = mode.mode;
+                c.d2pRate = mode.d2pRate;
+                cases.push_back(c);
+            }
+        }
+        // SACD：未压缩与 DST 两张镜像内容相同，对应用例的输出应一致
+        for (const char *file: {"dsd64.iso", "dst64.iso"}) {
+            for (int track = 0; track < 2; track++) {
+                for (const auto &mode: dsdModes) {
+                    if (mode.mode == DSD_MODE_D2P && mode.d2pRate != 176400) continue;
+                    Case c;
+                    c.name = std::string(file) + "/t" + std::to_string(track) + "/" + mode.name;
+                    c.file = dir + "/" + file;
+                    c.track = track;
+                    c.dsdMode = mode.mode;
+                    c.d2pRate = mode.d2pRate;
+                    cases.push_back(c);
+                }
+            }
+        }
+        return cases;
+    }
+
+    // ========= 播放与哈希 =========
+
+    struct Result {
+        bool ok = false;
+        std::string error;
+        int sampleRate = 0;
+        int channels = 0;
+        int bits = 0;
+        int64_t bytes = 0;
+        std::string md5;
+    };
+
+    class HashCallback : public IPlayerCallback {
+    public:
+        HashCallback() : mMd5(av_md5_alloc()) {
+            av_md5_init(mMd5);
+        }
+
+        ~HashCallback() override {
+            av_free(mMd5);
+        }
+
+        void onPrepared() override {}
+
+        void onAudioData(uint8_t *data, int size) override {
+            if (size <= 0) return;
+            std::lock_guard<std::mutex> lock(mMutex);
+            av_md5_update(mMd5, data, size);
+            mBytes += size;
+        }
+
+        void onComplete() override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompleted = true;
+            mCond.notify_all();
+        }
+
+        void onError(int code, const char *msg) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mError = true;
+            mErrorMessage = std::to_string(code) + " " + (msg ? msg : "");
+            mCond.notify_all();
+        }
+
+        void onProgress(int trackIndex, long currentMs, long totalMs, float progress) override {}
+
+        void onBuffering(bool buffering) override {}
+
+        bool waitDone(int timeoutMs) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                  [this] { return mCompleted || mError; });
+        }
+
+        int64_t getBytes() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mBytes;
+        }
+
+        std::string digest() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            uint8_t sum[16];
+            av_md5_final(mMd5, sum);
+            char hex[33];
+            for (int i = 0; i < 16; i++) snprintf(hex + i * 2, 3, "%02x", sum[i]);
+            return hex;
+        }
+
+        bool mError = false;
+        std::string mErrorMessage;
+
+    private:
+        AVMD5 *mMd5;
+        std::mutex mMutex;
+        std::condition_variable mCond;
+        int64_t mBytes = 0;
+        bool mCompleted = false;
+    };
+
+    Result runCase(const Case &c) {
+        Result result;
+        HashCallback callback;
+        BasePlayer *player;
+        bool sacd = isSacd(c);
+        if (sacd) {
+            auto *sacdPlayer = new SacdPlayer(&callback);
+            sacdPlayer->setDataSource(c.file, c.track);
+            player = sacdPlayer;
+        } else {
+            auto *ffPlayer = new FFPlayer(&callback);
+            ffPlayer->setDataSource(c.file.c_str(), {}, c.startMs, c.endMs);
+            player = ffPlayer;
+        }
+        player->setDsdConfig(c.dsdMode, c.d2pRate);
+        player->setOutputEncoding(c.encoding);
+        player->setMaxOutputChannels(c.maxChannels);
+
+        player->prepare();
+        if (player->getState() == STATE_ERROR) {
+            result.error = "prepare failed";
+        } else {
+            result.sampleRate = player->getSampleRate();
+            result.channels = player->getChannelCount();
+            result.bits = player->getBitPerSample();
+            player->play();
+            if (!callback.waitDone(60000)) {
+                result.error = "timeout";
+            } else if (callback.mError) {
+                result.error = "error " + callback.mErrorMessage;
+            } else {
+                if (sacd) {
+                    // SacdPlayer 在读取进度到达轨尾时即回调 onComplete，此时最后一个读块中的帧仍在送出：
+                    // 等输出静止后再停止，否则 stop() 会截断尾部
+                    int64_t last = -1;
+                    int stableMs = 0;
+                    while (stableMs < 300) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                        int64_t bytes = callback.getBytes();
+                        stableMs = bytes == last ? stableMs + 20 : 0;
+                        last = bytes;
+                    }
+                }
+                result.ok = true;
+            }
+        }
+        player->stop();
+        player->release();
+        delete player;
+        result.bytes = callback.getBytes();
+        result.md5 = callback.digest();
+        return result;
+    }
+
+    std::string formatEntry(const Result &result) {
+        char line[128];
+        snprintf(line, sizeof(line), "%d %d %d %lld %s", result.sampleRate, result.channels, result.bits,
+                 (long long) result.bytes, result.md5.c_str());
+        return line;
+    }
+
+    // 黄金值文件：每行 "用例名 采样率 声道 位深 字节数 md5"，# 开头为注释
+    std::map<std::string, std::string> loadGolden(const std::string &path) {
+        std::map<std::string, std::string> golden;
+        FILE *fp = fopen(path.c_str(), "r");
+        if (!fp) return golden;
+        char line[512];
+        while (fgets(line, sizeof(line), fp)) {
+            std::string text = line;
+            while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+            if (text.empty() || text[0] == '#') continue;
+            size_t space = text.find(' ');
+            if (space == std::string::npos) continue;
+            golden[text.substr(0, space)] = text.substr(space + 1);
+        }
+        fclose(fp);
+        return golden;
+    }
+
+    bool saveGolden(const std::string &path, const std::map<std::string, std::string> &golden) {
+        FILE *fp = fopen(path.c_str(), "w");
+        if (!fp) return false;
+        fprintf(fp, "# qycorpus golden output: name sample_rate channels bits bytes md5\n");
+        fprintf(fp, "# regenerate with: qycorpus --golden <this file> --update\n");
+        for (const auto &entry: golden) fprintf(fp, "%s %s\n", entry.first.c_str(), entry.second.c_str());
+        return fclose(fp) == 0;
+    }
+
+    void usage() {
+        fprintf(stderr,
+                "usage: qycorpus [options]\n"
+                "  --dir DIR         corpus directory (default /tmp/qycorpus)\n"
+                "  --golden FILE     golden hash file to compare against\n"
+                "  --update          write current results into the golden file\n"
+                "  --filter REGEX    run only matching cases\n"
+                "  --list            list cases and exit\n");
+    }
+
+    bool parseOptions(int argc, char **argv, Options &opt) {
+        enum {
+            OPT_DIR = 256, OPT_GOLDEN, OPT_UPDATE, OPT_FILTER, OPT_LIST
+        };
+        static const struct option longOptions[] = {
+                {"dir",    required_argument, nullptr, OPT_DIR},
+                {"golden", required_argument, nullptr, OPT_GOLDEN},
+                {"update", no_argument,       nullptr, OPT_UPDATE},
+                {"filter", required_argument, nullptr, OPT_FILTER},
+                {"list",   no_argument,       nullptr, OPT_LIST},
+                {"help",   no_argument,       nullptr, 'h'},
+                {nullptr, 0,                  nullptr, 0}
+        };
+
+        int c;
+        while ((c = getopt_long(argc, argv, "h", longOptions, nullptr)) != -1) {
+            switch (c) {
+                case OPT_DIR: opt.dir = optarg; break;
+                case OPT_GOLDEN: opt.golden = optarg; break;
+                case OPT_UPDATE: opt.update = true; break;
+                case OPT_FILTER: opt.filter = optarg; break;
+                case OPT_LIST: opt.list = true; break;
+                default: return false;
+            }
+        }
+        if (optind != argc) return false;
+        if (opt.update && opt.golden.empty()) return false;
+        return true;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+
+    std::vector<Case> cases = buildCases(opt.dir);
+    if (!opt.filter.empty()) {
+        std::regex re(opt.filter);
+        cases.erase(std::remove_if(cases.begin(), cases.end(),
+                                   [&](const Case &c) { return !std::regex_search(c.name, re); }),
+                    cases.end());
+    }
+    if (opt.list) {
+        for (const Case &c: cases) printf("%s\n", c.name.c_str());
+        return 0;
+    }
+
+    mkdir(opt.dir.c_str(), 0755);
+    std::vector<std::string> missing = generateCorpus(opt.dir);
+    for (const std::string &file: missing) fprintf(stderr, "qycorpus: cannot generate %s\n", file.c_str());
+
+    std::map<std::string, std::string> golden;
+    if (!opt.golden.empty()) golden = loadGolden(opt.golden);
+
+    int pass = 0, fail = 0, fresh = 0, errors = 0;
+    for (const Case &c: cases) {
+        std::string file = c.file.substr(c.file.rfind('/') + 1);
+        if (std::find(missing.begin(), missing.end(), file) != missing.end()) {
+            printf("ERROR %-28s corpus file missing\n", c.name.c_str());
+            errors++;
+            continue;
+        }
+        Result result = runCase(c);
+        if (!result.ok) {
+            printf("ERROR %-28s %s\n", c.name.c_str(), result.error.c_str());
+            errors++;
+            continue;
+        }
+        std::string entry = formatEntry(result);
+        auto it = golden.find(c.name);
+        if (it == golden.end()) {
+            printf("NEW   %-28s %s\n", c.name.c_str(), entry.c_str());
+            fresh++;
+        } else if (it->second != entry) {
+            printf("FAIL  %-28s %s\n", c.name.c_str(), entry.c_str());
+            printf("      %-28s %s (golden)\n", "", it->second.c_str());
+            fail++;
+        } else {
+            printf("PASS  %-28s %s\n", c.name.c_str(), entry.c_str());
+            pass++;
+        }
+        fflush(stdout);
+        if (opt.update) golden[c.name] = entry;
+    }
+
+    printf("%d passed, %d failed, %d new, %d errors\n", pass, fail, fresh, errors);
+    if (opt.update) {
+        if (!saveGolden(opt.golden, golden)) {
+            fprintf(stderr, "qycorpus: cannot write %s\n", opt.golden.c_str());
+            return 1;
+        }
+        return errors > 0 ? 1 : 0;
+    }
+    return (fail > 0 || fresh > 0 || errors > 0) ? 1 : 0;
+}
@@ -0,0 +1,523 @@
+/**
+ * qyplay: 主机上的无界面播放测试工具
+ *
+ * 直接驱动 FFPlayer / SacdPlayer，把 onAudioData 输出写入文件 (默认 /dev/null)，结束后打印：
+ * 准备耗时、首包耗时 (TTFA) 及其分段、解码速度 (相对实时的倍数)、Seek 延迟分布、缓冲次数与峰值内存。
+ * 默认尽快消费数据；-r 按输出码率节流，模拟 AudioTrack 的实时消费。
+ * --serve 通过 LocalHttpServer 把本地文件以 HTTP 提供给播放器，用于测试网络路径。
+ * --max-underruns 在欠载次数超出时以退出码 1 结束；本地文件按 -r 实时播放时应为 0。
+ *
+ * 示例：
+ *   qyplay song.flac
+ *   qyplay -r --seeks 20 --seek-interval 500 song.flac
+ *   qyplay --track 2 --dsd d2p --d2p-rate 176400 album.iso
+ *   qyplay --serve --serve-delay 30 --seeks 10 album.iso --track 0
+ *   qyplay -r --max-underruns 0 song.flac
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <getopt.h>
+#include <sys/resource.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "FFPlayer.h"
+#include "SacdPlayer.h"
+#include "LocalHttpServer.h"
+
+// libcommon/utils.h 的 min/max 宏会破坏 std::min/std::max
+#undef min
+#undef max
+
+namespace {
+
+    int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct Options {
+        std::string source;
+        int track = 0;
+        int64_t startMs = 0;
+        int64_t endMs = -1;
+        std::string output = "/dev/null";
+        bool realtime = false;
+        DsdMode dsdMode = DSD_MODE_D2P;
+        int d2pRate = 176400;
+        PcmEncoding encoding = PCM_ENCODING_AUTO;
+        int maxChannels = -1;
+        int seeks = 0;
+        int seekIntervalMs = 1000;
+        uint32_t seed = 1;
+        double limitSec = 0;
+        int pcmCacheSec = -1;
+        int64_t memLimit = 0;
+        bool serve = false;
+        int serveDelayMs = 0;
+        int maxUnderruns = -1;
+        std::map<std::string, std::string> headers;
+    };
+
+    class HarnessCallback : public IPlayerCallback {
+    public:
+        HarnessCallback(FILE *out, bool realtime) : mOut(out), mRealtime(realtime) {}
+
+        void onPrepared() override {
+            mPreparedUs = nowUs();
+        }
+
+        void onAudioData(uint8_t *data, int size) override {
+            if (size <= 0) return;
+            int64_t now = nowUs();
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                if (mFirstAudioUs == 0) mFirstAudioUs = now;
+                if (mSeekIssuedUs > 0) {
+                    mSeekLatencyUs.push_back(now - mSeekIssuedUs);
+                    mSeekIssuedUs = 0;
+                }
+                if (mPaceStartUs == 0) {
+                    mPaceStartUs = now;
+                    mPaceBytes = 0;
+                }
+                mBytes += size;
+                mPaceBytes += size;
+            }
+            if (mOut) fwrite(data, 1, size, mOut);
+
+            // 实时节流：按输出码率计算这些数据应在何时播完
+            if (mRealtime && mBytesPerSec > 0) {
+                int64_t dueUs = mPaceStartUs + mPaceBytes * 1000000 / mBytesPerSec;
+                int64_t waitUs = dueUs - nowUs();
+                if (waitUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+            }
+        }
+
+        void onProgress(int trackIndex, long currentMs, long totalMs, float progress) override {
+            mPositionMs = currentMs;
+        }
+
+        void onComplete() override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompleted = true;
+            mCond.notify_all();
+        }
+
+        void onError(int code, const char *msg) override {
+            fprintf(stderr, "qyplay: error %d: %s\n", code, msg ? msg : "");
+            std::lock_guard<std::mutex> lock(mMutex);
+            mError = true;
+            mCond.notify_all();
+        }
+
+        void onBuffering(bool buffering) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (buffering) {
+                mBufferingCount++;
+                mBufferingStartUs = nowUs();
+            } else if (mBufferingStartUs > 0) {
+                mBufferingUs += nowUs() - mBufferingStartUs;
+                mBufferingStartUs = 0;
+            }
+        }
+
+        void onStartupProfile(const int64_t *profile, int size) override {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStartup.assign(profile, profile + size);
+        }
+
+        void setBytesPerSec(int64_t bytesPerSec) {
+            mBytesPerSec = bytesPerSec;
+        }
+
+        // 在调用 player->seek() 之前记录，延迟取到 Seek 后第一次 onAudioData
+        void markSeek() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mSeekIssuedUs = nowUs();
+            mPaceStartUs = 0;
+            mCompleted = false;
+        }
+
+        /**
+         * 等待结束或超时
+         * @return true 表示已完成或出错
+         */
+        bool waitDone(int timeoutMs) {
+            std::unique_lock<std::mutex> lock(mMutex);
+            return mCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+                                  [this] { return mCompleted || mError; });
+        }
+
+        int64_t getBytes() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mBytes;
+        }
+
+        bool hasPendingSeek() {
+            std::lock_guard<std::mutex> lock(mMutex);
+            return mSeekIssuedUs > 0;
+        }
+
+        FILE *mOut;
+        bool mRealtime;
+        std::mutex mMutex;
+        std::condition_variable mCond;
+        int64_t mBytesPerSec = 0;
+        int64_t mPreparedUs = 0;
+        int64_t mFirstAudioUs = 0;
+        int64_t mSeekIssuedUs = 0;
+        int64_t mPaceStartUs = 0;
+        int64_t mPaceBytes = 0;
+        int64_t mBytes = 0;
+        long mPositionMs = 0;
+        bool mCompleted = false;
+        bool mError = false;
+        int mBufferingCount = 0;
+        std::vector<int64_t> mStartup;
+        int64_t mBufferingStartUs = 0;
+        int64_t mBufferingUs = 0;
+        std::vector<int64_t> mSeekLatencyUs;
+    };
+
+    void usage() {
+        fprintf(stderr,
+                "usage: qyplay [options] <file|iso|url>\n"
+                "  --track N            SACD track index (default 0)\n"
+                "  --start MS/--end MS  FFPlayer play range\n"
+                "  -o FILE              write output (default /dev/null)\n"
+                "  -r, --realtime       pace consumption at the output byte rate\n"
+                "  --dsd MODE           native|d2p|dop (default d2p)\n"
+                "  --d2p-rate HZ        D2P output rate (default 176400)\n"
+                "  --encoding E         auto|16|24|32|float\n"
+                "  --channels N         max output channels\n"
+                "  --seeks N            random seeks after each interval\n"
+                "  --seek-interval MS   audio played between seeks (default 1000)\n"
+                "  --seed N             seek position seed\n"
+                "  --limit SEC          stop after SEC seconds of output audio\n"
+                "  --pcm-cache SEC      FFPlayer PCM seek cache size\n"
+                "  --mem-limit MB       global native memory budget\n"
+                "  -H \"Key: Value\"      request header (repeatable)\n"
+                "  --serve              serve the local file over 127.0.0.1 HTTP\n"
+                "  --serve-delay MS     delay every HTTP response\n"
+                "  --max-underruns N    exit 1 when the engine reports more underruns\n");
+    }
+
+    bool parseOptions(int argc, char **argv, Options &opt) {
+        enum {
+            OPT_TRACK = 256, OPT_START, OPT_END, OPT_DSD, OPT_D2P_RATE, OPT_ENCODING, OPT_CHANNELS,
+            OPT_SEEKS, OPT_SEEK_INTERVAL, OPT_SEED, OPT_LIMIT, OPT_PCM_CACHE, OPT_MEM_LIMIT, OPT_SERVE,
+            OPT_SERVE_DELAY, OPT_MAX_UNDERRUNS
+        };
+        static const struct option longOptions[] = {
+                {"track",         required_argument, nullptr, OPT_TRACK},
+                {"start",         required_argument, nullptr, OPT_START},
+                {"end",           required_argument, nullptr, OPT_END},
+                {"output",        required_argument, nullptr, 'o'},
+                {"realtime",      no_argument,       nullptr, 'r'},
+                {"dsd",           required_argument, nullptr, OPT_DSD},
+                {"d2p-rate",      required_argument, nullptr, OPT_D2P_RATE},
+                {"encoding",      required_argument, nullptr, OPT_ENCODING},
+                {"channels",      required_argument, nullptr, OPT_CHANNELS},
+                {"seeks",         required_argument, nullptr, OPT_SEEKS},
+                {"seek-interval", required_argument, nullptr, OPT_SEEK_INTERVAL},
+                {"seed",          required_argument, nullptr, OPT_SEED},
+                {"limit",         required_argument, nullptr, OPT_LIMIT},
+                {"pcm-cache",     required_argument, nullptr, OPT_PCM_CACHE},
+                {"mem-limit",     required_argument, nullptr, OPT_MEM_LIMIT},
+                {"header",        required_argument, nullptr, 'H'},
+                {"serve",         no_argument,       nullptr, OPT_SERVE},
+                {"serve-delay",   required_argument, nullptr, OPT_SERVE_DELAY},
+                {"max-underruns", required_argument, nullptr, OPT_MAX_UNDERRUNS},
+                {"help",          no_argument,       nullptr, 'h'},
+                {nullptr, 0,                         nullptr, 0}
+        };
+
+        int c;
+        while ((c = getopt_long(argc, argv, "o:rH:h", longOptions, nullptr)) != -1) {
+            switch (c) {
+                case OPT_TRACK: opt.track = atoi(optarg); break;
+                case OPT_START: opt.startMs = atoll(optarg); break;
+                case OPT_END: opt.endMs = atoll(optarg); break;
+                case 'o': opt.output = optarg; break;
+                case 'r': opt.realtime = true; break;
+                case OPT_DSD:
+                    if (strcmp(optarg, "native") == 0) opt.dsdMode = DSD_MODE_NATIVE;
+                    else if (strcmp(optarg, "dop") == 0) opt.dsdMode = DSD_MODE_DOP;
+                    else if (strcmp(optarg, "d2p") == 0) opt.dsdMode = DSD_MODE_D2P;
+                    else return false;
+                    break;
+                case OPT_D2P_RATE: opt.d2pRate = atoi(optarg); break;
+                case OPT_ENCODING:
+                    if (strcmp(optarg, "16") == 0) opt.encoding = PCM_ENCODING_16BIT;
+                    else if (strcmp(optarg, "24") == 0) opt.encoding = PCM_ENCODING_24BIT_PACKED;
+                    else if (strcmp(optarg, "32") == 0) opt.encoding = PCM_ENCODING_32BIT;
+                    else if (strcmp(optarg, "float") == 0) opt.encoding = PCM_ENCODING_FLOAT;
+                    else if (strcmp(optarg, "auto") == 0) opt.encoding = PCM_ENCODING_AUTO;
+                    else return false;
+                    break;
+                case OPT_CHANNELS: opt.maxChannels = atoi(optarg); break;
+                case OPT_SEEKS: opt.seeks = atoi(optarg); break;
+                case OPT_SEEK_INTERVAL: opt.seekIntervalMs = std::max(10, atoi(optarg)); break;
+                case OPT_SEED: opt.seed = (uint32_t) strtoul(optarg, nullptr, 10); break;
+                case OPT_LIMIT: opt.limitSec = atof(optarg); break;
+                case OPT_PCM_CACHE: opt.pcmCacheSec = atoi(optarg); break;
+                case OPT_MEM_LIMIT: opt.memLimit = atoll(optarg) * 1024 * 1024; break;
+                case 'H': {
+                    const char *colon = strchr(optarg, ':');
+                    if (!colon) return false;
+                    std::string value = colon + 1;
+                    value.erase(0, value.find_first_not_of(' '));
+                    opt.headers[std::string(optarg, colon - optarg)] = value;
+                    break;
+                }
+                case OPT_SERVE: opt.serve = true; break;
+                case OPT_SERVE_DELAY: opt.serveDelayMs = atoi(optarg); break;
+                case OPT_MAX_UNDERRUNS: opt.maxUnderruns = atoi(optarg); break;
+                default: return false;
+            }
+        }
+        if (optind != argc - 1) return false;
+        opt.source = argv[optind];
+        return true;
+    }
+
+    bool isIso(const std::string &path) {
+        std::string lower = path;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        size_t query = lower.find('?');
+        if (query != std::string::npos) lower.resize(query);
+        return lower.size() > 4 && lower.compare(lower.size() - 4, 4, ".iso") == 0;
+    }
+
+    // 与 Java 层创建 AudioTrack 的格式一致：DSD Native 每帧每声道 4 字节
+    int64_t outputBytesPerSec(BasePlayer *player) {
+        int bits = player->getBitPerSample();
+        int bytesPerSample = bits == 1 ? 4 : bits / 8;
+        return (int64_t) player->getSampleRate() * player->getChannelCount() * bytesPerSample;
+    }
+
+    int64_t percentile(std::vector<int64_t> sorted, double p) {
+        if (sorted.empty()) return 0;
+        size_t index = (size_t) (p * (sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // 起播分段：每段为该里程碑与前一个已到达里程碑之差，PLAY 之后从 play() 重新计起
+    void printStartup(const std::vector<int64_t> &profile) {
+        if (profile.size() < (size_t) StartupProfile::SNAPSHOT_SIZE) {
+            printf("startup       -\n");
+            return;
+        }
+        static const char *names[StartupProfile::MILESTONE_COUNT] = {
+                "open", "stream info", "codec", "prepared", "play", "output", "buffered", "decode", "audio"};
+        const int64_t *marks = profile.data() + 2;
+        int64_t previous = 0;
+        printf("startup      ");
+        for (int i = 0; i < StartupProfile::MILESTONE_COUNT; i++) {
+            if (marks[i] < 0) continue;
+            if (i == StartupProfile::MILESTONE_PLAY) {
+                printf(" |");
+            } else {
+                printf(" %s %.1f", names[i], (marks[i] - previous) / 1000.0);
+            }
+            previous = marks[i];
+        }
+        int64_t flags = profile[1];
+        printf(" ms%s%s\n", flags & StartupProfile::FLAG_NETWORK ? ", network" : "",
+               flags & StartupProfile::FLAG_REUSED_HANDLE ? ", reused handle" : "");
+    }
+
+    double cpuSeconds(const struct rusage &ru) {
+        return ru.ru_utime.tv_sec + ru.ru_stime.tv_sec +
+               (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e6;
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    LocalHttpServer server;
+    std::string source = opt.source;
+    if (opt.serve) {
+        source = server.start(opt.source, opt.serveDelayMs);
+        if (source.empty()) {
+            fprintf(stderr, "qyplay: cannot serve %s\n", opt.source.c_str());
+            return 1;
+        }
+        fprintf(stderr, "qyplay: serving %s\n", source.c_str());
+    }
+
+    FILE *out = fopen(opt.output.c_str(), "wb");
+    if (!out) {
+        fprintf(stderr, "qyplay: cannot open %s\n", opt.output.c_str());
+        return 1;
+    }
+
+    MemoryBudget::setLimits(opt.memLimit, 0);
+    HarnessCallback callback(out, opt.realtime);
+    bool sacd = isIso(opt.source);
+    FFPlayer *ffPlayer = nullptr;
+    BasePlayer *player;
+    if (sacd) {
+        auto *sacdPlayer = new SacdPlayer(&callback);
+        sacdPlayer->setDataSource(source, opt.track, opt.headers);
+        player = sacdPlayer;
+    } else {
+        ffPlayer = new FFPlayer(&callback);
+        ffPlayer->setDataSource(source.c_str(), opt.headers, opt.startMs, opt.endMs);
+        if (opt.pcmCacheSec >= 0) ffPlayer->setPcmCacheSeconds(opt.pcmCacheSec);
+        player = ffPlayer;
+    }
+    player->setDsdConfig(opt.dsdMode, opt.d2pRate);
+    player->setOutputEncoding(opt.encoding);
+    if (opt.maxChannels > 0) player->setMaxOutputChannels(opt.maxChannels);
+
+    struct rusage ruStart{};
+    getrusage(RUSAGE_SELF, &ruStart);
+    int64_t startUs = nowUs();
+    player->prepare();
+    if (player->getState() == STATE_ERROR || callback.mPreparedUs == 0) {
+        fprintf(stderr, "qyplay: prepare failed\n");
+        player->release();
+        delete player;
+        fclose(out);
+        return 1;
+    }
+    int64_t bytesPerSec = outputBytesPerSec(player);
+    callback.setBytesPerSec(bytesPerSec);
+    long durationMs = player->getDuration();
+    player->play();
+
+    // 主循环：每输出 seekIntervalMs 的音频后随机 Seek 一次
+    uint32_t rng = opt.seed ? opt.seed : 1;
+    int seeksDone = 0;
+    int64_t seekIntervalBytes = bytesPerSec * opt.seekIntervalMs / 1000;
+    int64_t nextSeekBytes = seekIntervalBytes;
+    int64_t limitBytes = opt.limitSec > 0 ? (int64_t) (opt.limitSec * bytesPerSec) : 0;
+    for (;;) {
+        bool done = callback.waitDone(5);
+        int64_t bytes = callback.getBytes();
+        if (limitBytes > 0 && bytes >= limitBytes) break;
+        if (seeksDone < opt.seeks && bytesPerSec > 0 && durationMs > 0 && !callback.hasPendingSeek() &&
+            (bytes >= nextSeekBytes || (done && !callback.mError))) {
+            rng = rng * 1664525u + 1013904223u;
+            long target = (long) ((rng >> 8) % (uint32_t) std::max<long>(1, durationMs * 9 / 10));
+            callback.markSeek();
+            player->seek(target);
+            seeksDone++;
+            nextSeekBytes = bytes + seekIntervalBytes;
+            continue;
+        }
+        if (done && !callback.hasPendingSeek()) break;
+    }
+    int64_t endUs = nowUs();
+
+    double decodeRtf = ffPlayer ? ffPlayer->getDecodeRtf() : -1;
+    int sampleRate = player->getSampleRate();
+    int channels = player->getChannelCount();
+    int bits = player->getBitPerSample();
+    bool dsd = player->isDsd();
+    PcmEncoding encoding = player->getOutputEncoding();
+    int64_t stats[PlayerStats::SNAPSHOT_SIZE];
+    player->getStats().snapshot(stats, PlayerStats::SNAPSHOT_SIZE);
+    int64_t memory[MemoryAccount::SNAPSHOT_SIZE];
+    player->getMemory().snapshot(memory, MemoryAccount::SNAPSHOT_SIZE);
+    player->stop();
+    player->release();
+    delete player;
+    fclose(out);
+    server.stop();
+
+    struct rusage ruEnd{};
+    getrusage(RUSAGE_SELF, &ruEnd);
+
+    double wallSec = (endUs - startUs) / 1e6;
+    double audioSec = bytesPerSec > 0 ? (double) callback.mBytes / bytesPerSec : 0;
+    std::vector<int64_t> seekLatency = callback.mSeekLatencyUs;
+    std::sort(seekLatency.begin(), seekLatency.end());
+
+    printf("source        %s%s\n", opt.source.c_str(), opt.serve ? " (http)" : "");
+    printf("format        %d Hz, %d ch, %d bit%s, encoding %d\n", sampleRate, channels, bits,
+           dsd ? ", dsd" : "", encoding);
+    printf("duration      %.3f s\n", durationMs / 1000.0);
+    printf("prepare       %.1f ms\n", (callback.mPreparedUs - startUs) / 1000.0);
+    if (callback.mFirstAudioUs > 0) {
+        printf("ttfa          %.1f ms\n", (callback.mFirstAudioUs - startUs) / 1000.0);
+    } else {
+        printf("ttfa          -\n");
+    }
+    printStartup(callback.mStartup);
+    printf("audio         %.3f s in %.3f s wall (%.1fx realtime)\n", audioSec, wallSec,
+           wallSec > 0 ? audioSec / wallSec : 0);
+    printf("cpu           %.3f s (%.1f%% of wall)\n", cpuSeconds(ruEnd) - cpuSeconds(ruStart),
+           wallSec > 0 ? (cpuSeconds(ruEnd) - cpuSeconds(ruStart)) * 100 / wallSec : 0);
+    if (decodeRtf >= 0) printf("decode rtf    %.4f\n", decodeRtf);
+    const int64_t *counters = stats + 2;
+    printf("seeks         %zu", seekLatency.size());
+    if (!seekLatency.empty()) {
+        printf(", p50 %.1f ms, p90 %.1f ms, p99 %.1f ms, max %.1f ms",
+               percentile(seekLatency, 0.5) / 1000.0, percentile(seekLatency, 0.9) / 1000.0,
+               percentile(seekLatency, 0.99) / 1000.0, seekLatency.back() / 1000.0);
+    }
+    if (counters[PlayerStats::COUNTER_SEEK_CACHE_HITS] > 0) {
+        printf(", pcm cache hits %lld", (long long) counters[PlayerStats::COUNTER_SEEK_CACHE_HITS]);
+    }
+    printf("\n");
+    printf("buffering     %d events, %.1f ms\n", callback.mBufferingCount, callback.mBufferingUs / 1000.0);
+    printf("peak rss      %ld KB\n", ruEnd.ru_maxrss);
+    printf("engine        read %lld B / %lld pkts, queue peak %lld B, underruns %lld, "
+           "decode errors %lld, swr %lld, dst %lld\n",
+           (long long) counters[PlayerStats::COUNTER_READ_BYTES],
+           (long long) counters[PlayerStats::COUNTER_READ_PACKETS],
+           (long long) counters[PlayerStats::COUNTER_QUEUE_PEAK_BYTES],
+           (long long) counters[PlayerStats::COUNTER_UNDERRUNS],
+           (long long) counters[PlayerStats::COUNTER_DECODE_ERRORS],
+           (long long) counters[PlayerStats::COUNTER_SWR_REBUILDS],
+           (long long) counters[PlayerStats::COUNTER_DST_REBUILDS]);
+    int64_t pcmFrames = counters[PlayerStats::COUNTER_PCM_OUTPUT_FRAMES];
+    if (pcmFrames > 0 && sampleRate > 0) {
+        double pcmSec = (double) pcmFrames / sampleRate;
+        printf("pcm output    %.1f KB/s, convert cpu %.3f ms/s\n",
+               counters[PlayerStats::COUNTER_PCM_OUTPUT_BYTES] / 1024.0 / pcmSec,
+               counters[PlayerStats::COUNTER_PCM_CONVERT_CPU_NS] / 1e6 / pcmSec);
+    }
+    const int64_t *pools = memory + 3;
+    printf("memory        peak %lld KB (queue %lld, pcm cache %lld, out %lld, sacd read %lld, dst %lld KB at end)\n",
+           (long long) memory[2] / 1024,
+           (long long) pools[MemoryAccount::POOL_PACKET_QUEUE] / 1024,
+           (long long) pools[MemoryAccount::POOL_PCM_CACHE] / 1024,
+           (long long) pools[MemoryAccount::POOL_OUTPUT_BUFFER] / 1024,
+           (long long) pools[MemoryAccount::POOL_SACD_READ] / 1024,
+           (long long) pools[MemoryAccount::POOL_DST] / 1024);
+    static const char *histNames[PlayerStats::HIST_COUNT] = {"read", "decode", "callback", "buffering", "seek"};
+    for (int i = 0; i < PlayerStats::HIST_COUNT; i++) {
+        const int64_t *h = stats + 2 + PlayerStats::COUNTER_COUNT + i * LatencyHistogram::SNAPSHOT_SIZE;
+        if (h[0] == 0) continue;
+        printf("  %-11s %lld, mean %.1f us, max %.1f us\n", histNames[i], (long long) h[0],
+               (double) h[1] / h[0], (double) h[2]);
+    }
+    if (opt.serve) {
+        printf("http          %d requests, %lld bytes\n", server.getRequestCount(),
+               (long long) server.getBytesServed());
+    }
+    if (opt.maxUnderruns >= 0 && counters[PlayerStats::COUNTER_UNDERRUNS] > opt.maxUnderruns) {
+        fprintf(stderr, "qyplay: %lld underruns (max %d)\n",
+                (long long) counters[PlayerStats::COUNTER_UNDERRUNS], opt.maxUnderruns);
+        return 1;
+    }
+    return callback.mError ? 1 : 0;
+}
@@ -0,0 +1,158 @@
+/**
+ * qyprobe: 媒体库扫描 (解析模块) 的主机端测试工具
+ *
+ * 逐个探测文件 (或只读标签)，打印每个曲目的格式参数，最后打印 ScanStats 汇总，
+ * 用于对比快速路径、结果缓存与标签读取的耗时。
+ *
+ * 示例：
+ *   qyprobe ~/Music/*.flac album.cue album.iso
+ *   qyprobe --cache /tmp/qyprobe --repeat 2 ~/Music/*.flac
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "AudioProbe.h"
+#include "TagReader.h"
+#include "ProbeCache.h"
+#include "CoverStore.h"
+#include "ScanStats.h"
+
+namespace {
+
+    struct Options {
+        std::string cacheDir;
+        std::string coverDir = "/tmp/qyprobe-covers/";
+        bool tagsOnly = false;
+        bool quiet = false;
+        int repeat = 1;
+        std::vector<std::string> sources;
+    };
+
+    void usage() {
+        fprintf(stderr,
+                "usage: qyprobe [options] <file|cue|iso|url>...\n"
+                "  --tags               TagReader only (falls back to a full probe)\n"
+                "  --cache DIR          enable ProbeCache in DIR\n"
+                "  --covers DIR         cover directory (default /tmp/qyprobe-covers/)\n"
+                "  --repeat N           scan every source N times\n"
+                "  -q, --quiet          print only the summary\n");
+    }
+
+    bool parseOptions(int argc, char **argv, Options &opt) {
+        enum {
+            OPT_TAGS = 256, OPT_CACHE, OPT_COVERS, OPT_REPEAT
+        };
+        static const struct option longOptions[] = {
+                {"tags",   no_argument,       nullptr, OPT_TAGS},
+                {"cache",  required_argument, nullptr, OPT_CACHE},
+                {"covers", required_argument, nullptr, OPT_COVERS},
+                {"repeat", required_argument, nullptr, OPT_REPEAT},
+                {"quiet",  no_argument,       nullptr, 'q'},
+                {"help",   no_argument,       nullptr, 'h'},
+                {nullptr, 0,                  nullptr, 0}
+        };
+
+        int c;
+        while ((c = getopt_long(argc, argv, "qh", longOptions, nullptr)) != -1) {
+            switch (c) {
+                case OPT_TAGS: opt.tagsOnly = true; break;
+                case OPT_CACHE: opt.cacheDir = optarg; break;
+                case OPT_COVERS: opt.coverDir = optarg; break;
+                case OPT_REPEAT: opt.repeat = atoi(optarg) > 0 ? atoi(optarg) : 1; break;
+                case 'q': opt.quiet = true; break;
+                default: return false;
+            }
+        }
+        for (int i = optind; i < argc; i++) opt.sources.push_back(argv[i]);
+        return !opt.sources.empty();
+    }
+
+    bool isNetwork(const std::string &source) {
+        return source.find("://") != std::string::npos && source.compare(0, 7, "file://") != 0;
+    }
+
+    // 与 JNI 层 nativeReadTags 相同：本地文件先只读标签，不支持的格式回退到完整探测
+    InternalMetadata scan(const Options &opt, const std::string &source) {
+        if (opt.tagsOnly && !isNetwork(source)) {
+            InternalMetadata meta = TagReader::read(source);
+            if (meta.success) return meta;
+        }
+        return AudioProbe::probe(source, {}, "", "");
+    }
+
+    void printMetadata(const std::string &source, const InternalMetadata &meta) {
+        if (!meta.success) {
+            printf("%s: failed\n", source.c_str());
+            return;
+        }
+        printf("%s: %s / %s, %zu track(s)\n", source.c_str(), meta.albumArtist.c_str(),
+               meta.albumTitle.c_str(), meta.tracks.size());
+        for (const auto &t: meta.tracks) {
+            printf("  %2d %-8s %7d Hz %d ch %2d bit %8lld ms  %s\n", t.trackId, t.format.c_str(),
+                   t.sampleRate, t.channels, t.bitDepth, (long long) t.durationMs, t.title.c_str());
+        }
+    }
+
+    double meanMs(int64_t us, int64_t count) {
+        return count > 0 ? us / 1000.0 / count : 0.0;
+    }
+
+    void printSummary(double elapsedMs) {
+        int64_t s[ScanStats::SNAPSHOT_SIZE];
+        ScanStats::snapshot(s);
+        const int64_t *c = s + 1;
+        printf("elapsed %.1f ms\n", elapsedMs);
+        for (int network = 0; network < 2; network++) {
+            int base = network ? ScanStats::PROBE_NETWORK_COUNT : ScanStats::PROBE_LOCAL_COUNT;
+            int64_t count = c[base];
+            if (count == 0) continue;
+            printf("probe %-7s %lld, fast %lld, mean %.2f ms, mean read %lld KB\n",
+                   network ? "network" : "local", (long long) count, (long long) c[base + 1],
+                   meanMs(c[base + 2], count), (long long) (c[base + 3] / count / 1024));
+        }
+        int64_t tags = c[ScanStats::TAG_READ] + c[ScanStats::TAG_UNSUPPORTED];
+        if (tags > 0) {
+            printf("tags %lld, unsupported %lld, mean %.2f ms, mean read %lld KB\n",
+                   (long long) c[ScanStats::TAG_READ], (long long) c[ScanStats::TAG_UNSUPPORTED],
+                   meanMs(c[ScanStats::TAG_US], tags), (long long) (c[ScanStats::TAG_BYTES] / tags / 1024));
+        }
+        if (c[ScanStats::COVER_SAVED] + c[ScanStats::COVER_DEDUPED] > 0) {
+            printf("covers saved %lld (%lld KB), deduped %lld\n", (long long) c[ScanStats::COVER_SAVED],
+                   (long long) (c[ScanStats::COVER_SAVED_BYTES] / 1024),
+                   (long long) c[ScanStats::COVER_DEDUPED]);
+        }
+    }
+
+}
+
+int main(int argc, char **argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        usage();
+        return 2;
+    }
+    CoverStore::configure(opt.coverDir, 0);
+    if (!opt.cacheDir.empty() && !ProbeCache::open(opt.cacheDir, 100000)) {
+        fprintf(stderr, "qyprobe: cannot open cache in %s\n", opt.cacheDir.c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int failed = 0;
+    for (int round = 0; round < opt.repeat; round++) {
+        for (const auto &source: opt.sources) {
+            InternalMetadata meta = scan(opt, source);
+            if (!meta.success) failed++;
+            if (!opt.quiet && round == 0) printMetadata(source, meta);
+        }
+    }
+    double elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+    printSummary(elapsedMs);
+    ProbeCache::close();
+    return failed > 0 ? 1 : 0;
+}
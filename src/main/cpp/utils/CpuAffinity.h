@@ -7,11 +7,16 @@
 
 #include <sched.h>
 #include <unistd.h>
+#ifdef __ANDROID__
 #include <linux/resource.h>
+#endif
 #include <sys/resource.h>
+#include <stdio.h>
+#include <vector>
 #include "Logger.h"
 
 inline void setCpuAffinity(int coreCount) {
+#ifdef __ANDROID__
     cpu_set_t mask;
     CPU_ZERO(&mask);
 
@@ -28,6 +33,43 @@ inline void setCpuAffinity(int coreCount) {
     }
     setpriority(PRIO_PROCESS, 0, -19);
     LOGD("set %d cpu core for pid: %d", coreCount, pid);
+#else
+    // 核心编号按设备 SoC 写死，主机上不绑核，由调用方 (taskset / perf) 控制
+    (void) coreCount;
+#endif
+}
+
+/**
+ * 后台分析线程 (响度、指纹等批量任务)：调低调用线程的优先级，并限制在最高频率最低的一组核心 (小核) 上，
+ * 不与播放线程争抢大核
+ */
+inline void setBackgroundThread() {
+    setpriority(PRIO_PROCESS, 0, 10);
+
+    int cpuCount = (int) sysconf(_SC_NPROCESSORS_CONF);
+    if (cpuCount <= 0 || cpuCount > CPU_SETSIZE) return;
+    long minFreq = 0;
+    std::vector<long> freqs(cpuCount, 0);
+    for (int i = 0; i < cpuCount; ++i) {
+        char path[96];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", i);
+        FILE *f = fopen(path, "re");
+        if (!f) continue;
+        if (fscanf(f, "%ld", &freqs[i]) != 1) freqs[i] = 0;
+        fclose(f);
+        if (freqs[i] > 0 && (minFreq == 0 || freqs[i] < minFreq)) minFreq = freqs[i];
+    }
+    if (minFreq == 0) return;
+
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    for (int i = 0; i < cpuCount; ++i) {
+        if (freqs[i] == minFreq) CPU_SET(i, &mask);
+    }
+    // pid 为 0 时只作用于调用线程
+    if (sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+        LOGW("setBackgroundThread: sched_setaffinity failed");
+    }
 }
 
 #endif //QYPLAYER_CPUAFFINITY_H
@@ -0,0 +1,193 @@
+#include "DemuxerHandoff.h"
+#include "Logger.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+extern "C" {
+#include <libavutil/opt.h>
+}
+
+namespace {
+
+    struct InterruptRelay {
+        std::atomic<int (*)(void *)> callback{nullptr};
+        std::atomic<void *> opaque{nullptr};
+    };
+
+    int relayInterrupt(void *ctx) {
+        auto *relay = (InterruptRelay *) ctx;
+        void *opaque = relay->opaque.load();
+        int (*callback)(void *) = relay->callback.load();
+        return callback ? callback(opaque) : 0;
+    }
+
+    struct Entry {
+        std::string url;
+        std::string headersKey;
+        AVFormatContext *ctx;
+        bool streamInfoFound;
+        int64_t offeredMs;
+    };
+
+    // 回收线程是 detach 的，进程退出时可能仍在 gCond 上等待；这些对象不析构，
+    // 否则静态析构中 pthread_cond_destroy 会一直等到它醒来
+    std::mutex &gMutex = *new std::mutex;
+    std::condition_variable &gCond = *new std::condition_variable;
+    std::vector<Entry> &gEntries = *new std::vector<Entry>;
+    bool gReaperRunning = false;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // 在锁外关闭：关闭 HTTP 连接可能阻塞
+    void closeAll(std::vector<Entry> &entries) {
+        for (auto &e: entries) DemuxerHandoff::close(&e.ctx);
+        entries.clear();
+    }
+
+    void collectExpiredLocked(std::vector<Entry> &out) {
+        int64_t now = nowMs();
+        for (auto it = gEntries.begin(); it != gEntries.end();) {
+            if (now - it->offeredMs > DemuxerHandoff::TTL_MS) {
+                out.push_back(*it);
+                it = gEntries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 等到最早的暂存项到期再关闭，暂存为空时退出
+    void reaperLoop() {
+        std::unique_lock<std::mutex> lock(gMutex);
+        while (!gEntries.empty()) {
+            int64_t oldest = gEntries.front().offeredMs;
+            for (const auto &e: gEntries) oldest = std::min(oldest, e.offeredMs);
+            gCond.wait_for(lock, std::chrono::milliseconds(
+                    oldest + DemuxerHandoff::TTL_MS - nowMs() + 1));
+            std::vector<Entry> expired;
+            collectExpiredLocked(expired);
+            if (!expired.empty()) {
+                lock.unlock();
+                closeAll(expired);
+                lock.lock();
+            }
+        }
+        gReaperRunning = false;
+    }
+
+    void startReaperLocked() {
+        if (gReaperRunning) return;
+        gReaperRunning = true;
+        std::thread(reaperLoop).detach();
+    }
+
+    // 探测为了快速失败缩小过这些值，交给播放器前恢复默认
+    void restoreProbeDefaults(AVFormatContext *ctx) {
+        for (const char *name: {"probesize", "analyzeduration"}) {
+            const AVOption *opt = av_opt_find(ctx, name, nullptr, 0, 0);
+            if (opt) av_opt_set_int(ctx, name, opt->default_val.i64, 0);
+        }
+    }
+
+}
+
+std::string DemuxerHandoff::headersKey(const std::map<std::string, std::string> &headers) {
+    std::string key;
+    for (const auto &pair: headers) key += pair.first + ": " + pair.second + "\r\n";
+    return key;
+}
+
+void *DemuxerHandoff::installRelay(AVFormatContext *ctx) {
+    auto *relay = new InterruptRelay();
+    ctx->interrupt_callback.callback = relayInterrupt;
+    ctx->interrupt_callback.opaque = relay;
+    return relay;
+}
+
+void DemuxerHandoff::releaseRelay(void *relay) {
+    delete (InterruptRelay *) relay;
+}
+
+void DemuxerHandoff::bindInterrupt(AVFormatContext *ctx, int (*callback)(void *), void *opaque) {
+    if (ctx->interrupt_callback.callback == relayInterrupt) {
+        auto *relay = (InterruptRelay *) ctx->interrupt_callback.opaque;
+        relay->callback.store(nullptr);
+        relay->opaque.store(opaque);
+        relay->callback.store(callback);
+    } else {
+        ctx->interrupt_callback.callback = callback;
+        ctx->interrupt_callback.opaque = opaque;
+    }
+}
+
+void DemuxerHandoff::offer(const std::string &url, const std::string &headersKey,
+                           AVFormatContext *ctx, bool streamInfoFound) {
+    if (!ctx) return;
+    // 暂存期间不响应任何中断
+    bindInterrupt(ctx, nullptr, nullptr);
+
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        collectExpiredLocked(evicted);
+        for (auto it = gEntries.begin(); it != gEntries.end(); ++it) {
+            if (it->url == url) {
+                evicted.push_back(*it);
+                gEntries.erase(it);
+                break;
+            }
+        }
+        if ((int) gEntries.size() >= MAX_ENTRIES) {
+            evicted.push_back(gEntries.front());
+            gEntries.erase(gEntries.begin());
+        }
+        gEntries.push_back({url, headersKey, ctx, streamInfoFound, nowMs()});
+        startReaperLocked();
+    }
+    closeAll(evicted);
+}
+
+AVFormatContext *DemuxerHandoff::take(const std::string &url, const std::string &headersKey,
+                                      AVDictionary **options, bool &streamInfoFound) {
+    AVFormatContext *ctx = nullptr;
+    std::vector<Entry> expired;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        collectExpiredLocked(expired);
+        for (auto it = gEntries.begin(); it != gEntries.end(); ++it) {
+            if (it->url == url && it->headersKey == headersKey) {
+                ctx = it->ctx;
+                streamInfoFound = it->streamInfoFound;
+                gEntries.erase(it);
+                break;
+            }
+        }
+    }
+    closeAll(expired);
+    if (ctx) {
+        restoreProbeDefaults(ctx);
+        if (options) av_opt_set_dict2(ctx, options, AV_OPT_SEARCH_CHILDREN);
+    }
+    return ctx;
+}
+
+void DemuxerHandoff::close(AVFormatContext **ctx) {
+    if (!ctx || !*ctx) return;
+    InterruptRelay *relay = nullptr;
+    if ((*ctx)->interrupt_callback.callback == relayInterrupt) {
+        relay = (InterruptRelay *) (*ctx)->interrupt_callback.opaque;
+        // 关闭过程中不再转发给 (可能已析构的) 取走方
+        relay->callback.store(nullptr);
+    }
+    avformat_close_input(ctx);
+    *ctx = nullptr;
+    delete relay;
+}
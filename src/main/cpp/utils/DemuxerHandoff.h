@@ -0,0 +1,63 @@
+#ifndef QYPLAYER_DEMUXERHANDOFF_H
+#define QYPLAYER_DEMUXERHANDOFF_H
+
+#include <string>
+#include <map>
+
+extern "C" {
+#include <libavformat/avformat.h>
+}
+
+/**
+ * 探测 -> 播放的解复用器交接
+ *
+ * 网络文件探测完成后不立即关闭 AVFormatContext，而是暂存在这里 (最多 MAX_ENTRIES 个)。
+ * 随后 FFPlayer::prepare() 打开同一地址 (且请求头相同) 时直接取走，
+ * 省掉一次 HTTP 连接、read_header 以及可能的 find_stream_info。
+ * 暂存期间由后台线程在 TTL_MS 到期时关闭，没人取走的连接不会一直占着；线程在没有暂存项时退出。
+ *
+ * 上下文是按探测的选项打开的 (较小的 probesize 等)，取走时恢复格式层的默认值，
+ * 再套用取走方自己的打开选项 (rw_timeout、reconnect 等会下发到协议层)。
+ *
+ * 协议层 (URLContext) 在打开时复制了中断回调，之后修改 AVFormatContext::interrupt_callback
+ * 不会生效。因此网络上下文在打开前安装一个可转接的中断回调 (installRelay)，
+ * 取走方通过 bindInterrupt 把中断转接到自己的回调上。
+ * 安装过转接回调的上下文必须通过 close() 关闭。
+ */
+class DemuxerHandoff {
+public:
+    static const int MAX_ENTRIES = 2;
+    static const int64_t TTL_MS = 30000;
+
+    static std::string headersKey(const std::map<std::string, std::string> &headers);
+
+    /**
+     * 在 avformat_open_input 之前调用 (ctx 由 avformat_alloc_context 创建)
+     * @return 转接对象；avformat_open_input 失败时 (ctx 已被释放) 需调用 releaseRelay
+     */
+    static void *installRelay(AVFormatContext *ctx);
+
+    static void releaseRelay(void *relay);
+
+    static void bindInterrupt(AVFormatContext *ctx, int (*callback)(void *), void *opaque);
+
+    /**
+     * 转交所有权；streamInfoFound 表示是否已执行过 avformat_find_stream_info
+     */
+    static void offer(const std::string &url, const std::string &headersKey,
+                      AVFormatContext *ctx, bool streamInfoFound);
+
+    /**
+     * @param options 取走方 avformat_open_input 的选项，已套用的条目会被移除，可为 nullptr
+     * @return 取得所有权的上下文，没有可用的返回 nullptr
+     */
+    static AVFormatContext *take(const std::string &url, const std::string &headersKey,
+                                 AVDictionary **options, bool &streamInfoFound);
+
+    /**
+     * 关闭上下文并释放转接对象 (未安装转接时等同 avformat_close_input)
+     */
+    static void close(AVFormatContext **ctx);
+};
+
+#endif //QYPLAYER_DEMUXERHANDOFF_H
@@ -4,6 +4,7 @@
 
 #include "FFmpegNetworkStream.h"
 #include "Logger.h"
+#include "ProbeInterrupt.h"
 
 bool FFmpegNetworkStream::open(const std::string &url,
                                const std::map<std::string, std::string> &headers) {
@@ -40,8 +41,9 @@ bool FFmpegNetworkStream::open(const std::string &url,
     av_dict_set(&options, "probesize", "1024000", 0);
     av_dict_set(&options, "analyzeduration", "2000000", 0);
 
-    // 使用 avio_open2 支持 http/https 以及 file://
-    int ret = avio_open2(&ctx, url.c_str(), AVIO_FLAG_READ, nullptr, &options);
+    // 使用 avio_open2 支持 http/https 以及 file://；批量探测中打开时可被取消
+    AVIOInterruptCB interrupt = ProbeInterrupt::get();
+    int ret = avio_open2(&ctx, url.c_str(), AVIO_FLAG_READ, &interrupt, &options);
     av_dict_free(&options);
 
     if (ret < 0) {
@@ -39,6 +39,8 @@ public:
 
     static long get_size_cb(void *opaque);
 
+    int getBufferSize() const { return ctx ? ctx->buffer_size : 0; }
+
 private:
     AVIOContext *ctx = nullptr;
     int64_t fileSize = 0;
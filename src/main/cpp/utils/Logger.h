@@ -1,9 +1,31 @@
 #ifndef QYPLAYER_LOGGER_H
 #define QYPLAYER_LOGGER_H
 
+#define TAG "QYPlayer"
+
+#ifdef __ANDROID__
 #include "android/log.h"
+#else
+// 主机构建 (性能分析 / 基准测试)：日志输出到 stderr，格式与 logcat 的 brief 格式一致
+#include <stdio.h>
+#include <stdarg.h>
 
-#define TAG "QYPlayer"
+static inline void qyplayer_host_log(char level, const char *fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    fprintf(stderr, "%c/%s: ", level, TAG);
+    vfprintf(stderr, fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+#define ANDROID_LOG_DEBUG 'D'
+#define ANDROID_LOG_INFO 'I'
+#define ANDROID_LOG_WARN 'W'
+#define ANDROID_LOG_ERROR 'E'
+#define ANDROID_LOG_FATAL 'F'
+#define __android_log_print(level, tag, ...) qyplayer_host_log(level, __VA_ARGS__)
+#endif
 
 #ifdef DEBUG
 #define LOGD(...) __android_log_print(ANDROID_LOG_DEBUG, TAG, __VA_ARGS__)
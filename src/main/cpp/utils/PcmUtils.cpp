@@ -0,0 +1,61 @@
+#include "PcmUtils.h"
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+int PcmUtils::packS32ToS24(const int32_t *src, uint8_t *dst, int samples) {
+    const auto *in = reinterpret_cast<const uint8_t *>(src);
+    int i = 0;
+
+#if defined(__aarch64__)
+    // 一次处理 16 个样本：vld4 按字节去交错，丢掉最低字节后 vst3 重新交错
+    // 每块先读 64 字节再写 48 字节，写指针始终不超过读指针，因此可原地转换
+    for (; i + 16 <= samples; i += 16) {
+        uint8x16x4_t v = vld4q_u8(in + i * 4);
+        uint8x16x3_t o;
+        o.val[0] = v.val[1];
+        o.val[1] = v.val[2];
+        o.val[2] = v.val[3];
+        vst3q_u8(dst + i * 3, o);
+    }
+#endif
+
+    for (; i < samples; ++i) {
+        const uint8_t *s = in + i * 4;
+        uint8_t *d = dst + i * 3;
+        uint8_t b1 = s[1], b2 = s[2], b3 = s[3];
+        d[0] = b1;
+        d[1] = b2;
+        d[2] = b3;
+    }
+    return samples * 3;
+}
+
+int PcmUtils::unpackS24ToS32(const uint8_t *src, int32_t *dst, int samples) {
+    auto *out = reinterpret_cast<uint8_t *>(dst);
+    int i = 0;
+
+#if defined(__aarch64__)
+    const uint8x16_t zero = vdupq_n_u8(0);
+    for (; i + 16 <= samples; i += 16) {
+        uint8x16x3_t v = vld3q_u8(src + i * 3);
+        uint8x16x4_t o;
+        o.val[0] = zero;
+        o.val[1] = v.val[0];
+        o.val[2] = v.val[1];
+        o.val[3] = v.val[2];
+        vst4q_u8(out + i * 4, o);
+    }
+#endif
+
+    for (; i < samples; ++i) {
+        const uint8_t *s = src + i * 3;
+        uint8_t *d = out + i * 4;
+        d[0] = 0;
+        d[1] = s[0];
+        d[2] = s[1];
+        d[3] = s[2];
+    }
+    return samples * 4;
+}
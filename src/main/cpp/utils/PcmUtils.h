@@ -0,0 +1,32 @@
+#ifndef QYPLAYER_PCMUTILS_H
+#define QYPLAYER_PCMUTILS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * PCM 样本格式转换工具
+ * S32 与 S24_3LE (packed 24bit, 每样本 3 字节小端) 互转，aarch64 下走 NEON
+ */
+class PcmUtils {
+public:
+    /**
+     * S32 -> S24_3LE，保留高 24 位
+     * 支持原地转换 (src 与 dst 指向同一块内存)
+     *
+     * @param samples 样本总数 (帧数 * 声道数)
+     * @return 写入 dst 的字节数
+     */
+    static int packS32ToS24(const int32_t *src, uint8_t *dst, int samples);
+
+    /**
+     * S24_3LE -> S32，低 8 位补 0
+     * 不支持原地转换
+     *
+     * @param samples 样本总数 (帧数 * 声道数)
+     * @return 写入 dst 的字节数
+     */
+    static int unpackS24ToS32(const uint8_t *src, int32_t *dst, int samples);
+};
+
+#endif //QYPLAYER_PCMUTILS_H
@@ -0,0 +1,49 @@
+#ifndef QYPLAYER_PROBEINTERRUPT_H
+#define QYPLAYER_PROBEINTERRUPT_H
+
+#include <atomic>
+
+extern "C" {
+#include <libavformat/avio.h>
+}
+
+/**
+ * 批量任务的取消，转交给工作线程中进行的 FFmpeg IO
+ *
+ * 工作线程执行任务期间用 Scope 登记所在批次的取消标志，打开连接时装入 get() 返回的
+ * AVIOInterruptCB。批次被取消后，正在进行的连接 / 读取在下一次轮询时以 AVERROR_EXIT 返回。
+ *
+ * 回调只查询当前线程登记的标志，不持有任何指针：上下文随后被交接给播放器
+ * (DemuxerHandoff / SacdHandoff) 时，在播放线程中回调始终返回 0。
+ */
+class ProbeInterrupt {
+public:
+    class Scope {
+    public:
+        explicit Scope(const std::atomic<bool> *cancelled) : mPrevious(tCancelled) {
+            tCancelled = cancelled;
+        }
+
+        ~Scope() { tCancelled = mPrevious; }
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        const std::atomic<bool> *mPrevious;
+    };
+
+    static int callback(void *) {
+        return tCancelled && tCancelled->load(std::memory_order_relaxed) ? 1 : 0;
+    }
+
+    static AVIOInterruptCB get() {
+        return {callback, nullptr};
+    }
+
+private:
+    static inline thread_local const std::atomic<bool> *tCancelled = nullptr;
+};
+
+#endif //QYPLAYER_PROBEINTERRUPT_H
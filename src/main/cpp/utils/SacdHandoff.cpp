@@ -0,0 +1,221 @@
+#include "SacdHandoff.h"
+#include "DemuxerHandoff.h"
+#include "MemoryBudget.h"
+#include "Logger.h"
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+    struct Entry {
+        std::string url;
+        std::string headersKey;
+        SacdHandles handles;
+        int64_t offeredMs;
+        int64_t bytes;
+    };
+
+    // 同 DemuxerHandoff：回收线程是 detach 的，共享对象不析构
+    std::mutex &gMutex = *new std::mutex;
+    std::condition_variable &gCond = *new std::condition_variable;
+    std::vector<Entry> &gEntries = *new std::vector<Entry>;
+    bool gReaperRunning = false;
+    MemoryAccount &gMemory = *new MemoryAccount;
+
+    int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    int64_t nowUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // TOC 与 DST 帧缓冲 (scarletbook_open 分配) 加上网络读缓冲
+    int64_t handlesBytes(const SacdHandles &handles) {
+        int64_t bytes = 0;
+        scarletbook_handle_t *sb = handles.handle;
+        if (sb) {
+            bytes += sizeof(scarletbook_handle_t) + MAX_DST_SIZE + MASTER_TOC_LEN * SACD_LSN_SIZE;
+            // area[2] / area[3] 为 2ch / 多声道 TOC-2 的备份
+            for (int i = 0; i < 4 && sb->master_toc; i++) {
+                if (!sb->area[i].area_data) continue;
+                bool mulch = i == 3 || i == sb->mulch_area_idx;
+                bytes += (int64_t) (mulch ? sb->master_toc->area_2_toc_size
+                                          : sb->master_toc->area_1_toc_size) * SACD_LSN_SIZE;
+            }
+        }
+        if (handles.netStream) bytes += handles.netStream->getBufferSize();
+        return bytes;
+    }
+
+    void updateMemoryLocked() {
+        int64_t bytes = 0;
+        for (const auto &e: gEntries) bytes += e.bytes;
+        gMemory.set(MemoryAccount::POOL_HANDOFF, bytes);
+    }
+
+    // 在锁外关闭：关闭 HTTP 连接可能阻塞
+    void closeAll(std::vector<Entry> &entries) {
+        for (auto &e: entries) SacdHandoff::close(e.handles);
+        entries.clear();
+    }
+
+    void collectExpiredLocked(std::vector<Entry> &out) {
+        int64_t now = nowMs();
+        for (auto it = gEntries.begin(); it != gEntries.end();) {
+            if (now - it->offeredMs > SacdHandoff::TTL_MS) {
+                out.push_back(*it);
+                it = gEntries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // 等到最早的暂存项到期再关闭，暂存为空时退出
+    void reaperLoop() {
+        std::unique_lock<std::mutex> lock(gMutex);
+        while (!gEntries.empty()) {
+            int64_t oldest = gEntries.front().offeredMs;
+            for (const auto &e: gEntries) oldest = std::min(oldest, e.offeredMs);
+            gCond.wait_for(lock, std::chrono::milliseconds(
+                    oldest + SacdHandoff::TTL_MS - nowMs() + 1));
+            std::vector<Entry> expired;
+            collectExpiredLocked(expired);
+            if (!expired.empty()) {
+                updateMemoryLocked();
+                lock.unlock();
+                closeAll(expired);
+                lock.lock();
+            }
+        }
+        gReaperRunning = false;
+    }
+
+    void startReaperLocked() {
+        if (gReaperRunning) return;
+        gReaperRunning = true;
+        std::thread(reaperLoop).detach();
+    }
+
+    bool take(const std::string &url, const std::string &headersKey, SacdHandles &out) {
+        bool found = false;
+        std::vector<Entry> expired;
+        {
+            std::lock_guard<std::mutex> lock(gMutex);
+            collectExpiredLocked(expired);
+            for (auto it = gEntries.begin(); it != gEntries.end(); ++it) {
+                if (it->url == url && it->headersKey == headersKey) {
+                    out = it->handles;
+                    gEntries.erase(it);
+                    found = true;
+                    break;
+                }
+            }
+            updateMemoryLocked();
+        }
+        closeAll(expired);
+        return found;
+    }
+
+}
+
+bool SacdHandoff::isNetwork(const std::string &url) {
+    return url.find("http://") == 0 || url.find("https://") == 0;
+}
+
+bool SacdHandoff::open(const std::string &url, const std::map<std::string, std::string> &headers,
+                       SacdHandles &out, SacdOpenTiming *timing) {
+    out = SacdHandles();
+    SacdOpenTiming local;
+    if (!timing) timing = &local;
+    *timing = SacdOpenTiming();
+    if (take(url, DemuxerHandoff::headersKey(headers), out)) {
+        LOGD("SacdHandoff: reuse handle for %s", url.c_str());
+        timing->reused = true;
+        return true;
+    }
+
+    int64_t start = nowUs();
+    if (isNetwork(url)) {
+        out.netStream = new FFmpegNetworkStream();
+        if (!out.netStream->open(url, headers)) {
+            LOGE("SacdHandoff: FFmpegNetworkStream open failed");
+            close(out);
+            return false;
+        }
+        sacd_io_callbacks_t cb;
+        cb.context = out.netStream;
+        cb.read = FFmpegNetworkStream::read_cb;
+        cb.seek = FFmpegNetworkStream::seek_cb;
+        cb.tell = FFmpegNetworkStream::tell_cb;
+        cb.get_size = FFmpegNetworkStream::get_size_cb;
+        out.reader = sacd_open_callbacks(&cb);
+    } else {
+        out.reader = sacd_open(url.c_str());
+    }
+
+    if (!out.reader) {
+        LOGE("SacdHandoff: sacd_open failed: %s", url.c_str());
+        close(out);
+        return false;
+    }
+    int64_t opened = nowUs();
+    timing->openUs = opened - start;
+
+    out.handle = scarletbook_open(out.reader);
+    timing->tocUs = nowUs() - opened;
+    if (!out.handle) {
+        LOGE("SacdHandoff: scarletbook_open failed (Not a valid SACD ISO)");
+        close(out);
+        return false;
+    }
+    return true;
+}
+
+void SacdHandoff::offer(const std::string &url, const std::map<std::string, std::string> &headers,
+                        SacdHandles &handles) {
+    if (!handles.handle) {
+        close(handles);
+        return;
+    }
+
+    std::vector<Entry> evicted;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        collectExpiredLocked(evicted);
+        for (auto it = gEntries.begin(); it != gEntries.end(); ++it) {
+            if (it->url == url) {
+                evicted.push_back(*it);
+                gEntries.erase(it);
+                break;
+            }
+        }
+        if ((int) gEntries.size() >= MAX_ENTRIES) {
+            evicted.push_back(gEntries.front());
+            gEntries.erase(gEntries.begin());
+        }
+        gEntries.push_back({url, DemuxerHandoff::headersKey(headers), handles, nowMs(),
+                            handlesBytes(handles)});
+        updateMemoryLocked();
+        startReaperLocked();
+    }
+    handles = SacdHandles();
+    closeAll(evicted);
+}
+
+void SacdHandoff::close(SacdHandles &handles) {
+    if (handles.handle) scarletbook_close(handles.handle);
+    if (handles.reader) sacd_close(handles.reader);
+    if (handles.netStream) {
+        handles.netStream->close();
+        delete handles.netStream;
+    }
+    handles = SacdHandles();
+}
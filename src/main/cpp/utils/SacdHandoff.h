@@ -0,0 +1,67 @@
+#ifndef QYPLAYER_SACDHANDOFF_H
+#define QYPLAYER_SACDHANDOFF_H
+
+#include <string>
+#include <map>
+#include "FFmpegNetworkStream.h"
+
+extern "C" {
+#include "sacd_reader.h"
+#include "scarletbook_read.h"
+}
+
+/**
+ * 一次打开的 SACD 镜像：网络流 (本地文件为 nullptr) -> sacd_reader -> scarletbook
+ */
+struct SacdHandles {
+    FFmpegNetworkStream *netStream = nullptr;
+    sacd_reader_t *reader = nullptr;
+    scarletbook_handle_t *handle = nullptr;
+};
+
+/**
+ * SacdHandoff::open 的分段耗时 (微秒)，取走暂存句柄时两段均为 0
+ */
+struct SacdOpenTiming {
+    bool reused = false;
+    int64_t openUs = 0; // sacd_open，网络镜像为 avio_open2 (DNS/TCP/TLS 与 HTTP 响应)
+    int64_t tocUs = 0;  // scarletbook_open (Master / Area TOC 与文本)
+};
+
+/**
+ * SACD 镜像句柄的短期共享
+ *
+ * scarletbook_open 需要读取 Master TOC、各区域 TOC 与文本，网络镜像上还要先建立 HTTP 连接。
+ * 探测完成或播放器切换曲目时不关闭句柄，而是暂存在这里 (最多 MAX_ENTRIES 个)；
+ * 随后 SacdPlayer::prepare() 或再次探测同一镜像 (且请求头相同) 时直接取走。
+ * 与 DemuxerHandoff 相同，句柄同一时间只属于一个使用者，到期 (TTL_MS) 由后台线程关闭。
+ * 暂存句柄的 TOC 缓冲与网络读缓冲计入 MemoryBudget (MemoryAccount::POOL_HANDOFF)。
+ */
+class SacdHandoff {
+public:
+    static const int MAX_ENTRIES = 2;
+    static const int64_t TTL_MS = 30000;
+
+    static bool isNetwork(const std::string &url);
+
+    /**
+     * 优先取走暂存的句柄，没有则重新打开
+     * @param timing 可为 nullptr
+     * @return 失败时 out 保持为空
+     */
+    static bool open(const std::string &url, const std::map<std::string, std::string> &headers,
+                     SacdHandles &out, SacdOpenTiming *timing = nullptr);
+
+    /**
+     * 转交所有权，调用后 handles 被清空
+     */
+    static void offer(const std::string &url, const std::map<std::string, std::string> &headers,
+                      SacdHandles &handles);
+
+    /**
+     * 关闭句柄，调用后 handles 被清空
+     */
+    static void close(SacdHandles &handles);
+};
+
+#endif //QYPLAYER_SACDHANDOFF_H
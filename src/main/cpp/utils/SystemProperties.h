@@ -6,15 +6,31 @@
 #define QYPLAYER_SYSTEMPROPERTIES_H
 
 #include <string>
+#include <stdlib.h>
+#include <ctype.h>
+
+#ifdef __ANDROID__
 #include "sys/system_properties.h"
+#endif
 
 class SystemProperties {
 public:
     inline static std::string getSystemProperty(const char *key, const char *def = "") {
+#ifdef __ANDROID__
         char value[PROP_VALUE_MAX] = {0};
         if (__system_property_get(key, value) > 0) {
             return {value};
         }
+#else
+        // 主机构建：从环境变量读取，属性名转大写、'.' 转 '_'
+        // (persist.sys.audio.i2s -> PERSIST_SYS_AUDIO_I2S)
+        std::string name = key;
+        for (auto &c: name) c = c == '.' ? '_' : (char) toupper((unsigned char) c);
+        const char *value = getenv(name.c_str());
+        if (value && value[0]) {
+            return {value};
+        }
+#endif
         return {def};
     }
 
@@ -22,6 +38,20 @@ public:
         std::string prop = getSystemProperty("persist.sys.audio.i2s", "false");
         return (prop == "1" || prop == "true" || prop == "True");
     }
+
+    /**
+     * 设备支持的最大 PCM 输出声道数 (2/4/6/8)
+     * 未配置时沿用 I2S 四声道开关的结论
+     */
+    inline static int getMaxOutputChannels() {
+        std::string prop = getSystemProperty("persist.sys.audio.max_channels", "");
+        int channels = prop.empty() ? 0 : atoi(prop.c_str());
+        if (channels <= 0) return is4ChannelSupported() ? 4 : 2;
+        if (channels >= 8) return 8;
+        if (channels >= 6) return 6;
+        if (channels >= 4) return 4;
+        return 2;
+    }
 };
 
 
@@ -0,0 +1,75 @@
+#include "Trace.h"
+
+#ifdef QYPLAYER_TRACE
+
+#ifdef __ANDROID__
+#include <android/trace.h>
+
+int qy_trace_enabled(void) { return ATrace_isEnabled(); }
+
+void qy_trace_begin(const char *name) { ATrace_beginSection(name); }
+
+void qy_trace_end(void) { ATrace_endSection(); }
+
+#else
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+    // ftrace 的 trace_marker，与 atrace 写入的格式一致 (B|pid|name / E|pid)，Perfetto 可直接解析
+    int openTraceMarker() {
+        const char *paths[] = {"/sys/kernel/tracing/trace_marker",
+                               "/sys/kernel/debug/tracing/trace_marker"};
+        for (const char *path: paths) {
+            int fd = open(path, O_WRONLY | O_CLOEXEC);
+            if (fd >= 0) return fd;
+        }
+        return -1;
+    }
+
+    int traceMarkerFd() {
+        static int fd = openTraceMarker();
+        return fd;
+    }
+
+    long monotonicUs() {
+        struct timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000000L + ts.tv_nsec / 1000;
+    }
+}
+
+int qy_trace_enabled(void) { return 1; }
+
+void qy_trace_begin(const char *name) {
+    int fd = traceMarkerFd();
+    if (fd >= 0) {
+        char buf[128];
+        int len = snprintf(buf, sizeof(buf), "B|%d|%s", getpid(), name);
+        if (len > (int) sizeof(buf) - 1) len = (int) sizeof(buf) - 1;
+        (void) !write(fd, buf, len);
+    } else {
+        // 无 tracefs 权限时输出文本：时间 (us)、线程号、区间
+        fprintf(stderr, "T/QYPlayer: %ld %ld B %s\n", monotonicUs(), (long) syscall(SYS_gettid), name);
+    }
+}
+
+void qy_trace_end(void) {
+    int fd = traceMarkerFd();
+    if (fd >= 0) {
+        char buf[32];
+        int len = snprintf(buf, sizeof(buf), "E|%d", getpid());
+        (void) !write(fd, buf, len);
+    } else {
+        fprintf(stderr, "T/QYPlayer: %ld %ld E\n", monotonicUs(), (long) syscall(SYS_gettid));
+    }
+}
+
+#endif
+
+#endif // QYPLAYER_TRACE
@@ -0,0 +1,78 @@
+#ifndef QYPLAYER_TRACE_H
+#define QYPLAYER_TRACE_H
+
+/**
+ * 原生热点路径的 Trace 标记 (C / C++ 通用)
+ *
+ * 默认不编译，CMake 打开 -DQYPLAYER_TRACE=ON 后生效：
+ *   - Android：ATrace (API 23+)，由 Perfetto / systrace 抓取，需勾选应用的 atrace 类别
+ *   - 主机：写入 ftrace 的 trace_marker (trace-cmd / perf / Perfetto 可抓取)；不可写时退化为 stderr 文本
+ * 关闭时所有宏展开为空，不产生任何开销。
+ *
+ * 线程命名与 Trace 开关无关，始终生效。
+ */
+
+#include <sys/prctl.h>
+
+/**
+ * 设置调用线程的名字 (内核限制 15 个字符)，供 Perfetto / top / debuggerd 显示
+ */
+static inline void qy_set_thread_name(const char *name) {
+    prctl(PR_SET_NAME, name, 0, 0, 0);
+}
+
+#ifdef QYPLAYER_TRACE
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int qy_trace_enabled(void);
+
+void qy_trace_begin(const char *name);
+
+void qy_trace_end(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#define QY_TRACE_BEGIN(name) qy_trace_begin(name)
+#define QY_TRACE_END() qy_trace_end()
+
+#else
+
+#define QY_TRACE_BEGIN(name) ((void) 0)
+#define QY_TRACE_END() ((void) 0)
+
+#endif
+
+#ifdef __cplusplus
+
+#ifdef QYPLAYER_TRACE
+
+class ScopedTrace {
+public:
+    explicit ScopedTrace(const char *name) { qy_trace_begin(name); }
+
+    ~ScopedTrace() { qy_trace_end(); }
+
+    ScopedTrace(const ScopedTrace &) = delete;
+
+    ScopedTrace &operator=(const ScopedTrace &) = delete;
+};
+
+#define QY_TRACE_CONCAT_(a, b) a##b
+#define QY_TRACE_CONCAT(a, b) QY_TRACE_CONCAT_(a, b)
+// 作用域内的 Trace 区间：QY_TRACE_SCOPE("decode");
+#define QY_TRACE_SCOPE(name) ScopedTrace QY_TRACE_CONCAT(qyTraceScope, __LINE__)(name)
+
+#else
+
+#define QY_TRACE_SCOPE(name) ((void) 0)
+
+#endif
+
+#endif // __cplusplus
+
+#endif //QYPLAYER_TRACE_H
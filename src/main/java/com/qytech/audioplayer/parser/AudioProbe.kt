@@ -1,6 +1,9 @@
 package com.qytech.audioplayer.parser
 
+import com.qytech.audioplayer.parser.model.AudioFingerprint
 import com.qytech.audioplayer.parser.model.AudioMetadata
+import com.qytech.audioplayer.parser.model.AudioTrackItem
+import com.qytech.audioplayer.parser.model.LoudnessInfo
 import com.qytech.audioplayer.strategy.ScanProfile
 import com.qytech.audioplayer.strategy.WebDavUtils
 import com.qytech.audioplayer.utils.QYPlayerLogger
@@ -23,6 +26,7 @@ object AudioProbe {
         val finalHeaders: MutableMap<String, String> = mutableMapOf()
         var filename: String? = null
         var audioSourceUrl: String? = null
+        var validator: String? = null
 
         // --- A. WebDAV 层处理 (解包) ---
         val actualProfile = if (profile is ScanProfile.WebDav) {
@@ -54,6 +58,7 @@ object AudioProbe {
             actualProfile.headers?.let { finalHeaders.putAll(it) }
 
             filename = actualProfile.filename
+            validator = actualProfile.validator
             if (actualProfile is ScanProfile.RemoteCue) {
                 audioSourceUrl = actualProfile.audioSourceUrl
             }
@@ -64,7 +69,7 @@ object AudioProbe {
 
         QYPlayerLogger.d("probe: finalUrl = $finalUrl, headers = $headersParam, filename = $filename, audioSourceUrl = $audioSourceUrl")
 
-        val result = nativeProbe(finalUrl, headersParam, filename, audioSourceUrl)
+        val result = nativeProbe(finalUrl, headersParam, filename, audioSourceUrl, validator)
         QYPlayerLogger.d("probe: result = $result")
         return result
     }
@@ -80,16 +85,17 @@ object AudioProbe {
         audioSourceUrl: String? = null,
         webDavUser: String? = null,
         webDavPwd: String? = null,
+        validator: String? = null,
     ): AudioMetadata? {
         // 1. 构建基础 Profile (不含 WebDAV)
         val baseProfile = when {
             // CUE 模式：必须有 audioSourceUrl 和 filename
             !audioSourceUrl.isNullOrEmpty() && !filename.isNullOrEmpty() -> {
-                ScanProfile.RemoteCue(filename, audioSourceUrl, headers)
+                ScanProfile.RemoteCue(filename, audioSourceUrl, headers, validator)
             }
             // 网盘/流媒体文件模式：必须有 filename 才能携带 headers
             !filename.isNullOrEmpty() -> {
-                ScanProfile.RemoteFile(filename, headers)
+                ScanProfile.RemoteFile(filename, headers, validator)
             }
             // 标准模式：本地文件 或 不需要特殊处理的 URL (headers 参数会被忽略)
             else -> {
@@ -112,10 +118,294 @@ object AudioProbe {
         return probe(path, finalProfile)
     }
 
+    /**
+     * 3. 批量探测 (媒体库扫描)
+     * 本地文件与网络地址分别在两组 native 线程中并行处理，结果逐个通过 [callback] 返回。
+     * 阻塞直到全部完成、callback 返回 false 或调用 [cancelBatch]，请在后台线程调用。
+     * 取消时进行中的网络连接会被中断，其结果不再回调。
+     *
+     * @param filenames 与 [sources] 一一对应的原始文件名 (网盘文件)，可为 null
+     * @param validators 与 [sources] 一一对应的 ETag / Last-Modified (网络文件)，可为 null
+     * @param headers 仅用于网络地址
+     * @param stats 非 null 时返回前填入本批统计 (吞吐与串行基线)
+     * @return 已回调的文件数
+     */
+    fun probeBatch(
+        sources: List<String>,
+        filenames: List<String?>? = null,
+        validators: List<String?>? = null,
+        headers: Map<String, String>? = null,
+        localThreads: Int = 4,
+        networkThreads: Int = 8,
+        stats: ProbeBatchStats? = null,
+        callback: ProbeBatchCallback,
+    ): Int {
+        if (sources.isEmpty()) return 0
+        return nativeProbeBatch(
+            sources.toTypedArray(),
+            filenames?.toTypedArray(),
+            validators?.toTypedArray(),
+            headers?.ifEmpty { null },
+            localThreads,
+            networkThreads,
+            callback,
+            stats?.raw
+        )
+    }
+
+    /**
+     * 取消所有进行中的批量任务 (探测、标签、指纹、响度)，可在任意线程调用
+     */
+    fun cancelBatch() {
+        nativeCancelBatch()
+    }
+
+    /**
+     * 读取扫描统计快照 (探测耗时、读取字节等)，写入 [stats]
+     */
+    fun getScanStats(stats: ScanStats): Boolean = nativeGetScanStats(stats.raw)
+
+    /**
+     * 清零扫描统计
+     */
+    fun resetScanStats() {
+        nativeResetScanStats()
+    }
+
+    /**
+     * 4. 探测结果缓存
+     * 本地文件按 (路径, 大小, 修改时间) 校验，网络文件按 [ScanProfile.RemoteProfile.validator] 校验，
+     * 未变化的文件重复扫描时不再打开解析。
+     *
+     * @param dir 缓存目录 (如 context.cacheDir)，传 null 关闭缓存
+     * @param maxEntries 条目上限，元数据与指纹、响度等结果分别计数，超出后淘汰最久未访问的条目
+     */
+    fun setCacheDir(dir: String?, maxEntries: Int = 100_000): Boolean {
+        return nativeSetCacheDir(dir, maxEntries)
+    }
+
+    fun clearCache() {
+        nativeClearCache()
+    }
+
+    /**
+     * 5. 内嵌封面
+     * 封面按内容去重保存 (同专辑曲目共用一个文件)，可选同时生成 JPEG 缩略图。
+     *
+     * @param dir 保存目录，null 使用默认目录 /sdcard/Music/.covers/
+     * @param thumbnailSize 缩略图最长边像素，0 不生成
+     */
+    fun setCoverOptions(dir: String? = null, thumbnailSize: Int = 0) {
+        nativeSetCoverOptions(dir, thumbnailSize)
+    }
+
+    /**
+     * @param coverPath [AudioMetadata] 中的封面路径
+     * @return 对应的缩略图路径，未生成时返回 null
+     */
+    fun getThumbnailPath(coverPath: String): String? {
+        return nativeGetThumbnailPath(coverPath)
+    }
+
+    /**
+     * 6. 音频指纹 (chromaprint)
+     * 只解码开头 [maxSeconds] 秒，不启动播放器。结果写入探测缓存 (需先调用 [setCacheDir])。
+     *
+     * @param headers 仅用于网络地址
+     * @param validator 网络文件的 ETag / Last-Modified，用于缓存校验
+     */
+    fun fingerprint(
+        source: String,
+        headers: Map<String, String>? = null,
+        maxSeconds: Int = 120,
+        validator: String? = null,
+    ): AudioFingerprint? {
+        return nativeFingerprint(source, headers?.ifEmpty { null }, maxSeconds, validator)
+    }
+
+    /**
+     * 批量计算指纹，线程模型与 [probeBatch] 相同。阻塞，请在后台线程调用。
+     *
+     * @return 已完成的文件数
+     */
+    fun fingerprintBatch(
+        sources: List<String>,
+        validators: List<String?>? = null,
+        headers: Map<String, String>? = null,
+        maxSeconds: Int = 120,
+        localThreads: Int = 4,
+        networkThreads: Int = 4,
+        callback: FingerprintBatchCallback,
+    ): Int {
+        if (sources.isEmpty()) return 0
+        return nativeFingerprintBatch(
+            sources.toTypedArray(),
+            validators?.toTypedArray(),
+            headers?.ifEmpty { null },
+            maxSeconds,
+            localThreads,
+            networkThreads,
+            callback
+        )
+    }
+
+    /**
+     * 7. 响度分析 (EBU R128 / ReplayGain 2.0)
+     * 完整解码一遍，结果写入探测缓存 (需先调用 [setCacheDir])；之后 [probe] 返回的曲目会带上增益。
+     *
+     * @param endMs <= startMs 表示到文件结尾
+     */
+    fun analyzeLoudness(
+        source: String,
+        headers: Map<String, String>? = null,
+        startMs: Long = 0,
+        endMs: Long = 0,
+        validator: String? = null,
+    ): LoudnessInfo? {
+        return nativeAnalyzeLoudness(source, headers?.ifEmpty { null }, startMs, endMs, validator)
+    }
+
+    /**
+     * 批量分析曲目响度，按 [AudioTrackItem.album] 分组计算专辑增益。
+     * 工作线程以低优先级运行在小核上。阻塞，请在后台线程调用。
+     *
+     * @param validators 与 [tracks] 一一对应的 ETag / Last-Modified (网络文件)，可为 null
+     * @return 已完成的曲目数
+     */
+    fun analyzeLoudnessBatch(
+        tracks: List<AudioTrackItem>,
+        validators: List<String?>? = null,
+        headers: Map<String, String>? = null,
+        localThreads: Int = 2,
+        networkThreads: Int = 2,
+        callback: LoudnessBatchCallback,
+    ): Int {
+        if (tracks.isEmpty()) return 0
+        return nativeAnalyzeLoudnessBatch(
+            tracks.map { it.path }.toTypedArray(),
+            tracks.map { it.startMs }.toLongArray(),
+            tracks.map { it.endMs }.toLongArray(),
+            tracks.map { it.album.ifEmpty { null } }.toTypedArray(),
+            validators?.toTypedArray(),
+            headers?.ifEmpty { null },
+            localThreads,
+            networkThreads,
+            callback
+        )
+    }
+
+    /**
+     * 8. 仅读取标签 (标题、艺术家、专辑、音轨号、碟号)
+     * MP3 / DSF / AIFF 的 ID3 与 FLAC / Ogg 的 Vorbis comment 直接从文件中读取，不打开 FFmpeg，
+     * 不读取封面 ([AudioMetadata] 中无封面路径，MP3 / Ogg 无采样率等参数)。
+     * 网络地址与其他格式回退到 [probe]。
+     */
+    fun readTags(source: String, headers: Map<String, String>? = null): AudioMetadata? {
+        return nativeReadTags(source, headers?.ifEmpty { null })
+    }
+
+    /**
+     * 批量读取标签，线程模型与 [probeBatch] 相同。阻塞，请在后台线程调用。
+     *
+     * @return 已完成的文件数
+     */
+    fun readTagsBatch(
+        sources: List<String>,
+        headers: Map<String, String>? = null,
+        localThreads: Int = 4,
+        networkThreads: Int = 8,
+        callback: ProbeBatchCallback,
+    ): Int {
+        if (sources.isEmpty()) return 0
+        return nativeReadTagsBatch(
+            sources.toTypedArray(),
+            headers?.ifEmpty { null },
+            localThreads,
+            networkThreads,
+            callback
+        )
+    }
+
     private external fun nativeProbe(
         source: String,
         headers: Map<String, String>?,
         filename: String?,
         audioSourceUrl: String?,
+        validator: String?,
     ): AudioMetadata?
+
+    private external fun nativeProbeBatch(
+        sources: Array<String>,
+        filenames: Array<String?>?,
+        validators: Array<String?>?,
+        headers: Map<String, String>?,
+        localThreads: Int,
+        networkThreads: Int,
+        callback: ProbeBatchCallback,
+        stats: LongArray?,
+    ): Int
+
+    private external fun nativeCancelBatch()
+
+    private external fun nativeGetScanStats(out: LongArray): Boolean
+
+    private external fun nativeResetScanStats()
+
+    private external fun nativeReadTags(
+        source: String,
+        headers: Map<String, String>?,
+    ): AudioMetadata?
+
+    private external fun nativeReadTagsBatch(
+        sources: Array<String>,
+        headers: Map<String, String>?,
+        localThreads: Int,
+        networkThreads: Int,
+        callback: ProbeBatchCallback,
+    ): Int
+
+    private external fun nativeSetCacheDir(dir: String?, maxEntries: Int): Boolean
+
+    private external fun nativeClearCache()
+
+    private external fun nativeSetCoverOptions(dir: String?, thumbnailSize: Int)
+
+    private external fun nativeGetThumbnailPath(coverPath: String): String?
+
+    private external fun nativeFingerprint(
+        source: String,
+        headers: Map<String, String>?,
+        maxSeconds: Int,
+        validator: String?,
+    ): AudioFingerprint?
+
+    private external fun nativeFingerprintBatch(
+        sources: Array<String>,
+        validators: Array<String?>?,
+        headers: Map<String, String>?,
+        maxSeconds: Int,
+        localThreads: Int,
+        networkThreads: Int,
+        callback: FingerprintBatchCallback,
+    ): Int
+
+    private external fun nativeAnalyzeLoudness(
+        source: String,
+        headers: Map<String, String>?,
+        startMs: Long,
+        endMs: Long,
+        validator: String?,
+    ): LoudnessInfo?
+
+    private external fun nativeAnalyzeLoudnessBatch(
+        sources: Array<String>,
+        startMs: LongArray,
+        endMs: LongArray,
+        albumKeys: Array<String?>,
+        validators: Array<String?>?,
+        headers: Map<String, String>?,
+        localThreads: Int,
+        networkThreads: Int,
+        callback: LoudnessBatchCallback,
+    ): Int
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+package com.qytech.audioplayer.parser
+
+import androidx.annotation.Keep
+import com.qytech.audioplayer.parser.model.LoudnessInfo
+
+/**
+ * 批量响度分析结果回调。专辑增益需要整张专辑的结果，因此全部分析完成后才在调用线程中依次回调。
+ */
+@Keep
+fun interface LoudnessBatchCallback {
+    /**
+     * @param index 在输入列表中的下标
+     * @param loudness 分析失败为 null
+     * @return false 停止后续回调
+     */
+    fun onResult(index: Int, source: String, loudness: LoudnessInfo?): Boolean
+}
@@ -0,0 +1,17 @@
+package com.qytech.audioplayer.parser
+
+import androidx.annotation.Keep
+import com.qytech.audioplayer.parser.model.AudioMetadata
+
+/**
+ * 批量探测结果回调。在 native 工作线程中调用，但已串行化，不会并发进入。
+ */
+@Keep
+fun interface ProbeBatchCallback {
+    /**
+     * @param index 在输入列表中的下标
+     * @param metadata 探测失败为 null
+     * @return false 取消剩余任务
+     */
+    fun onResult(index: Int, source: String, metadata: AudioMetadata?): Boolean
+}
@@ -0,0 +1,34 @@
+package com.qytech.audioplayer.parser
+
+/**
+ * 一次批量探测的统计，布局与 native 层 BatchProbe::Stats 一致。
+ *
+ * 传给 [AudioProbe.probeBatch] 后在返回时填入。[serialMs] 为各文件耗时之和，
+ * 即逐个串行探测的估计耗时，与 [elapsedMs] 相比即并行带来的加速。
+ */
+class ProbeBatchStats {
+    internal val raw = LongArray(SIZE)
+
+    val total: Long get() = raw[0]
+
+    /** 已回调的结果数，取消后丢弃的不计 */
+    val delivered: Long get() = raw[1]
+    val elapsedMs: Long get() = raw[2]
+    val serialMs: Long get() = raw[3]
+    val cancelled: Boolean get() = raw[4] != 0L
+
+    val filesPerSecond: Double
+        get() = if (elapsedMs > 0) delivered * 1000.0 / elapsedMs else 0.0
+
+    /** 串行基线下的吞吐 */
+    val serialFilesPerSecond: Double
+        get() = if (serialMs > 0) delivered * 1000.0 / serialMs else 0.0
+
+    override fun toString(): String =
+        "ProbeBatchStats(delivered=$delivered/$total, elapsed=${elapsedMs}ms, " +
+            "serial=${serialMs}ms, cancelled=$cancelled)"
+
+    companion object {
+        internal const val SIZE = 5
+    }
+}
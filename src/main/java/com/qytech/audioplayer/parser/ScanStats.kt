@@ -0,0 +1,120 @@
+package com.qytech.audioplayer.parser
+
+/**
+ * 媒体库扫描统计快照，布局与 native 层 ScanStats::snapshot 一致。
+ *
+ * 计数为进程内累计值，可反复传给 [AudioProbe.getScanStats] 而不产生分配；
+ * 一轮扫描前调用 [AudioProbe.resetScanStats] 即可得到该轮的数据。
+ */
+class ScanStats {
+    internal val raw = LongArray(SNAPSHOT_SIZE)
+
+    val version: Long get() = raw[0]
+
+    fun counter(counter: Int): Long = raw[COUNTER_OFFSET + counter]
+
+    /** 完整探测次数 (不含缓存命中) */
+    fun probeCount(network: Boolean): Long =
+        counter(if (network) PROBE_NETWORK_COUNT else PROBE_LOCAL_COUNT)
+
+    /** 跳过 avformat_find_stream_info 的探测占比 */
+    fun probeFastRatio(network: Boolean): Double {
+        val count = probeCount(network)
+        if (count <= 0) return 0.0
+        return counter(if (network) PROBE_NETWORK_FAST else PROBE_LOCAL_FAST).toDouble() / count
+    }
+
+    fun probeMeanMs(network: Boolean): Double {
+        val count = probeCount(network)
+        if (count <= 0) return 0.0
+        return counter(if (network) PROBE_NETWORK_US else PROBE_LOCAL_US) / 1000.0 / count
+    }
+
+    fun probeMeanBytes(network: Boolean): Long {
+        val count = probeCount(network)
+        if (count <= 0) return 0
+        return counter(if (network) PROBE_NETWORK_BYTES else PROBE_LOCAL_BYTES) / count
+    }
+
+    /** 因内容相同而复用已有文件的封面占比 */
+    val coverDedupRatio: Double
+        get() {
+            val total = counter(COVER_SAVED) + counter(COVER_DEDUPED)
+            return if (total > 0) counter(COVER_DEDUPED).toDouble() / total else 0.0
+        }
+
+    val thumbnailMeanMs: Double
+        get() {
+            val count = counter(THUMB_CREATED) + counter(THUMB_FAILED)
+            return if (count > 0) counter(THUMB_US) / 1000.0 / count else 0.0
+        }
+
+    /** 单核每秒可计算的指纹数 */
+    val fingerprintsPerCpuSecond: Double
+        get() {
+            val cpuUs = counter(FINGERPRINT_CPU_US)
+            return if (cpuUs > 0) counter(FINGERPRINT_COMPUTED) * 1e6 / cpuUs else 0.0
+        }
+
+    /** 指纹计算相对实时的倍数 (单核) */
+    val fingerprintRealtimeFactor: Double
+        get() {
+            val cpuUs = counter(FINGERPRINT_CPU_US)
+            return if (cpuUs > 0) counter(FINGERPRINT_AUDIO_MS) * 1000.0 / cpuUs else 0.0
+        }
+
+    /** 响度分析相对实时的倍数 (单核) */
+    val loudnessRealtimeFactor: Double
+        get() {
+            val cpuUs = counter(LOUDNESS_CPU_US)
+            return if (cpuUs > 0) counter(LOUDNESS_AUDIO_MS) * 1000.0 / cpuUs else 0.0
+        }
+
+    /** 只读标签的平均耗时，可与 [probeMeanMs] 对比 */
+    val tagReadMeanMs: Double
+        get() {
+            val count = counter(TAG_READ) + counter(TAG_UNSUPPORTED)
+            return if (count > 0) counter(TAG_US) / 1000.0 / count else 0.0
+        }
+
+    val tagReadMeanBytes: Long
+        get() {
+            val count = counter(TAG_READ) + counter(TAG_UNSUPPORTED)
+            return if (count > 0) counter(TAG_BYTES) / count else 0
+        }
+
+    companion object {
+        const val PROBE_LOCAL_COUNT = 0
+        const val PROBE_LOCAL_FAST = 1
+        const val PROBE_LOCAL_US = 2
+        const val PROBE_LOCAL_BYTES = 3
+        const val PROBE_NETWORK_COUNT = 4
+        const val PROBE_NETWORK_FAST = 5
+        const val PROBE_NETWORK_US = 6
+        const val PROBE_NETWORK_BYTES = 7
+        const val COVER_SAVED = 8
+        const val COVER_DEDUPED = 9
+        const val COVER_SAVED_BYTES = 10
+        const val THUMB_CREATED = 11
+        const val THUMB_FAILED = 12
+        const val THUMB_US = 13
+        const val FINGERPRINT_COMPUTED = 14
+        const val FINGERPRINT_CACHED = 15
+        const val FINGERPRINT_FAILED = 16
+        const val FINGERPRINT_AUDIO_MS = 17
+        const val FINGERPRINT_CPU_US = 18
+        const val LOUDNESS_ANALYZED = 19
+        const val LOUDNESS_CACHED = 20
+        const val LOUDNESS_FAILED = 21
+        const val LOUDNESS_AUDIO_MS = 22
+        const val LOUDNESS_CPU_US = 23
+        const val TAG_READ = 24
+        const val TAG_UNSUPPORTED = 25
+        const val TAG_US = 26
+        const val TAG_BYTES = 27
+        const val COUNTER_COUNT = 28
+
+        internal const val COUNTER_OFFSET = 1
+        const val SNAPSHOT_SIZE = COUNTER_OFFSET + COUNTER_COUNT
+    }
+}
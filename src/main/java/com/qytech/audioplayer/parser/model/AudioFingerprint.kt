@@ -0,0 +1,12 @@
+package com.qytech.audioplayer.parser.model
+
+import androidx.annotation.Keep
+
+/**
+ * 音频指纹 (chromaprint)
+ */
+@Keep
+data class AudioFingerprint(
+    val fingerprint: String, // 压缩编码，可直接用于 AcoustID 查询
+    val durationMs: Long,    // 整个文件的时长
+)
@@ -34,7 +34,16 @@ data class AudioTrackItem(
     val sampleRate: Int = 0,
     val channels: Int = 0,
     val bitDepth: Int = 0,
-    val bitRate: Long = 0
+    val bitRate: Long = 0,
+
+    // --- SACD 区域 (scarletbook area 下标，即实际播放的区域：立体声优先)；其他格式为 -1 ---
+    val sacdArea: Int = -1,
+
+    // --- 响度 (见 AudioProbe.analyzeLoudness)，未分析为 NaN ---
+    val trackGainDb: Float = Float.NaN,
+    val trackPeak: Float = Float.NaN,
+    val albumGainDb: Float = Float.NaN,
+    val albumPeak: Float = Float.NaN,
 ) : Parcelable
 
 /**
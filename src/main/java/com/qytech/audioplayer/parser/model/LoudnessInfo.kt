@@ -0,0 +1,16 @@
+package com.qytech.audioplayer.parser.model
+
+import androidx.annotation.Keep
+
+/**
+ * 响度分析结果 (EBU R128 / ReplayGain 2.0，参考响度 -18 LUFS)
+ * 播放时的增益 = trackGainDb (或 albumGainDb)，并以 peak 限制避免削波
+ */
+@Keep
+data class LoudnessInfo(
+    val integratedLufs: Float,        // 积分响度，静音为 -Infinity
+    val truePeak: Float,              // 真峰值 (线性，1.0 = 0 dBTP)
+    val trackGainDb: Float,
+    val albumGainDb: Float = Float.NaN, // 未按专辑分析为 NaN
+    val albumPeak: Float = Float.NaN,
+)
@@ -10,6 +10,12 @@ interface AudioPlayer {
     fun setDsdMode(mode: DSDMode)
     fun setD2pSampleRate(sampleRate: D2pSampleRate)
 
+    /** PCM 输出编码，需在 prepare 之前设置；不支持的播放器忽略 */
+    fun setOutputEncoding(encoding: PcmEncoding) {}
+
+    /** 最大 PCM 输出声道数 (2/4/6/8)，<= 0 表示按设备属性自动协商；需在 prepare 之前设置 */
+    fun setMaxOutputChannels(channels: Int) {}
+
     fun prepare()
     fun play()
     fun pause()
@@ -22,6 +28,12 @@ interface AudioPlayer {
 
     fun getState(): PlaybackState
 
+    /** 读取播放遥测快照到 stats (可复用同一实例轮询)；不支持的播放器返回 false */
+    fun getStats(stats: PlaybackStats): Boolean = false
+
+    /** 读取原生内存记账快照到 usage (可复用同一实例轮询)；不支持的播放器返回 false */
+    fun getMemoryUsage(usage: MemoryUsage): Boolean = false
+
     /** 回调事件监听，如错误、状态变化、结束等 */
     fun addListener(listener: PlayerListener)
     fun removeListener(listener: PlayerListener)
@@ -45,6 +57,9 @@ interface PlayerListener {
     fun onComplete()
 
     fun onStateChanged(state: PlaybackState)
+
+    /** 起播耗时剖析，每次 prepare 后首次送出音频时回调一次；不支持的播放器不回调 */
+    fun onStartupProfile(profile: StartupProfile) {}
 }
 
 
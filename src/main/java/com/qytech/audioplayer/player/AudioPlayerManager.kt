@@ -314,6 +314,14 @@ class AudioPlayerManager private constructor(private val context: Context) : Aud
         currentPlayer?.setD2pSampleRate(sampleRate)
     }
 
+    override fun setOutputEncoding(encoding: PcmEncoding) {
+        currentPlayer?.setOutputEncoding(encoding)
+    }
+
+    override fun setMaxOutputChannels(channels: Int) {
+        currentPlayer?.setMaxOutputChannels(channels)
+    }
+
     override fun prepare() {
         scope.launch { currentPlayer?.prepare() }
     }
@@ -35,6 +35,8 @@ abstract class BaseNativePlayer(
     private var dsdMode: DSDMode? = null
     private var mediaSource: MediaSource? = null
     private var d2pSampleRate: D2pSampleRate? = null
+    private var outputEncoding: PcmEncoding = PcmEncoding.AUTO
+    private var maxOutputChannels: Int = -1
 
     // 标记是否需要在 prepare 完成后自动播放
     private var playWhenReady = false
@@ -61,12 +63,22 @@ abstract class BaseNativePlayer(
         d2pSampleRate = sampleRate
     }
 
+    override fun setOutputEncoding(encoding: PcmEncoding) {
+        outputEncoding = encoding
+    }
+
+    override fun setMaxOutputChannels(channels: Int) {
+        maxOutputChannels = channels
+    }
+
     override fun prepare() {
         QYPlayerLogger.d("BaseNativePlayer: prepare")
         playWhenReady = false
         isPlayingNotified = false
         // 设置 DSD 模式和 D2P 采样率
         dsdMode?.let { engine.setDsdConfig(it.value, d2pSampleRate?.hz ?: -1) }
+        engine.setOutputEncoding(outputEncoding.supported().value)
+        engine.setMaxOutputChannels(maxOutputChannels)
         engine.prepare()
     }
 
@@ -186,6 +198,10 @@ abstract class BaseNativePlayer(
 
     override fun getState(): PlaybackState = engine.getPlayerState()
 
+    override fun getStats(stats: PlaybackStats): Boolean = engine.getStats(stats.raw)
+
+    override fun getMemoryUsage(usage: MemoryUsage): Boolean = engine.getMemoryUsage(usage.raw)
+
     override fun addListener(listener: PlayerListener) {
         listeners.add(listener)
 
@@ -229,8 +245,7 @@ abstract class BaseNativePlayer(
     private fun getAudioEncoding(bitPerSample: Int): Int {
         return when (bitPerSample) {
             1 -> AudioFormat.ENCODING_DSD // 需要系统支持或特定的 AudioTrack 配置
-            32 -> AudioFormat.ENCODING_PCM_32BIT
-            else -> AudioFormat.ENCODING_PCM_16BIT
+            else -> PcmEncoding.fromValue(engine.getOutputEncoding()).toAudioFormat()
         }
     }
 
@@ -357,6 +372,15 @@ abstract class BaseNativePlayer(
                 notifyStateChanged(PlaybackState.PLAYING)
             }
         }
+
+        override fun onStartupProfile(profile: LongArray) {
+            if (profile.size < StartupProfile.SNAPSHOT_SIZE ||
+                profile[0] != StartupProfile.SNAPSHOT_VERSION.toLong()
+            ) return
+            val startup = StartupProfile(profile)
+            QYPlayerLogger.d("onStartupProfile: $startup")
+            listeners.forEach { it.onStartupProfile(startup) }
+        }
     }
 
     @Deprecated("Use PlayerListener instead")
@@ -13,6 +13,14 @@ class FFPlayer(
     context,
     PlayerStrategy.FFmpeg
 ) {
+    /**
+     * 最近解码 PCM 的缓存时长 (秒，默认 3，最多 8MB 且受全局内存预算约束)，短距离 Seek 命中时
+     * 直接从内存重放；<= 0 关闭。需在 prepare 之前设置
+     */
+    fun setPcmCacheSeconds(seconds: Int) {
+        engine.setPcmCacheSeconds(seconds)
+    }
+
     override fun setMediaSource(mediaSource: MediaSource) {
         super.setMediaSource(mediaSource)
         QYPlayerLogger.d("setMediaSource $mediaSource")
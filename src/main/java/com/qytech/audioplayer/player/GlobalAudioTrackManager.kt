@@ -139,8 +139,12 @@ object GlobalAudioTrackManager {
     }
 
     private fun createTrack(sampleRate: Int, encoding: Int, channel: Int): AudioTrack {
-        val channelConfig =
-            if (channel == 4) AudioFormat.CHANNEL_OUT_QUAD else AudioFormat.CHANNEL_OUT_STEREO
+        val channelConfig = when (channel) {
+            4 -> AudioFormat.CHANNEL_OUT_QUAD
+            6 -> AudioFormat.CHANNEL_OUT_5POINT1
+            8 -> AudioFormat.CHANNEL_OUT_7POINT1_SURROUND
+            else -> AudioFormat.CHANNEL_OUT_STEREO
+        }
         val minBufferSize = AudioTrack.getMinBufferSize(sampleRate, channelConfig, encoding)
         // 适当增大 Buffer 以防止高码率 DSD 播放卡顿
         val bufferSize = if (minBufferSize > 0) minBufferSize * 4 else sampleRate * 4
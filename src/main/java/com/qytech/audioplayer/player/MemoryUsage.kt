@@ -0,0 +1,58 @@
+package com.qytech.audioplayer.player
+
+/**
+ * 原生内存记账快照，布局与 native 层 MemoryAccount::snapshot 一致。
+ *
+ * 会话分项为当前占用 (不含 FFmpeg 内部分配)；全局字段为所有播放器实例的合计。
+ * 内部持有定长 LongArray，可反复传给 AudioPlayer.getMemoryUsage 轮询而不产生分配。
+ */
+class MemoryUsage {
+    internal val raw = LongArray(SNAPSHOT_SIZE)
+
+    val version: Long get() = raw[0]
+
+    /** 本会话当前占用 (字节) */
+    val sessionBytes: Long get() = raw[1]
+
+    /** 本会话峰值 (字节) */
+    val sessionPeakBytes: Long get() = raw[2]
+
+    fun poolBytes(pool: Int): Long = raw[POOL_OFFSET + pool]
+
+    val globalBytes: Long get() = raw[GLOBAL_OFFSET]
+    val globalPeakBytes: Long get() = raw[GLOBAL_OFFSET + 1]
+
+    /** 全局总上限，0 表示不限 */
+    val globalLimitBytes: Long get() = raw[GLOBAL_OFFSET + 2]
+    val packetQueueLimitBytes: Long get() = raw[GLOBAL_OFFSET + 3]
+
+    companion object {
+        const val SNAPSHOT_VERSION = 2
+
+        const val POOL_PACKET_QUEUE = 0
+        const val POOL_PCM_CACHE = 1
+        const val POOL_OUTPUT_BUFFER = 2
+        const val POOL_SACD_READ = 3
+        const val POOL_DST = 4
+
+        /** 暂存待复用的 SACD 镜像句柄，不属于任何会话，只计入全局合计 */
+        const val POOL_HANDOFF = 5
+        const val POOL_COUNT = 6
+
+        private const val POOL_OFFSET = 3
+        private const val GLOBAL_OFFSET = POOL_OFFSET + POOL_COUNT
+        const val SNAPSHOT_SIZE = GLOBAL_OFFSET + 4
+
+        /**
+         * 设置所有播放器实例共享的原生内存上限，随时生效。
+         *
+         * 超出总上限后 PacketQueue 只保留起播所需的数据量，新建的 PCM Seek 缓存按余量缩小；
+         * 播放必需的固定缓冲不受限制。
+         * @param totalBytes 总上限，<= 0 表示不限
+         * @param packetQueueBytes 单个会话 PacketQueue 上限，<= 0 使用默认值 (50MB)
+         */
+        fun setGlobalLimits(totalBytes: Long, packetQueueBytes: Long = 0) {
+            NativePlayerEngine.setMemoryLimits(totalBytes, packetQueueBytes)
+        }
+    }
+}
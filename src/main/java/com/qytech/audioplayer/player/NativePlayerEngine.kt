@@ -12,6 +12,9 @@ internal interface EngineCallback {
     fun onAudioData(data: ByteArray, size: Int)
 
     fun onBuffering(isBuffering: Boolean)
+
+    /** 布局见 StartupProfile */
+    fun onStartupProfile(profile: LongArray)
 }
 
 internal class NativePlayerEngine {
@@ -23,6 +26,13 @@ internal class NativePlayerEngine {
                 QYPlayerLogger.e("Failed to load library: ${e.message}")
             }
         }
+
+        fun setMemoryLimits(totalBytes: Long, packetQueueBytes: Long) {
+            native_setMemoryLimits(totalBytes, packetQueueBytes)
+        }
+
+        @JvmStatic
+        private external fun native_setMemoryLimits(totalBytes: Long, packetQueueBytes: Long)
     }
 
     private var nativeHandle: Long = 0
@@ -59,6 +69,18 @@ internal class NativePlayerEngine {
         if (nativeHandle != 0L) native_setDsdConfig(nativeHandle, mode, d2pSampleRate)
     }
 
+    fun setOutputEncoding(encoding: Int) {
+        if (nativeHandle != 0L) native_setOutputEncoding(nativeHandle, encoding)
+    }
+
+    fun setMaxOutputChannels(channels: Int) {
+        if (nativeHandle != 0L) native_setMaxOutputChannels(nativeHandle, channels)
+    }
+
+    fun setPcmCacheSeconds(seconds: Int) {
+        if (nativeHandle != 0L) native_setPcmCacheSeconds(nativeHandle, seconds)
+    }
+
     fun prepare() {
         if (nativeHandle != 0L) native_prepare(nativeHandle)
     }
@@ -103,6 +125,16 @@ internal class NativePlayerEngine {
         if (nativeHandle != 0L) PlaybackState.fromValue(native_getPlayerState(nativeHandle)) else PlaybackState.IDLE
 
     fun isDsd(): Boolean = if (nativeHandle != 0L) native_isDsd(nativeHandle) else false
+    fun getOutputEncoding(): Int =
+        if (nativeHandle != 0L) native_getOutputEncoding(nativeHandle) else PcmEncoding.AUTO.value
+
+    /** 将遥测快照写入 out (长度 >= PlaybackStats.SNAPSHOT_SIZE)，不加锁、不分配 */
+    fun getStats(out: LongArray): Boolean =
+        if (nativeHandle != 0L) native_getStats(nativeHandle, out) else false
+
+    /** 将内存记账快照写入 out (长度 >= MemoryUsage.SNAPSHOT_SIZE)，不加锁、不分配 */
+    fun getMemoryUsage(out: LongArray): Boolean =
+        if (nativeHandle != 0L) native_getMemoryUsage(nativeHandle, out) else false
 
     // JNI External Methods
     private external fun native_init(type: Int, callback: EngineCallback): Long
@@ -134,4 +166,11 @@ internal class NativePlayerEngine {
     private external fun native_getPlayerState(handle: Long): Int
 
     private external fun native_isDsd(handle: Long): Boolean
+
+    private external fun native_setOutputEncoding(handle: Long, encoding: Int)
+    private external fun native_getOutputEncoding(handle: Long): Int
+    private external fun native_setMaxOutputChannels(handle: Long, channels: Int)
+    private external fun native_setPcmCacheSeconds(handle: Long, seconds: Int)
+    private external fun native_getStats(handle: Long, out: LongArray): Boolean
+    private external fun native_getMemoryUsage(handle: Long, out: LongArray): Boolean
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+package com.qytech.audioplayer.player
+
+import android.media.AudioFormat
+import android.os.Build
+
+/**
+ * PCM 输出编码，与 native 层 PcmEncoding 一一对应。AUTO 表示按源位深自动选择 (S16 / S32)。
+ */
+enum class PcmEncoding(
+    val value: Int,
+) {
+    AUTO(0),
+    PCM_16BIT(1),
+    PCM_24BIT_PACKED(2),
+    PCM_32BIT(3),
+    PCM_FLOAT(4);
+
+    /** ENCODING_PCM_24BIT_PACKED 需要 API 31，更低版本改用 S32，保证 native 输出与 AudioTrack 编码一致 */
+    fun supported(): PcmEncoding =
+        if (this == PCM_24BIT_PACKED && Build.VERSION.SDK_INT < Build.VERSION_CODES.S) PCM_32BIT else this
+
+    fun toAudioFormat(): Int = when (supported()) {
+        PCM_24BIT_PACKED -> AudioFormat.ENCODING_PCM_24BIT_PACKED
+        PCM_32BIT -> AudioFormat.ENCODING_PCM_32BIT
+        PCM_FLOAT -> AudioFormat.ENCODING_PCM_FLOAT
+        else -> AudioFormat.ENCODING_PCM_16BIT
+    }
+
+    companion object {
+        fun fromValue(value: Int): PcmEncoding {
+            return PcmEncoding.entries.firstOrNull { it.value == value } ?: AUTO
+        }
+    }
+}
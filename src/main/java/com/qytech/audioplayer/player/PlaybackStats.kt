@@ -0,0 +1,113 @@
+package com.qytech.audioplayer.player
+
+/**
+ * 播放遥测快照，布局与 native 层 PlayerStats::snapshot 一致。
+ *
+ * 内部持有定长 LongArray，可反复传给 AudioPlayer.getStats 轮询而不产生分配；
+ * 计数器与直方图均为自 prepare 起的累计值，速率等派生量由调用方对两次快照求差。
+ */
+class PlaybackStats {
+    internal val raw = LongArray(SNAPSHOT_SIZE)
+
+    val version: Long get() = raw[0]
+
+    /** 快照时间 (steady clock, us) */
+    val timestampUs: Long get() = raw[1]
+
+    fun counter(counter: Int): Long = raw[COUNTER_OFFSET + counter]
+
+    fun histogramCount(histogram: Int): Long = raw[histogramOffset(histogram)]
+    fun histogramSumUs(histogram: Int): Long = raw[histogramOffset(histogram) + 1]
+    fun histogramMaxUs(histogram: Int): Long = raw[histogramOffset(histogram) + 2]
+
+    fun histogramMeanUs(histogram: Int): Long {
+        val count = histogramCount(histogram)
+        return if (count > 0) histogramSumUs(histogram) / count else 0
+    }
+
+    /** 桶 0 为 < 1us，桶 i 为 [2^(i-1), 2^i) us，最后一个桶收纳其余 */
+    fun histogramBucket(histogram: Int, bucket: Int): Long =
+        raw[histogramOffset(histogram) + 3 + bucket]
+
+    /** 按桶上界估算分位数 (us)，quantile 取 0..1 */
+    fun histogramPercentileUs(histogram: Int, quantile: Double): Long {
+        val count = histogramCount(histogram)
+        if (count <= 0) return 0
+        val target = (count * quantile).toLong().coerceIn(1, count)
+        var seen = 0L
+        for (bucket in 0 until HISTOGRAM_BUCKETS) {
+            seen += histogramBucket(histogram, bucket)
+            if (seen >= target) return if (bucket == 0) 1 else 1L shl bucket
+        }
+        return histogramMaxUs(histogram)
+    }
+
+    val readBytes: Long get() = counter(COUNTER_READ_BYTES)
+    val deliveredBytes: Long get() = counter(COUNTER_DELIVERED_BYTES)
+    val queuePackets: Long get() = counter(COUNTER_QUEUE_PACKETS)
+    val queueBytes: Long get() = counter(COUNTER_QUEUE_BYTES)
+    val underruns: Long get() = counter(COUNTER_UNDERRUNS)
+
+    /** PCM 路径每秒音频的输出字节数，用于比较各 PcmEncoding 的带宽；sampleRate 为输出采样率 */
+    fun pcmBytesPerAudioSecond(sampleRate: Int): Double {
+        val frames = counter(COUNTER_PCM_OUTPUT_FRAMES)
+        if (frames <= 0 || sampleRate <= 0) return 0.0
+        return counter(COUNTER_PCM_OUTPUT_BYTES) * sampleRate.toDouble() / frames
+    }
+
+    /** PCM 路径每秒音频的转换 CPU 时间 (ms) */
+    fun pcmConvertCpuMsPerAudioSecond(sampleRate: Int): Double {
+        val frames = counter(COUNTER_PCM_OUTPUT_FRAMES)
+        if (frames <= 0 || sampleRate <= 0) return 0.0
+        return counter(COUNTER_PCM_CONVERT_CPU_NS) / 1e6 * sampleRate / frames
+    }
+    val bufferingEpisodes: Long get() = histogramCount(HIST_BUFFERING)
+    val seekCacheHits: Long get() = counter(COUNTER_SEEK_CACHE_HITS)
+    val seekCacheMisses: Long get() = counter(COUNTER_SEEK_CACHE_MISSES)
+
+    /** 命中 / 未命中 PCM 缓存的 Seek 平均延迟 (us) */
+    val seekHitMeanUs: Long
+        get() = if (seekCacheHits > 0) counter(COUNTER_SEEK_HIT_US) / seekCacheHits else 0
+    val seekMissMeanUs: Long
+        get() = if (seekCacheMisses > 0) counter(COUNTER_SEEK_MISS_US) / seekCacheMisses else 0
+
+    private fun histogramOffset(histogram: Int): Int =
+        HISTOGRAM_OFFSET + histogram * HISTOGRAM_SIZE
+
+    companion object {
+        const val SNAPSHOT_VERSION = 2
+
+        const val COUNTER_READ_BYTES = 0
+        const val COUNTER_READ_PACKETS = 1
+        const val COUNTER_DELIVERED_BYTES = 2
+        const val COUNTER_QUEUE_PACKETS = 3
+        const val COUNTER_QUEUE_BYTES = 4
+        const val COUNTER_QUEUE_PEAK_BYTES = 5
+        const val COUNTER_UNDERRUNS = 6
+        const val COUNTER_DECODE_ERRORS = 7
+        const val COUNTER_SWR_REBUILDS = 8
+        const val COUNTER_DST_REBUILDS = 9
+        const val COUNTER_PCM_OUTPUT_BYTES = 10
+        const val COUNTER_PCM_OUTPUT_FRAMES = 11
+        const val COUNTER_PCM_CONVERT_CPU_NS = 12
+        const val COUNTER_SEEK_CACHE_HITS = 13
+        const val COUNTER_SEEK_CACHE_MISSES = 14
+        const val COUNTER_SEEK_HIT_US = 15
+        const val COUNTER_SEEK_MISS_US = 16
+        const val COUNTER_COUNT = 17
+
+        const val HIST_READ = 0
+        const val HIST_DECODE = 1
+        const val HIST_CALLBACK = 2
+        const val HIST_BUFFERING = 3
+        const val HIST_SEEK = 4
+        const val HIST_COUNT = 5
+
+        const val HISTOGRAM_BUCKETS = 24
+        private const val HISTOGRAM_SIZE = 3 + HISTOGRAM_BUCKETS
+
+        private const val COUNTER_OFFSET = 2
+        private const val HISTOGRAM_OFFSET = COUNTER_OFFSET + COUNTER_COUNT
+        const val SNAPSHOT_SIZE = HISTOGRAM_OFFSET + HIST_COUNT * HISTOGRAM_SIZE
+    }
+}
@@ -0,0 +1,87 @@
+package com.qytech.audioplayer.player
+
+/**
+ * 起播耗时剖析，布局与 native 层 StartupProfile::finish 一致。
+ *
+ * 每次 prepare 后首次送出音频时回调一次 (PlayerListener.onStartupProfile)。
+ * 各里程碑为相对 prepare() 开始的微秒数，未到达为 -1；play() 的调用时机由上层决定，
+ * 起播耗时按 play() 重新计起。
+ */
+class StartupProfile internal constructor(private val raw: LongArray) {
+
+    val version: Long get() = raw[0]
+
+    val isNetwork: Boolean get() = (raw[1] and FLAG_NETWORK) != 0L
+
+    /** 接管了探测时打开的解复用器 / SACD 句柄，打开与解析阶段近似为 0 */
+    val reusedHandle: Boolean get() = (raw[1] and FLAG_REUSED_HANDLE) != 0L
+
+    fun milestoneUs(milestone: Int): Long = raw[MILESTONE_OFFSET + milestone]
+
+    /**
+     * 阶段耗时：milestone 与其前一个已到达里程碑之差 (PLAY 之前从 prepare() 计起，之后从 play() 计起)
+     * @return milestone 未到达时返回 -1
+     */
+    fun phaseUs(milestone: Int): Long {
+        val end = milestoneUs(milestone)
+        if (end < 0) return -1
+        val floor = if (milestone > MILESTONE_PLAY) MILESTONE_PLAY else 0
+        for (previous in milestone - 1 downTo floor) {
+            val start = milestoneUs(previous)
+            if (start >= 0) return end - start
+        }
+        return end
+    }
+
+    /** prepare() 到 onPrepared */
+    val timeToPreparedUs: Long get() = milestoneUs(MILESTONE_PREPARED)
+
+    /** play() 到首次送出音频 */
+    val timeToFirstAudioUs: Long
+        get() {
+            val play = milestoneUs(MILESTONE_PLAY)
+            val audio = milestoneUs(MILESTONE_FIRST_AUDIO)
+            return if (play >= 0 && audio >= 0) audio - play else -1
+        }
+
+    override fun toString(): String =
+        (0 until MILESTONE_COUNT).joinToString(
+            prefix = "StartupProfile(",
+            postfix = ", network=$isNetwork, reused=$reusedHandle)"
+        ) { "${MILESTONE_NAMES[it]}=${milestoneUs(it)}" }
+
+    companion object {
+        const val SNAPSHOT_VERSION = 1
+
+        /** 源已打开 (网络源含 DNS/TCP/TLS 与 HTTP 响应) */
+        const val MILESTONE_OPENED = 0
+
+        /** 流信息 / SACD TOC 解析完成 */
+        const val MILESTONE_STREAM_INFO = 1
+
+        /** 解码器 / 重采样器就绪 */
+        const val MILESTONE_CODEC_OPENED = 2
+        const val MILESTONE_PREPARED = 3
+        const val MILESTONE_PLAY = 4
+
+        /** 读取线程 / SACD 输出线程已启动 */
+        const val MILESTONE_OUTPUT_STARTED = 5
+
+        /** 起播缓冲完成 (FFmpeg 源) / 首批扇区读取完成 (SACD) */
+        const val MILESTONE_BUFFERED = 6
+        const val MILESTONE_FIRST_DECODE = 7
+        const val MILESTONE_FIRST_AUDIO = 8
+        const val MILESTONE_COUNT = 9
+
+        const val FLAG_NETWORK = 1L
+        const val FLAG_REUSED_HANDLE = 2L
+
+        private const val MILESTONE_OFFSET = 2
+        const val SNAPSHOT_SIZE = MILESTONE_OFFSET + MILESTONE_COUNT
+
+        private val MILESTONE_NAMES = arrayOf(
+            "opened", "streamInfo", "codecOpened", "prepared", "play",
+            "outputStarted", "buffered", "firstDecode", "firstAudio"
+        )
+    }
+}
@@ -17,6 +17,13 @@ sealed interface ScanProfile {
     interface RemoteProfile : ScanProfile {
         val headers: Map<String, String>?
         val filename: String
+
+        /**
+         * 服务端给出的 ETag 或 Last-Modified (例如 WebDAV PROPFIND 结果)，
+         * 用于探测结果缓存的有效性校验；为空时网络文件不走缓存
+         */
+        val validator: String?
+            get() = null
     }
 
     /**
@@ -25,10 +32,12 @@ sealed interface ScanProfile {
      *
      * @param headers HTTP 请求头 (关键鉴权信息)
      * @param filename 原始文件名 (辅助格式识别)
+     * @param validator ETag 或 Last-Modified
      */
     data class RemoteFile(
         override val filename: String,
         override val headers: Map<String, String>? = null,
+        override val validator: String? = null,
     ) : RemoteProfile
 
     /**
@@ -38,11 +47,13 @@ sealed interface ScanProfile {
      * @param headers HTTP 请求头 (用于下载 CUE 和 音频)
      * @param filename CUE 文件名
      * @param audioSourceUrl CUE 对应的原始音频 URL
+     * @param validator CUE 文件的 ETag 或 Last-Modified
      */
     data class RemoteCue(
         override val filename: String,
         val audioSourceUrl: String,
         override val headers: Map<String, String>? = null,
+        override val validator: String? = null,
     ) : RemoteProfile
 
     /**